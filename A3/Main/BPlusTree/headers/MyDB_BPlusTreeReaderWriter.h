@@ -0,0 +1,121 @@
+
+#ifndef BPLUS_H
+#define BPLUS_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_INRecord.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_TableReaderWriter.h"
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+class MyDB_BPlusTreeReaderWriter;
+typedef shared_ptr <MyDB_BPlusTreeReaderWriter> MyDB_BPlusTreeReaderWriterPtr;
+
+// A MyDB_BPlusTreeReaderWriter stores a table as a B+-Tree, ordered on one of its attributes.
+// The leaves are regular pages holding the records (unsorted within a leaf), and the internal
+// nodes are directory pages holding MyDB_INRecords, sorted on their keys.  Each MyDB_INRecord
+// points to a child that holds keys no larger than its own key, and no smaller than the key of
+// the MyDB_INRecord before it; the last MyDB_INRecord on the rightmost node at each level has
+// the largest possible key, and is treated as having no upper bound at all.  The location of the root is
+// kept in the table (via setRootLocation), so it goes into the catalog with everything else.
+//
+// Since the leaves are regular pages and the internal nodes are directory pages, the usual
+// table iterators (getIteratorAlt (), getBatchIterator (), ...) still do a full scan of all of
+// the records.  For example, to get all of the records with keys in [10, 20]:
+//
+//	MyDB_BPlusTreeReaderWriter myTree ("key", myTable, myMgr);
+//	myTree.loadFromTextFile ("myData.tbl");
+//	MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> (), high = make_shared <MyDB_IntAttVal> ();
+//	low->set (10);
+//	high->set (20);
+//	MyDB_RecordIteratorAltPtr myIter = myTree.getSortedRangeIteratorAlt (low, high);
+class MyDB_BPlusTreeReaderWriter : public MyDB_TableReaderWriter {
+
+public:
+
+	// create a B+-Tree over the table, ordered on the named attribute... if the table does
+	// not have a root yet, an empty tree is set up
+	MyDB_BPlusTreeReaderWriter (string orderOnAttName, MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
+
+	// like the above, except that the tree is ordered on the table's sort attribute
+	MyDB_BPlusTreeReaderWriter (MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
+
+	// gets an instance of an alternate iterator over all of the records whose keys are
+	// in [low, high], in sorted order... a point lookup just uses low == high
+	MyDB_RecordIteratorAltPtr getSortedRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// like the above, except that the records are not returned in any particular order;
+	// this is cheaper, since the leaves do not have to be sorted
+	MyDB_RecordIteratorAltPtr getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// insert a record into the tree, splitting nodes as needed
+	void append (MyDB_RecordPtr appendMe) override;
+
+	// the records on a page image have to go wherever they belong in the tree, so they are
+	// inserted one at a time
+	void appendImage (void *image) override;
+
+	// replaces the contents of the tree with the records in sortedInput, which must already
+	// be sorted on the tree's attribute (say, by sort () in Sorting.h).  Rather than inserting
+	// the records one at a time, this streams them into leaves that are packed until they hold
+	// fillFactor * pageSize bytes, and builds the internal nodes bottom-up as the leaves fill,
+	// all in a single pass.  A fill factor of less than 1.0 leaves room for later inserts
+	void bulkLoad (MyDB_TableReaderWriter &sortedInput, double fillFactor = 1.0);
+
+	// empties out the tree, leaving a root with a single empty leaf
+	void clear () override;
+
+	// the height of the tree (a tree whose root points right at the leaves has height 1)
+	int getHeight ();
+
+	// print the tree, for debugging
+	void printTree ();
+
+private:
+
+	// rewrites the given page with andMe added to it... the records on the page are loaded
+	// into iterRec, one at a time, in order, and andMe goes in front of the first one for
+	// which goesBefore () is true (or at the end).  If everything does not fit, the lower half
+	// of the records go onto a new page and the upper half stay on this page, and a
+	// MyDB_INRecord that points to the new page (whose key is the largest key on the new
+	// page) is returned; otherwise, nullptr is returned.  A leaf is sorted before it is split
+	MyDB_RecordPtr insertInOrder (MyDB_PageReaderWriter page, MyDB_RecordPtr andMe, MyDB_RecordPtr iterRec,
+		function <bool ()> goesBefore);
+
+	// appends a record into the subtree rooted at the given page... if the root of the
+	// subtree splits, the MyDB_INRecord for the new page is returned; otherwise, nullptr
+	MyDB_RecordPtr append (int whichPage, MyDB_RecordPtr appendMe);
+
+	// gets a MyDB_INRecord with a key of the right type
+	MyDB_INRecordPtr getINRecord ();
+
+	// adds all of the leaves under the given page that could have keys in [low, high]
+	// to the list, in key order
+	void discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list, MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// helper for printTree
+	void printTree (int whichPage, int depth);
+
+	// builds a comparator that checks whether the key of lhs is less than the key of rhs;
+	// either one can be a regular record or a MyDB_INRecord
+	function <bool ()> buildComparator (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+
+	// the key of a record (or of a MyDB_INRecord)
+	MyDB_AttValPtr getKey (MyDB_RecordPtr fromMe);
+
+	// is the lhs key less than the rhs key?
+	bool keyLess (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs);
+
+	// the type and position of the attribute the tree is ordered on
+	MyDB_AttTypePtr orderingAttType;
+	int whichAttIsOrdering;
+
+	// the page holding the root
+	int rootLocation;
+};
+
+#endif
@@ -0,0 +1,410 @@
+
+#ifndef BPLUS_C
+#define BPLUS_C
+
+#include "MyDB_PageListFilterIteratorAlt.h"
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include <iostream>
+#include <string.h>
+
+MyDB_BPlusTreeReaderWriter :: MyDB_BPlusTreeReaderWriter (string orderOnAttName, MyDB_TablePtr forMeIn,
+	MyDB_BufferManagerPtr myBufferIn) : MyDB_TableReaderWriter (forMeIn, myBufferIn) {
+
+	// find the ordering attribute
+	auto res = forMe->getSchema ()->getAttByName (orderOnAttName);
+	if (res.first == -1) {
+		cout << "This is bad... could not find the attribute " << orderOnAttName << " to order the B+-Tree on.\n";
+		exit (1);
+	}
+	whichAttIsOrdering = res.first;
+	orderingAttType = res.second;
+
+	// and set up an empty tree if there is not one already
+	if (forMe->getRootLocation () == -1)
+		clear ();
+	rootLocation = forMe->getRootLocation ();
+}
+
+MyDB_BPlusTreeReaderWriter :: MyDB_BPlusTreeReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) :
+	MyDB_BPlusTreeReaderWriter (forMeIn->getSortAtt (), forMeIn, myBufferIn) {}
+
+void MyDB_BPlusTreeReaderWriter :: clear () {
+
+	// page 0 is the root, and page 1 is the only leaf
+	forMe->setLastPage (1);
+	MyDB_PageReaderWriter root = (*this)[0];
+	root.clear ();
+	root.setType (MyDB_PageType :: DirectoryPage);
+	MyDB_INRecordPtr toLeaf = getINRecord ();
+	toLeaf->setPtr (1);
+	root.append (toLeaf);
+
+	lastPage = make_shared <MyDB_PageReaderWriter> (*this, 1);
+	lastPage->clear ();
+
+	rootLocation = 0;
+	forMe->setRootLocation (0);
+	clearStats ();
+}
+
+void MyDB_BPlusTreeReaderWriter :: bulkLoad (MyDB_TableReaderWriter &sortedInput, double fillFactor) {
+
+	if (fillFactor <= 0.0 || fillFactor > 1.0) {
+		cout << "This is bad... the fill factor for a B+-Tree has to be in (0, 1].\n";
+		exit (1);
+	}
+	size_t headerSize = 2 * sizeof (size_t);
+	size_t limit = (size_t) (fillFactor * myBuffer->getPageSize ());
+
+	// the page being filled at each level (level 0 holds the leaves), the number of bytes
+	// on it, and the largest key on it... the first leaf is page 0
+	vector <int> pages;
+	vector <size_t> bytes;
+	vector <MyDB_AttValPtr> maxKeys;
+	MyDB_TableReaderWriter :: clear ();
+	pages.push_back (0);
+	bytes.push_back (headerSize);
+	maxKeys.push_back (orderingAttType->createAtt ());
+
+	auto startPage = [&] (int level) {
+		pages[level] = forMe->lastPage () + 1;
+		bytes[level] = headerSize;
+		(*this)[pages[level]].setType (level == 0 ? MyDB_PageType :: RegularPage : MyDB_PageType :: DirectoryPage);
+	};
+
+	// adds an entry pointing to a finished page into the level above it... if that fills up
+	// the page at that level, it is finished as well
+	MyDB_INRecordPtr entry = getINRecord ();
+	function <void (int, MyDB_AttValPtr, int)> addEntry = [&] (int level, MyDB_AttValPtr key, int ptr) {
+		if (level == (int) pages.size ()) {
+			pages.push_back (0);
+			bytes.push_back (0);
+			maxKeys.push_back (orderingAttType->createAtt ());
+			startPage (level);
+		}
+		entry->setKey (key);
+		entry->setPtr (ptr);
+		size_t size = entry->getBinarySize ();
+		if (bytes[level] + size > limit && bytes[level] > headerSize) {
+			addEntry (level + 1, maxKeys[level], pages[level]);
+			startPage (level);
+			entry->setKey (key);
+			entry->setPtr (ptr);
+		}
+		if (!(*this)[pages[level]].append (entry)) {
+			cout << "This is bad... a key is too large to fit onto a B+-Tree page.\n";
+			exit (1);
+		}
+		bytes[level] += size;
+		maxKeys[level]->set (key);
+	};
+
+	// now, stream in the records
+	MyDB_RecordPtr rec = getEmptyRecord ();
+	MyDB_AttValPtr key = getKey (rec);
+	MyDB_PageReaderWriter leaf = (*this)[0];
+	MyDB_RecordIteratorAltPtr myIter = sortedInput.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (rec);
+		if (bytes[0] > headerSize && keyLess (key, maxKeys[0])) {
+			cout << "This is bad... the records sent to bulkLoad are not sorted on the B+-Tree's attribute.\n";
+			exit (1);
+		}
+
+		// if this leaf is full, finish it and start a new one
+		size_t size = rec->getBinarySize ();
+		if (bytes[0] + size > limit && bytes[0] > headerSize) {
+			addEntry (1, maxKeys[0], pages[0]);
+			startPage (0);
+			leaf = (*this)[pages[0]];
+		}
+		if (!leaf.append (rec)) {
+			cout << "This is bad... a record is too large to fit onto a B+-Tree page.\n";
+			exit (1);
+		}
+		bytes[0] += size;
+		maxKeys[0]->set (key);
+		addToStats (rec);
+	}
+
+	// finish the last page at each level... the entry for each one has the largest possible
+	// key, since it has no upper bound (this can add a new level, so we check the size each time)
+	for (int level = 0; level < (int) pages.size () - 1 || level == 0; level++)
+		addEntry (level + 1, orderingAttType->createAttMax (), pages[level]);
+
+	rootLocation = pages.back ();
+	forMe->setRootLocation (rootLocation);
+}
+
+MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getSortedRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	vector <MyDB_PageReaderWriter> list;
+	discoverPages (rootLocation, list, low, high);
+
+	// sort each of the leaves... since the leaves come back in key order, this is all that
+	// is needed to get all of the records in order
+	MyDB_RecordPtr lhs = getEmptyRecord ();
+	MyDB_RecordPtr rhs = getEmptyRecord ();
+	function <bool ()> comparator = buildComparator (lhs, rhs);
+	vector <MyDB_PageReaderWriter> sortedList;
+	for (MyDB_PageReaderWriter &page : list)
+		sortedList.push_back (*page.sort (comparator, lhs, rhs));
+
+	MyDB_RecordPtr myRec = getEmptyRecord ();
+	MyDB_AttValPtr key = getKey (myRec);
+	return make_shared <MyDB_PageListFilterIteratorAlt> (sortedList, myRec,
+		[this, key, low, high] {return !keyLess (key, low) && !keyLess (high, key);});
+}
+
+MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	vector <MyDB_PageReaderWriter> list;
+	discoverPages (rootLocation, list, low, high);
+
+	MyDB_RecordPtr myRec = getEmptyRecord ();
+	MyDB_AttValPtr key = getKey (myRec);
+	return make_shared <MyDB_PageListFilterIteratorAlt> (list, myRec,
+		[this, key, low, high] {return !keyLess (key, low) && !keyLess (high, key);});
+}
+
+void MyDB_BPlusTreeReaderWriter :: discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
+	MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	// if this is a leaf, we are done
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	if (page.getType () == MyDB_PageType :: RegularPage) {
+		list.push_back (page);
+		return;
+	}
+
+	// child i holds keys in [key of entry i - 1, key of entry i]... so we go through
+	// the entries until we find one whose lower bound is past high, remembering which
+	// children have an upper bound no smaller than low
+	vector <int> children;
+	vector <bool> reachesLow;
+	MyDB_INRecordPtr temp = getINRecord ();
+	MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+	bool pastHigh = false;
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		if (pastHigh)
+			break;
+		children.push_back (temp->getPtr ());
+		reachesLow.push_back (!keyLess (temp->getKey (), low));
+		pastHigh = keyLess (high, temp->getKey ());
+	}
+
+	// the last entry on the page has no upper bound, so if we got to it, it is searched
+	for (int i = 0; i < (int) children.size (); i++) {
+		if (reachesLow[i] || (i == (int) children.size () - 1 && !pastHigh))
+			discoverPages (children[i], list, low, high);
+	}
+}
+
+void MyDB_BPlusTreeReaderWriter :: appendImage (void *image) {
+	appendImageRecords (image);
+}
+
+void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
+
+	addToStats (appendMe);
+	MyDB_RecordPtr newChild = append (rootLocation, appendMe);
+	if (newChild == nullptr)
+		return;
+
+	// the root split, so we need a new root... it points to the new page, and to the old root
+	int newRoot = forMe->lastPage () + 1;
+	MyDB_PageReaderWriter root = (*this)[newRoot];
+	root.setType (MyDB_PageType :: DirectoryPage);
+	root.append (newChild);
+	MyDB_INRecordPtr toOldRoot = getINRecord ();
+	toOldRoot->setPtr (rootLocation);
+	root.append (toOldRoot);
+
+	rootLocation = newRoot;
+	forMe->setRootLocation (newRoot);
+}
+
+MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordPtr appendMe) {
+
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	MyDB_AttValPtr key = getKey (appendMe);
+
+	// at a leaf, just put the record on the page, splitting it if it is full
+	if (page.getType () == MyDB_PageType :: RegularPage) {
+		if (page.append (appendMe))
+			return nullptr;
+		MyDB_RecordPtr temp = getEmptyRecord ();
+		MyDB_AttValPtr tempKey = getKey (temp);
+		return insertInOrder (page, appendMe, temp, [this, key, tempKey] {return keyLess (key, tempKey);});
+	}
+
+	// otherwise, find the first entry whose key is at least as large as the new record's key;
+	// if there is none, it goes under the last entry
+	MyDB_INRecordPtr temp = getINRecord ();
+	MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		if (!keyLess (temp->getKey (), key))
+			break;
+	}
+
+	int child = temp->getPtr ();
+	MyDB_RecordPtr newChild = append (child, appendMe);
+	if (newChild == nullptr)
+		return nullptr;
+
+	// the child split... the entry for the new page goes right in front of the entry for the
+	// child (we cannot just sort the entries, since the two can have the same key)
+	return insertInOrder (page, newChild, temp, [temp, child] {return temp->getPtr () == child;});
+}
+
+MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: insertInOrder (MyDB_PageReaderWriter page, MyDB_RecordPtr andMe, 
+	MyDB_RecordPtr iterRec, function <bool ()> goesBefore) {
+
+	// the entries on an internal node are always kept in order, but a leaf needs to be sorted
+	bool isLeaf = page.getType () == MyDB_PageType :: RegularPage;
+	if (isLeaf) {
+		MyDB_RecordPtr lhs = getEmptyRecord ();
+		MyDB_RecordPtr rhs = getEmptyRecord ();
+		page.sortInPlace (buildComparator (lhs, rhs), lhs, rhs);
+	}
+
+	// copy the page off to the side (pinned, since we hold pointers into it), and list all
+	// of the records in order, with the new one in its place
+	MyDB_PageReaderWriter copy (true, *myBuffer);
+	memcpy (copy.getBytes (), page.getBytes (), page.getPageSize ());
+	vector <char> andMeBytes (andMe->getBinarySize ());
+	andMe->toBinary (andMeBytes.data ());
+
+	vector <void *> records;
+	size_t totalBytes = andMeBytes.size ();
+	bool placed = false;
+	MyDB_RecordIteratorAltPtr myIter = copy.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (iterRec);
+		if (!placed && goesBefore ()) {
+			records.push_back (andMeBytes.data ());
+			placed = true;
+		}
+		records.push_back (myIter->getCurrentPointer ());
+		totalBytes += iterRec->getBinarySize ();
+	}
+	if (!placed)
+		records.push_back (andMeBytes.data ());
+
+	// if everything fits, just write it all back
+	MyDB_PageType type = page.getType ();
+	page.clear ();
+	page.setType (type);
+	if (2 * sizeof (size_t) + totalBytes <= page.getPageSize ()) {
+		for (void *rec : records) {
+			iterRec->fromBinary (rec);
+			page.append (iterRec);
+		}
+		return nullptr;
+	}
+
+	// otherwise, the first half go on a new page, and the rest go back onto this one
+	int newPage = forMe->lastPage () + 1;
+	MyDB_PageReaderWriter lowerHalf = (*this)[newPage];
+	lowerHalf.setType (type);
+
+	size_t bytesSoFar = 0;
+	MyDB_AttValPtr splitKey;
+	for (void *rec : records) {
+		iterRec->fromBinary (rec);
+		bool lower = bytesSoFar < totalBytes / 2;
+		if (!(lower ? lowerHalf : page).append (iterRec)) {
+			cout << "This is bad... a record is too large to fit into half of a B+-Tree page.\n";
+			exit (1);
+		}
+		if (lower)
+			splitKey = getKey (iterRec)->getCopy ();
+		bytesSoFar += iterRec->getBinarySize ();
+	}
+
+	MyDB_INRecordPtr result = getINRecord ();
+	result->setKey (splitKey);
+	result->setPtr (newPage);
+	return result;
+}
+
+MyDB_INRecordPtr MyDB_BPlusTreeReaderWriter :: getINRecord () {
+	return make_shared <MyDB_INRecord> (orderingAttType->createAttMax ());
+}
+
+MyDB_AttValPtr MyDB_BPlusTreeReaderWriter :: getKey (MyDB_RecordPtr fromMe) {
+
+	// a MyDB_INRecord has no schema, and its key comes first
+	if (fromMe->getSchema () == nullptr)
+		return fromMe->getAtt (0);
+	return fromMe->getAtt (whichAttIsOrdering);
+}
+
+bool MyDB_BPlusTreeReaderWriter :: keyLess (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
+	if (orderingAttType->isBool ())
+		return lhs->toBool () < rhs->toBool ();
+	if (orderingAttType->promotableToInt ())
+		return lhs->toInt () < rhs->toInt ();
+	if (orderingAttType->promotableToDouble ())
+		return lhs->toDouble () < rhs->toDouble ();
+	return lhs->toString () < rhs->toString ();
+}
+
+function <bool ()> MyDB_BPlusTreeReaderWriter :: buildComparator (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+	// the attribute objects in a record stay put as new records are loaded into it, so
+	// we can grab them once here
+	MyDB_AttValPtr lhsKey = getKey (lhs);
+	MyDB_AttValPtr rhsKey = getKey (rhs);
+	return [this, lhsKey, rhsKey] {return keyLess (lhsKey, rhsKey);};
+}
+
+int MyDB_BPlusTreeReaderWriter :: getHeight () {
+	int height = 0;
+	MyDB_INRecordPtr temp = getINRecord ();
+	for (int whichPage = rootLocation; (*this)[whichPage].getType () == MyDB_PageType :: DirectoryPage; height++) {
+		MyDB_RecordIteratorAltPtr myIter = (*this)[whichPage].getIteratorAlt ();
+		myIter->advance ();
+		myIter->getCurrent (temp);
+		whichPage = temp->getPtr ();
+	}
+	return height;
+}
+
+void MyDB_BPlusTreeReaderWriter :: printTree () {
+	printTree (rootLocation, 0);
+}
+
+void MyDB_BPlusTreeReaderWriter :: printTree (int whichPage, int depth) {
+
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	string indent (depth * 4, ' ');
+
+	// print out the records on a leaf
+	if (page.getType () == MyDB_PageType :: RegularPage) {
+		MyDB_RecordPtr temp = getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			cout << indent << temp << "\n";
+		}
+		return;
+	}
+
+	// and recursively print an internal node
+	MyDB_INRecordPtr temp = getINRecord ();
+	vector <pair <int, string>> children;
+	MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (temp);
+		children.push_back (make_pair (temp->getPtr (), temp->getKey ()->toString ()));
+	}
+	for (auto &child : children) {
+		printTree (child.first, depth + 1);
+		cout << indent << "(" << child.second << ", page " << child.first << ")\n";
+	}
+}
+
+#endif
@@ -0,0 +1,27 @@
+
+#ifndef BLOCK_COMPRESSOR_H
+#define BLOCK_COMPRESSOR_H
+
+#include <stddef.h>
+
+// A small LZ77 block compressor in the style of LZ4, used to store pages compactly on disk.
+// It is built for speed rather than ratio: matches are found with a single hash table of the
+// last place each four-byte sequence was seen, and there is no entropy coding.  A compressed
+// block is a list of sequences, each of which is
+//
+//	[token][more literal length][literals][2-byte offset][more match length]
+//
+// where the high four bits of the token are the number of literals and the low four bits are
+// the match length minus four (a nibble of 15 means that more length follows, in bytes that
+// are added on until one is not 255).  The last sequence has only literals.
+
+// compresses the n bytes at from into the cap bytes at into, and returns the size of the
+// compressed block... returns zero if it does not fit, so that the caller can store the bytes
+// uncompressed instead
+size_t compressBlock (const char *from, size_t n, char *into, size_t cap);
+
+// decompresses the n byte block at from into the outSize bytes at into; returns false if the
+// block is corrupt or does not decompress to exactly outSize bytes
+bool decompressBlock (const char *from, size_t n, char *into, size_t outSize);
+
+#endif
@@ -16,6 +16,7 @@
 #include "CheckLRU.h"
 #include <map>
 #include <memory>
+#include "MyDB_ExtentFile.h"
 #include "MyDB_Page.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
@@ -63,6 +64,19 @@ public:
 	// 2) the number of pages managed by the buffer manager is numPages;
 	// 3) temporary pages are written to the file tempFile
 	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile);
+
+	// like the above, except that if compressTemp is true, temporary pages are compressed
+	// when they are written out to tempFile (see MyDB_ExtentFile.h), which is a good idea
+	// when there is a lot of spilling, say from a big sort, and the disk is slow
+	MyDB_BufferManager (size_t pageSize, size_t numPages, string tempFile, bool compressTemp);
+
+	// from now on, the pages of the given table are compressed when they are written to its
+	// file; this is meant for big tables that are mostly read, or not used much at all.  Pages
+	// in RAM are never compressed, so nothing else changes.  If the file already has pages,
+	// they are compressed right away (into a new file that replaces the old one).  A file
+	// that has been compressed stays that way: whenever it is opened, the buffer manager
+	// sees that it holds compressed pages
+	void compressTable (MyDB_TablePtr whichTable);
 	
 	// when the buffer manager is destroyed, all of the dirty pages need to be
 	// written back to disk, and any temporary files need to be deleted
@@ -82,6 +96,9 @@ private:
 	// lists the FDs for all of the files
 	map <MyDB_TablePtr, int, TableCompare> fds;
 
+	// the files whose pages are compressed (the temp file is the one for the nullptr)
+	map <MyDB_TablePtr, MyDB_ExtentFilePtr, TableCompare> extentFiles;
+
 	// all of the chunks of RAM that are currently not allocated
 	vector <void *> availableRam;
 
@@ -103,9 +120,16 @@ private:
 	// the number of buffer pages
 	size_t numPages;
 
+	// whether the temp file is compressed
+	bool compressTemp;
+
 	// so that the page can access these private methods
 	friend class MyDB_Page;
 	friend class SortMergeJoin;
+	friend class HashJoin;
+	friend class Aggregate;
+	friend class QueryOp;
+	friend class MorselScan;
 
 	// kick out the LRU page
 	void kickOutPage ();
@@ -116,6 +140,13 @@ private:
 	// removes all traces of the page from the buffer manager
 	void killPage (MyDB_PagePtr killMe);
 
+	// opens the file for the given table (or the temp file, for the nullptr) if it is not open
+	void openFile (MyDB_TablePtr whichTable);
+
+	// read the page from, and write it to, its file
+	void readPage (MyDB_PagePtr readMe);
+	void writePage (MyDB_PagePtr writeMe);
+
 };
 
 #endif
@@ -0,0 +1,112 @@
+
+#ifndef EXTENT_FILE_H
+#define EXTENT_FILE_H
+
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <vector>
+
+using namespace std;
+
+class MyDB_ExtentFile;
+typedef shared_ptr <MyDB_ExtentFile> MyDB_ExtentFilePtr;
+
+// An extent file is how the buffer manager stores the pages of a file compressed.  In RAM, a
+// page is always its full, uncompressed size; on disk, each page is compressed on its own (see
+// MyDB_BlockCompressor.h), and stored as a variable-size block, or extent, somewhere in the file.
+// The extent map says where each page's extent is:
+//
+//	[header: magic number, page size, where the extent map is, the number of pages]
+//	... extents and extent maps, in no particular order ...
+//
+// The header is written as soon as the file is made.  A new map is written when the file is
+// closed (or saveMap is called), after everything else in the file; only then is the header
+// pointed at it, and the old map's space reused.  So if the program stops before the file is
+// closed, the header still points at a complete map (of the pages as they were when it was
+// written), rather than at extents that have been written over it.
+//
+// Extents are allocated in units of EXTENT_UNIT bytes.  When a page is written again, it is
+// written over its old extent if it still fits there; otherwise the old extent becomes a hole,
+// and the page goes into the smallest hole that it fits into, or onto the end of the file.  A
+// page that does not compress is stored as it is, in a full page-sized extent.
+//
+// Because the header starts with a magic number that no page type can start with, a file that
+// holds extents can be told apart from a file of regular, uncompressed pages just by looking at
+// its first few bytes.  This object does not own the file; it just reads and writes it.
+class MyDB_ExtentFile {
+
+public:
+
+	// sets up the extent file in the given (open) file, for pages of the given size... if the
+	// file already holds extents, its extent map is read in; otherwise, the file should be empty,
+	// and the header is written to it
+	MyDB_ExtentFile (int fd, size_t pageSize);
+
+	// returns true if the given open file holds extents
+	static bool holdsExtents (int fd);
+
+	// reads the i^th page into the page-sized buffer intoHere... a page that has never been
+	// written comes back as all zeros
+	void readPage (size_t i, void *intoHere);
+
+	// compresses and writes the page-sized buffer fromHere as the i^th page
+	void writePage (size_t i, void *fromHere);
+
+	// the i^th page is not needed any more, so its extent can be reused
+	void freePage (size_t i);
+
+	// writes the extent map onto the end of the file, and the header pointing to it at the
+	// start, so that the file can be opened again
+	void saveMap ();
+
+	// the number of bytes that the header and the extents (along with any holes between them)
+	// take up at the start of the file
+	size_t getBytesUsed ();
+
+private:
+
+	// where one page is on disk... length is the size of the compressed block (zero if the page
+	// has never been written, or the page size if it is not compressed), and capacity the size
+	// of the extent that holds it
+	struct Extent {
+		size_t offset;
+		size_t length;
+		size_t capacity;
+	};
+
+	// finds an extent for a block of the given size
+	size_t allocate (size_t capacity);
+
+	// writes the header, pointing at the current map
+	void writeHeader ();
+
+	// read and write numBytes bytes at the given place in the file; these exit if they can't
+	void readAt (size_t offset, void *intoHere, size_t numBytes);
+	void writeAt (size_t offset, void *fromHere, size_t numBytes);
+
+	// rounds a size up to a whole number of extent units
+	static size_t roundUp (size_t numBytes);
+
+	// the file, and the size of a page
+	int fd;
+	size_t pageSize;
+
+	// where each of the pages is
+	vector <Extent> extents;
+
+	// the unused extents, by their capacity
+	multimap <size_t, size_t> holes;
+
+	// the end of the last extent (or of the map, if that is after it)
+	size_t fileEnd;
+
+	// where the map that the header points to is, and the space that it takes up
+	size_t mapOffset;
+	size_t mapCapacity;
+
+	// where pages are compressed into, and read into before they are decompressed
+	vector <char> scratch;
+};
+
+#endif
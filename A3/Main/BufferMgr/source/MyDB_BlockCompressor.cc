@@ -0,0 +1,178 @@
+
+#ifndef BLOCK_COMPRESSOR_C
+#define BLOCK_COMPRESSOR_C
+
+#include "MyDB_BlockCompressor.h"
+#include <string.h>
+
+// matches shorter than this are not worth the three bytes that they cost
+#define MIN_MATCH 4
+
+// the farthest back that a match can be, since offsets are two bytes
+#define MAX_OFFSET 65535
+
+// the hash table has 2^HASH_BITS slots
+#define HASH_BITS 12
+
+static inline unsigned hashFour (const unsigned char *at) {
+	unsigned val;
+	memcpy (&val, at, 4);
+	return (val * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// writes out the rest of a length that did not fit into its nibble
+static inline unsigned char *putLength (unsigned char *into, size_t len) {
+	while (len >= 255) {
+		*(into++) = 255;
+		len -= 255;
+	}
+	*(into++) = (unsigned char) len;
+	return into;
+}
+
+// reads the rest of a length whose nibble was 15; returns false if the block ends first
+static inline bool getLength (const unsigned char *&from, const unsigned char *end, size_t &len) {
+	unsigned char next;
+	do {
+		if (from == end)
+			return false;
+		next = *(from++);
+		len += next;
+	} while (next == 255);
+	return true;
+}
+
+// writes a sequence of numLits literals from lits, followed (if matchLen is not zero) by a
+// match; returns nullptr if it does not fit before end
+static unsigned char *putSequence (unsigned char *into, unsigned char *end, const unsigned char *lits,
+	size_t numLits, size_t offset, size_t matchLen) {
+
+	// the most that the sequence can take up
+	size_t most = 1 + numLits + numLits / 255 + 1;
+	if (matchLen != 0)
+		most += 2 + matchLen / 255 + 1;
+	if (most > (size_t) (end - into))
+		return nullptr;
+
+	unsigned char *token = into++;
+	*token = (unsigned char) ((numLits >= 15 ? 15 : numLits) << 4);
+	if (numLits >= 15)
+		into = putLength (into, numLits - 15);
+	memcpy (into, lits, numLits);
+	into += numLits;
+
+	if (matchLen != 0) {
+		*(into++) = (unsigned char) (offset & 0xFF);
+		*(into++) = (unsigned char) (offset >> 8);
+		size_t extra = matchLen - MIN_MATCH;
+		*token |= (unsigned char) (extra >= 15 ? 15 : extra);
+		if (extra >= 15)
+			into = putLength (into, extra - 15);
+	}
+	return into;
+}
+
+size_t compressBlock (const char *fromIn, size_t n, char *intoIn, size_t cap) {
+
+	const unsigned char *from = (const unsigned char *) fromIn;
+	const unsigned char *end = from + n;
+	unsigned char *into = (unsigned char *) intoIn;
+	unsigned char *intoEnd = into + cap;
+
+	// each slot holds one more than the position where its hash was last seen (zero is empty)
+	unsigned lastSeen[1 << HASH_BITS];
+	memset (lastSeen, 0, sizeof (lastSeen));
+
+	const unsigned char *anchor = from;
+	const unsigned char *pos = from;
+	while (n >= MIN_MATCH && pos + MIN_MATCH <= end) {
+
+		unsigned slot = hashFour (pos);
+		unsigned cand = lastSeen[slot];
+		lastSeen[slot] = (unsigned) (pos - from) + 1;
+
+		if (cand != 0) {
+			const unsigned char *match = from + cand - 1;
+			if ((size_t) (pos - match) <= MAX_OFFSET && memcmp (match, pos, MIN_MATCH) == 0) {
+
+				// extend the match as far as it goes
+				size_t len = MIN_MATCH;
+				while (pos + len < end && match[len] == pos[len])
+					len++;
+
+				into = putSequence (into, intoEnd, anchor, pos - anchor, pos - match, len);
+				if (into == nullptr)
+					return 0;
+
+				// remember a spot near the end of the match, so that the next match can
+				// start just after this one
+				pos += len;
+				if (pos + MIN_MATCH <= end)
+					lastSeen[hashFour (pos - 2)] = (unsigned) (pos - 2 - from) + 1;
+				anchor = pos;
+				continue;
+			}
+		}
+		pos++;
+	}
+
+	// and the literals that are left over
+	into = putSequence (into, intoEnd, anchor, end - anchor, 0, 0);
+	if (into == nullptr)
+		return 0;
+	return into - (unsigned char *) intoIn;
+}
+
+bool decompressBlock (const char *fromIn, size_t n, char *intoIn, size_t outSize) {
+
+	const unsigned char *from = (const unsigned char *) fromIn;
+	const unsigned char *end = from + n;
+	unsigned char *into = (unsigned char *) intoIn;
+	unsigned char *intoEnd = into + outSize;
+
+	while (from != end) {
+
+		unsigned char token = *(from++);
+
+		// copy the literals
+		size_t numLits = token >> 4;
+		if (numLits == 15 && !getLength (from, end, numLits))
+			return false;
+		if (numLits > (size_t) (end - from) || numLits > (size_t) (intoEnd - into))
+			return false;
+		memcpy (into, from, numLits);
+		into += numLits;
+		from += numLits;
+
+		// the last sequence has no match
+		if (from == end)
+			break;
+
+		// and then the match
+		if (end - from < 2)
+			return false;
+		size_t offset = from[0] | (from[1] << 8);
+		from += 2;
+		size_t len = token & 15;
+		if (len == 15 && !getLength (from, end, len))
+			return false;
+		len += MIN_MATCH;
+		if (offset == 0 || offset > (size_t) (into - (unsigned char *) intoIn) || len > (size_t) (intoEnd - into))
+			return false;
+
+		// a match can overlap the bytes that it is producing (that is how runs are stored), in
+		// which case it has to be copied a byte at a time
+		const unsigned char *match = into - offset;
+		if (offset >= len) {
+			memcpy (into, match, len);
+			into += len;
+		} else {
+			for (size_t i = 0; i < len; i++)
+				*(into++) = *(match++);
+		}
+	}
+
+	return into == intoEnd;
+}
+
+#endif
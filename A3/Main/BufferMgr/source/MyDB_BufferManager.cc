@@ -20,7 +20,9 @@
 #include "MyDB_Page.h"
 #include <fcntl.h>
 #include <iostream>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <utility>
@@ -31,19 +33,15 @@ size_t MyDB_BufferManager ::getPageSize() { return pageSize; }
 
 MyDB_PageHandle MyDB_BufferManager ::getPage(MyDB_TablePtr whichTable, long i) {
 
-  // open the file, if it is not open
-  if (fds.count(whichTable) == 0) {
-    int fd = open(whichTable->getStorageLoc().c_str(),
-                  O_CREAT | O_RDWR | O_BINARY, 0666);
-    fds[whichTable] = fd;
-  }
-
   // make sure we don't have a null table
   if (whichTable == nullptr) {
     cout << "Can't allocate a page with a null table!!\n";
     exit(1);
   }
 
+  // open the file, if it is not open
+  openFile(whichTable);
+
   // next, see if the page is already in existence
   pair<MyDB_TablePtr, long> whichPage = make_pair(whichTable, i);
   if (allPages.count(whichPage) == 0) {
@@ -61,11 +59,7 @@ MyDB_PageHandle MyDB_BufferManager ::getPage(MyDB_TablePtr whichTable, long i) {
 MyDB_PageHandle MyDB_BufferManager ::getPage() {
 
   // open the file, if it is not open
-  if (fds.count(nullptr) == 0) {
-    int fd =
-        open(tempFile.c_str(), O_TRUNC | O_CREAT | O_RDWR | O_BINARY, 0666);
-    fds[nullptr] = fd;
-  }
+  openFile(nullptr);
 
   // check if we are extending the size of the temp file
   size_t pos;
@@ -97,8 +91,7 @@ void MyDB_BufferManager ::kickOutPage() {
 
   // write it back if necessary
   if (page->isDirty) {
-    lseek(fds[page->myTable], page->pos * pageSize, SEEK_SET);
-    write(fds[page->myTable], page->bytes, pageSize);
+    writePage(page);
     page->isDirty = false;
   }
 
@@ -121,6 +114,8 @@ void MyDB_BufferManager ::killPage(MyDB_PagePtr killMe) {
 
     // recycle him
     availablePositions.push(killMe->pos);
+    if (extentFiles.count(nullptr) != 0)
+      extentFiles[nullptr]->freePage(killMe->pos);
     if (killMe->bytes != nullptr) {
       availableRam.push_back(killMe->bytes);
     }
@@ -179,8 +174,7 @@ void MyDB_BufferManager ::access(MyDB_PagePtr updateMe) {
     availableRam.pop_back();
 
     // and read it
-    lseek(fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
-    read(fds[updateMe->myTable], updateMe->bytes, pageSize);
+    readPage(updateMe);
 
     updateMe->timeTick = ++lastTimeTick;
     lastUsed.insert(updateMe);
@@ -190,18 +184,15 @@ void MyDB_BufferManager ::access(MyDB_PagePtr updateMe) {
 MyDB_PageHandle MyDB_BufferManager ::getPinnedPage(MyDB_TablePtr whichTable,
                                                    long i) {
 
-  // open the file, if it is not open
-  if (fds.count(whichTable) == 0) {
-    int fd = open(whichTable->getStorageLoc().c_str(), O_CREAT | O_RDWR, 0666);
-    fds[whichTable] = fd;
-  }
-
   // make sure we don't have a null table
   if (whichTable == nullptr) {
     cout << "Can't allocate a page with a null table!!\n";
     exit(1);
   }
 
+  // open the file, if it is not open
+  openFile(whichTable);
+
   // first, see if the page is there in the buffer
   pair<MyDB_TablePtr, long> whichPage = make_pair(whichTable, i);
   MyDB_PagePtr returnVal;
@@ -241,8 +232,7 @@ MyDB_PageHandle MyDB_BufferManager ::getPinnedPage(MyDB_TablePtr whichTable,
     availableRam.pop_back();
 
     // and read it
-    lseek(fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
-    read(fds[returnVal->myTable], returnVal->bytes, pageSize);
+    readPage(returnVal);
   }
 
   // get outta here
@@ -274,8 +264,101 @@ void MyDB_BufferManager ::unpin(MyDB_PagePtr unpinMe) {
   lastUsed.insert(unpinMe);
 }
 
+void MyDB_BufferManager ::openFile(MyDB_TablePtr whichTable) {
+
+  if (fds.count(whichTable) != 0)
+    return;
+
+  // the temp file is started over; a table's file is compressed if it
+  // already holds extents
+  int fd;
+  if (whichTable == nullptr) {
+    fd = open(tempFile.c_str(), O_TRUNC | O_CREAT | O_RDWR | O_BINARY, 0666);
+    if (compressTemp)
+      extentFiles[nullptr] = make_shared<MyDB_ExtentFile>(fd, pageSize);
+  } else {
+    fd = open(whichTable->getStorageLoc().c_str(), O_CREAT | O_RDWR | O_BINARY,
+              0666);
+    if (MyDB_ExtentFile ::holdsExtents(fd))
+      extentFiles[whichTable] = make_shared<MyDB_ExtentFile>(fd, pageSize);
+  }
+  fds[whichTable] = fd;
+}
+
+void MyDB_BufferManager ::readPage(MyDB_PagePtr readMe) {
+  if (extentFiles.count(readMe->myTable) != 0) {
+    extentFiles[readMe->myTable]->readPage(readMe->pos, readMe->bytes);
+  } else {
+    lseek(fds[readMe->myTable], readMe->pos * pageSize, SEEK_SET);
+    read(fds[readMe->myTable], readMe->bytes, pageSize);
+  }
+}
+
+void MyDB_BufferManager ::writePage(MyDB_PagePtr writeMe) {
+  if (extentFiles.count(writeMe->myTable) != 0) {
+    extentFiles[writeMe->myTable]->writePage(writeMe->pos, writeMe->bytes);
+  } else {
+    lseek(fds[writeMe->myTable], writeMe->pos * pageSize, SEEK_SET);
+    write(fds[writeMe->myTable], writeMe->bytes, pageSize);
+  }
+}
+
+void MyDB_BufferManager ::compressTable(MyDB_TablePtr whichTable) {
+
+  if (whichTable == nullptr) {
+    cout << "Can't compress a null table!!\n";
+    exit(1);
+  }
+
+  // see if it is already compressed
+  openFile(whichTable);
+  if (extentFiles.count(whichTable) != 0)
+    return;
+
+  // bring the file up to date with any of its pages that are buffered
+  for (auto page : allPages) {
+    if (page.second->myTable->getName() == whichTable->getName() &&
+        page.second->bytes != nullptr && page.second->isDirty) {
+      writePage(page.second);
+      page.second->isDirty = false;
+    }
+  }
+
+  // if there is nothing in the file yet, it can just hold extents from now on
+  int fd = fds[whichTable];
+  off_t fileSize = lseek(fd, 0, SEEK_END);
+  if (fileSize == 0) {
+    extentFiles[whichTable] = make_shared<MyDB_ExtentFile>(fd, pageSize);
+    return;
+  }
+
+  // otherwise, compress each of its pages into a new file, which then
+  // replaces the old one
+  string packedLoc = whichTable->getStorageLoc() + ".compressing";
+  int packedFd =
+      open(packedLoc.c_str(), O_TRUNC | O_CREAT | O_RDWR | O_BINARY, 0666);
+  MyDB_ExtentFile packer(packedFd, pageSize);
+  vector<char> page(pageSize);
+  for (size_t i = 0; i * pageSize < (size_t)fileSize; i++) {
+    memset(page.data(), 0, pageSize);
+    lseek(fd, i * pageSize, SEEK_SET);
+    read(fd, page.data(), pageSize);
+    packer.writePage(i, page.data());
+  }
+  packer.saveMap();
+  close(fd);
+  rename(packedLoc.c_str(), whichTable->getStorageLoc().c_str());
+  fds[whichTable] = packedFd;
+  extentFiles[whichTable] = make_shared<MyDB_ExtentFile>(packedFd, pageSize);
+}
+
+MyDB_BufferManager ::MyDB_BufferManager(size_t pageSizeIn, size_t numPagesIn,
+                                        string tempFileIn)
+    : MyDB_BufferManager(pageSizeIn, numPagesIn, tempFileIn, false) {}
+
 MyDB_BufferManager ::MyDB_BufferManager(size_t pageSizeIn, size_t numPagesIn,
-                                        string tempFileIn) {
+                                        string tempFileIn,
+                                        bool compressTempIn) {
 
   // remember the inputs
   pageSize = pageSizeIn;
@@ -292,6 +375,9 @@ MyDB_BufferManager ::MyDB_BufferManager(size_t pageSizeIn, size_t numPagesIn,
   // the number of pages
   numPages = numPagesIn;
 
+  // whether temp pages are compressed on disk
+  compressTemp = compressTempIn;
+
   // create all of the RAM
   for (size_t i = 0; i < numPages; i++) {
     availableRam.push_back(malloc(pageSizeIn));
@@ -306,8 +392,7 @@ MyDB_BufferManager ::~MyDB_BufferManager() {
 
       // write it back if necessary
       if (page.second->isDirty) {
-        lseek(fds[page.second->myTable], page.second->pos * pageSize, SEEK_SET);
-        write(fds[page.second->myTable], page.second->bytes, pageSize);
+        writePage(page.second);
       }
 
       free(page.second->bytes);
@@ -315,6 +400,12 @@ MyDB_BufferManager ::~MyDB_BufferManager() {
     }
   }
 
+  // the compressed tables need their extent maps so they can be read again
+  for (auto extentFile : extentFiles) {
+    if (extentFile.first != nullptr)
+      extentFile.second->saveMap();
+  }
+
   // delete the rest of the RAM
   for (auto ram : availableRam) {
     free(ram);
@@ -0,0 +1,198 @@
+
+#ifndef EXTENT_FILE_C
+#define EXTENT_FILE_C
+
+#include <algorithm>
+#include <iostream>
+#include "MyDB_BlockCompressor.h"
+#include "MyDB_ExtentFile.h"
+#include <string.h>
+#include <unistd.h>
+
+// the first eight bytes of a file that holds extents
+#define EXTENT_MAGIC 0x73746E6574784544ULL
+
+// extents are allocated in units of this many bytes; the header takes up the first one
+#define EXTENT_UNIT 64
+
+// what is at the start of the file
+struct ExtentFileHeader {
+	unsigned long long magic;
+	size_t pageSize;
+	size_t mapOffset;
+	size_t numPages;
+};
+
+MyDB_ExtentFile :: MyDB_ExtentFile (int fdIn, size_t pageSizeIn) {
+
+	fd = fdIn;
+	pageSize = pageSizeIn;
+	scratch.resize (pageSize);
+	fileEnd = EXTENT_UNIT;
+	mapOffset = EXTENT_UNIT;
+	mapCapacity = 0;
+
+	// a new file gets its header (and an empty map) right away, so that it is never taken
+	// for a file of regular pages
+	if (!holdsExtents (fd)) {
+		writeHeader ();
+		return;
+	}
+
+	ExtentFileHeader header;
+	readAt (0, &header, sizeof (header));
+	if (header.pageSize != pageSize) {
+		cout << "This is bad... the file was compressed with " << header.pageSize << " byte pages, but the pages are "
+			<< pageSize << " bytes.\n";
+		exit (1);
+	}
+
+	// read in the map... it stays where it is until a new one is written, so new extents go
+	// after it
+	extents.resize (header.numPages);
+	readAt (header.mapOffset, extents.data (), extents.size () * sizeof (Extent));
+	mapOffset = header.mapOffset;
+	mapCapacity = roundUp (extents.size () * sizeof (Extent));
+	fileEnd = mapOffset + mapCapacity;
+
+	// and everything between the extents (and the map) is a hole
+	vector <pair <size_t, size_t>> used;
+	for (Extent &extent : extents) {
+		if (extent.capacity != 0)
+			used.push_back (make_pair (extent.offset, extent.capacity));
+	}
+	used.push_back (make_pair (mapOffset, mapCapacity));
+	sort (used.begin (), used.end ());
+	size_t pos = EXTENT_UNIT;
+	for (auto &extent : used) {
+		if (extent.first > pos)
+			holes.insert (make_pair (extent.first - pos, pos));
+		pos = max (pos, extent.first + extent.second);
+	}
+}
+
+bool MyDB_ExtentFile :: holdsExtents (int fd) {
+	unsigned long long magic = 0;
+	lseek (fd, 0, SEEK_SET);
+	return read (fd, &magic, sizeof (magic)) == sizeof (magic) && magic == EXTENT_MAGIC;
+}
+
+void MyDB_ExtentFile :: readPage (size_t i, void *intoHere) {
+
+	if (i >= extents.size () || extents[i].length == 0) {
+		memset (intoHere, 0, pageSize);
+		return;
+	}
+
+	Extent &extent = extents[i];
+	if (extent.length == pageSize) {
+		readAt (extent.offset, intoHere, pageSize);
+		return;
+	}
+
+	readAt (extent.offset, scratch.data (), extent.length);
+	if (!decompressBlock (scratch.data (), extent.length, (char *) intoHere, pageSize)) {
+		cout << "This is bad... page " << i << " of a compressed file is corrupt.\n";
+		exit (1);
+	}
+}
+
+void MyDB_ExtentFile :: writePage (size_t i, void *fromHere) {
+
+	// a block that is not smaller than the page is not worth decompressing
+	char *block = scratch.data ();
+	size_t length = compressBlock ((char *) fromHere, pageSize, block, pageSize - 1);
+	if (length == 0) {
+		block = (char *) fromHere;
+		length = pageSize;
+	}
+
+	// find a place for it
+	if (i >= extents.size ())
+		extents.resize (i + 1, Extent {0, 0, 0});
+	size_t capacity = roundUp (length);
+	if (extents[i].capacity < capacity) {
+		freePage (i);
+		extents[i].offset = allocate (capacity);
+		extents[i].capacity = capacity;
+	}
+	extents[i].length = length;
+
+	writeAt (extents[i].offset, block, length);
+}
+
+void MyDB_ExtentFile :: freePage (size_t i) {
+	if (i >= extents.size () || extents[i].capacity == 0)
+		return;
+	holes.insert (make_pair (extents[i].capacity, extents[i].offset));
+	extents[i] = Extent {0, 0, 0};
+}
+
+size_t MyDB_ExtentFile :: allocate (size_t capacity) {
+
+	// see if there is a hole that is big enough
+	auto hole = holes.lower_bound (capacity);
+	if (hole == holes.end ()) {
+		size_t offset = fileEnd;
+		fileEnd += capacity;
+		return offset;
+	}
+
+	// if so, use the start of it, and put back the rest
+	size_t offset = hole->second;
+	size_t left = hole->first - capacity;
+	holes.erase (hole);
+	if (left != 0)
+		holes.insert (make_pair (left, offset + capacity));
+	return offset;
+}
+
+void MyDB_ExtentFile :: saveMap () {
+
+	// the new map goes after everything else, and the header is only pointed at it once it is
+	// all there, so that the file always has a complete map
+	size_t newCapacity = roundUp (extents.size () * sizeof (Extent));
+	size_t newOffset = fileEnd;
+	writeAt (newOffset, extents.data (), extents.size () * sizeof (Extent));
+	if (ftruncate (fd, newOffset + newCapacity) != 0) {
+		cout << "This is bad... could not set the size of a compressed file.\n";
+		exit (1);
+	}
+
+	// now the old map's space can be used for extents
+	if (mapCapacity != 0)
+		holes.insert (make_pair (mapCapacity, mapOffset));
+	mapOffset = newOffset;
+	mapCapacity = newCapacity;
+	fileEnd = newOffset + newCapacity;
+	writeHeader ();
+}
+
+void MyDB_ExtentFile :: writeHeader () {
+	ExtentFileHeader header {EXTENT_MAGIC, pageSize, mapOffset, extents.size ()};
+	writeAt (0, &header, sizeof (header));
+}
+
+void MyDB_ExtentFile :: readAt (size_t offset, void *intoHere, size_t numBytes) {
+	if (lseek (fd, offset, SEEK_SET) != (off_t) offset || read (fd, intoHere, numBytes) != (ssize_t) numBytes) {
+		cout << "This is bad... could not read " << numBytes << " bytes at " << offset << " in a compressed file.\n";
+		exit (1);
+	}
+}
+
+void MyDB_ExtentFile :: writeAt (size_t offset, void *fromHere, size_t numBytes) {
+	if (lseek (fd, offset, SEEK_SET) != (off_t) offset || write (fd, fromHere, numBytes) != (ssize_t) numBytes) {
+		cout << "This is bad... could not write " << numBytes << " bytes at " << offset << " in a compressed file.\n";
+		exit (1);
+	}
+}
+
+size_t MyDB_ExtentFile :: roundUp (size_t numBytes) {
+	return (numBytes + EXTENT_UNIT - 1) / EXTENT_UNIT * EXTENT_UNIT;
+}
+
+size_t MyDB_ExtentFile :: getBytesUsed () {
+	return fileEnd;
+}
+
+#endif
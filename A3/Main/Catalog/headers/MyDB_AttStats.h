@@ -0,0 +1,79 @@
+
+#ifndef ATT_STATS_H
+#define ATT_STATS_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_AttVal.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A MyDB_AttStats holds the statistics for one attribute of a table: the fraction of the
+// values that are null, the smallest and largest values, and an equi-depth histogram.  The
+// histogram is a list of bounds b_0 <= b_1 <= ... <= b_k, where b_0 is the min and b_k is the
+// max, and about the same number of values (1 / k of them) fall into each bucket [b_i, b_i+1].
+// So a value that shows up a lot ends up as the bound of several buckets in a row.
+//
+// The records do not have real nulls, but an empty text field loads as an empty string, so
+// for a string attribute, that is what is counted as null.
+//
+// These are built from a sample of the values, by MyDB_TableReaderWriter :: analyze (), and are
+// used to estimate the fraction of a table's records that satisfy a predicate.
+class MyDB_AttStats {
+
+public:
+
+	// empty statistics (that do not know anything) for an attribute of the given type
+	MyDB_AttStats (MyDB_AttTypePtr type);
+
+	// builds the statistics from a sample of the attribute's non-null values (which gets
+	// sorted), along with the number of nulls that were in the sample... the histogram has
+	// numBuckets buckets, or fewer if there are not many values
+	void build (vector <MyDB_AttValPtr> &sample, size_t numNulls, int numBuckets = 64);
+
+	// true if there are any statistics here (if not, the estimates below are useless)
+	bool isBuilt ();
+
+	// the fraction of the values that are null
+	double getNullFraction ();
+
+	// the smallest and largest values
+	MyDB_AttValPtr getMin ();
+	MyDB_AttValPtr getMax ();
+
+	// the number of buckets in the histogram
+	int getNumBuckets ();
+
+	// the estimated fraction of the values that are in [low, high]... either bound can be
+	// nullptr, meaning that there is no bound on that side
+	double estimateRange (MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// the estimated fraction of the values that are equal to val, given the number of
+	// distinct values of the attribute
+	double estimateEqual (MyDB_AttValPtr val, size_t numDistinct);
+
+	// writes the statistics to a string, so they can go into the catalog, and reads them
+	// back; returns false if the string is not a set of statistics for this type
+	string toString ();
+	bool fromString (string fromMe);
+
+private:
+
+	// compares two values of the attribute's type: returns < 0, 0, or > 0
+	int compare (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs);
+
+	// the attribute's type
+	MyDB_AttTypePtr type;
+
+	// whether the statistics have been built (or read from the catalog)
+	bool built;
+
+	// the fraction of nulls
+	double nullFraction;
+
+	// the bounds of the buckets... empty if nothing is known
+	vector <MyDB_AttValPtr> bounds;
+};
+
+#endif
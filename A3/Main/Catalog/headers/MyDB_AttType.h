@@ -21,6 +21,11 @@ public:
 	virtual bool promotableToDouble () = 0;
 	virtual bool promotableToString () = 0;
 	virtual MyDB_AttValPtr createAtt () = 0;
+
+	// like createAtt, but the value is returned as it is, so that it can be put right into
+	// a record along with the rest of the record's values
+	virtual MyDB_AttVal makeAtt () = 0;
+
 	virtual MyDB_AttValPtr createAttMax () = 0;
 	virtual string toString () = 0;
 	virtual bool isBool () = 0;
@@ -56,6 +61,10 @@ public:
 		return make_shared <MyDB_IntAttVal> ();
 	}	
 
+	MyDB_AttVal makeAtt () {
+		return MyDB_AttVal (IntVal);
+	}
+
 	MyDB_AttValPtr createAttMax () {
 		MyDB_IntAttValPtr retVal = make_shared <MyDB_IntAttVal> ();
 		retVal->set (INT_MAX);
@@ -94,6 +103,10 @@ public:
 		return make_shared <MyDB_DoubleAttVal> ();
 	}	
 
+	MyDB_AttVal makeAtt () {
+		return MyDB_AttVal (DoubleVal);
+	}
+
 	MyDB_AttValPtr createAttMax () {
 		MyDB_DoubleAttValPtr retVal = make_shared <MyDB_DoubleAttVal> ();
 		retVal->set (1.79769e+308);
@@ -131,6 +144,10 @@ public:
 		return make_shared <MyDB_StringAttVal> ();
 	}	
 
+	MyDB_AttVal makeAtt () {
+		return MyDB_AttVal (StringVal);
+	}
+
 	MyDB_AttValPtr createAttMax () {
 		MyDB_StringAttValPtr retVal = make_shared <MyDB_StringAttVal> ();
 		retVal->set ("~~~~~~~~~");
@@ -168,6 +185,10 @@ public:
 		return make_shared <MyDB_BoolAttVal> ();
 	}	
 
+	MyDB_AttVal makeAtt () {
+		return MyDB_AttVal (BoolVal);
+	}
+
 	MyDB_AttValPtr createAttMax () {
 		MyDB_BoolAttValPtr retVal = make_shared <MyDB_BoolAttVal> ();
 		retVal->set (true);
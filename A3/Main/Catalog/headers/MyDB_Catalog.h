@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace std;
@@ -14,7 +15,23 @@ using namespace std;
 class MyDB_Catalog;
 typedef shared_ptr <MyDB_Catalog> MyDB_CatalogPtr;
 
-// this encapsulates a simple little key-value store
+// this encapsulates a simple little key-value store.  The keys are grouped by the name that
+// they start with (everything up to the first '.'), which for the keys written by a table
+// is the table's name, and on disk, the catalog is a log of records, one for each version of
+// a group: a record has the length of the record, the group's name, and then each of its
+// (key, value) pairs, with each string written as its length (a varint) and then its bytes
+// (and each key written without the group's name at the front).  So:
+//
+// 1) opening the catalog just reads the file and finds where the latest record for each
+//    group is, without looking at any of the keys or values; a group is decoded the first
+//    time that one of its keys is asked for (so getting one table out of a catalog with
+//    lots of tables does not need to decode the others).
+// 2) save () only appends a new record for each group that has changed since the last
+//    save... once the file gets to be more than twice as big as the latest records, it is
+//    rewritten with just those (to a temporary file, which is then renamed).
+//
+// A catalog file in the old text format (a "|key|value|" line for each key) can still be
+// opened, and it is rewritten in the new format the first time that it is saved
 class MyDB_Catalog {
 
 public:
@@ -54,13 +71,56 @@ public:
 	// saves any updates to the catalog
 	void save ();
 
+	// the values in a string list cannot have a '#' in them (and values in the old text
+	// format could not have a '|' or '\n'), so a value that might (say, a string attribute
+	// value) is escaped first, with each bad character (and '%', and also ';', which is handy
+	// for separating things inside of a value) written out as %XX; unescape undoes this
+	static string escape (string fromMe);
+	static string unescape (string fromMe);
+
 private:
 
+	// the keys that start with the same name
+	struct Group {
+
+		// the group's (key, value) pairs, once the group has been decoded
+		map <string, string> entries;
+		bool decoded;
+
+		// true if the group has changed since the last save
+		bool dirty;
+
+		// where the latest record for the group starts in fileImage (if the group has not
+		// been decoded), and the number of bytes in it
+		size_t offset;
+		size_t numBytes;
+	};
+
+	// finds the value for the key... returns nullptr if it is not there, unless create is
+	// true, in which case it is added (and its group is marked as changed)
+	string *find (const string &key, bool create);
+
+	// decodes a group out of fileImage, and writes out a group's record
+	void decode (const string &name, Group &group);
+	static void encode (const string &name, Group &group, string &intoMe);
+
+	// reads a catalog in the old text format
+	void readText ();
+
 	// the name of the catalog file
 	string fName;
 
-	// the map that stores the catalog's contents
-	map <string, string> myData;
+	// the groups of (key, value) pairs, by name
+	unordered_map <string, Group> groups;
+
+	// the contents of the file, when it was opened
+	vector <char> fileImage;
+
+	// the number of bytes in the file
+	size_t fileBytes;
+
+	// true if the next save has to rewrite the whole file
+	bool rewrite;
 };
 
 #endif
@@ -0,0 +1,59 @@
+
+#ifndef HLL_H
+#define HLL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A MyDB_HyperLogLog is a sketch used to estimate the number of distinct values in a big set
+// of values, using a small, fixed amount of space: 2^precision one-byte registers (4KB for
+// the default precision of 12, which gives a standard error of about 1.6%).
+//
+// Each value is hashed, the first precision bits of the hash pick a register, and the
+// register remembers the longest run of leading zeros seen in the rest of the hash.  Two
+// sketches can be merged (say, the ones built by different threads loading different parts
+// of a file) by taking the max of each register, and adding the same value twice never
+// changes the sketch.  For example:
+//
+//	MyDB_HyperLogLog sketch;
+//	for (...)
+//		sketch.add (myRec->getAtt (0)->hash ());
+//	size_t numDistinct = sketch.estimate ();
+class MyDB_HyperLogLog {
+
+public:
+
+	// creates an empty sketch with 2^precision registers (precision is from 4 through 16)
+	MyDB_HyperLogLog (int precision = 12);
+
+	// adds the value with the given hash into the sketch... the hash does not have to be
+	// any good (std::hash is fine, even on ints), since it is mixed up first
+	void add (size_t hash);
+
+	// adds everything in the other sketch into this one; both must have the same precision
+	void merge (const MyDB_HyperLogLog &other);
+
+	// the estimated number of distinct values that have been added
+	size_t estimate () const;
+
+	// empties out the sketch
+	void clear ();
+
+	// writes the sketch to a string, with one character per register, so that it can be
+	// put into the catalog; and reads it back... returns false if the string is not a sketch
+	string toString () const;
+	bool fromString (const string &fromMe);
+
+private:
+
+	// the number of bits of the hash used to pick the register
+	int precision;
+
+	// the registers
+	vector <uint8_t> registers;
+};
+
+#endif
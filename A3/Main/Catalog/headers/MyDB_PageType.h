@@ -1,3 +1,3 @@
 
 // this lists all of the different page types
-enum MyDB_PageType {RegularPage, DirectoryPage};
+enum MyDB_PageType {RegularPage, DirectoryPage, PaxPage, CompressedPage};
@@ -21,13 +21,57 @@ public:
 	// get a particular attribute... the pair is the index (first, second, third, etc.) and the type
 	pair <int, MyDB_AttTypePtr> getAttByName (string findMe);
 
-	// get the list of all of the attributes... the pair is the name and the type
+	// get the list of all of the attributes... the pair is the name and the type.  Attributes
+	// must only be added with appendAtt, so that the layout is worked out again
 	vector <pair <string, MyDB_AttTypePtr>> &getAtts ();
 
 	// append another attribute to the schema
 	void appendAtt (pair <string, MyDB_AttTypePtr> addAtt);
 
-	// create this schema by loading from the catalog
+	// The schema picks how its records are laid out in binary form.  If any attribute is a
+	// string, records use the variable layout:
+	//
+	//	[short record size][short size][value 1][short size][value 2] ...
+	//
+	// where each size includes the short itself.  Otherwise (as long as there is at least one
+	// attribute) every record is the same size, so there is no need for any of the headers,
+	// and records use the fixed layout instead, which is just the values back-to-back:
+	//
+	//	[value 1][value 2] ...
+	//
+	// with four bytes for an int, eight for a double, and one for a bool.  Attribute k of a
+	// fixed-width record is then always getFixedOffset (k) bytes in, and record r on a page is
+	// r * getFixedSize () bytes after the first one, so neither has to be found by walking the
+	// sizes.  Note that the values are not aligned.
+	//
+	// The layout is worked out whenever an attribute is added, so these can be called from
+	// many threads at once.  It is written into the catalog with the rest of the schema, and
+	// when a schema is loaded from the catalog, it uses the layout that its table was written
+	// with (see fromCatalog)
+	inline bool isFixedWidth () {
+		return fixedWidth;
+	}
+
+	// for a fixed-width schema, the size of each record, and where the given attribute starts
+	inline size_t getFixedSize () {
+		return fixedOffsets.back ();
+	}
+
+	inline size_t getFixedOffset (int whichAtt) {
+		return fixedOffsets[whichAtt];
+	}
+
+	// makes the schema use the variable layout even if it has no strings... this is how the
+	// records of a table written before there was a fixed layout are read
+	void useVariableLayout ();
+
+	// the number of bytes taken up by the record with this schema at rec
+	inline size_t getBinarySize (void *rec) {
+		return isFixedWidth () ? getFixedSize () : *((short *) rec);
+	}
+
+	// create this schema by loading from the catalog... a table that was put into the catalog
+	// without a layout was written before there was a fixed layout, so it uses the variable one
 	void fromCatalog (string tableName, MyDB_CatalogPtr catalog);
 
 	// add to the catalog
@@ -42,6 +86,16 @@ private:
 	// add an attribute for the given table to the catalog
 	static void addAtt (string tableName, pair <string, MyDB_AttTypePtr>, MyDB_CatalogPtr catalog);
 
+	// works out the layout from the attributes
+	void findLayout ();
+
+	// the layout: whether it is fixed, and if so, where each attribute starts (with one extra
+	// entry at the end, for the size of the record)... if variableOnly is set, the layout is
+	// never fixed
+	bool fixedWidth = false;
+	vector <size_t> fixedOffsets = vector <size_t> (1, 0);
+	bool variableOnly = false;
+
 	// this is a list, in order, of the attributes in the schema
 	// the string is the name of the attribute, and we also know the types
 	vector <pair <string, MyDB_AttTypePtr>> allAtts;
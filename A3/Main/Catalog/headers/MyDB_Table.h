@@ -3,9 +3,12 @@
 #define TABLE_H
 
 #include <iostream>
+#include "MyDB_AttStats.h"
 #include "MyDB_Catalog.h"
+#include "MyDB_HyperLogLog.h"
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
+#include "MyDB_ZoneMap.h"
 #include <memory>
 #include <string>
 
@@ -78,13 +81,43 @@ public:
 	void setRootLocation (int toMe);
 	int getRootLocation ();
 
-        // get the distinct value count for an attribute
+        // get the distinct value count for an attribute... if the table has sketches, the
+        // count is estimated from the attribute's sketch
         size_t getDistinctValues (string forMe);
         size_t getDistinctValues (int forMe);
 
         // set the distinct value count for all attributes
         void setDistinctValues (vector <size_t> &toMe);
 
+        // get/set the HyperLogLog sketches of the values of each attribute... a table that
+        // has them (say, because it was loaded from a text file) keeps them up to date as
+        // records are appended, and they go into the catalog with everything else; an empty
+        // list means that the table does not have any
+        vector <MyDB_HyperLogLog> &getSketches ();
+        void setSketches (vector <MyDB_HyperLogLog> &toMe);
+
+        // get/set the statistics (null fraction, min/max, and histogram) for each attribute...
+        // these are built by MyDB_TableReaderWriter :: analyze (), and go into the catalog with
+        // everything else; an empty list means that the table has not been analyzed
+        vector <MyDB_AttStats> &getAttStats ();
+        void setAttStats (vector <MyDB_AttStats> &toMe);
+
+        // the estimated number of records whose value for the attribute is in [low, high]
+        // (either bound can be nullptr, meaning there is no bound on that side), or is equal
+        // to val... if the table has not been analyzed, the usual rules of thumb are used (a
+        // third of the records for a range, and one over the number of distinct values for
+        // an equality).  These are what a plan uses to choose between a scan, an index, and
+        // a sort
+        double estimateRangeCount (string att, MyDB_AttValPtr low, MyDB_AttValPtr high);
+        double estimateEqualCount (string att, MyDB_AttValPtr val);
+
+        // the zone maps (per-page min/max) that the table has, one for each attribute that
+        // has had MyDB_TableReaderWriter :: addZoneMap () called on it... they go into the
+        // catalog with everything else.  getZoneMap returns nullptr if there is not one for
+        // the named attribute
+        vector <MyDB_ZoneMap> &getZoneMaps ();
+        MyDB_ZoneMap *getZoneMap (string att);
+
         // get/set the number of tuples in the relation
         void setTupleCount (size_t toMe);
         size_t getTupleCount ();
@@ -94,6 +127,15 @@ private:
 	// the distinct value counts
 	vector <size_t> allCounts;
 
+	// the sketches for each attribute
+	vector <MyDB_HyperLogLog> sketches;
+
+	// the statistics for each attribute
+	vector <MyDB_AttStats> attStats;
+
+	// the zone maps
+	vector <MyDB_ZoneMap> zoneMaps;
+
 	// the number of tuples
 	int count;
 
@@ -0,0 +1,85 @@
+
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_AttVal.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A MyDB_ZoneMap remembers, for one attribute of a table, the smallest and largest value of
+// that attribute on each page of the table's file.  A scan that is looking for records whose
+// value is in some range can then skip any page whose [min, max] does not overlap the range,
+// without reading it.  On a table that is sorted on the attribute, the pages hold disjoint
+// runs of values, so a range query only has to read the few pages that the range covers.
+//
+// Each page is in one of three states: its zone is known (it has records, and all of them
+// are in [min, max]), it is known to be empty, or nothing is known about it (say, a page
+// past the end of what the zone map has been told about).  Only a page that is known not to
+// have anything in a range can be skipped.
+//
+// The zone maps of a table are kept up to date by MyDB_TableReaderWriter as records are
+// appended (so the output of sort () in Sorting.h gets them too), and they go into the
+// catalog with the rest of the table; see MyDB_TableReaderWriter :: addZoneMap ().
+class MyDB_ZoneMap {
+
+public:
+
+	// an empty zone map (that does not know about any pages) for the given attribute, which
+	// is at position whichAtt in the schema, and has the given type
+	MyDB_ZoneMap (string attName, int whichAtt, MyDB_AttTypePtr type);
+
+	// the attribute that this is a zone map for, and its position in the schema
+	string &getAttName ();
+	int getWhichAtt ();
+
+	// forgets about all of the pages
+	void clear ();
+
+	// records that the given page is empty
+	void setEmpty (int whichPage);
+
+	// records that a record with the given value is on the page, widening its zone if
+	// needed... this does nothing if nothing is known about the page, since there could
+	// be other records on it that the zone map has not been told about
+	void add (int whichPage, MyDB_AttValPtr val);
+
+	// returns false if the page is known to have no records with a value in [low, high]...
+	// either bound can be nullptr, meaning that there is no bound on that side
+	bool mightHave (int whichPage, MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// returns true if val is in [low, high] (again, either bound can be nullptr)
+	bool inRange (MyDB_AttValPtr val, MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// the zone of the page, if it is known and the page is not empty; otherwise, nullptr
+	MyDB_AttValPtr getMin (int whichPage);
+	MyDB_AttValPtr getMax (int whichPage);
+
+	// writes the zone map to a string, so that it can go into the catalog, and reads it back;
+	// fromString returns false if the string is not a zone map over an attribute of the given
+	// type (the attribute's name comes from the string, but its position is not changed)
+	string toString ();
+	bool fromString (string fromMe);
+
+private:
+
+	// compares two values of the attribute's type: returns < 0, 0, or > 0
+	int compare (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs);
+
+	// what is known about each page
+	enum PageState {Unknown, Empty, Known};
+
+	// the attribute
+	string attName;
+	int whichAtt;
+	MyDB_AttTypePtr type;
+
+	// the state and zone of each page; pages past the end of these are Unknown
+	vector <PageState> states;
+	vector <MyDB_AttValPtr> mins;
+	vector <MyDB_AttValPtr> maxes;
+};
+
+#endif
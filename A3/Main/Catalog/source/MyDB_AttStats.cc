@@ -0,0 +1,192 @@
+
+#ifndef ATT_STATS_C
+#define ATT_STATS_C
+
+#include "MyDB_AttStats.h"
+#include "MyDB_Catalog.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+MyDB_AttStats :: MyDB_AttStats (MyDB_AttTypePtr typeIn) {
+	type = typeIn;
+	nullFraction = 0.0;
+	built = false;
+}
+
+int MyDB_AttStats :: compare (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
+	if (type->isBool ())
+		return (int) lhs->toBool () - (int) rhs->toBool ();
+	if (type->promotableToInt ()) {
+		int l = lhs->toInt (), r = rhs->toInt ();
+		return (l < r) ? -1 : (l > r);
+	}
+	if (type->promotableToDouble ()) {
+		double l = lhs->toDouble (), r = rhs->toDouble ();
+		return (l < r) ? -1 : (l > r);
+	}
+	return lhs->toString ().compare (rhs->toString ());
+}
+
+void MyDB_AttStats :: build (vector <MyDB_AttValPtr> &sample, size_t numNulls, int numBuckets) {
+
+	built = true;
+	bounds.clear ();
+	size_t n = sample.size ();
+	nullFraction = (n + numNulls == 0) ? 0.0 : numNulls / (double) (n + numNulls);
+	if (n == 0)
+		return;
+
+	sort (sample.begin (), sample.end (), [this] (const MyDB_AttValPtr &lhs, const MyDB_AttValPtr &rhs) {
+		return compare (lhs, rhs) < 0;
+	});
+
+	// bound i is the value that is i / k of the way through the sorted sample
+	size_t k = min ((size_t) numBuckets, n - 1);
+	if (k == 0) {
+		bounds.push_back (sample[0]->getCopy ());
+		return;
+	}
+	for (size_t i = 0; i <= k; i++)
+		bounds.push_back (sample[i * (n - 1) / k]->getCopy ());
+}
+
+bool MyDB_AttStats :: isBuilt () {
+	return built;
+}
+
+double MyDB_AttStats :: getNullFraction () {
+	return nullFraction;
+}
+
+MyDB_AttValPtr MyDB_AttStats :: getMin () {
+	return bounds.empty () ? nullptr : bounds.front ();
+}
+
+MyDB_AttValPtr MyDB_AttStats :: getMax () {
+	return bounds.empty () ? nullptr : bounds.back ();
+}
+
+int MyDB_AttStats :: getNumBuckets () {
+	return bounds.empty () ? 0 : bounds.size () - 1;
+}
+
+double MyDB_AttStats :: estimateRange (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	if (bounds.empty ())
+		return 0.0;
+
+	// just one value
+	if (bounds.size () == 1) {
+		bool in = (low == nullptr || compare (bounds[0], low) >= 0) && (high == nullptr || compare (bounds[0], high) <= 0);
+		return in ? 1.0 - nullFraction : 0.0;
+	}
+
+	// add up the part of each bucket that overlaps the range
+	double numBuckets = 0.0;
+	bool numeric = type->promotableToDouble () || type->isBool ();
+	for (size_t i = 0; i + 1 < bounds.size (); i++) {
+		MyDB_AttValPtr a = bounds[i], b = bounds[i + 1];
+		if ((low != nullptr && compare (b, low) < 0) || (high != nullptr && compare (a, high) > 0))
+			continue;
+
+		bool containsBucket = (low == nullptr || compare (a, low) >= 0) && (high == nullptr || compare (b, high) <= 0);
+		if (containsBucket) {
+			numBuckets += 1.0;
+
+		// for numbers, assume that the values are spread out evenly in the bucket
+		} else if (numeric) {
+			double lo = a->toDouble (), hi = b->toDouble ();
+			if (type->isBool ()) {
+				lo = a->toBool ();
+				hi = b->toBool ();
+			}
+			double width = hi - lo;
+			if (low != nullptr)
+				lo = max (lo, type->isBool () ? (double) low->toBool () : low->toDouble ());
+			if (high != nullptr)
+				hi = min (hi, type->isBool () ? (double) high->toBool () : high->toDouble ());
+			numBuckets += (width > 0.0) ? max (0.0, hi - lo) / width : 1.0;
+
+		// and for strings, just guess that half of the bucket is in there
+		} else {
+			numBuckets += 0.5;
+		}
+	}
+	return numBuckets / getNumBuckets () * (1.0 - nullFraction);
+}
+
+double MyDB_AttStats :: estimateEqual (MyDB_AttValPtr val, size_t numDistinct) {
+
+	if (bounds.empty ())
+		return 0.0;
+	if (compare (val, bounds.front ()) < 0 || compare (val, bounds.back ()) > 0)
+		return 0.0;
+	if (bounds.size () == 1)
+		return 1.0 - nullFraction;
+
+	// a value that is the bound of several buckets is common enough to know about... if it
+	// covers some stretch of the sorted values, the expected number of bounds that land in
+	// that stretch is its length (in buckets)
+	int numBounds = 0;
+	for (MyDB_AttValPtr bound : bounds) {
+		if (compare (bound, val) == 0)
+			numBounds++;
+	}
+	if (numBounds > 1)
+		return numBounds / (double) getNumBuckets () * (1.0 - nullFraction);
+
+	// otherwise, assume that it is as common as any other value
+	return (1.0 - nullFraction) / max (numDistinct, (size_t) 1);
+}
+
+string MyDB_AttStats :: toString () {
+
+	// the null fraction, and then the bounds, separated by semicolons... doubles are written
+	// out with all of their digits, so they come back exactly
+	char buf[64];
+	snprintf (buf, sizeof (buf), "%.17g", nullFraction);
+	string returnVal = buf;
+	for (MyDB_AttValPtr bound : bounds) {
+		returnVal += ";";
+		if (type->promotableToDouble () && !type->promotableToInt ()) {
+			snprintf (buf, sizeof (buf), "%.17g", bound->toDouble ());
+			returnVal += buf;
+		} else {
+			returnVal += MyDB_Catalog :: escape (bound->toString ());
+		}
+	}
+	return returnVal;
+}
+
+bool MyDB_AttStats :: fromString (string fromMe) {
+
+	vector <string> pieces;
+	size_t pos = 0;
+	while (true) {
+		size_t next = fromMe.find (';', pos);
+		pieces.push_back (fromMe.substr (pos, next == string :: npos ? string :: npos : next - pos));
+		if (next == string :: npos)
+			break;
+		pos = next + 1;
+	}
+
+	char *parsedTo;
+	double newNullFraction = strtod (pieces[0].c_str (), &parsedTo);
+	if (parsedTo == pieces[0].c_str ())
+		return false;
+
+	vector <MyDB_AttValPtr> newBounds;
+	for (size_t i = 1; i < pieces.size (); i++) {
+		MyDB_AttValPtr bound = type->createAtt ();
+		string text = MyDB_Catalog :: unescape (pieces[i]);
+		bound->fromString (text);
+		newBounds.push_back (bound);
+	}
+	nullFraction = newNullFraction;
+	bounds = newBounds;
+	built = true;
+	return true;
+}
+
+#endif
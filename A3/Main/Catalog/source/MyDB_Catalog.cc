@@ -5,8 +5,11 @@
 #include "MyDB_Catalog.h"
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string>
+#include <string.h>
 
 #include "MyDB_AttType.h"
 #include "MyDB_AttVal.h"
@@ -15,8 +18,135 @@
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
 
+string MyDB_Catalog :: escape (string fromMe) {
+	string returnVal;
+	for (char c : fromMe) {
+		if (c == '%' || c == ';' || c == '#' || c == '|' || c == '\n') {
+			char buf[4];
+			snprintf (buf, sizeof (buf), "%%%02X", (unsigned char) c);
+			returnVal += buf;
+		} else {
+			returnVal.push_back (c);
+		}
+	}
+	return returnVal;
+}
+
+string MyDB_Catalog :: unescape (string fromMe) {
+	string returnVal;
+	for (size_t i = 0; i < fromMe.size (); i++) {
+		if (fromMe[i] == '%' && i + 2 < fromMe.size ()) {
+			returnVal.push_back ((char) strtol (fromMe.substr (i + 1, 2).c_str (), nullptr, 16));
+			i += 2;
+		} else {
+			returnVal.push_back (fromMe[i]);
+		}
+	}
+	return returnVal;
+}
+
+// the first bytes of a catalog file in the binary format
+#define CATALOG_MAGIC "MyDBCat1"
+#define CATALOG_MAGIC_LEN 8
+
+// the name of the group that a key goes into
+static string groupOf (const string &key) {
+	return key.substr (0, key.find ('.'));
+}
+
+// the length of each record is written as four bytes; every other length is a varint (seven
+// bits per byte, low bits first, with the high bit set on every byte but the last one)
+static void writeVarint (string &intoMe, size_t val) {
+	while (val >= 128) {
+		intoMe.push_back ((char) ((val & 127) | 128));
+		val >>= 7;
+	}
+	intoMe.push_back ((char) val);
+}
+
+// reads a varint at pos, and moves pos past it... returns false if it runs past end
+static bool readVarint (const char *&pos, const char *end, size_t &val) {
+	val = 0;
+	for (int shift = 0; pos < end && shift < 64; shift += 7) {
+		unsigned char next = *(pos++);
+		val |= ((size_t) (next & 127)) << shift;
+		if (next < 128)
+			return true;
+	}
+	return false;
+}
+
+// reads a varint length at pos, followed by that many bytes, which go into intoMe
+static bool readString (const char *&pos, const char *end, string &intoMe) {
+	size_t len;
+	if (!readVarint (pos, end, len) || (size_t) (end - pos) < len)
+		return false;
+	intoMe.assign (pos, len);
+	pos += len;
+	return true;
+}
+
+string *MyDB_Catalog :: find (const string &key, bool create) {
+
+	auto group = groups.find (groupOf (key));
+	if (group == groups.end ()) {
+		if (!create)
+			return nullptr;
+		group = groups.insert (make_pair (groupOf (key), Group ())).first;
+		group->second.decoded = true;
+		group->second.numBytes = 0;
+	}
+	if (!group->second.decoded)
+		decode (group->first, group->second);
+
+	if (create) {
+		group->second.dirty = true;
+		return &group->second.entries[key];
+	}
+	auto entry = group->second.entries.find (key);
+	return (entry == group->second.entries.end ()) ? nullptr : &entry->second;
+}
+
+void MyDB_Catalog :: decode (const string &name, Group &group) {
+
+	// skip the length and the group name, and then read the pairs... each key is written
+	// without the group name at the front of it.  This stops if anything runs past the
+	// end of the record
+	const char *pos = fileImage.data () + group.offset + sizeof (uint32_t);
+	const char *end = fileImage.data () + group.offset + group.numBytes;
+	string key, val;
+	size_t numEntries;
+	if (readString (pos, end, key) && readVarint (pos, end, numEntries)) {
+		for (size_t i = 0; i < numEntries; i++) {
+			if (!readString (pos, end, key) || !readString (pos, end, val))
+				break;
+			group.entries[name + key] = val;
+		}
+	}
+	group.decoded = true;
+}
+
+void MyDB_Catalog :: encode (const string &name, Group &group, string &intoMe) {
+	size_t start = intoMe.size ();
+	intoMe.append (sizeof (uint32_t), '\0');
+	writeVarint (intoMe, name.size ());
+	intoMe += name;
+	writeVarint (intoMe, group.entries.size ());
+	for (auto const &ent : group.entries) {
+		writeVarint (intoMe, ent.first.size () - name.size ());
+		intoMe.append (ent.first, name.size (), string :: npos);
+		writeVarint (intoMe, ent.second.size ());
+		intoMe += ent.second;
+	}
+
+	// and now we know the length
+	group.numBytes = intoMe.size () - start;
+	uint32_t len = group.numBytes - sizeof (uint32_t);
+	memcpy (&intoMe[start], &len, sizeof (len));
+}
+
 void MyDB_Catalog :: putString (string key, string value) {
-	myData [key] = value;
+	*find (key, true) = value;
 }
 
 void MyDB_Catalog :: putStringList (string key, vector <string> value) {
@@ -24,54 +154,55 @@ void MyDB_Catalog :: putStringList (string key, vector <string> value) {
 	for (string s : value) {
 		res = res + s + "#";
 	}
-	myData [key] = res;
+	*find (key, true) = res;
 }
 
 void MyDB_Catalog :: putInt (string key, int value) {
-	ostringstream convert;
-	convert << value;
-	myData [key] = convert.str ();
+	*find (key, true) = to_string (value);
 }
 
 bool MyDB_Catalog :: getStringList (string key, vector <string> &returnVal) {
 
 	// verify the entry is in the map
-	if (myData.count (key) == 0)
+	string *res = find (key, false);
+	if (res == nullptr)
 		return false;
 
 	// it is, so parse the other side
-	string res = myData[key];	
-	for (int pos = 0; pos < (int) res.size (); pos = res.find ("#", pos + 1) + 1) {
-		string temp = res.substr (pos, res.find ("#", pos + 1) - pos);
-		returnVal.push_back (temp);
+	for (size_t pos = 0; pos < res->size (); ) {
+		size_t next = res->find ('#', pos);
+		if (next == string :: npos)
+			next = res->size ();
+		returnVal.push_back (res->substr (pos, next - pos));
+		pos = next + 1;
 	}
 	return true;
 }
 
 bool MyDB_Catalog :: getString (string key, string &res) {
-	if (myData.count (key) == 0)
+	string *val = find (key, false);
+	if (val == nullptr)
 		return false;
 
-	res = myData[key];
+	res = *val;
 	return true;
 }
 
 bool MyDB_Catalog :: getInt (string key, int &value) {
 
 	// verify the entry is in the map
-	if (myData.count (key) == 0)
+	string *val = find (key, false);
+	if (val == nullptr)
 		return false;
 
 	// it is, so convert it to an int
-	string :: size_type sz;
-	try {
-		value = std::stoi (myData [key], &sz);
+	char *end;
+	long temp = strtol (val->c_str (), &end, 10);
 
-	// exception means that we could not convert
-	} catch (...) {
+	// no digits means that we could not convert
+	if (end == val->c_str ())
 		return false;
-	}
-	
+	value = (int) temp;
 	return true;
 }
 
@@ -79,8 +210,54 @@ MyDB_Catalog :: MyDB_Catalog (string fNameIn) {
 
 	// remember the catalog name
 	fName = fNameIn;
+	fileBytes = 0;
+	rewrite = true;
+
+	// try to read in the file
+	FILE *myFile = fopen (fName.c_str (), "rb");
+	if (myFile == nullptr)
+		return;
+	fseek (myFile, 0, SEEK_END);
+	fileImage.resize (ftell (myFile));
+	fseek (myFile, 0, SEEK_SET);
+	fileImage.resize (fread (fileImage.data (), 1, fileImage.size (), myFile));
+	fclose (myFile);
+
+	// see if it is in the old format
+	if (fileImage.size () < CATALOG_MAGIC_LEN || memcmp (fileImage.data (), CATALOG_MAGIC, CATALOG_MAGIC_LEN) != 0) {
+		readText ();
+		return;
+	}
 
-	// try to open the file
+	// find the latest record for each group... if the last record was not completely
+	// written, it is dropped (and the file is cleaned up on the next save)
+	size_t pos = CATALOG_MAGIC_LEN;
+	while (pos + sizeof (uint32_t) <= fileImage.size ()) {
+		uint32_t len;
+		memcpy (&len, &fileImage[pos], sizeof (len));
+		size_t numBytes = sizeof (uint32_t) + len;
+		if (numBytes > fileImage.size () - pos)
+			break;
+
+		string name;
+		const char *namePos = &fileImage[pos + sizeof (uint32_t)];
+		if (!readString (namePos, &fileImage[pos] + numBytes, name))
+			break;
+		Group &group = groups[name];
+		group.entries.clear ();
+		group.decoded = false;
+		group.dirty = false;
+		group.offset = pos;
+		group.numBytes = numBytes;
+		pos += numBytes;
+	}
+	fileBytes = pos;
+	rewrite = (pos != fileImage.size ());
+}
+
+void MyDB_Catalog :: readText () {
+
+	fileImage.clear ();
 	string line;
 	ifstream myfile (fName);
 
@@ -101,7 +278,7 @@ MyDB_Catalog :: MyDB_Catalog (string fNameIn) {
 				continue;
 
 			// and add the pair
-			myData [line.substr (firstPipe + 1, secPipe - firstPipe - 1)] = 
+			*find (line.substr (firstPipe + 1, secPipe - firstPipe - 1), true) =
 				line.substr (secPipe + 1, lastPipe - secPipe - 1);
 		}
 		myfile.close();
@@ -116,14 +293,58 @@ MyDB_Catalog :: ~MyDB_Catalog () {
 
 void MyDB_Catalog :: save () {
 
-	ofstream myFile (fName, ofstream::out | ofstream::trunc);
-	if (myFile.is_open()) {
-		for (auto const &ent : myData) {
-			myFile << "|" << ent.first << "|" << ent.second << "|\n";
+	// just add a record onto the end of the file for each group that changed
+	if (!rewrite) {
+		string newRecords;
+		size_t liveBytes = CATALOG_MAGIC_LEN;
+		for (auto &group : groups) {
+			if (group.second.dirty) {
+				encode (group.first, group.second, newRecords);
+				group.second.dirty = false;
+			}
+			liveBytes += group.second.numBytes;
+		}
+		if (newRecords.empty ())
+			return;
+
+		// unless the file has gotten too big, in which case it is rewritten... it is also
+		// rewritten if it is not the same size as before (say, someone else saved it), since
+		// then the new records might not go after the ones that we know about
+		if (fileBytes + newRecords.size () <= 2 * liveBytes) {
+			FILE *myFile = fopen (fName.c_str (), "ab");
+			if (myFile != nullptr) {
+				fseek (myFile, 0, SEEK_END);
+				if ((size_t) ftell (myFile) == fileBytes) {
+					fileBytes += fwrite (newRecords.data (), 1, newRecords.size (), myFile);
+					fclose (myFile);
+					return;
+				}
+				fclose (myFile);
+			}
 		}
 	}
-}
 
-#endif
+	// write out the latest record for each group... a group that has not been decoded
+	// is just copied over from the old file
+	string contents (CATALOG_MAGIC, CATALOG_MAGIC_LEN);
+	for (auto &group : groups) {
+		if (group.second.decoded)
+			encode (group.first, group.second, contents);
+		else
+			contents.append (&fileImage[group.second.offset], group.second.numBytes);
+		group.second.dirty = false;
+	}
 
+	string tempName = fName + ".tmp";
+	FILE *myFile = fopen (tempName.c_str (), "wb");
+	if (myFile == nullptr)
+		return;
+	bool wroteAll = fwrite (contents.data (), 1, contents.size (), myFile) == contents.size ();
+	wroteAll = (fclose (myFile) == 0) && wroteAll;
+	if (wroteAll && rename (tempName.c_str (), fName.c_str ()) == 0) {
+		fileBytes = contents.size ();
+		rewrite = false;
+	}
+}
 
+#endif
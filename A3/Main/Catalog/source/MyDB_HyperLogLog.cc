@@ -0,0 +1,97 @@
+
+#ifndef HLL_C
+#define HLL_C
+
+#include "MyDB_HyperLogLog.h"
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+
+MyDB_HyperLogLog :: MyDB_HyperLogLog (int precisionIn) {
+	if (precisionIn < 4 || precisionIn > 16) {
+		cout << "This is bad... a HyperLogLog precision of " << precisionIn << " is not allowed.\n";
+		exit (1);
+	}
+	precision = precisionIn;
+	registers.resize (((size_t) 1) << precision, 0);
+}
+
+void MyDB_HyperLogLog :: add (size_t hashIn) {
+
+	// mix the bits up, using the murmur3 finalizer
+	uint64_t hash = hashIn;
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	// the high bits pick the register, and the rest give the rank... the extra bit at the end
+	// keeps the rank from running off the end of the hash
+	size_t whichReg = hash >> (64 - precision);
+	uint64_t rest = (hash << precision) | (((uint64_t) 1) << (precision - 1));
+	uint8_t rank = __builtin_clzll (rest) + 1;
+	if (rank > registers[whichReg])
+		registers[whichReg] = rank;
+}
+
+void MyDB_HyperLogLog :: merge (const MyDB_HyperLogLog &other) {
+	if (other.precision != precision) {
+		cout << "This is bad... cannot merge HyperLogLogs with different precisions.\n";
+		exit (1);
+	}
+	for (size_t i = 0; i < registers.size (); i++)
+		registers[i] = max (registers[i], other.registers[i]);
+}
+
+size_t MyDB_HyperLogLog :: estimate () const {
+
+	double m = registers.size ();
+	double sum = 0;
+	size_t numZeros = 0;
+	for (uint8_t reg : registers) {
+		sum += ldexp (1.0, -reg);
+		if (reg == 0)
+			numZeros++;
+	}
+	double est = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+
+	// for small sets, lots of registers are still empty, and counting them is more accurate
+	if (est <= 2.5 * m && numZeros > 0)
+		est = m * log (m / numZeros);
+	return (size_t) (est + 0.5);
+}
+
+void MyDB_HyperLogLog :: clear () {
+	fill (registers.begin (), registers.end (), 0);
+}
+
+string MyDB_HyperLogLog :: toString () const {
+	string returnVal;
+	returnVal.reserve (registers.size ());
+	for (uint8_t reg : registers)
+		returnVal.push_back ('0' + reg);
+	return returnVal;
+}
+
+bool MyDB_HyperLogLog :: fromString (const string &fromMe) {
+
+	// the number of registers gives the precision
+	int newPrecision = 4;
+	while (newPrecision <= 16 && (((size_t) 1) << newPrecision) != fromMe.size ())
+		newPrecision++;
+	if (newPrecision > 16)
+		return false;
+
+	vector <uint8_t> newRegisters (fromMe.size ());
+	for (size_t i = 0; i < fromMe.size (); i++) {
+		if (fromMe[i] < '0' || fromMe[i] > '0' + 64)
+			return false;
+		newRegisters[i] = fromMe[i] - '0';
+	}
+	precision = newPrecision;
+	registers = newRegisters;
+	return true;
+}
+
+#endif
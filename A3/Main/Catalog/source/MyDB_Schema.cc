@@ -68,10 +68,44 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 			exit (1);
 		}
 	}
+	findLayout ();
+
+	// and use the layout that the table's records were written with
+	string layout;
+	if (!catalog->getString (tableName + ".layout", layout) || layout == "variable") {
+		useVariableLayout ();
+	} else if (layout != "fixed" || !fixedWidth) {
+		cout << "This is bad... table " << tableName << " has a bad layout in the catalog: " << layout << "\n";
+		exit (1);
+	}
 }
 
 void MyDB_Schema :: appendAtt (pair <string, MyDB_AttTypePtr> addAtt) {
 	allAtts.push_back (addAtt);
+	findLayout ();
+}
+
+void MyDB_Schema :: useVariableLayout () {
+	variableOnly = true;
+	findLayout ();
+}
+
+void MyDB_Schema :: findLayout () {
+	fixedWidth = !allAtts.empty () && !variableOnly;
+	fixedOffsets.assign (1, 0);
+	for (auto &att : allAtts) {
+		size_t width;
+		if (att.second->isBool ())
+			width = sizeof (char);
+		else if (att.second->promotableToInt ())
+			width = sizeof (int);
+		else if (att.second->promotableToDouble ())
+			width = sizeof (double);
+		else
+			width = 0;
+		fixedWidth = fixedWidth && width != 0;
+		fixedOffsets.push_back (fixedOffsets.back () + width);
+	}
 }
 
 void MyDB_Schema :: putInCatalog (string tableName, MyDB_CatalogPtr catalog) {
@@ -80,6 +114,9 @@ void MyDB_Schema :: putInCatalog (string tableName, MyDB_CatalogPtr catalog) {
 	for (auto entry : allAtts) {
 		addAtt (tableName, entry, catalog);
 	}	
+
+	// and the layout
+	catalog->putString (tableName + ".layout", fixedWidth ? "fixed" : "variable");
 }
 
 vector <pair <string, MyDB_AttTypePtr>> &MyDB_Schema :: getAtts () {
@@ -3,6 +3,7 @@
 #define TABLE_C
 
 #include "MyDB_Table.h"
+#include <algorithm>
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	tableName = name;
@@ -11,6 +12,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	count = 0;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn) {
@@ -21,6 +23,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	count = 0;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn, string fileTypeIn, string sortAttIn) {
@@ -31,6 +34,7 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = fileTypeIn;
 	sortAtt = sortAttIn;
 	rootLocation = -1;
+	count = 0;
 }
 
 MyDB_Table :: ~MyDB_Table () {}
@@ -42,12 +46,14 @@ string &MyDB_Table :: getName () {
 size_t MyDB_Table :: getDistinctValues (string forMe) {
 	auto res = mySchema->getAttByName (forMe);
 	if (res.first != -1)
-		return allCounts[res.first];
+		return getDistinctValues (res.first);
 	else
 		return -1;
 }
 
 size_t MyDB_Table :: getDistinctValues (int forMe) {
+	if (!sketches.empty ())
+		return sketches[forMe].estimate ();
         return allCounts[forMe];
 }
 
@@ -55,6 +61,51 @@ void MyDB_Table :: setDistinctValues (vector <size_t> &toMe) {
         allCounts = toMe;
 }
 
+vector <MyDB_HyperLogLog> &MyDB_Table :: getSketches () {
+	return sketches;
+}
+
+void MyDB_Table :: setSketches (vector <MyDB_HyperLogLog> &toMe) {
+	sketches = toMe;
+}
+
+vector <MyDB_AttStats> &MyDB_Table :: getAttStats () {
+	return attStats;
+}
+
+void MyDB_Table :: setAttStats (vector <MyDB_AttStats> &toMe) {
+	attStats = toMe;
+}
+
+double MyDB_Table :: estimateRangeCount (string att, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	int whichAtt = mySchema->getAttByName (att).first;
+	if (whichAtt == -1 || attStats.empty ())
+		return (low == nullptr && high == nullptr) ? count : count / 3.0;
+	return attStats[whichAtt].estimateRange (low, high) * count;
+}
+
+double MyDB_Table :: estimateEqualCount (string att, MyDB_AttValPtr val) {
+	int whichAtt = mySchema->getAttByName (att).first;
+	if (whichAtt == -1)
+		return count / 10.0;
+	size_t numDistinct = getDistinctValues (whichAtt);
+	if (attStats.empty ())
+		return count / (double) max (numDistinct, (size_t) 1);
+	return attStats[whichAtt].estimateEqual (val, numDistinct) * count;
+}
+
+vector <MyDB_ZoneMap> &MyDB_Table :: getZoneMaps () {
+	return zoneMaps;
+}
+
+MyDB_ZoneMap *MyDB_Table :: getZoneMap (string att) {
+	for (auto &a : zoneMaps) {
+		if (a.getAttName () == att)
+			return &a;
+	}
+	return nullptr;
+}
+
 void MyDB_Table :: setTupleCount (size_t toMe) {
         count = toMe;
 }
@@ -143,6 +194,45 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	for (auto a : temp)
 		allCounts.push_back (stoull(a));
 
+	// and the sketches, if there are any
+	sketches.clear ();
+	temp.clear ();
+	catalog->getStringList (tableName + ".sketches", temp);
+	for (auto a : temp) {
+		MyDB_HyperLogLog sketch;
+		if (sketch.fromString (a))
+			sketches.push_back (sketch);
+	}
+	if (sketches.size () != mySchema->getAtts ().size ())
+		sketches.clear ();
+
+	// and the statistics
+	attStats.clear ();
+	temp.clear ();
+	catalog->getStringList (tableName + ".attStats", temp);
+	if (temp.size () == mySchema->getAtts ().size ()) {
+		for (size_t i = 0; i < temp.size (); i++) {
+			MyDB_AttStats stats (mySchema->getAtts ()[i].second);
+			if (stats.fromString (temp[i]))
+				attStats.push_back (stats);
+		}
+		if (attStats.size () != temp.size ())
+			attStats.clear ();
+	}
+
+	// and the zone maps... each one starts with the name of its attribute
+	zoneMaps.clear ();
+	temp.clear ();
+	catalog->getStringList (tableName + ".zoneMaps", temp);
+	for (auto a : temp) {
+		auto att = mySchema->getAttByName (MyDB_Catalog :: unescape (a.substr (0, a.find (';'))));
+		if (att.first == -1)
+			continue;
+		MyDB_ZoneMap zoneMap ("", att.first, att.second);
+		if (zoneMap.fromString (a))
+			zoneMaps.push_back (zoneMap);
+	}
+
 	// get the number of tuples
 	catalog->getInt (tableName + ".numTuples", count);
 
@@ -178,10 +268,33 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 
 	// remember the number of distinct attribute vals
 	vector <string> temp;
-	for (auto a : allCounts)
-		temp.push_back (to_string(a));
+	if (!sketches.empty ()) {
+		for (auto &a : sketches)
+			temp.push_back (to_string (a.estimate ()));
+	} else {
+		for (auto a : allCounts)
+			temp.push_back (to_string(a));
+	}
 	catalog->putStringList (tableName + ".valCounts", temp);
 
+	// and the sketches they came from
+	temp.clear ();
+	for (auto &a : sketches)
+		temp.push_back (a.toString ());
+	catalog->putStringList (tableName + ".sketches", temp);
+
+	// and the statistics for each attribute
+	temp.clear ();
+	for (auto &a : attStats)
+		temp.push_back (a.toString ());
+	catalog->putStringList (tableName + ".attStats", temp);
+
+	// and the zone maps
+	temp.clear ();
+	for (auto &a : zoneMaps)
+		temp.push_back (a.toString ());
+	catalog->putStringList (tableName + ".zoneMaps", temp);
+
 	// remember the number of tuples
 	catalog->putInt (tableName + ".numTuples", count);
 
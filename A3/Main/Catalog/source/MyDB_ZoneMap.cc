@@ -0,0 +1,164 @@
+
+#ifndef ZONE_MAP_C
+#define ZONE_MAP_C
+
+#include "MyDB_Catalog.h"
+#include "MyDB_ZoneMap.h"
+#include <stdio.h>
+
+MyDB_ZoneMap :: MyDB_ZoneMap (string attNameIn, int whichAttIn, MyDB_AttTypePtr typeIn) {
+	attName = attNameIn;
+	whichAtt = whichAttIn;
+	type = typeIn;
+}
+
+string &MyDB_ZoneMap :: getAttName () {
+	return attName;
+}
+
+int MyDB_ZoneMap :: getWhichAtt () {
+	return whichAtt;
+}
+
+int MyDB_ZoneMap :: compare (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
+	if (type->isBool ())
+		return (int) lhs->toBool () - (int) rhs->toBool ();
+	if (type->promotableToInt ()) {
+		int l = lhs->toInt (), r = rhs->toInt ();
+		return (l < r) ? -1 : (l > r);
+	}
+	if (type->promotableToDouble ()) {
+		double l = lhs->toDouble (), r = rhs->toDouble ();
+		return (l < r) ? -1 : (l > r);
+	}
+	return lhs->toString ().compare (rhs->toString ());
+}
+
+void MyDB_ZoneMap :: clear () {
+	states.clear ();
+	mins.clear ();
+	maxes.clear ();
+}
+
+void MyDB_ZoneMap :: setEmpty (int whichPage) {
+	if (whichPage >= (int) states.size ()) {
+		states.resize (whichPage + 1, Unknown);
+		mins.resize (whichPage + 1);
+		maxes.resize (whichPage + 1);
+	}
+	states[whichPage] = Empty;
+}
+
+void MyDB_ZoneMap :: add (int whichPage, MyDB_AttValPtr val) {
+	if (whichPage >= (int) states.size () || states[whichPage] == Unknown)
+		return;
+
+	// the first record on the page
+	if (states[whichPage] == Empty) {
+		states[whichPage] = Known;
+		if (mins[whichPage] == nullptr) {
+			mins[whichPage] = type->createAtt ();
+			maxes[whichPage] = type->createAtt ();
+		}
+		mins[whichPage]->set (val);
+		maxes[whichPage]->set (val);
+		return;
+	}
+
+	if (compare (val, mins[whichPage]) < 0)
+		mins[whichPage]->set (val);
+	else if (compare (val, maxes[whichPage]) > 0)
+		maxes[whichPage]->set (val);
+}
+
+bool MyDB_ZoneMap :: mightHave (int whichPage, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	if (whichPage >= (int) states.size () || states[whichPage] == Unknown)
+		return true;
+	if (states[whichPage] == Empty)
+		return false;
+	return (low == nullptr || compare (maxes[whichPage], low) >= 0) &&
+		(high == nullptr || compare (mins[whichPage], high) <= 0);
+}
+
+bool MyDB_ZoneMap :: inRange (MyDB_AttValPtr val, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+	return (low == nullptr || compare (val, low) >= 0) && (high == nullptr || compare (val, high) <= 0);
+}
+
+MyDB_AttValPtr MyDB_ZoneMap :: getMin (int whichPage) {
+	if (whichPage >= (int) states.size () || states[whichPage] != Known)
+		return nullptr;
+	return mins[whichPage];
+}
+
+MyDB_AttValPtr MyDB_ZoneMap :: getMax (int whichPage) {
+	if (whichPage >= (int) states.size () || states[whichPage] != Known)
+		return nullptr;
+	return maxes[whichPage];
+}
+
+string MyDB_ZoneMap :: toString () {
+
+	// the attribute name, and then two entries (the min and the max) for each page, all
+	// separated by semicolons... an unknown page is written as "?;?" and an empty one as
+	// "-;-", and a value has a ':' in front of it, so that it cannot be confused with those
+	string returnVal = MyDB_Catalog :: escape (attName);
+	for (size_t i = 0; i < states.size (); i++) {
+		if (states[i] != Known) {
+			returnVal += (states[i] == Empty) ? ";-;-" : ";?;?";
+			continue;
+		}
+		for (MyDB_AttValPtr val : {mins[i], maxes[i]}) {
+			returnVal += ";:";
+			if (type->promotableToDouble () && !type->promotableToInt ()) {
+				char buf[64];
+				snprintf (buf, sizeof (buf), "%.17g", val->toDouble ());
+				returnVal += buf;
+			} else {
+				returnVal += MyDB_Catalog :: escape (val->toString ());
+			}
+		}
+	}
+	return returnVal;
+}
+
+bool MyDB_ZoneMap :: fromString (string fromMe) {
+
+	vector <string> pieces;
+	size_t pos = 0;
+	while (true) {
+		size_t next = fromMe.find (';', pos);
+		pieces.push_back (fromMe.substr (pos, next == string :: npos ? string :: npos : next - pos));
+		if (next == string :: npos)
+			break;
+		pos = next + 1;
+	}
+	if (pieces.size () % 2 != 1)
+		return false;
+
+	vector <PageState> newStates;
+	vector <MyDB_AttValPtr> newMins, newMaxes;
+	for (size_t i = 1; i < pieces.size (); i += 2) {
+		if (pieces[i] == "?" || pieces[i] == "-") {
+			newStates.push_back (pieces[i] == "-" ? Empty : Unknown);
+			newMins.push_back (nullptr);
+			newMaxes.push_back (nullptr);
+			continue;
+		}
+		if (pieces[i].empty () || pieces[i][0] != ':' || pieces[i + 1].empty () || pieces[i + 1][0] != ':')
+			return false;
+		newStates.push_back (Known);
+		for (int j = 0; j < 2; j++) {
+			MyDB_AttValPtr val = type->createAtt ();
+			string text = MyDB_Catalog :: unescape (pieces[i + j].substr (1));
+			val->fromString (text);
+			(j == 0 ? newMins : newMaxes).push_back (val);
+		}
+	}
+	attName = MyDB_Catalog :: unescape (pieces[0]);
+	states = newStates;
+	mins = newMins;
+	maxes = newMaxes;
+	return true;
+}
+
+#endif
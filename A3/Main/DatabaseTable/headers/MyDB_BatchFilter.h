@@ -0,0 +1,105 @@
+
+#ifndef BATCH_FILTER_H
+#define BATCH_FILTER_H
+
+#include <memory>
+#include "MyDB_FilterKernels.h"
+#include "MyDB_RecordBatch.h"
+#include "MyDB_TypedExpr.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class MyDB_BatchFilter;
+typedef shared_ptr <MyDB_BatchFilter> MyDB_BatchFilterPtr;
+
+// A MyDB_BatchFilter runs a predicate (written just like the ones sent to compileComputation)
+// over a whole MyDB_RecordBatch at once, producing a selection bitmap.  Comparisons between an
+// int or double attribute and a constant of the same type (or an int constant, for a double
+// attribute), or between two attributes of the same numeric type, are run with the SIMD kernels
+// in MyDB_FilterKernels.h over the batch's decoded columns, and &&, ||, and ! are run over the
+// resulting bitmaps.  Any other part of the predicate (say, a string comparison) is compiled into
+// a MyDB_TypedExpr and run on the records one at a time, which needs the batch to have record
+// pointers (so the batch cannot come from a PAX page).
+//
+// Running a filter writes to it (the nodes for && and || keep the right child's bitmap in
+// scratch space of their own, and a compiled MyDB_TypedExpr keeps the values it works on), so
+// one filter cannot be used by more than one thread at a time; each thread that filters
+// batches needs its own MyDB_BatchFilter.
+//
+// For example:
+//
+//	MyDB_BatchFilter filter (mySchema, "&& (< ([nationkey], int[10]), > ([acctbal], double[0.0]))");
+//	MyDB_RecordBatchPtr batch = make_shared <MyDB_RecordBatch> (mySchema, filter.getNeededAtts ());
+//	uint64_t bits[BITMAP_WORDS (MAX_BATCH_SIZE)];
+//	while (myIter->getNextBatch (*batch))
+//		count += filter.apply (*batch, bits);
+class MyDB_BatchFilter {
+
+public:
+
+	// compile the predicate over records with the given schema
+	MyDB_BatchFilter (MyDB_SchemaPtr mySchema, string predicate);
+
+	// the positions of the attributes that a batch must decode to run this filter
+	vector <int> getNeededAtts ();
+
+	// run the filter over the batch; bit i of the result is set if record i passes.  The
+	// bitmap must have BITMAP_WORDS (batch.size ()) words.  Returns the number of records
+	// that pass.  This is not thread-safe (see above)
+	int apply (MyDB_RecordBatch &batch, uint64_t *bits);
+
+private:
+
+	// the different kinds of nodes in a compiled filter
+	enum NodeKind {AttConst, AttAtt, AndNode, OrNode, NotNode, RowByRow};
+
+	// one node in the compiled filter
+	struct Node {
+		NodeKind kind;
+
+		// for the comparisons
+		MyDB_CompareOp op;
+		bool isDouble;
+		int lhsAtt;
+		int rhsAtt;
+		int intConst;
+		double doubleConst;
+
+		// the children (for and, or, not)
+		int lhs;
+		int rhs;
+
+		// for a part of the predicate that is run row by row
+		MyDB_TypedExprPtr expr;
+
+		// scratch space for the bitmap of the right child... since this is written each time
+		// the filter is run, a filter is only good for one thread
+		vector <uint64_t> scratch;
+	};
+
+	// one side of a comparison, as it is parsed
+	struct Operand {
+		bool isAtt;
+		bool isConst;
+		bool isDouble;
+		int att;
+		double val;
+	};
+
+	// parse the predicate starting at vals into a node; returns its position in allNodes
+	int compile (char * &vals);
+	Operand parseOperand (char * &vals);
+	int rowByRow (char *from, char *to);
+
+	// run the given node
+	void run (int whichNode, MyDB_RecordBatch &batch, uint64_t *bits);
+
+	MyDB_SchemaPtr mySchema;
+	vector <Node> allNodes;
+	vector <int> neededAtts;
+	int root;
+};
+
+#endif
@@ -0,0 +1,30 @@
+
+#ifndef BATCH_ITER_H
+#define BATCH_ITER_H
+
+#include <memory>
+#include "MyDB_RecordBatch.h"
+using namespace std;
+
+// This pure virtual class is used to iterate through the records in a page or file a batch
+// at a time.  Instances of this class will be created via calls to
+// MyDB_PageReaderWriter.getBatchIterator () or MyDB_TableReaderWriter.getBatchIterator ().
+//
+class MyDB_BatchIterator;
+typedef shared_ptr <MyDB_BatchIterator> MyDB_BatchIteratorPtr;
+
+class MyDB_BatchIterator {
+
+public:
+
+	// empties out fillMe, and then loads the next run of records (at most MAX_BATCH_SIZE,
+	// all from the same page) into it.  Returns false if there are no more records
+	virtual bool getNextBatch (MyDB_RecordBatch &fillMe) = 0;
+
+	// destructor and contructor
+	MyDB_BatchIterator () {};
+	virtual ~MyDB_BatchIterator () {};
+
+};
+
+#endif
@@ -0,0 +1,183 @@
+
+#ifndef COMPRESSED_PAGE_H
+#define COMPRESSED_PAGE_H
+
+#include "MyDB_RecordBatch.h"
+#include "MyDB_Schema.h"
+#include <stddef.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// the ways that a column on a compressed page can be stored
+enum MyDB_ColumnEncoding {PlainEncoding, FrameOfReference, DeltaEncoding, RunLength, Dictionary};
+
+// A compressed page is a read-only PAX page: the values of each attribute are kept together,
+// but each column is stored using whichever of these encodings makes it smallest:
+//
+// 1) PlainEncoding stores the values just as a PAX page does (ints, doubles, and bools as
+//    dense arrays, and strings back-to-back with their short length headers).
+// 2) FrameOfReference (ints only) stores the smallest value on the page, and then, for each
+//    record, the difference from it, in 1, 2, or 4 bytes.
+// 3) DeltaEncoding (ints only) stores the first value, the smallest difference between two
+//    neighbouring values, and then, for each record, how much more than that its value is
+//    over the one before, in 1, 2, or 4 bytes (the first record's code is not used, so that
+//    each record's code is in the same place as with frame-of-reference).  This is what a
+//    sorted column ends up with.
+// 4) RunLength stores each run of equal values once, along with where the run ends.
+// 5) Dictionary stores each distinct value once, and then a 1 or 2 byte code for each record.
+//
+// The encoding of a column is picked when the page is written, from statistics gathered over
+// the page's records (their range, the number of distinct values, the number of runs, and the
+// range of the differences).  The layout of the page is:
+//
+//	[page type = CompressedPage][bytes the records would use as rows][num recs][num atts]
+//	[bytes used on the page][one ColumnHeader per attribute] ... column 0 ... column 1 ... etc.
+//
+// Unlike a PAX page, a compressed page can hold many more records than a regular page, so
+// it can't be turned back into a regular page; toRows () writes the records into a buffer that
+// is as big as they need.  Records can't be appended to a compressed page.  Instead, the pages
+// are filled by a MyDB_CompressedPageBuilder, which only lets in as many records as fit using
+// the encodings that do not depend on the order of the records (plain, frame-of-reference, and
+// dictionary); run-length and delta encoding are used when they are smaller, but they never
+// make room for more records.  That way, the records on a page can be put in any order, and
+// the page written again, and they always fit.
+//
+// This object does not own the page; it just interprets the bytes given to it.
+class MyDB_CompressedPage {
+
+public:
+
+	// where a scan of one column is... the getters below use this to pick up where the last
+	// call left off, for the encodings that have to be walked from the start of the column
+	struct Cursor {
+		size_t rec = 0;
+		size_t run = 0;
+		size_t pos = 0;
+		int last = 0;
+	};
+
+	// interpret the given bytes as a compressed page
+	MyDB_CompressedPage (void *bytes, size_t pageSize);
+
+	// the number of records and attributes on the page
+	size_t getNumRecs ();
+	size_t getNumAtts ();
+
+	// the number of bytes of the page that are used, and the number that the records would
+	// use on regular pages
+	size_t getBytesUsed ();
+	size_t getRowBytes ();
+
+	// how the given attribute's column is stored
+	MyDB_ColumnEncoding getEncoding (int whichAtt);
+
+	// writes the records on this page, in order, into intoHere, laid out just like a regular
+	// page (intoHere is grown to hold them, and may be bigger than a page)
+	void toRows (vector <char> &intoHere);
+
+	// decode the values of the given attribute for records from through from + n - 1 into
+	// into... bools come out as one char per record, and strings as the address of the value
+	// on the page (with its short length header).  The cursor should start out as Cursor ()
+	// and be passed back in on each call for the same attribute; reading the records in order
+	// is the fastest
+	void getInts (int whichAtt, size_t from, size_t n, int *into, Cursor &cur);
+	void getDoubles (int whichAtt, size_t from, size_t n, double *into, Cursor &cur);
+	void getBools (int whichAtt, size_t from, size_t n, char *into, Cursor &cur);
+	void getStrings (int whichAtt, size_t from, size_t n, char **into, Cursor &cur);
+
+private:
+
+	friend class MyDB_CompressedPageBuilder;
+
+	// how one column is stored... width is the number of bytes in each value (zero for a
+	// string), and codeWidth the number of bytes in each code.  numEntries is the number of
+	// runs or of dictionary entries.  base is the smallest value, or the first one, for
+	// frame-of-reference and delta encoding, and step is the smallest difference
+	struct ColumnHeader {
+		unsigned start;
+		unsigned encoding;
+		unsigned width;
+		unsigned codeWidth;
+		unsigned numEntries;
+		int base;
+		int step;
+		unsigned unused;
+	};
+
+	// for run-length encoding, moves the cursor to the run holding the given record
+	void seekRun (ColumnHeader &col, size_t whichRec, Cursor &cur);
+
+	// the start of the values of a run-length or dictionary encoded column
+	char *getEntries (ColumnHeader &col);
+
+	// the header fields
+	size_t &rowBytes ();
+	size_t &numRecs ();
+	size_t &numAtts ();
+	size_t &bytesUsed ();
+	ColumnHeader *columns ();
+	size_t dataStart ();
+
+	char *bytes;
+	size_t pageSize;
+};
+
+// This puts together the records for a compressed page, and then writes the page.  For
+// example, to compress the records on regular page images:
+//
+//	MyDB_CompressedPageBuilder builder (mySchema, pageSize);
+//	for (each record, in binary form at rec) {
+//		if (!builder.add (rec)) {
+//			builder.write (...a new page...);
+//			builder.add (rec);
+//		}
+//	}
+//	builder.write (...a new page...);
+class MyDB_CompressedPageBuilder {
+
+public:
+
+	// sets up to build pages of the given size, for records with the given schema
+	MyDB_CompressedPageBuilder (MyDB_SchemaPtr mySchema, size_t pageSize);
+
+	// adds the record whose binary (regular page) form is at fromHere; returns false, and does
+	// not add it, if the page would not have room for it
+	bool add (void *fromHere);
+
+	// the number of records that have been added
+	size_t getNumRecs ();
+
+	// writes all of the records that have been added onto the page-sized buffer intoHere,
+	// as a compressed page, and then empties out the builder
+	void write (void *intoHere);
+
+private:
+
+	// what add () keeps track of for each attribute, to see how big the column would be
+	// with the encodings that do not depend on the order of the records... the distinct
+	// values stop being tracked once there are too many for a dictionary
+	struct ColumnStats {
+		size_t plainBytes = 0;
+		int minInt = 0;
+		int maxInt = 0;
+		unordered_set <string> distinct;
+		size_t distinctBytes = 0;
+		bool tooMany = false;
+	};
+
+	// the type of each attribute, and the size of each record if they are fixed-width (or
+	// zero if they are not; see MyDB_Schema.h)
+	vector <MyDB_BatchColType> types;
+	size_t fixedSize;
+
+	// the records that have been added, and their statistics
+	vector <char> rows;
+	vector <size_t> recStarts;
+	vector <ColumnStats> stats;
+	size_t pageSize;
+};
+
+#endif
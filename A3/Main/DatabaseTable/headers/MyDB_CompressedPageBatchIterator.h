@@ -0,0 +1,39 @@
+
+#ifndef COMPRESSED_PAGE_BATCH_ITER_H
+#define COMPRESSED_PAGE_BATCH_ITER_H
+
+#include "MyDB_BatchIterator.h"
+#include "MyDB_CompressedPage.h"
+#include "MyDB_PageHandle.h"
+#include <vector>
+
+using namespace std;
+
+// a batch iterator over a compressed page... the columns that the batch wants are decoded
+// straight from the page into the batch, using the SIMD kernels in MyDB_DecodeKernels.h, and
+// the records are never put back together into rows
+class MyDB_CompressedPageBatchIterator : public MyDB_BatchIterator {
+
+public:
+
+	// loads the next run of records on the page into fillMe
+	bool getNextBatch (MyDB_RecordBatch &fillMe) override;
+
+	// destructor and contructor
+	MyDB_CompressedPageBatchIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn);
+	~MyDB_CompressedPageBatchIterator ();
+
+private:
+
+	// the number of records that have been put into batches so far
+	size_t recsConsumed;
+
+	// where we are in each column, and room for the addresses of the strings in a batch
+	vector <MyDB_CompressedPage :: Cursor> cursors;
+	vector <char *> strings;
+
+	MyDB_PageHandle myPage;
+	size_t pageSize;
+};
+
+#endif
@@ -0,0 +1,39 @@
+
+#ifndef COMPRESSED_PAGE_REC_ITER_H
+#define COMPRESSED_PAGE_REC_ITER_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIterator.h"
+#include <vector>
+
+using namespace std;
+
+// an iterator over the records on a compressed page... the records are all decoded into rows
+// held by the iterator when it is created, so the addresses from getCurrentPointer () are good
+// for as long as the iterator is around (whether or not the page is)
+class MyDB_CompressedPageRecIterator : public MyDB_RecordIterator {
+
+public:
+
+	// put the contents of the next record on the page into the iterator record
+	void getNext () override;
+
+	// return true iff there is another record on the page
+	bool hasNext () override;
+
+	// the address of the record that the next call to getNext () will load
+	void *getCurrentPointer () override;
+
+	// destructor and contructor
+	MyDB_CompressedPageRecIterator (MyDB_PageHandle myPage, size_t pageSize, MyDB_RecordPtr myRecIn);
+	~MyDB_CompressedPageRecIterator ();
+
+private:
+
+	size_t bytesConsumed;
+	vector <char> rows;
+	MyDB_RecordPtr myRec;
+};
+
+#endif
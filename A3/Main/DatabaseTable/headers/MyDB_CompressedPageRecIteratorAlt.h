@@ -0,0 +1,39 @@
+
+#ifndef COMPRESSED_PAGE_REC_ITER_ALT_H
+#define COMPRESSED_PAGE_REC_ITER_ALT_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include <vector>
+
+using namespace std;
+
+// the alternate iterator over the records on a compressed page... just as with
+// MyDB_CompressedPageRecIterator, the records are decoded into rows held by the iterator
+class MyDB_CompressedPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+	// load the current record into the parameter
+	void getCurrent (MyDB_RecordPtr intoMe) override;
+
+	// the address of the current record, which is good for as long as the iterator is around
+	void *getCurrentPointer () override;
+
+	// advance to the next record... returns true if there is a next record, and false if
+	// there are no more records to iterate over
+	bool advance () override;
+
+	// destructor and contructor
+	MyDB_CompressedPageRecIteratorAlt (MyDB_PageHandle myPage, size_t pageSize);
+	~MyDB_CompressedPageRecIteratorAlt ();
+
+private:
+
+	size_t bytesConsumed;
+	int nextRecSize;
+	vector <char> rows;
+};
+
+#endif
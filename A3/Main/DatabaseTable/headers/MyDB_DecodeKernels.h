@@ -0,0 +1,26 @@
+
+#ifndef DECODE_KERNELS_H
+#define DECODE_KERNELS_H
+
+using namespace std;
+
+// These are the kernels used to decode the compressed columns on a MyDB_CompressedPage.  A
+// packed column holds one unsigned code of width bytes (1, 2, or 4) for each value, and the
+// kernels widen n of those codes into ints, either by adding them onto a base (for
+// frame-of-reference and delta encoding) or by using them to look up a dictionary.
+//
+// Just like the filter kernels, these use AVX-512 or AVX2 if the machine supports them, and
+// plain loops otherwise; the level is the one set by useKernels () in MyDB_FilterKernels.h.
+
+// into[i] = base + codes[i]... the sum wraps around, so any int can be reached from any base
+void unpackInts (const char *codes, int width, int base, int n, int *into);
+
+// into[i] = dict[codes[i]]
+void lookUpInts (const char *codes, int width, const int *dict, int n, int *into);
+void lookUpDoubles (const char *codes, int width, const double *dict, int n, double *into);
+
+// turns n deltas into values, in place: vals[i] = start + vals[0] + ... + vals[i] (with the
+// sums wrapping around, to match unpackInts)
+void prefixSumInts (int *vals, int n, int start);
+
+#endif
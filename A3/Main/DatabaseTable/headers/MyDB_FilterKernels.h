@@ -0,0 +1,51 @@
+
+#ifndef FILTER_KERNELS_H
+#define FILTER_KERNELS_H
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+// These are the kernels used to filter the columns of a MyDB_RecordBatch.  Each comparison
+// kernel runs over n values and writes a selection bitmap, where bit i (bit i % 64 of word
+// i / 64) is set if row i passes.  The bitmap must have room for BITMAP_WORDS (n) words;
+// any bits past n are cleared.
+//
+// On x86, the kernels use AVX-512 (16 ints or 8 doubles per instruction) or AVX2 (8 ints or
+// 4 doubles per instruction) if the machine supports them, and plain loops otherwise.  The
+// choice is made at run time, so nothing special is needed when compiling.
+
+// the number of 64-bit words in a bitmap for n rows
+#define BITMAP_WORDS(n) (((n) + 63) / 64)
+
+// the comparisons that the kernels can do
+enum MyDB_CompareOp {LessThan, GreaterThan, EqualTo, NotEqualTo};
+
+// the instruction sets that the kernels can use
+enum MyDB_KernelLevel {ScalarKernels, AVX2Kernels, AVX512Kernels};
+
+// compare each of the n values against a constant: bit i is set if vals[i] op constant
+void compareInts (const int *vals, int n, MyDB_CompareOp op, int constant, uint64_t *bits);
+void compareDoubles (const double *vals, int n, MyDB_CompareOp op, double constant, uint64_t *bits);
+
+// compare two columns: bit i is set if lhs[i] op rhs[i]
+void compareIntColumns (const int *lhs, const int *rhs, int n, MyDB_CompareOp op, uint64_t *bits);
+void compareDoubleColumns (const double *lhs, const double *rhs, int n, MyDB_CompareOp op, uint64_t *bits);
+
+// combine bitmaps over n rows: into = into && other, into = into || other, bits = !bits
+void andBitmaps (uint64_t *into, const uint64_t *other, int n);
+void orBitmaps (uint64_t *into, const uint64_t *other, int n);
+void notBitmap (uint64_t *bits, int n);
+
+// the number of rows selected by the bitmap
+int countBitmap (const uint64_t *bits, int n);
+
+// use the best kernels that are supported by this machine, but no better than maxLevel (this
+// is mostly useful for testing); returns the level that will actually be used
+MyDB_KernelLevel useKernels (MyDB_KernelLevel maxLevel);
+
+// the kernels that are currently being used
+MyDB_KernelLevel getKernelLevel ();
+
+#endif
@@ -0,0 +1,54 @@
+
+#ifndef MERGE_ITER_ALT_H
+#define MERGE_ITER_ALT_H
+
+#include <functional>
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include <vector>
+
+using namespace std;
+
+// merges a list of iterators over sorted lists of records (say, the sorted runs from the first
+// phase of a TPMMS) into one iterator over all of the records, in sorted order... this is the
+// second phase of the TPMMS, done on the fly as the caller asks for records, rather than by
+// writing the records out to a file.  Comparisons are performed using comparator, lhs, rhs,
+// which the caller should not use for anything else while iterating
+class MyDB_MergeIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+	// load the current record into the parameter
+	void getCurrent (MyDB_RecordPtr intoMe) override;
+
+	// after a call to advance (), a call to getCurrentPointer () will get the address
+	// of the record.  At a later time, it is then possible to reconstitute the record
+	// by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+	// the record is located on has not been swapped out
+	void *getCurrentPointer () override;
+
+	// advance to the next record in sorted order... returns true if there is one
+	bool advance () override;
+
+	MyDB_MergeIteratorAlt (vector <MyDB_RecordIteratorAltPtr> &mergeUs, function <bool ()> comparator,
+		MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+	~MyDB_MergeIteratorAlt ();
+
+private:
+
+	// true if the current record of a comes after the current record of b, so that a
+	// heap ordered with this has the smallest record on top
+	bool after (MyDB_RecordIteratorAltPtr &a, MyDB_RecordIteratorAltPtr &b);
+
+	// the iterators that still have records, as a heap
+	vector <MyDB_RecordIteratorAltPtr> heap;
+
+	// the iterators that have not been started yet
+	vector <MyDB_RecordIteratorAltPtr> notStarted;
+
+	function <bool ()> comparator;
+	MyDB_RecordPtr lhs;
+	MyDB_RecordPtr rhs;
+};
+
+#endif
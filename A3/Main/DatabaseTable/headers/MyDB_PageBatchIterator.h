@@ -0,0 +1,25 @@
+
+#ifndef PAGE_BATCH_ITER_H
+#define PAGE_BATCH_ITER_H
+
+#include "MyDB_BatchIterator.h"
+#include "MyDB_PageHandle.h"
+
+class MyDB_PageBatchIterator : public MyDB_BatchIterator {
+
+public:
+
+	// loads the next run of records on the page into fillMe
+	bool getNextBatch (MyDB_RecordBatch &fillMe) override;
+
+	// destructor and contructor
+	MyDB_PageBatchIterator (MyDB_PageHandle myPageIn);
+	~MyDB_PageBatchIterator ();
+
+private:
+
+	size_t bytesConsumed;
+	MyDB_PageHandle myPage;
+};
+
+#endif
@@ -0,0 +1,44 @@
+
+#ifndef PAGE_LIST_FILTER_ITER_ALT_H
+#define PAGE_LIST_FILTER_ITER_ALT_H
+
+#include <functional>
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include <vector>
+
+using namespace std;
+
+// iterates through the records on a list of pages, skipping over any record that does not pass
+// a filter... this is what the index lookups (say, a range lookup in a B+-Tree, or a probe into
+// a hash file) return, once they have found the pages that could have the records they want
+class MyDB_PageListFilterIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+	// load the current record into the parameter
+	void getCurrent (MyDB_RecordPtr intoMe) override;
+
+	// after a call to advance (), a call to getCurrentPointer () will get the address
+	// of the record.  At a later time, it is then possible to reconstitute the record
+	// by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+	// the record is located on has not been swapped out
+	void *getCurrentPointer () override;
+
+	// advance to the next record that passes the filter... returns true if there is one
+	bool advance () override;
+
+	// iterate over the records on the given pages (the list can be empty); each record is
+	// loaded into myRec, and passes () is called to see if it should be returned
+	MyDB_PageListFilterIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, MyDB_RecordPtr myRec, function <bool ()> passes);
+	~MyDB_PageListFilterIteratorAlt ();
+
+private:
+
+	MyDB_RecordIteratorAltPtr myIter;
+	MyDB_RecordPtr myRec;
+	function <bool ()> passes;
+};
+
+#endif
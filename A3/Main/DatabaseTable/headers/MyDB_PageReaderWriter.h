@@ -14,6 +14,7 @@
 #define PAGE_RW_H
 
 #include <memory>
+#include "MyDB_BatchIterator.h"
 #include "MyDB_PageType.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
@@ -40,7 +41,10 @@ public:
 	MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager &parent);
 
 	// empties out the contents of this page, so that it has no records in it
-	// the type of the page is set to MyDB_PageType :: RegularPage
+	// the type of the page is set to MyDB_PageType :: RegularPage, unless the page
+	// belongs to a table whose file type is "pax" or "compressed", in which case it is
+	// set up as an empty MyDB_PageType :: PaxPage (compressed pages are only ever written
+	// whole; see MyDB_CompressedPage.h)
 	void clear ();	
 
 	// return an itrator over this page... each time returnVal->next () is
@@ -52,16 +56,21 @@ public:
 	// iterator that has the alternate getCurrent ()/advance () interface
 	MyDB_RecordIteratorAltPtr getIteratorAlt ();
 
+	// gets an iterator that loads the records on this page into a MyDB_RecordBatch, up
+	// to MAX_BATCH_SIZE records at a time
+	MyDB_BatchIteratorPtr getBatchIterator ();
+
 	// gets an instance of an alternatie iterator over a list of pages
 	friend MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs);
 
 	// appends a record to this page... return false is the append fails because
-	// there is not enough space on the page; otherwise, return true
+	// there is not enough space on the page (which is always the case for a compressed
+	// page); otherwise, return true
 	bool append (MyDB_RecordPtr appendMe);
 
 	// appends a record to this page... return a pointer to the location of where
 	// the record is written if there is enough space on the page; otherwise, return
-	// a nullptr
+	// a nullptr.  This cannot be used on a PAX or compressed page
 	void *appendAndReturnLocation (MyDB_RecordPtr appendMe);
 
 	// gets the type of this page... this is just a value from an ennumeration
@@ -74,10 +83,13 @@ public:
 	// sorts the contents of the page... the boolean lambda that is sent into
 	// this function must check to see if the contents of the record pointed to
 	// by lhs are less than the contens of the record pointed to by rhs... typically,
-	// this lambda would have been created via a call to buildRecordComparator
+	// this lambda would have been created via a call to buildRecordComparator.  This
+	// cannot be used on a compressed page, whose records might not fit on one regular page
 	MyDB_PageReaderWriterPtr sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
-	// like the above, except that the sorting is done in place, on the page
+	// like the above, except that the sorting is done in place, on the page... the records
+	// are copied into a per-thread scratch frame, their (offset, length) pairs are sorted, and
+	// the raw bytes are copied back, so no record is re-serialized and nothing is allocated
 	void sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
 	// returns the page size
@@ -86,10 +98,23 @@ public:
 	// returns the actual bytes
 	void *getBytes ();
 
+	// overwrites this page with a copy of the given page image (the bytes of a regular
+	// page that was put together somewhere else, say in memory outside of the buffer)
+	void copyFrom (void *image);
+
+	// the reverse of the above: copies this page into image (which has room for a page) as
+	// a regular page... the records on a PAX page are written out as rows.  A compressed
+	// page is copied as it is, since its records might not fit on a regular page (the copy
+	// can be decoded with MyDB_CompressedPage)
+	void copyTo (void *image);
+
 private:
 
 	// this is the page that we are messing with
 	MyDB_PageHandle myPage;	
+
+	// the schema, if this page is in a "pax" or "compressed" table; otherwise, nullptr
+	MyDB_SchemaPtr paxSchema;
 	
 	// this is our buffer manager
 	size_t pageSize;
@@ -0,0 +1,115 @@
+
+#ifndef PAX_PAGE_H
+#define PAX_PAGE_H
+
+#include "MyDB_Schema.h"
+#include <stddef.h>
+#include <vector>
+
+using namespace std;
+
+// A PAX page holds the same records as a regular page, but rather than storing each record
+// contiguously, it groups the values of each attribute together into a "minipage".  Ints,
+// doubles, and bools are stored as dense arrays with no length headers (so the i^th int in
+// a column is just at start + i * sizeof (int)), while strings keep their usual short length
+// header, and are stored back-to-back.  The records going in and coming out are in whichever
+// layout their schema uses (see MyDB_Schema.h).  The layout of the page is:
+//
+//	[page type = PaxPage][bytes the records would use on a regular page][num recs][num atts]
+//	[one MiniPage header per attribute] ... minipage 0 ... minipage 1 ... etc.
+//
+// The second slot is kept at the same place as NUM_BYTES_USED on a regular page, and a PAX
+// page never accepts a record that would not have fit on a regular page.  That way, the page
+// can always be turned back into a regular page (see toRows ()), which is how the sorts work
+// over PAX pages.  The record iterators (MyDB_PaxPageRecIterator and friends) do not need the
+// whole page as rows; they use a Cursor to put together one record at a time, straight from
+// the minipages.
+//
+// Since the space needed by each attribute is not known until records arrive, the minipages
+// start out empty; when an append overflows one of them, all of the minipages are moved so
+// that each gets a share of the free space proportional to what it is using.  This object
+// does not own the page; it just interprets the bytes given to it.
+class MyDB_PaxPage {
+
+public:
+
+	// interpret the given bytes as a PAX page
+	MyDB_PaxPage (void *bytes, size_t pageSize);
+
+	// lay out an empty PAX page for records with the given schema
+	void clear (MyDB_SchemaPtr mySchema);
+
+	// append the record whose binary (regular page) form is at fromHere; returns false if
+	// there is not enough room on the page
+	bool appendRow (void *fromHere);
+
+	// writes the records on this page, in order, as a regular page, into the page-sized
+	// buffer intoHere
+	void toRows (void *intoHere);
+
+	// where one record's values are: the offset (from the start of the page) of its value in
+	// each of the minipages, along with what is needed to put the record together as a row
+	// (the width of each value, or zero for a string), and the number of records on the page
+	struct Cursor {
+		vector <size_t> at;
+		vector <unsigned> widths;
+		bool fixedWidth;
+		size_t numRecs;
+		size_t whichRec;
+	};
+
+	// points the cursor at the first record on the page
+	void firstRow (Cursor &cur);
+
+	// writes the cursor's record as a row (as on a regular page) at intoHere, which must have
+	// room for it, and returns the row's size in bytes
+	size_t getRow (Cursor &cur, char *intoHere);
+
+	// moves the cursor on to the next record
+	void skipRow (Cursor &cur);
+
+	// the number of bytes that the records on this page would take up on a regular page
+	// (including the header), which is also the size of the page as rows
+	size_t getRowBytes ();
+
+	// the number of records on the page
+	size_t getNumRecs ();
+
+	// the start of the minipage for the given attribute
+	char *getColumn (int whichAtt);
+
+	// the number of bytes of each value in the given minipage; zero if the attribute is a
+	// string (and so each value has its own short length header)
+	unsigned getWidth (int whichAtt);
+
+private:
+
+	// the location and size of the minipage for one attribute
+	struct MiniPage {
+		unsigned start;
+		unsigned capacity;
+		unsigned used;
+		unsigned width;
+	};
+
+	// moves the minipages so that each one has room for its current contents, plus the number
+	// of bytes listed in adds; returns false if the page is not big enough for that
+	bool relayout (vector <unsigned> &adds);
+
+	// true if no attribute is a string, in which case the records use the fixed layout (see
+	// MyDB_Schema.h), and then the size of each of those records
+	bool isFixedWidth ();
+	size_t getFixedSize ();
+
+	// the header fields
+	size_t &numRowBytes ();
+	size_t &numRecs ();
+	size_t &numAtts ();
+	MiniPage *miniPages ();
+	size_t dataStart ();
+
+	char *bytes;
+	size_t pageSize;
+};
+
+#endif
@@ -0,0 +1,38 @@
+
+#ifndef PAX_PAGE_BATCH_ITER_H
+#define PAX_PAGE_BATCH_ITER_H
+
+#include "MyDB_BatchIterator.h"
+#include "MyDB_PageHandle.h"
+#include <vector>
+
+using namespace std;
+
+// a batch iterator over a PAX page... only the minipages for the attributes that the batch
+// decodes are ever touched, and ints, doubles, and bools are copied over a column at a time
+class MyDB_PaxPageBatchIterator : public MyDB_BatchIterator {
+
+public:
+
+	// loads the next run of records on the page into fillMe
+	bool getNextBatch (MyDB_RecordBatch &fillMe) override;
+
+	// destructor and contructor
+	MyDB_PaxPageBatchIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn);
+	~MyDB_PaxPageBatchIterator ();
+
+private:
+
+	// the number of records that have been put into batches so far
+	size_t recsConsumed;
+
+	// strings have to be walked one at a time; for each string attribute, this is the
+	// record we have walked to, and its offset from the start of the minipage
+	vector <size_t> stringRec;
+	vector <size_t> stringPos;
+
+	MyDB_PageHandle myPage;
+	size_t pageSize;
+};
+
+#endif
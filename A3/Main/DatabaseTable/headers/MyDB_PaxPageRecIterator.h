@@ -0,0 +1,51 @@
+
+#ifndef PAX_PAGE_REC_ITER_H
+#define PAX_PAGE_REC_ITER_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIterator.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// an iterator over the records on a PAX page... each record is put together as a row, straight
+// from the minipages, as it is loaded.  A record whose address is asked for is put into a copy
+// of the page as rows held by the iterator (which is only made if getCurrentPointer () is
+// called), so those addresses are good for as long as the iterator is around
+class MyDB_PaxPageRecIterator : public MyDB_RecordIterator {
+
+public:
+
+	// put the contents of the next record on the page into the iterator record
+	void getNext () override;
+
+	// return true iff there is another record on the page
+	bool hasNext () override;
+
+	// the address of the record that the next call to getNext () will load
+	void *getCurrentPointer () override;
+
+	// destructor and contructor
+	MyDB_PaxPageRecIterator (MyDB_PageHandle myPage, size_t pageSize, MyDB_RecordPtr myRecIn);
+	~MyDB_PaxPageRecIterator ();
+
+private:
+
+	// where the current record is on the page, and where it would be as a row
+	MyDB_PaxPage :: Cursor cur;
+	size_t rowOffset;
+
+	// the current record, as a row (room for any record on a page), and the page as rows (if
+	// it has been asked for)
+	unique_ptr <char []> row;
+	vector <char> rows;
+
+	MyDB_PageHandle myPage;
+	size_t pageSize;
+	MyDB_RecordPtr myRec;
+};
+
+#endif
@@ -0,0 +1,50 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_H
+#define PAX_PAGE_REC_ITER_ALT_H
+
+#include "MyDB_PageHandle.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+// the alternate iterator over the records on a PAX page... just as with
+// MyDB_PaxPageRecIterator, each record is put together from the minipages as it is loaded
+class MyDB_PaxPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+	// load the current record into the parameter
+	void getCurrent (MyDB_RecordPtr intoMe) override;
+
+	// the address of the current record, which is good for as long as the iterator is around
+	void *getCurrentPointer () override;
+
+	// advance to the next record... returns true if there is a next record, and false if
+	// there are no more records to iterate over
+	bool advance () override;
+
+	// destructor and contructor
+	MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPage, size_t pageSize);
+	~MyDB_PaxPageRecIteratorAlt ();
+
+private:
+
+	// where the current record is on the page, and where it would be as a row
+	MyDB_PaxPage :: Cursor cur;
+	size_t rowOffset;
+	int nextRecSize;
+
+	// the current record, as a row (room for any record on a page), and the page as rows (if
+	// it has been asked for)
+	unique_ptr <char []> row;
+	vector <char> rows;
+
+	MyDB_PageHandle myPage;
+	size_t pageSize;
+};
+
+#endif
@@ -0,0 +1,145 @@
+
+#ifndef RECORD_BATCH_H
+#define RECORD_BATCH_H
+
+#include <memory>
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// the largest number of records that a batch can hold
+#define MAX_BATCH_SIZE 1024
+
+class MyDB_RecordBatch;
+typedef shared_ptr <MyDB_RecordBatch> MyDB_RecordBatchPtr;
+
+// the type of the values held in one column of a batch
+enum MyDB_BatchColType {IntCol, DoubleCol, BoolCol, StringCol};
+
+// A batch holds up to MAX_BATCH_SIZE consecutive records from one page, decoded a column at a
+// time.  For each attribute that the batch decodes, there is an array with the offset of that
+// attribute's value inside of each record, and a typed array with the value itself.  This means
+// that an operator can run a tight loop (or a SIMD kernel) over, say, getIntColumn (0), rather
+// than pulling every record through a MyDB_Record and its attribute objects.  Batches are filled
+// by the iterators returned from MyDB_PageReaderWriter.getBatchIterator () and
+// MyDB_TableReaderWriter.getBatchIterator ().
+class MyDB_RecordBatch {
+
+public:
+
+	// creates a batch that decodes every attribute in the schema
+	MyDB_RecordBatch (MyDB_SchemaPtr mySchema);
+
+	// creates a batch that only decodes the listed attributes (given as positions in the
+	// schema); the other attributes are skipped over, and their columns are empty
+	MyDB_RecordBatch (MyDB_SchemaPtr mySchema, vector <int> whichAtts);
+
+	// the number of records in the batch
+	inline int size () {
+		return numRecs;
+	}
+
+	// true if no more records can be added to the batch
+	inline bool isFull () {
+		return numRecs == MAX_BATCH_SIZE;
+	}
+
+	// empties the batch
+	void clear ();
+
+	// the typed columns... whichAtt is the position of the attribute in the schema, and the
+	// attribute must have been decoded.  Entry i of the array holds the value from record i.
+	// Bools are stored as one char per record (1 for true, 0 for false)
+	inline int *getIntColumn (int whichAtt) {
+		return columns[whichAtt].ints.data ();
+	}
+
+	inline double *getDoubleColumn (int whichAtt) {
+		return columns[whichAtt].doubles.data ();
+	}
+
+	inline char *getBoolColumn (int whichAtt) {
+		return columns[whichAtt].bools.data ();
+	}
+
+	// strings are copied out of the page into a buffer owned by the batch; this returns the
+	// null-terminated value of the given attribute in the given record.  The pointer does not
+	// depend on the page, but it is only good until the batch is cleared or filled again
+	inline const char *getString (int whichAtt, int whichRec) {
+		return stringData.data () + columns[whichAtt].stringStarts[whichRec];
+	}
+
+	// the offset of the attribute's value from the start of each record; not set when the
+	// batch was filled from a PAX or compressed page
+	inline unsigned short *getOffsets (int whichAtt) {
+		return columns[whichAtt].offsets.data ();
+	}
+
+	// the type of the values in the given column
+	inline MyDB_BatchColType getColType (int whichAtt) {
+		return columns[whichAtt].type;
+	}
+
+	// true if the given attribute is decoded by this batch
+	inline bool isDecoded (int whichAtt) {
+		return columns[whichAtt].decoded;
+	}
+
+	// the address of the given record on its page.  At a later time, it is then possible to
+	// reconstitute the record by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING
+	// that the page that the record is located on has not been swapped out.  The batch
+	// iterators do not pin the pages that they read, so a page can be swapped out as soon as
+	// another page is brought into the buffer (say, by the next call to getNextBatch); the
+	// caller has to pin the page (MyDB_TableReaderWriter.getPinned) if the address is to be
+	// used after that.  Records on a PAX or compressed page are not stored contiguously, so for
+	// a batch filled from one of those, this is nullptr
+	inline void *getRecordPointer (int whichRec) {
+		return recPointers[whichRec];
+	}
+
+	// loads the given record from the batch into intoMe; as with getRecordPointer (), this
+	// assumes that the page has not been swapped out
+	void getRecord (int whichRec, MyDB_RecordPtr intoMe);
+
+	// decodes the record at the given address, and adds it to the end of the batch.  Returns
+	// the address just past the record.  Must not be called if the batch is full
+	void *addRecord (void *fromHere);
+
+	// like addRecord (), but for the n records stored back-to-back at fromHere, which must use
+	// the fixed layout (see MyDB_Schema.h)... they are decoded a column at a time.  There must
+	// be room in the batch for all of them
+	void *addRecords (void *fromHere, int n);
+
+	// the schema of the records in the batch
+	MyDB_SchemaPtr getSchema ();
+
+private:
+
+	friend class MyDB_CompressedPageBatchIterator;
+	friend class MyDB_PaxPageBatchIterator;
+
+	// all of the information about one attribute in the batch
+	struct Column {
+		MyDB_BatchColType type;
+		bool decoded;
+		vector <unsigned short> offsets;
+		vector <int> ints;
+		vector <double> doubles;
+		vector <char> bools;
+		vector <size_t> stringStarts;
+	};
+
+	// sets up the columns
+	void setUp (vector <int> &whichAtts);
+
+	MyDB_SchemaPtr mySchema;
+	vector <Column> columns;
+	vector <void *> recPointers;
+	vector <char> stringData;
+	int numRecs;
+};
+
+#endif
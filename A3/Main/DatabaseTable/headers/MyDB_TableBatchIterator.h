@@ -0,0 +1,30 @@
+
+#ifndef TABLE_BATCH_ITER_H
+#define TABLE_BATCH_ITER_H
+
+#include "MyDB_BatchIterator.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+
+class MyDB_TableBatchIterator : public MyDB_BatchIterator {
+
+public:
+
+	// loads the next run of records in the table into fillMe
+	bool getNextBatch (MyDB_RecordBatch &fillMe) override;
+
+	// destructor and contructor
+	MyDB_TableBatchIterator (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn);
+	MyDB_TableBatchIterator (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, int lowPage, int highPage);
+	~MyDB_TableBatchIterator ();
+
+private:
+
+	MyDB_BatchIteratorPtr myIter;
+	int curPage;
+	int highPage;
+	MyDB_TableReaderWriter &myParent;
+	MyDB_TablePtr myTable;
+};
+
+#endif
@@ -14,6 +14,7 @@
 #define TABLE_RW_H
 
 #include <memory>
+#include "MyDB_BatchIterator.h"
 #include "MyDB_BufferManager.h"
 #include "MyDB_Record.h"
 #include "MyDB_RecordIterator.h"
@@ -35,8 +36,9 @@ public:
 	// create a table reader/writer
 	MyDB_TableReaderWriter (MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
 
-	// gets an empty record from this table
-	MyDB_RecordPtr getEmptyRecord ();
+	// gets an empty record from this table... if there is an arena, the record is made in it
+	// (see MyDB_Arena.h)
+	MyDB_RecordPtr getEmptyRecord (MyDB_ArenaPtr arena = nullptr);
 
 	// append a record to the table
 	virtual void append (MyDB_RecordPtr appendMe);
@@ -55,11 +57,67 @@ public:
 	// highPage inclusive
 	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
 
+	// gets an iterator that loads the records in this table into a MyDB_RecordBatch, up
+	// to MAX_BATCH_SIZE records (all from the same page) at a time
+	MyDB_BatchIteratorPtr getBatchIterator ();
+
+	// like the above, but only iterates from lowPage through highPage inclusive
+	MyDB_BatchIteratorPtr getBatchIterator (int lowPage, int highPage);
+
+	// gets an empty batch for records from this table... if whichAtts is empty, the batch
+	// decodes every attribute; otherwise, it decodes only the named attributes
+	MyDB_RecordBatchPtr getEmptyBatch (vector <string> whichAtts = {});
+
+	// gets an iterator over the records whose value for the named attribute is in [low, high]
+	// (either bound can be nullptr, meaning that there is no bound on that side).  If the
+	// table has a zone map on the attribute, any page whose zone does not overlap the range
+	// is never read, so on a table sorted on the attribute, only the few pages that the range
+	// covers are read; otherwise, every page is read
+	MyDB_RecordIteratorAltPtr getRangeScanIteratorAlt (string att, MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// the pages that getRangeScanIteratorAlt would read for the same range
+	vector <int> getPagesInRange (string att, MyDB_AttValPtr low, MyDB_AttValPtr high);
+
+	// builds a zone map (the min and max value on each page) for the named attribute, with
+	// one pass over the table, and adds it to the table.  From then on, it is kept up to date
+	// as records are appended (so a table that is the output of sort () gets zone maps if
+	// they were added before the sort).  This only works for heap, PAX, and compressed files,
+	// since the other kinds of files move records around between pages
+	void addZoneMap (string att);
+
 	// load a text file into this table... this returns a pair where the first
-	// entry is a list of (approximate) distinct value counts for each of the
+	// entry is a list of (approximate, from HyperLogLog) distinct value counts for each of the
 	// attributes in the table, and the second entry is the number of tuples that
-	// have been loaded into the table
-	pair <vector <size_t>, size_t> loadFromTextFile (string fromMe);
+	// have been loaded into the table.  The file is read in large chunks, each chunk
+	// is cut up at line boundaries, and the pieces are parsed into pages in memory by
+	// numThreads threads (by default, one per core); the pages are then added onto the
+	// table in order, via appendImage ().  For a "compressed" table, the threads build
+	// compressed pages (see MyDB_CompressedPage.h) rather than regular ones, so the
+	// compression is done in parallel, too.  Once the records are in, the table's statistics
+	// are built with analyze (), unless buildStats is false.  The load rate, in MB/s, is
+	// printed out (this does not count the time to build the statistics, which is printed
+	// separately)
+	pair <vector <size_t>, size_t> loadFromTextFile (string fromMe, int numThreads = 0, bool buildStats = true);
+
+	// builds the statistics (null fraction, min/max, and an equi-depth histogram with
+	// numBuckets buckets) for each attribute, and puts them into the table... they come from
+	// a sample of about sampleSize records, made up of all of the records on pages picked
+	// at random, so only part of a big table is read.  This is done at the end of each
+	// loadFromTextFile (unless it is asked not to); after that, appends do not change the
+	// statistics
+	void analyze (size_t sampleSize = 30000, int numBuckets = 64);
+
+	// adds the records on the given page image (the bytes of a regular page that was
+	// put together in memory) onto the end of the table... for a heap file, the image
+	// is just copied onto a new last page; otherwise, the records are appended one at
+	// a time.  A compressed table also takes the image of a compressed page, which is
+	// copied onto a new last page; the pages appended after it are PAX pages
+	virtual void appendImage (void *image);
+
+	// empties out the table, so that it has no records in it... this is done before a
+	// text file is loaded.  After this, the table keeps statistics (a tuple count and a
+	// HyperLogLog sketch for each attribute) that are updated on every append
+	virtual void clear ();
 
 	// dump the contents of this table into a text file
 	void writeIntoTextFile (string toMe);
@@ -87,8 +145,24 @@ public:
 
 private:
 
+	// appends the records on the page image one at a time, via append ()
+	void appendImageRecords (void *image);
+
+	// the table's statistics (its tuple count and the sketches of its attributes) are
+	// reset when it is emptied out (along with the attribute statistics from analyze ()),
+	// and updated as records are appended... the updates only happen if the table has
+	// sketches
+	void clearStats ();
+	void addToStats (MyDB_RecordPtr appendMe);
+
+	// tells the table's zone maps that the given page has been emptied out, or that a
+	// record has been put onto it
+	void emptyZones (int whichPage);
+	void addToZones (int whichPage, MyDB_RecordPtr appendMe);
+
 	friend class MyDB_PageReaderWriter;
 	friend class MyDB_BPlusTreeReaderWriter;
+	friend class MyDB_HashReaderWriter;
 	MyDB_TablePtr forMe;
 	MyDB_BufferManagerPtr myBuffer;
 	shared_ptr <MyDB_PageReaderWriter> lastPage;
@@ -2,6 +2,7 @@
 #ifndef SORTING_H
 #define SORTING_H
 
+#include <cstdint>
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
@@ -13,6 +14,19 @@
 void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
         function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
+// like sort (), except that the sorted records are not written anywhere: the first phase of the
+// TPMMS is run over sortMe, and the returned iterator does the merge of the sorted runs as the
+// caller asks for records (see MyDB_MergeIteratorAlt), so the records come back in sorted order.
+// The iterator uses comparator, lhs, rhs, so the caller should not use lhs and rhs while iterating
+MyDB_RecordIteratorAltPtr buildIteratorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+        function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
+
+// like the above, except that the records to sort are on the list of anonymous pages sortMe
+// (whose pages are sorted in place), rather than in a table
+MyDB_RecordIteratorAltPtr buildIteratorOverSortedRuns (int runSize, MyDB_BufferManagerPtr parent,
+        vector <MyDB_PageReaderWriter> &sortMe, function <bool ()> comparator, MyDB_RecordPtr lhs,
+        MyDB_RecordPtr rhs);
+
 // helper function.  Gets two iterators, leftIter and rightIter.  It is assumed that these are iterators over
 // sorted lists of records.  This function then merges all of those records into a list of anonymous pages,
 // and returns the list of anonymous pages to the caller.  The resulting list of anonymous pages is sorted.
@@ -23,8 +37,18 @@ vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB
 // accepts a list of iterators called mergeUs.  It is assumed that these are all iterators over sorted lists
 // of records.  This function then merges all of those records and appends them to the file sortIntoMe.  If
 // all of the iterators are over sorted lists of records, then all of the records appended onto the end of
-// sortIntoMe will be sorted.  Comparisons are performed using comparator, lhs, rhs
+// sortIntoMe will be sorted.  Comparisons are performed using comparator, lhs, rhs.  At most
+// limit records are appended; the merge stops as soon as that many have been written
 void mergeIntoFile (MyDB_TableReaderWriter &sortIntoMe, vector <MyDB_RecordIteratorAltPtr> &mergeUs,
+        function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs, size_t limit = SIZE_MAX);
+
+// like sort (), except that only the first k records in sorted order are written to sortIntoMe.
+// The k smallest records seen so far are kept in a bounded heap whose records live in at most
+// runSize pinned anonymous pages, so a single pass over sortMe is all that is needed and nothing
+// is spilled.  Records that do not beat the current k^th record are rejected with one comparison
+// and never copied.  If the k records do not fit into runSize pages, this falls back to a TPMMS
+// whose final merge stops after k records.  Comparisons are performed using comparator, lhs, rhs
+void sortTopK (size_t k, int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe,
         function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
 #endif
@@ -0,0 +1,245 @@
+
+#ifndef BATCH_FILTER_C
+#define BATCH_FILTER_C
+
+#include <algorithm>
+#include "MyDB_BatchFilter.h"
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+
+static char *findsymbol (char val, char *input) {
+	while (*input != val) {
+		input++;
+	}
+	return input + 1;
+}
+
+static void skipSpace (char * &vals) {
+	while (*vals == ' ' || *vals == '\t' || *vals == '\n')
+		vals++;
+}
+
+// moves past one complete expression (an attribute, a constant, or an operation and its
+// parenthesized arguments), without compiling it
+static void skipExpr (char * &vals) {
+	int depth = 0;
+	while (*vals != 0) {
+		if (*vals == '[') {
+			vals = findsymbol (']', vals);
+			if (depth == 0)
+				return;
+			continue;
+		}
+		if (*vals == '(') {
+			depth++;
+		} else if (*vals == ')') {
+			depth--;
+			if (depth == 0) {
+				vals++;
+				return;
+			}
+		}
+		vals++;
+	}
+}
+
+MyDB_BatchFilter :: MyDB_BatchFilter (MyDB_SchemaPtr mySchemaIn, string predicate) {
+	mySchema = mySchemaIn;
+	char *str = (char *) predicate.c_str ();
+	root = compile (str);
+}
+
+vector <int> MyDB_BatchFilter :: getNeededAtts () {
+	return neededAtts;
+}
+
+MyDB_BatchFilter :: Operand MyDB_BatchFilter :: parseOperand (char * &vals) {
+
+	Operand result;
+	result.isAtt = false;
+	result.isConst = false;
+	result.isDouble = false;
+	result.att = -1;
+	result.val = 0;
+
+	skipSpace (vals);
+	if (vals[0] == '[') {
+		char *start = vals + 1;
+		vals = findsymbol (']', vals);
+		auto whichAtt = mySchema->getAttByName (string (start, vals - 1 - start));
+
+		// only numeric attributes can go through the kernels
+		if (whichAtt.first >= 0 && !whichAtt.second->isBool () && whichAtt.second->promotableToDouble ()) {
+			result.isAtt = true;
+			result.att = whichAtt.first;
+			result.isDouble = !whichAtt.second->promotableToInt ();
+		}
+
+	} else if (strncmp (vals, "int", 3) == 0) {
+		vals = findsymbol ('[', vals);
+		result.isConst = true;
+		result.val = stoi (vals);
+		vals = findsymbol (']', vals);
+
+	} else if (strncmp (vals, "double", 6) == 0) {
+		vals = findsymbol ('[', vals);
+		result.isConst = true;
+		result.isDouble = true;
+		result.val = stod (vals);
+		vals = findsymbol (']', vals);
+
+	} else {
+		skipExpr (vals);
+	}
+	return result;
+}
+
+int MyDB_BatchFilter :: rowByRow (char *from, char *to) {
+	Node result;
+	result.kind = RowByRow;
+	result.expr = make_shared <MyDB_TypedExpr> (mySchema, string (from, to - from));
+	if (result.expr->getType () != BoolExpr) {
+		cout << "This is bad... a filter must be a boolean.\n";
+		exit (1);
+	}
+	allNodes.push_back (result);
+	return allNodes.size () - 1;
+}
+
+int MyDB_BatchFilter :: compile (char * &vals) {
+
+	skipSpace (vals);
+	char *begin = vals;
+	Node result;
+	result.scratch.resize (BITMAP_WORDS (MAX_BATCH_SIZE));
+
+	// and and or
+	if ((vals[0] == '&' && vals[1] == '&') || (vals[0] == '|' && vals[1] == '|')) {
+		result.kind = (vals[0] == '&') ? AndNode : OrNode;
+		vals = findsymbol ('(', vals);
+		result.lhs = compile (vals);
+		vals = findsymbol (',', vals);
+		result.rhs = compile (vals);
+		vals = findsymbol (')', vals);
+
+	// the comparisons
+	} else if ((vals[0] == '!' && vals[1] == '=') || (vals[0] == '=' && vals[1] == '=') || vals[0] == '<' || vals[0] == '>') {
+		result.op = (vals[0] == '!') ? NotEqualTo : (vals[0] == '=') ? EqualTo : (vals[0] == '<') ? LessThan : GreaterThan;
+		vals = findsymbol ('(', vals);
+		Operand lhs = parseOperand (vals);
+		vals = findsymbol (',', vals);
+		Operand rhs = parseOperand (vals);
+		vals = findsymbol (')', vals);
+
+		// put the attribute on the left, if there is one
+		if (lhs.isConst && rhs.isAtt) {
+			swap (lhs, rhs);
+			if (result.op == LessThan)
+				result.op = GreaterThan;
+			else if (result.op == GreaterThan)
+				result.op = LessThan;
+		}
+
+		// an int attribute against an int constant, or a double attribute against any number
+		if (lhs.isAtt && rhs.isConst && (lhs.isDouble || !rhs.isDouble)) {
+			result.kind = AttConst;
+			result.isDouble = lhs.isDouble;
+			result.lhsAtt = lhs.att;
+			result.intConst = (int) rhs.val;
+			result.doubleConst = rhs.val;
+
+		// or two attributes of the same type
+		} else if (lhs.isAtt && rhs.isAtt && lhs.isDouble == rhs.isDouble) {
+			result.kind = AttAtt;
+			result.isDouble = lhs.isDouble;
+			result.lhsAtt = lhs.att;
+			result.rhsAtt = rhs.att;
+
+		} else {
+			return rowByRow (begin, vals);
+		}
+
+		neededAtts.push_back (result.lhsAtt);
+		if (result.kind == AttAtt)
+			neededAtts.push_back (result.rhsAtt);
+		sort (neededAtts.begin (), neededAtts.end ());
+		neededAtts.erase (unique (neededAtts.begin (), neededAtts.end ()), neededAtts.end ());
+
+	// not
+	} else if (vals[0] == '!') {
+		result.kind = NotNode;
+		vals = findsymbol ('(', vals);
+		result.lhs = compile (vals);
+		vals = findsymbol (')', vals);
+
+	// anything else is done a record at a time
+	} else {
+		skipExpr (vals);
+		return rowByRow (begin, vals);
+	}
+
+	allNodes.push_back (result);
+	return allNodes.size () - 1;
+}
+
+void MyDB_BatchFilter :: run (int whichNode, MyDB_RecordBatch &batch, uint64_t *bits) {
+
+	Node &node = allNodes[whichNode];
+	int n = batch.size ();
+	switch (node.kind) {
+	case AttConst:
+	case AttAtt:
+		if (!batch.isDecoded (node.lhsAtt) || (node.kind == AttAtt && !batch.isDecoded (node.rhsAtt))) {
+			cout << "This is bad... the batch does not have the attributes that the filter needs.\n";
+			exit (1);
+		}
+		if (node.kind == AttConst && node.isDouble)
+			compareDoubles (batch.getDoubleColumn (node.lhsAtt), n, node.op, node.doubleConst, bits);
+		else if (node.kind == AttConst)
+			compareInts (batch.getIntColumn (node.lhsAtt), n, node.op, node.intConst, bits);
+		else if (node.isDouble)
+			compareDoubleColumns (batch.getDoubleColumn (node.lhsAtt), batch.getDoubleColumn (node.rhsAtt), n, node.op, bits);
+		else
+			compareIntColumns (batch.getIntColumn (node.lhsAtt), batch.getIntColumn (node.rhsAtt), n, node.op, bits);
+		break;
+
+	case AndNode:
+		run (node.lhs, batch, bits);
+		run (node.rhs, batch, node.scratch.data ());
+		andBitmaps (bits, node.scratch.data (), n);
+		break;
+
+	case OrNode:
+		run (node.lhs, batch, bits);
+		run (node.rhs, batch, node.scratch.data ());
+		orBitmaps (bits, node.scratch.data (), n);
+		break;
+
+	case NotNode:
+		run (node.lhs, batch, bits);
+		notBitmap (bits, n);
+		break;
+
+	case RowByRow:
+		memset (bits, 0, BITMAP_WORDS (n) * sizeof (uint64_t));
+		for (int i = 0; i < n; i++) {
+			void *rec = batch.getRecordPointer (i);
+			if (rec == nullptr) {
+				cout << "This is bad... this filter needs the records, and this batch does not have them.\n";
+				exit (1);
+			}
+			if (node.expr->evalBool (rec))
+				bits[i >> 6] |= ((uint64_t) 1) << (i & 63);
+		}
+		break;
+	}
+}
+
+int MyDB_BatchFilter :: apply (MyDB_RecordBatch &batch, uint64_t *bits) {
+	run (root, batch, bits);
+	return countBitmap (bits, batch.size ());
+}
+
+#endif
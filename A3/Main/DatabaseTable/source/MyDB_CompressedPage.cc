@@ -0,0 +1,629 @@
+
+#ifndef COMPRESSED_PAGE_C
+#define COMPRESSED_PAGE_C
+
+#include "MyDB_CompressedPage.h"
+#include "MyDB_DecodeKernels.h"
+#include "MyDB_PageType.h"
+#include <algorithm>
+#include <iostream>
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+
+using namespace std;
+
+// rounds up to a multiple of eight bytes, so that every column starts on an aligned address
+#define ALIGN8(x) ((((size_t) (x)) + 7) & ~((size_t) 7))
+
+// a dictionary never has more entries than a 2 byte code can pick out
+#define MAX_DICT_ENTRIES 65536
+
+// the number of bytes needed for codes that go up to maxCode
+static unsigned codeWidth (uint64_t maxCode) {
+	if (maxCode < 256)
+		return 1;
+	if (maxCode < 65536)
+		return 2;
+	return 4;
+}
+
+static void putCode (char *codes, unsigned width, size_t i, unsigned code) {
+	if (width == 1)
+		((unsigned char *) codes)[i] = (unsigned char) code;
+	else if (width == 2)
+		((unsigned short *) codes)[i] = (unsigned short) code;
+	else
+		((unsigned *) codes)[i] = code;
+}
+
+static unsigned readCode (const char *codes, unsigned width, size_t i) {
+	if (width == 1)
+		return ((const unsigned char *) codes)[i];
+	if (width == 2)
+		return ((const unsigned short *) codes)[i];
+	return ((const unsigned *) codes)[i];
+}
+
+// the number of bytes in each value of the given type (zero for a string)
+static unsigned valueWidth (MyDB_BatchColType type) {
+	switch (type) {
+	case IntCol: return sizeof (int);
+	case DoubleCol: return sizeof (double);
+	case BoolCol: return sizeof (char);
+	default: return 0;
+	}
+}
+
+// the size of a dictionary encoded column with n records and d distinct values, whose
+// values take up entryBytes when they are stored plainly
+static size_t dictSize (size_t n, size_t d, size_t entryBytes, bool isString) {
+	return ALIGN8 (n * codeWidth (d - 1)) + (isString ? sizeof (unsigned) * d : 0) + entryBytes;
+}
+
+// where the records start, for a page with the given number of attributes
+static size_t dataStartFor (size_t numAtts, size_t headerSize) {
+	return ALIGN8 (5 * sizeof (size_t) + numAtts * headerSize);
+}
+
+MyDB_CompressedPage :: MyDB_CompressedPage (void *bytesIn, size_t pageSizeIn) {
+	bytes = (char *) bytesIn;
+	pageSize = pageSizeIn;
+}
+
+size_t &MyDB_CompressedPage :: rowBytes () {
+	return *((size_t *) (bytes + sizeof (size_t)));
+}
+
+size_t &MyDB_CompressedPage :: numRecs () {
+	return *((size_t *) (bytes + 2 * sizeof (size_t)));
+}
+
+size_t &MyDB_CompressedPage :: numAtts () {
+	return *((size_t *) (bytes + 3 * sizeof (size_t)));
+}
+
+size_t &MyDB_CompressedPage :: bytesUsed () {
+	return *((size_t *) (bytes + 4 * sizeof (size_t)));
+}
+
+MyDB_CompressedPage :: ColumnHeader *MyDB_CompressedPage :: columns () {
+	return (ColumnHeader *) (bytes + 5 * sizeof (size_t));
+}
+
+size_t MyDB_CompressedPage :: dataStart () {
+	return dataStartFor (numAtts (), sizeof (ColumnHeader));
+}
+
+size_t MyDB_CompressedPage :: getNumRecs () {
+	return numRecs ();
+}
+
+size_t MyDB_CompressedPage :: getNumAtts () {
+	return numAtts ();
+}
+
+size_t MyDB_CompressedPage :: getBytesUsed () {
+	return bytesUsed ();
+}
+
+size_t MyDB_CompressedPage :: getRowBytes () {
+	return rowBytes ();
+}
+
+MyDB_ColumnEncoding MyDB_CompressedPage :: getEncoding (int whichAtt) {
+	return (MyDB_ColumnEncoding) columns ()[whichAtt].encoding;
+}
+
+char *MyDB_CompressedPage :: getEntries (ColumnHeader &col) {
+	if (col.encoding == RunLength)
+		return bytes + col.start + ALIGN8 (col.numEntries * sizeof (unsigned));
+	return bytes + col.start + ALIGN8 (numRecs () * col.codeWidth);
+}
+
+void MyDB_CompressedPage :: seekRun (ColumnHeader &col, size_t whichRec, Cursor &cur) {
+
+	// start over if we have to go backwards
+	if (whichRec < cur.rec) {
+		cur.run = 0;
+		cur.pos = 0;
+	}
+
+	// the string of each run is walked past to get to the next one
+	unsigned *runEnds = (unsigned *) (bytes + col.start);
+	char *values = getEntries (col);
+	while (runEnds[cur.run] <= whichRec) {
+		if (col.width == 0)
+			cur.pos += *((short *) (values + cur.pos));
+		cur.run++;
+	}
+	cur.rec = whichRec;
+}
+
+void MyDB_CompressedPage :: getInts (int whichAtt, size_t from, size_t n, int *into, Cursor &cur) {
+
+	if (n == 0)
+		return;
+	ColumnHeader &col = columns ()[whichAtt];
+	char *data = bytes + col.start;
+	switch (col.encoding) {
+	case PlainEncoding:
+		memcpy (into, data + from * sizeof (int), n * sizeof (int));
+		break;
+
+	case FrameOfReference:
+		unpackInts (data + from * col.codeWidth, col.codeWidth, col.base, n, into);
+		break;
+
+	case DeltaEncoding:
+
+		// the i^th code is the difference between values i - 1 and i, so to start anywhere
+		// other than where the last call left off, we have to add up the differences
+		if (from == 0) {
+			into[0] = col.base;
+			unpackInts (data + col.codeWidth, col.codeWidth, col.step, n - 1, into + 1);
+			prefixSumInts (into + 1, n - 1, col.base);
+		} else {
+			if (cur.rec == 0 || cur.rec > from) {
+				cur.rec = 1;
+				cur.last = col.base;
+			}
+			for (; cur.rec < from; cur.rec++)
+				cur.last = (int) ((unsigned) cur.last + (unsigned) col.step + readCode (data, col.codeWidth, cur.rec));
+			unpackInts (data + from * col.codeWidth, col.codeWidth, col.step, n, into);
+			prefixSumInts (into, n, cur.last);
+		}
+		cur.rec = from + n;
+		cur.last = into[n - 1];
+		break;
+
+	case RunLength: {
+		seekRun (col, from, cur);
+		unsigned *runEnds = (unsigned *) data;
+		int *values = (int *) getEntries (col);
+		for (size_t i = 0; i < n; ) {
+			size_t end = min ((size_t) runEnds[cur.run] - from, n);
+			fill (into + i, into + end, values[cur.run]);
+			i = end;
+			if (i < n)
+				seekRun (col, from + i, cur);
+		}
+		break;
+	}
+
+	case Dictionary:
+		lookUpInts (data + from * col.codeWidth, col.codeWidth, (int *) getEntries (col), n, into);
+		break;
+	}
+}
+
+void MyDB_CompressedPage :: getDoubles (int whichAtt, size_t from, size_t n, double *into, Cursor &cur) {
+
+	if (n == 0)
+		return;
+	ColumnHeader &col = columns ()[whichAtt];
+	char *data = bytes + col.start;
+	switch (col.encoding) {
+	case RunLength: {
+		seekRun (col, from, cur);
+		unsigned *runEnds = (unsigned *) data;
+		double *values = (double *) getEntries (col);
+		for (size_t i = 0; i < n; ) {
+			size_t end = min ((size_t) runEnds[cur.run] - from, n);
+			fill (into + i, into + end, values[cur.run]);
+			i = end;
+			if (i < n)
+				seekRun (col, from + i, cur);
+		}
+		break;
+	}
+
+	case Dictionary:
+		lookUpDoubles (data + from * col.codeWidth, col.codeWidth, (double *) getEntries (col), n, into);
+		break;
+
+	default:
+		memcpy (into, data + from * sizeof (double), n * sizeof (double));
+		break;
+	}
+}
+
+void MyDB_CompressedPage :: getBools (int whichAtt, size_t from, size_t n, char *into, Cursor &cur) {
+
+	if (n == 0)
+		return;
+	ColumnHeader &col = columns ()[whichAtt];
+	char *data = bytes + col.start;
+	if (col.encoding == RunLength) {
+		seekRun (col, from, cur);
+		unsigned *runEnds = (unsigned *) data;
+		char *values = getEntries (col);
+		for (size_t i = 0; i < n; ) {
+			size_t end = min ((size_t) runEnds[cur.run] - from, n);
+			fill (into + i, into + end, (char) (values[cur.run] == 1));
+			i = end;
+			if (i < n)
+				seekRun (col, from + i, cur);
+		}
+	} else {
+		for (size_t i = 0; i < n; i++)
+			into[i] = (data[from + i] == 1);
+	}
+}
+
+void MyDB_CompressedPage :: getStrings (int whichAtt, size_t from, size_t n, char **into, Cursor &cur) {
+
+	if (n == 0)
+		return;
+	ColumnHeader &col = columns ()[whichAtt];
+	char *data = bytes + col.start;
+	switch (col.encoding) {
+	case RunLength: {
+		seekRun (col, from, cur);
+		unsigned *runEnds = (unsigned *) data;
+		char *values = getEntries (col);
+		for (size_t i = 0; i < n; ) {
+			size_t end = min ((size_t) runEnds[cur.run] - from, n);
+			fill (into + i, into + end, values + cur.pos);
+			i = end;
+			if (i < n)
+				seekRun (col, from + i, cur);
+		}
+		break;
+	}
+
+	case Dictionary: {
+		unsigned *entryStarts = (unsigned *) getEntries (col);
+		char *entries = (char *) (entryStarts + col.numEntries);
+		for (size_t i = 0; i < n; i++)
+			into[i] = entries + entryStarts[readCode (data + from * col.codeWidth, col.codeWidth, i)];
+		break;
+	}
+
+	default:
+
+		// the strings are back-to-back, so they have to be walked
+		if (cur.rec > from) {
+			cur.rec = 0;
+			cur.pos = 0;
+		}
+		for (; cur.rec < from; cur.rec++)
+			cur.pos += *((short *) (data + cur.pos));
+		for (size_t i = 0; i < n; i++) {
+			into[i] = data + cur.pos;
+			cur.pos += *((short *) (data + cur.pos));
+		}
+		cur.rec += n;
+		break;
+	}
+}
+
+void MyDB_CompressedPage :: toRows (vector <char> &intoHere) {
+
+	// decode each of the columns... every kind of value fits in eight bytes
+	static thread_local vector <vector <char>> decoded;
+	size_t n = numRecs ();
+	size_t atts = numAtts ();
+	ColumnHeader *cols = columns ();
+	decoded.resize (atts);
+	for (size_t i = 0; i < atts; i++) {
+		decoded[i].resize (n * sizeof (double));
+		Cursor cur;
+		if (cols[i].width == sizeof (int))
+			getInts (i, 0, n, (int *) decoded[i].data (), cur);
+		else if (cols[i].width == sizeof (double))
+			getDoubles (i, 0, n, (double *) decoded[i].data (), cur);
+		else if (cols[i].width == sizeof (char))
+			getBools (i, 0, n, decoded[i].data (), cur);
+		else
+			getStrings (i, 0, n, (char **) decoded[i].data (), cur);
+	}
+
+	if (intoHere.size () < rowBytes ())
+		intoHere.resize (rowBytes ());
+	char *out = intoHere.data ();
+	*((MyDB_PageType *) out) = MyDB_PageType :: RegularPage;
+	*((size_t *) (out + sizeof (size_t))) = rowBytes ();
+	char *pos = out + 2 * sizeof (size_t);
+
+	// if no attribute is a string, the records use the fixed layout (see MyDB_Schema.h), and
+	// are just their values
+	bool fixed = (atts > 0);
+	for (size_t i = 0; i < atts; i++)
+		fixed = fixed && cols[i].width != 0;
+	if (fixed) {
+		for (size_t r = 0; r < n; r++) {
+			for (size_t i = 0; i < atts; i++) {
+				memcpy (pos, decoded[i].data () + r * cols[i].width, cols[i].width);
+				pos += cols[i].width;
+			}
+		}
+		return;
+	}
+
+	// otherwise, stitch each record back together from its values
+	for (size_t r = 0; r < n; r++) {
+		char *recStart = pos;
+		pos += sizeof (short);
+		for (size_t i = 0; i < atts; i++) {
+			unsigned width = cols[i].width;
+			if (width) {
+				*((short *) pos) = (short) (sizeof (short) + width);
+				memcpy (pos + sizeof (short), decoded[i].data () + r * width, width);
+				pos += sizeof (short) + width;
+			} else {
+				char *val = ((char **) decoded[i].data ())[r];
+				short len = *((short *) val);
+				memcpy (pos, val, len);
+				pos += len;
+			}
+		}
+		*((short *) recStart) = (short) (pos - recStart);
+	}
+}
+
+MyDB_CompressedPageBuilder :: MyDB_CompressedPageBuilder (MyDB_SchemaPtr mySchema, size_t pageSizeIn) {
+	pageSize = pageSizeIn;
+	fixedSize = mySchema->isFixedWidth () ? mySchema->getFixedSize () : 0;
+	for (auto &att : mySchema->getAtts ()) {
+		if (att.second->isBool ())
+			types.push_back (BoolCol);
+		else if (att.second->promotableToInt ())
+			types.push_back (IntCol);
+		else if (att.second->promotableToDouble ())
+			types.push_back (DoubleCol);
+		else
+			types.push_back (StringCol);
+	}
+	stats.resize (types.size ());
+}
+
+size_t MyDB_CompressedPageBuilder :: getNumRecs () {
+	return recStarts.size ();
+}
+
+bool MyDB_CompressedPageBuilder :: add (void *fromHere) {
+
+	// find the value of each attribute, and see how big its column would be with it
+	static thread_local vector <string> keys;
+	static thread_local vector <bool> isNew;
+	char *rec = (char *) fromHere;
+	size_t n = recStarts.size () + 1;
+	size_t total = dataStartFor (types.size (), sizeof (MyDB_CompressedPage :: ColumnHeader));
+	keys.resize (types.size ());
+	isNew.resize (types.size ());
+	char *pos = fixedSize ? rec : rec + sizeof (short);
+	for (size_t i = 0; i < types.size (); i++) {
+		unsigned width = valueWidth (types[i]);
+		unsigned len = fixedSize ? width : *((short *) pos);
+		if (fixedSize)
+			keys[i].assign (pos, width);
+		else if (width)
+			keys[i].assign (pos + sizeof (short), width);
+		else
+			keys[i].assign (pos, len);
+		pos += len;
+
+		ColumnStats &col = stats[i];
+		size_t smallest = col.plainBytes + keys[i].size ();
+		if (types[i] == IntCol) {
+			int val = *((int *) keys[i].data ());
+			int low = (n == 1) ? val : min (col.minInt, val);
+			int high = (n == 1) ? val : max (col.maxInt, val);
+			smallest = min (smallest, n * codeWidth ((unsigned) high - (unsigned) low));
+		}
+		isNew[i] = !col.tooMany && col.distinct.count (keys[i]) == 0;
+		size_t numDistinct = col.distinct.size () + (isNew[i] ? 1 : 0);
+		if (types[i] != BoolCol && !col.tooMany && numDistinct <= MAX_DICT_ENTRIES) {
+			size_t entryBytes = col.distinctBytes + (isNew[i] ? keys[i].size () : 0);
+			smallest = min (smallest, dictSize (n, numDistinct, entryBytes, width == 0));
+		}
+		total += ALIGN8 (smallest);
+	}
+	if (total > pageSize)
+		return false;
+
+	// it fits, so remember the record and update the statistics
+	for (size_t i = 0; i < types.size (); i++) {
+		ColumnStats &col = stats[i];
+		col.plainBytes += keys[i].size ();
+		if (types[i] == IntCol) {
+			int val = *((int *) keys[i].data ());
+			col.minInt = (n == 1) ? val : min (col.minInt, val);
+			col.maxInt = (n == 1) ? val : max (col.maxInt, val);
+		}
+		if (isNew[i]) {
+			col.distinct.insert (keys[i]);
+			col.distinctBytes += keys[i].size ();
+			if (col.distinct.size () > MAX_DICT_ENTRIES) {
+				col.tooMany = true;
+				col.distinct.clear ();
+			}
+		}
+	}
+	size_t recSize = fixedSize ? fixedSize : *((short *) rec);
+	recStarts.push_back (rows.size ());
+	rows.insert (rows.end (), rec, rec + recSize);
+	return true;
+}
+
+void MyDB_CompressedPageBuilder :: write (void *intoHere) {
+
+	size_t n = recStarts.size ();
+	size_t atts = types.size ();
+	MyDB_CompressedPage page (intoHere, pageSize);
+	*((MyDB_PageType *) intoHere) = MyDB_PageType :: CompressedPage;
+	page.rowBytes () = 2 * sizeof (size_t) + rows.size ();
+	page.numRecs () = n;
+	page.numAtts () = atts;
+
+	// find each record's values... vals[i * n + r] is the value of attribute i in record r,
+	// and lens has its length
+	static thread_local vector <char *> vals;
+	static thread_local vector <unsigned> lens;
+	vals.resize (n * atts);
+	lens.resize (n * atts);
+	for (size_t r = 0; r < n; r++) {
+		char *pos = rows.data () + recStarts[r] + (fixedSize ? 0 : sizeof (short));
+		for (size_t i = 0; i < atts; i++) {
+			unsigned width = valueWidth (types[i]);
+			unsigned len = fixedSize ? width : *((short *) pos);
+			vals[i * n + r] = (width && !fixedSize) ? pos + sizeof (short) : pos;
+			lens[i * n + r] = width ? width : len;
+			pos += len;
+		}
+	}
+
+	size_t start = page.dataStart ();
+	for (size_t i = 0; i < atts; i++) {
+		char **v = vals.data () + i * n;
+		unsigned *l = lens.data () + i * n;
+		unsigned width = valueWidth (types[i]);
+
+		// gather the statistics for the column: the runs, the distinct values (in the order
+		// that they first appear), and for ints, the range of the values and of the differences
+		size_t plainBytes = 0, runs = 0, runBytes = 0, distinctBytes = 0;
+		unordered_map <string, unsigned> dict;
+		vector <size_t> firstSeen;
+		int low = 0, high = 0;
+		int64_t lowDelta = 0, highDelta = 0;
+		for (size_t r = 0; r < n; r++) {
+			plainBytes += l[r];
+			if (r == 0 || l[r] != l[r - 1] || memcmp (v[r], v[r - 1], l[r]) != 0) {
+				runs++;
+				runBytes += l[r];
+			}
+			if (dict.size () <= MAX_DICT_ENTRIES && types[i] != BoolCol) {
+				auto added = dict.insert (make_pair (string (v[r], l[r]), (unsigned) dict.size ()));
+				if (added.second) {
+					firstSeen.push_back (r);
+					distinctBytes += l[r];
+				}
+			}
+			if (types[i] == IntCol) {
+				int val = *((int *) v[r]);
+				low = (r == 0) ? val : min (low, val);
+				high = (r == 0) ? val : max (high, val);
+				if (r > 0) {
+					int64_t delta = (int64_t) val - *((int *) v[r - 1]);
+					lowDelta = (r == 1) ? delta : min (lowDelta, delta);
+					highDelta = (r == 1) ? delta : max (highDelta, delta);
+				}
+			}
+		}
+
+		// and pick the encoding that is the smallest... on a tie, the one that comes first
+		// here, since it is cheaper to decode
+		MyDB_ColumnEncoding best = PlainEncoding;
+		size_t bestSize = plainBytes;
+		unsigned forWidth = codeWidth ((unsigned) high - (unsigned) low);
+		unsigned deltaWidth = codeWidth (min ((uint64_t) (highDelta - lowDelta), (uint64_t) 0xFFFFFFFF));
+		unsigned dictWidth = codeWidth (dict.size () - 1);
+		if (types[i] == IntCol && n * forWidth < bestSize) {
+			best = FrameOfReference;
+			bestSize = n * forWidth;
+		}
+		if (types[i] == IntCol && n * deltaWidth < bestSize) {
+			best = DeltaEncoding;
+			bestSize = n * deltaWidth;
+		}
+		if (types[i] != BoolCol && dict.size () <= MAX_DICT_ENTRIES &&
+			dictSize (n, dict.size (), distinctBytes, width == 0) < bestSize) {
+			best = Dictionary;
+			bestSize = dictSize (n, dict.size (), distinctBytes, width == 0);
+		}
+		if (ALIGN8 (runs * sizeof (unsigned)) + runBytes < bestSize) {
+			best = RunLength;
+			bestSize = ALIGN8 (runs * sizeof (unsigned)) + runBytes;
+		}
+
+		if (start + bestSize > pageSize) {
+			cout << "This is bad... the records on a compressed page did not fit.\n";
+			exit (1);
+		}
+
+		// now write out the column
+		MyDB_CompressedPage :: ColumnHeader &col = page.columns ()[i];
+		col.start = start;
+		col.encoding = best;
+		col.width = width;
+		col.codeWidth = 0;
+		col.numEntries = 0;
+		col.base = 0;
+		col.step = 0;
+		col.unused = 0;
+		char *out = (char *) intoHere + start;
+		switch (best) {
+		case PlainEncoding:
+			for (size_t r = 0; r < n; r++) {
+				memcpy (out, v[r], l[r]);
+				out += l[r];
+			}
+			break;
+
+		case FrameOfReference:
+			col.codeWidth = forWidth;
+			col.base = low;
+			for (size_t r = 0; r < n; r++)
+				putCode (out, forWidth, r, (unsigned) *((int *) v[r]) - (unsigned) low);
+			break;
+
+		case DeltaEncoding:
+			col.codeWidth = deltaWidth;
+			col.base = *((int *) v[0]);
+			col.step = (int) lowDelta;
+			putCode (out, deltaWidth, 0, 0);
+			for (size_t r = 1; r < n; r++)
+				putCode (out, deltaWidth, r, (unsigned) *((int *) v[r]) - (unsigned) *((int *) v[r - 1]) - (unsigned) col.step);
+			break;
+
+		case RunLength: {
+			col.numEntries = runs;
+			unsigned *runEnds = (unsigned *) out;
+			char *values = page.getEntries (col);
+			size_t run = 0;
+			for (size_t r = 0; r < n; r++) {
+				if (r == 0 || l[r] != l[r - 1] || memcmp (v[r], v[r - 1], l[r]) != 0) {
+					if (r > 0)
+						runEnds[run++] = r;
+					memcpy (values, v[r], l[r]);
+					values += l[r];
+				}
+			}
+			runEnds[run] = n;
+			break;
+		}
+
+		case Dictionary: {
+			col.codeWidth = dictWidth;
+			col.numEntries = dict.size ();
+			for (size_t r = 0; r < n; r++)
+				putCode (out, dictWidth, r, dict[string (v[r], l[r])]);
+
+			// strings need to be found by their code, so there is a list of where they start
+			char *entries = page.getEntries (col);
+			unsigned *entryStarts = (unsigned *) entries;
+			if (width == 0)
+				entries += sizeof (unsigned) * dict.size ();
+			unsigned offset = 0;
+			for (size_t j = 0; j < firstSeen.size (); j++) {
+				if (width == 0)
+					entryStarts[j] = offset;
+				memcpy (entries + offset, v[firstSeen[j]], l[firstSeen[j]]);
+				offset += l[firstSeen[j]];
+			}
+			break;
+		}
+		}
+		start += ALIGN8 (bestSize);
+	}
+	page.bytesUsed () = start;
+
+	// and get ready for the next page
+	rows.clear ();
+	recStarts.clear ();
+	stats.clear ();
+	stats.resize (types.size ());
+}
+
+#endif
@@ -0,0 +1,68 @@
+
+#ifndef COMPRESSED_PAGE_BATCH_ITER_C
+#define COMPRESSED_PAGE_BATCH_ITER_C
+
+#include "MyDB_CompressedPageBatchIterator.h"
+#include "MyDB_RecordBatch.h"
+
+bool MyDB_CompressedPageBatchIterator :: getNextBatch (MyDB_RecordBatch &fillMe) {
+
+	fillMe.clear ();
+	MyDB_CompressedPage page (myPage->getBytes (), pageSize);
+	size_t numRecs = page.getNumRecs ();
+	if (recsConsumed == numRecs)
+		return false;
+
+	size_t howMany = numRecs - recsConsumed;
+	if (howMany > MAX_BATCH_SIZE)
+		howMany = MAX_BATCH_SIZE;
+
+	if (cursors.size () < fillMe.columns.size ())
+		cursors.resize (fillMe.columns.size ());
+
+	// decode each of the columns that the batch wants
+	for (size_t i = 0; i < fillMe.columns.size (); i++) {
+		MyDB_RecordBatch :: Column &col = fillMe.columns[i];
+		if (!col.decoded)
+			continue;
+
+		switch (col.type) {
+		case IntCol:
+			page.getInts (i, recsConsumed, howMany, col.ints.data (), cursors[i]);
+			break;
+		case DoubleCol:
+			page.getDoubles (i, recsConsumed, howMany, col.doubles.data (), cursors[i]);
+			break;
+		case BoolCol:
+			page.getBools (i, recsConsumed, howMany, col.bools.data (), cursors[i]);
+			break;
+		case StringCol:
+			strings.resize (howMany);
+			page.getStrings (i, recsConsumed, howMany, strings.data (), cursors[i]);
+			for (size_t j = 0; j < howMany; j++) {
+				short len = *((short *) strings[j]);
+				col.stringStarts[j] = fillMe.stringData.size ();
+				fillMe.stringData.insert (fillMe.stringData.end (), strings[j] + sizeof (short), strings[j] + len);
+			}
+			break;
+		}
+	}
+
+	// there is no contiguous version of the records on the page to point to
+	for (size_t j = 0; j < howMany; j++)
+		fillMe.recPointers[j] = nullptr;
+
+	fillMe.numRecs = howMany;
+	recsConsumed += howMany;
+	return true;
+}
+
+MyDB_CompressedPageBatchIterator :: MyDB_CompressedPageBatchIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn) {
+	recsConsumed = 0;
+	myPage = myPageIn;
+	pageSize = pageSizeIn;
+}
+
+MyDB_CompressedPageBatchIterator :: ~MyDB_CompressedPageBatchIterator () {}
+
+#endif
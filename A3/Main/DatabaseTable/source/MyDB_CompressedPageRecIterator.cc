@@ -0,0 +1,32 @@
+
+#ifndef COMPRESSED_PAGE_REC_ITER_C
+#define COMPRESSED_PAGE_REC_ITER_C
+
+#include "MyDB_CompressedPage.h"
+#include "MyDB_CompressedPageRecIterator.h"
+
+#define NUM_BYTES_USED *((size_t *) (rows.data () + sizeof (size_t)))
+
+void MyDB_CompressedPageRecIterator :: getNext () {
+	char *pos = rows.data () + bytesConsumed;
+	bytesConsumed = ((char *) myRec->fromBinary (pos)) - rows.data ();
+}
+
+void *MyDB_CompressedPageRecIterator :: getCurrentPointer () {
+	return rows.data () + bytesConsumed;
+}
+
+bool MyDB_CompressedPageRecIterator :: hasNext () {
+	return bytesConsumed != NUM_BYTES_USED;
+}
+
+MyDB_CompressedPageRecIterator :: MyDB_CompressedPageRecIterator (MyDB_PageHandle myPage, size_t pageSize,
+	MyDB_RecordPtr myRecIn) {
+	MyDB_CompressedPage (myPage->getBytes (), pageSize).toRows (rows);
+	bytesConsumed = sizeof (size_t) * 2;
+	myRec = myRecIn;
+}
+
+MyDB_CompressedPageRecIterator :: ~MyDB_CompressedPageRecIterator () {}
+
+#endif
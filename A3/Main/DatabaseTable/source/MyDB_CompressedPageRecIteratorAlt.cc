@@ -0,0 +1,37 @@
+
+#ifndef COMPRESSED_PAGE_REC_ITER_ALT_C
+#define COMPRESSED_PAGE_REC_ITER_ALT_C
+
+#include "MyDB_CompressedPage.h"
+#include "MyDB_CompressedPageRecIteratorAlt.h"
+
+#define NUM_BYTES_USED *((size_t *) (rows.data () + sizeof (size_t)))
+
+void MyDB_CompressedPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	char *pos = rows.data () + bytesConsumed;
+	nextRecSize = ((char *) intoMe->fromBinary (pos)) - pos;
+}
+
+void *MyDB_CompressedPageRecIteratorAlt :: getCurrentPointer () {
+	return rows.data () + bytesConsumed;
+}
+
+bool MyDB_CompressedPageRecIteratorAlt :: advance () {
+	if (nextRecSize == -1) {
+		cout << "You can't call advance without calling getCurrent!!\n";
+		exit (1);
+	}
+	bytesConsumed += nextRecSize;
+	nextRecSize = -1;
+	return bytesConsumed != NUM_BYTES_USED;
+}
+
+MyDB_CompressedPageRecIteratorAlt :: MyDB_CompressedPageRecIteratorAlt (MyDB_PageHandle myPage, size_t pageSize) {
+	MyDB_CompressedPage (myPage->getBytes (), pageSize).toRows (rows);
+	bytesConsumed = sizeof (size_t) * 2;
+	nextRecSize = 0;
+}
+
+MyDB_CompressedPageRecIteratorAlt :: ~MyDB_CompressedPageRecIteratorAlt () {}
+
+#endif
@@ -0,0 +1,175 @@
+
+#ifndef DECODE_KERNELS_C
+#define DECODE_KERNELS_C
+
+#include "MyDB_DecodeKernels.h"
+#include "MyDB_FilterKernels.h"
+
+#if defined (__x86_64__) || defined (__i386__)
+#define X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// the i^th code in a packed column
+static inline unsigned getCode (const char *codes, int width, int i) {
+	if (width == 1)
+		return ((const unsigned char *) codes)[i];
+	if (width == 2)
+		return ((const unsigned short *) codes)[i];
+	return ((const unsigned *) codes)[i];
+}
+
+#ifdef X86_KERNELS
+
+// widens the eight codes starting at the i^th one into ints
+__attribute__ ((target ("avx2")))
+static inline __m256i avx2Codes (const char *codes, int width, int i) {
+	if (width == 1)
+		return _mm256_cvtepu8_epi32 (_mm_loadl_epi64 ((const __m128i *) (codes + i)));
+	if (width == 2)
+		return _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (codes + 2 * i)));
+	return _mm256_loadu_si256 ((const __m256i *) (codes + 4 * i));
+}
+
+__attribute__ ((target ("avx2")))
+static int avx2Unpack (const char *codes, int width, int base, int n, int *into) {
+	__m256i b = _mm256_set1_epi32 (base);
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_si256 ((__m256i *) (into + i), _mm256_add_epi32 (avx2Codes (codes, width, i), b));
+	return i;
+}
+
+__attribute__ ((target ("avx2")))
+static int avx2LookUpInts (const char *codes, int width, const int *dict, int n, int *into) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+		_mm256_storeu_si256 ((__m256i *) (into + i), _mm256_i32gather_epi32 (dict, avx2Codes (codes, width, i), 4));
+	return i;
+}
+
+__attribute__ ((target ("avx2")))
+static int avx2LookUpDoubles (const char *codes, int width, const double *dict, int n, double *into) {
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i idx = avx2Codes (codes, width, i);
+		_mm256_storeu_pd (into + i, _mm256_i32gather_pd (dict, _mm256_castsi256_si128 (idx), 8));
+		_mm256_storeu_pd (into + i + 4, _mm256_i32gather_pd (dict, _mm256_extracti128_si256 (idx, 1), 8));
+	}
+	return i;
+}
+
+// the prefix sum of eight values is done with two shifted adds inside of each 128-bit lane,
+// and then the total of the low lane is added onto the high lane
+__attribute__ ((target ("avx2")))
+static int avx2PrefixSum (int *vals, int n, int &start) {
+	__m256i carry = _mm256_set1_epi32 (start);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i x = _mm256_loadu_si256 ((const __m256i *) (vals + i));
+		x = _mm256_add_epi32 (x, _mm256_slli_si256 (x, 4));
+		x = _mm256_add_epi32 (x, _mm256_slli_si256 (x, 8));
+		__m256i lowTotal = _mm256_shuffle_epi32 (x, 0xFF);
+		x = _mm256_add_epi32 (x, _mm256_permute2x128_si256 (lowTotal, lowTotal, 0x08));
+		x = _mm256_add_epi32 (x, carry);
+		_mm256_storeu_si256 ((__m256i *) (vals + i), x);
+		carry = _mm256_permutevar8x32_epi32 (x, _mm256_set1_epi32 (7));
+	}
+	if (i > 0)
+		start = vals[i - 1];
+	return i;
+}
+
+// the AVX-512 versions do sixteen codes at a time
+__attribute__ ((target ("avx512f")))
+static inline __m512i avx512Codes (const char *codes, int width, int i) {
+	if (width == 1)
+		return _mm512_cvtepu8_epi32 (_mm_loadu_si128 ((const __m128i *) (codes + i)));
+	if (width == 2)
+		return _mm512_cvtepu16_epi32 (_mm256_loadu_si256 ((const __m256i *) (codes + 2 * i)));
+	return _mm512_loadu_si512 ((const void *) (codes + 4 * i));
+}
+
+__attribute__ ((target ("avx512f")))
+static int avx512Unpack (const char *codes, int width, int base, int n, int *into) {
+	__m512i b = _mm512_set1_epi32 (base);
+	int i = 0;
+	for (; i + 16 <= n; i += 16)
+		_mm512_storeu_si512 ((void *) (into + i), _mm512_add_epi32 (avx512Codes (codes, width, i), b));
+	return i;
+}
+
+__attribute__ ((target ("avx512f")))
+static int avx512LookUpInts (const char *codes, int width, const int *dict, int n, int *into) {
+	int i = 0;
+	for (; i + 16 <= n; i += 16)
+		_mm512_storeu_si512 ((void *) (into + i), _mm512_i32gather_epi32 (avx512Codes (codes, width, i), dict, 4));
+	return i;
+}
+
+__attribute__ ((target ("avx512f")))
+static int avx512LookUpDoubles (const char *codes, int width, const double *dict, int n, double *into) {
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m512i idx = avx512Codes (codes, width, i);
+		_mm512_storeu_pd (into + i, _mm512_i32gather_pd (_mm512_castsi512_si256 (idx), dict, 8));
+		_mm512_storeu_pd (into + i + 8, _mm512_i32gather_pd (_mm512_extracti64x4_epi64 (idx, 1), dict, 8));
+	}
+	return i;
+}
+
+#endif
+
+// as with the filter kernels, the SIMD code does as many values as it can, and the plain
+// loops finish off the rest
+void unpackInts (const char *codes, int width, int base, int n, int *into) {
+	int done = 0;
+#ifdef X86_KERNELS
+	if (getKernelLevel () == AVX512Kernels)
+		done = avx512Unpack (codes, width, base, n, into);
+	else if (getKernelLevel () == AVX2Kernels)
+		done = avx2Unpack (codes, width, base, n, into);
+#endif
+	for (int i = done; i < n; i++)
+		into[i] = (int) ((unsigned) base + getCode (codes, width, i));
+}
+
+void lookUpInts (const char *codes, int width, const int *dict, int n, int *into) {
+	int done = 0;
+#ifdef X86_KERNELS
+	if (getKernelLevel () == AVX512Kernels)
+		done = avx512LookUpInts (codes, width, dict, n, into);
+	else if (getKernelLevel () == AVX2Kernels)
+		done = avx2LookUpInts (codes, width, dict, n, into);
+#endif
+	for (int i = done; i < n; i++)
+		into[i] = dict[getCode (codes, width, i)];
+}
+
+void lookUpDoubles (const char *codes, int width, const double *dict, int n, double *into) {
+	int done = 0;
+#ifdef X86_KERNELS
+	if (getKernelLevel () == AVX512Kernels)
+		done = avx512LookUpDoubles (codes, width, dict, n, into);
+	else if (getKernelLevel () == AVX2Kernels)
+		done = avx2LookUpDoubles (codes, width, dict, n, into);
+#endif
+	for (int i = done; i < n; i++)
+		into[i] = dict[getCode (codes, width, i)];
+}
+
+// a prefix sum does not get much out of wider registers, so the AVX-512 level uses AVX2 here
+void prefixSumInts (int *vals, int n, int start) {
+	int done = 0;
+#ifdef X86_KERNELS
+	if (getKernelLevel () != ScalarKernels)
+		done = avx2PrefixSum (vals, n, start);
+#endif
+	unsigned sum = start;
+	for (int i = done; i < n; i++) {
+		sum += (unsigned) vals[i];
+		vals[i] = (int) sum;
+	}
+}
+
+#endif
@@ -0,0 +1,215 @@
+
+#ifndef FILTER_KERNELS_C
+#define FILTER_KERNELS_C
+
+#include "MyDB_FilterKernels.h"
+#include <string.h>
+
+#if defined (__x86_64__) || defined (__i386__)
+#define X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// the best level supported by this machine
+static MyDB_KernelLevel bestLevel () {
+#ifdef X86_KERNELS
+	if (__builtin_cpu_supports ("avx512f"))
+		return AVX512Kernels;
+	if (__builtin_cpu_supports ("avx2"))
+		return AVX2Kernels;
+#endif
+	return ScalarKernels;
+}
+
+static MyDB_KernelLevel currentLevel = bestLevel ();
+
+MyDB_KernelLevel useKernels (MyDB_KernelLevel maxLevel) {
+	MyDB_KernelLevel best = bestLevel ();
+	currentLevel = (maxLevel < best) ? maxLevel : best;
+	return currentLevel;
+}
+
+MyDB_KernelLevel getKernelLevel () {
+	return currentLevel;
+}
+
+// the plain version of the comparisons... if rhs is nullptr, compare against the constant.  This
+// does rows from through n - 1, and is also used to finish off the rows that do not fill up a
+// whole SIMD register
+template <class T>
+static void scalarCompare (const T *lhs, const T *rhs, T constant, int from, int n, MyDB_CompareOp op, uint64_t *bits) {
+	for (int i = from; i < n; i++) {
+		T r = rhs ? rhs[i] : constant;
+		bool pass;
+		switch (op) {
+		case LessThan: pass = lhs[i] < r; break;
+		case GreaterThan: pass = lhs[i] > r; break;
+		case EqualTo: pass = lhs[i] == r; break;
+		default: pass = lhs[i] != r; break;
+		}
+		bits[i >> 6] |= ((uint64_t) pass) << (i & 63);
+	}
+}
+
+#ifdef X86_KERNELS
+
+// the AVX2 kernels produce one byte of the bitmap for every eight rows
+__attribute__ ((target ("avx2")))
+static int avx2Ints (const int *lhs, const int *rhs, int constant, int n, MyDB_CompareOp op, uint64_t *bits) {
+	unsigned char *out = (unsigned char *) bits;
+	__m256i c = _mm256_set1_epi32 (constant);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256i l = _mm256_loadu_si256 ((const __m256i *) (lhs + i));
+		__m256i r = rhs ? _mm256_loadu_si256 ((const __m256i *) (rhs + i)) : c;
+		__m256i res;
+		if (op == LessThan)
+			res = _mm256_cmpgt_epi32 (r, l);
+		else if (op == GreaterThan)
+			res = _mm256_cmpgt_epi32 (l, r);
+		else
+			res = _mm256_cmpeq_epi32 (l, r);
+		int mask = _mm256_movemask_ps (_mm256_castsi256_ps (res));
+		out[i >> 3] = (op == NotEqualTo) ? ~mask : mask;
+	}
+	return i;
+}
+
+__attribute__ ((target ("avx2")))
+static inline int avx2DoubleMask (__m256d l, __m256d r, MyDB_CompareOp op) {
+	switch (op) {
+	case LessThan: return _mm256_movemask_pd (_mm256_cmp_pd (l, r, _CMP_LT_OQ));
+	case GreaterThan: return _mm256_movemask_pd (_mm256_cmp_pd (l, r, _CMP_GT_OQ));
+	case EqualTo: return _mm256_movemask_pd (_mm256_cmp_pd (l, r, _CMP_EQ_OQ));
+	default: return _mm256_movemask_pd (_mm256_cmp_pd (l, r, _CMP_NEQ_UQ));
+	}
+}
+
+__attribute__ ((target ("avx2")))
+static int avx2Doubles (const double *lhs, const double *rhs, double constant, int n, MyDB_CompareOp op, uint64_t *bits) {
+	unsigned char *out = (unsigned char *) bits;
+	__m256d c = _mm256_set1_pd (constant);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m256d lLow = _mm256_loadu_pd (lhs + i);
+		__m256d lHigh = _mm256_loadu_pd (lhs + i + 4);
+		__m256d rLow = rhs ? _mm256_loadu_pd (rhs + i) : c;
+		__m256d rHigh = rhs ? _mm256_loadu_pd (rhs + i + 4) : c;
+		out[i >> 3] = avx2DoubleMask (lLow, rLow, op) | (avx2DoubleMask (lHigh, rHigh, op) << 4);
+	}
+	return i;
+}
+
+// the AVX-512 kernels compare straight into a mask register: 16 ints or 8 doubles at a time
+__attribute__ ((target ("avx512f")))
+static int avx512Ints (const int *lhs, const int *rhs, int constant, int n, MyDB_CompareOp op, uint64_t *bits) {
+	uint16_t *out = (uint16_t *) bits;
+	__m512i c = _mm512_set1_epi32 (constant);
+	int i = 0;
+	for (; i + 16 <= n; i += 16) {
+		__m512i l = _mm512_loadu_si512 ((const void *) (lhs + i));
+		__m512i r = rhs ? _mm512_loadu_si512 ((const void *) (rhs + i)) : c;
+		__mmask16 mask;
+		switch (op) {
+		case LessThan: mask = _mm512_cmp_epi32_mask (l, r, _MM_CMPINT_LT); break;
+		case GreaterThan: mask = _mm512_cmp_epi32_mask (l, r, _MM_CMPINT_NLE); break;
+		case EqualTo: mask = _mm512_cmp_epi32_mask (l, r, _MM_CMPINT_EQ); break;
+		default: mask = _mm512_cmp_epi32_mask (l, r, _MM_CMPINT_NE); break;
+		}
+		out[i >> 4] = mask;
+	}
+	return i;
+}
+
+__attribute__ ((target ("avx512f")))
+static int avx512Doubles (const double *lhs, const double *rhs, double constant, int n, MyDB_CompareOp op, uint64_t *bits) {
+	unsigned char *out = (unsigned char *) bits;
+	__m512d c = _mm512_set1_pd (constant);
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512d l = _mm512_loadu_pd (lhs + i);
+		__m512d r = rhs ? _mm512_loadu_pd (rhs + i) : c;
+		__mmask8 mask;
+		switch (op) {
+		case LessThan: mask = _mm512_cmp_pd_mask (l, r, _CMP_LT_OQ); break;
+		case GreaterThan: mask = _mm512_cmp_pd_mask (l, r, _CMP_GT_OQ); break;
+		case EqualTo: mask = _mm512_cmp_pd_mask (l, r, _CMP_EQ_OQ); break;
+		default: mask = _mm512_cmp_pd_mask (l, r, _CMP_NEQ_UQ); break;
+		}
+		out[i >> 3] = mask;
+	}
+	return i;
+}
+
+#endif
+
+// every comparison goes through one of these two... the SIMD kernels do as many rows as they
+// can, and the scalar code finishes off the rest
+static void intKernel (const int *lhs, const int *rhs, int constant, int n, MyDB_CompareOp op, uint64_t *bits) {
+	memset (bits, 0, BITMAP_WORDS (n) * sizeof (uint64_t));
+	int done = 0;
+#ifdef X86_KERNELS
+	if (currentLevel == AVX512Kernels)
+		done = avx512Ints (lhs, rhs, constant, n, op, bits);
+	else if (currentLevel == AVX2Kernels)
+		done = avx2Ints (lhs, rhs, constant, n, op, bits);
+#endif
+	scalarCompare <int> (lhs, rhs, constant, done, n, op, bits);
+}
+
+static void doubleKernel (const double *lhs, const double *rhs, double constant, int n, MyDB_CompareOp op, uint64_t *bits) {
+	memset (bits, 0, BITMAP_WORDS (n) * sizeof (uint64_t));
+	int done = 0;
+#ifdef X86_KERNELS
+	if (currentLevel == AVX512Kernels)
+		done = avx512Doubles (lhs, rhs, constant, n, op, bits);
+	else if (currentLevel == AVX2Kernels)
+		done = avx2Doubles (lhs, rhs, constant, n, op, bits);
+#endif
+	scalarCompare <double> (lhs, rhs, constant, done, n, op, bits);
+}
+
+void compareInts (const int *vals, int n, MyDB_CompareOp op, int constant, uint64_t *bits) {
+	intKernel (vals, nullptr, constant, n, op, bits);
+}
+
+void compareDoubles (const double *vals, int n, MyDB_CompareOp op, double constant, uint64_t *bits) {
+	doubleKernel (vals, nullptr, constant, n, op, bits);
+}
+
+void compareIntColumns (const int *lhs, const int *rhs, int n, MyDB_CompareOp op, uint64_t *bits) {
+	intKernel (lhs, rhs, 0, n, op, bits);
+}
+
+void compareDoubleColumns (const double *lhs, const double *rhs, int n, MyDB_CompareOp op, uint64_t *bits) {
+	doubleKernel (lhs, rhs, 0, n, op, bits);
+}
+
+// the bitmap operations work a word (64 rows) at a time, which the compiler can vectorize further
+void andBitmaps (uint64_t *into, const uint64_t *other, int n) {
+	for (int i = 0; i < BITMAP_WORDS (n); i++)
+		into[i] &= other[i];
+}
+
+void orBitmaps (uint64_t *into, const uint64_t *other, int n) {
+	for (int i = 0; i < BITMAP_WORDS (n); i++)
+		into[i] |= other[i];
+}
+
+void notBitmap (uint64_t *bits, int n) {
+	for (int i = 0; i < BITMAP_WORDS (n); i++)
+		bits[i] = ~bits[i];
+
+	// make sure that the rows past the end are not selected
+	if (n % 64 != 0)
+		bits[n / 64] &= (((uint64_t) 1) << (n % 64)) - 1;
+}
+
+int countBitmap (const uint64_t *bits, int n) {
+	int count = 0;
+	for (int i = 0; i < BITMAP_WORDS (n); i++)
+		count += __builtin_popcountll (bits[i]);
+	return count;
+}
+
+#endif
@@ -0,0 +1,58 @@
+
+#ifndef MERGE_ITER_ALT_C
+#define MERGE_ITER_ALT_C
+
+#include <algorithm>
+#include "MyDB_MergeIteratorAlt.h"
+
+void MyDB_MergeIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	heap.front ()->getCurrent (intoMe);
+}
+
+void *MyDB_MergeIteratorAlt :: getCurrentPointer () {
+	return heap.front ()->getCurrentPointer ();
+}
+
+bool MyDB_MergeIteratorAlt :: after (MyDB_RecordIteratorAltPtr &a, MyDB_RecordIteratorAltPtr &b) {
+	b->getCurrent (lhs);
+	a->getCurrent (rhs);
+	return comparator ();
+}
+
+bool MyDB_MergeIteratorAlt :: advance () {
+
+	auto heapCompare = [this] (MyDB_RecordIteratorAltPtr &a, MyDB_RecordIteratorAltPtr &b) {return after (a, b);};
+
+	// the first time through, start each of the iterators
+	if (!notStarted.empty ()) {
+		for (auto &iter : notStarted) {
+			if (iter->advance ())
+				heap.push_back (iter);
+		}
+		notStarted.clear ();
+		make_heap (heap.begin (), heap.end (), heapCompare);
+		return !heap.empty ();
+	}
+
+	// after that, move the iterator with the smallest record along
+	if (heap.empty ())
+		return false;
+	pop_heap (heap.begin (), heap.end (), heapCompare);
+	if (heap.back ()->advance ())
+		push_heap (heap.begin (), heap.end (), heapCompare);
+	else
+		heap.pop_back ();
+	return !heap.empty ();
+}
+
+MyDB_MergeIteratorAlt :: MyDB_MergeIteratorAlt (vector <MyDB_RecordIteratorAltPtr> &mergeUs, function <bool ()> comparatorIn,
+	MyDB_RecordPtr lhsIn, MyDB_RecordPtr rhsIn) {
+	notStarted = mergeUs;
+	comparator = comparatorIn;
+	lhs = lhsIn;
+	rhs = rhsIn;
+}
+
+MyDB_MergeIteratorAlt :: ~MyDB_MergeIteratorAlt () {}
+
+#endif
@@ -0,0 +1,39 @@
+
+#ifndef PAGE_BATCH_ITER_C
+#define PAGE_BATCH_ITER_C
+
+#include <algorithm>
+#include "MyDB_PageBatchIterator.h"
+
+#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+
+bool MyDB_PageBatchIterator :: getNextBatch (MyDB_RecordBatch &fillMe) {
+
+	fillMe.clear ();
+	char *bytes = (char *) myPage->getBytes ();
+	size_t bytesUsed = NUM_BYTES_USED;
+
+	// fixed-width records can all be decoded at once
+	MyDB_SchemaPtr mySchema = fillMe.getSchema ();
+	if (mySchema->isFixedWidth ()) {
+		size_t recSize = mySchema->getFixedSize ();
+		int n = (int) min ((bytesUsed - bytesConsumed) / recSize, (size_t) MAX_BATCH_SIZE);
+		bytesConsumed = (char *) fillMe.addRecords (bytes + bytesConsumed, n) - bytes;
+		return n > 0;
+	}
+
+	while (bytesConsumed != bytesUsed && !fillMe.isFull ()) {
+		char *nextPos = (char *) fillMe.addRecord (bytes + bytesConsumed);
+		bytesConsumed = nextPos - bytes;
+	}
+	return fillMe.size () > 0;
+}
+
+MyDB_PageBatchIterator :: MyDB_PageBatchIterator (MyDB_PageHandle myPageIn) {
+	bytesConsumed = sizeof (size_t) * 2;
+	myPage = myPageIn;
+}
+
+MyDB_PageBatchIterator :: ~MyDB_PageBatchIterator () {}
+
+#endif
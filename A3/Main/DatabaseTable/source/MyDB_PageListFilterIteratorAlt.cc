@@ -0,0 +1,38 @@
+
+#ifndef PAGE_LIST_FILTER_ITER_ALT_C
+#define PAGE_LIST_FILTER_ITER_ALT_C
+
+#include "MyDB_PageListFilterIteratorAlt.h"
+
+void MyDB_PageListFilterIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (myIter->getCurrentPointer ());
+}
+
+void *MyDB_PageListFilterIteratorAlt :: getCurrentPointer () {
+	return myIter->getCurrentPointer ();
+}
+
+bool MyDB_PageListFilterIteratorAlt :: advance () {
+
+	// go until we find a record that passes
+	if (myIter == nullptr)
+		return false;
+	while (myIter->advance ()) {
+		myIter->getCurrent (myRec);
+		if (passes ())
+			return true;
+	}
+	return false;
+}
+
+MyDB_PageListFilterIteratorAlt :: MyDB_PageListFilterIteratorAlt (vector <MyDB_PageReaderWriter> &forUs, 
+	MyDB_RecordPtr myRecIn, function <bool ()> passesIn) {
+	if (!forUs.empty ())
+		myIter = getIteratorAlt (forUs);
+	myRec = myRecIn;
+	passes = passesIn;
+}
+
+MyDB_PageListFilterIteratorAlt :: ~MyDB_PageListFilterIteratorAlt () {}
+
+#endif
@@ -14,11 +14,21 @@
 #define PAGE_RW_C
 
 #include <algorithm>
+#include "MyDB_CompressedPage.h"
+#include "MyDB_CompressedPageBatchIterator.h"
+#include "MyDB_CompressedPageRecIterator.h"
+#include "MyDB_CompressedPageRecIteratorAlt.h"
+#include "MyDB_PageBatchIterator.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_PageRecIterator.h"
 #include "MyDB_PageRecIteratorAlt.h"
 #include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageBatchIterator.h"
+#include "MyDB_PaxPageRecIterator.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
 #include "RecordComparator.h"
+#include <string.h>
 
 #define PAGE_TYPE *((MyDB_PageType *) ((char *) myPage->getBytes ()))
 #define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
@@ -29,6 +39,8 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent,
 	// get the actual page
 	myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
 	pageSize = parent.getBufferMgr ()->getPageSize ();
+	if (parent.getTable ()->getFileType () == "pax" || parent.getTable ()->getFileType () == "compressed")
+		paxSchema = parent.getTable ()->getSchema ();
 }
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWriter &parent, int whichPage) {
@@ -40,6 +52,8 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_TableReaderWri
 		myPage = parent.getBufferMgr ()->getPage (parent.getTable (), whichPage);
 	}
 	pageSize = parent.getBufferMgr ()->getPageSize ();
+	if (parent.getTable ()->getFileType () == "pax" || parent.getTable ()->getFileType () == "compressed")
+		paxSchema = parent.getTable ()->getSchema ();
 }
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_BufferManager &parent) {
@@ -60,8 +74,12 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager
 }
 
 void MyDB_PageReaderWriter :: clear () {
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	PAGE_TYPE = MyDB_PageType :: RegularPage;
+	if (paxSchema != nullptr) {
+		MyDB_PaxPage (myPage->getBytes (), pageSize).clear (paxSchema);
+	} else {
+		NUM_BYTES_USED = 2 * sizeof (size_t);
+		PAGE_TYPE = MyDB_PageType :: RegularPage;
+	}
 	myPage->wroteBytes ();	
 }
 
@@ -74,19 +92,39 @@ MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs)
 }
 
 MyDB_RecordIteratorPtr MyDB_PageReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
+	if (PAGE_TYPE == MyDB_PageType :: CompressedPage)
+		return make_shared <MyDB_CompressedPageRecIterator> (myPage, pageSize, iterateIntoMe);
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageRecIterator> (myPage, pageSize, iterateIntoMe);
 	return make_shared <MyDB_PageRecIterator> (myPage, iterateIntoMe);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt () {
+	if (PAGE_TYPE == MyDB_PageType :: CompressedPage)
+		return make_shared <MyDB_CompressedPageRecIteratorAlt> (myPage, pageSize);
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageRecIteratorAlt> (myPage, pageSize);
 	return make_shared <MyDB_PageRecIteratorAlt> (myPage);
 }
 
+MyDB_BatchIteratorPtr MyDB_PageReaderWriter :: getBatchIterator () {
+	if (PAGE_TYPE == MyDB_PageType :: CompressedPage)
+		return make_shared <MyDB_CompressedPageBatchIterator> (myPage, pageSize);
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageBatchIterator> (myPage, pageSize);
+	return make_shared <MyDB_PageBatchIterator> (myPage);
+}
+
 void MyDB_PageReaderWriter :: setType (MyDB_PageType toMe) {
 	PAGE_TYPE = toMe;
 	myPage->wroteBytes ();	
 }
 
 void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe) {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage || PAGE_TYPE == MyDB_PageType :: CompressedPage) {
+		cout << "Records on a PAX or compressed page have no single location!!\n";
+		exit (1);
+	}
 	void *recLocation = NUM_BYTES_USED + (char *)  myPage->getBytes ();
 	if (append (appendMe))
 		return recLocation;
@@ -97,6 +135,23 @@ void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe)
 bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	
 	size_t recSize = appendMe->getBinarySize ();
+
+	// a compressed page is written all at once, and never has room for more
+	if (PAGE_TYPE == MyDB_PageType :: CompressedPage)
+		return false;
+
+	// on a PAX page, the record is split up over the minipages
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		static thread_local vector <char> rec;
+		if (rec.size () < recSize)
+			rec.resize (recSize);
+		appendMe->toBinary (rec.data ());
+		if (!MyDB_PaxPage (myPage->getBytes (), pageSize).appendRow (rec.data ()))
+			return false;
+		myPage->wroteBytes ();
+		return true;
+	}
+
 	if (recSize > NUM_BYTES_LEFT)
 		return false;
 
@@ -108,49 +163,150 @@ bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	return true;
 }
 
-void MyDB_PageReaderWriter :: 
-	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
-
-	void *temp = malloc (pageSize);
-	memcpy (temp, myPage->getBytes (), pageSize);
+// a record on a page that is being sorted: its offset and its length in bytes
+struct RecordSlot {
+	unsigned offset;
+	unsigned length;
+};
+
+// stable bottom-up merge sort of the slots, using aux as the merge buffer... std::stable_sort
+// would allocate its own buffer on every call, so we use this instead
+template <class Less>
+static void mergeSortSlots (vector <RecordSlot> &slots, vector <RecordSlot> &aux, Less less) {
+
+	size_t n = slots.size ();
+	aux.resize (n);
+	RecordSlot *from = slots.data ();
+	RecordSlot *to = aux.data ();
+
+	// short runs are sorted by insertion
+	const size_t firstRun = 8;
+	for (size_t lo = 0; lo < n; lo += firstRun) {
+		size_t hi = min (lo + firstRun, n);
+		for (size_t i = lo + 1; i < hi; i++) {
+			RecordSlot cur = from[i];
+			size_t j = i;
+			for (; j > lo && less (cur, from[j - 1]); j--)
+				from[j] = from[j - 1];
+			from[j] = cur;
+		}
+	}
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	// and then merged, ping-ponging between the two buffers
+	for (size_t width = firstRun; width < n; width *= 2) {
+		for (size_t lo = 0; lo < n; lo += 2 * width) {
+			size_t mid = min (lo + width, n), hi = min (lo + 2 * width, n);
+			size_t i = lo, j = mid, k = lo;
+			while (i < mid && j < hi)
+				to[k++] = less (from[j], from[i]) ? from[j++] : from[i++];
+			while (i < mid)
+				to[k++] = from[i++];
+			while (j < hi)
+				to[k++] = from[j++];
+		}
+		swap (from, to);
 	}
 
-	// and now we sort the vector of positions, using the record contents to build a comparator
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
+	if (from != slots.data ())
+		memcpy (slots.data (), from, n * sizeof (RecordSlot));
+}
 
-	// and write the guys back
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	myPage->wroteBytes ();	
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		append (lhs);
+void MyDB_PageReaderWriter :: 
+	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+
+	// the scratch frame and the slot lists belong to the thread, and are reused by every
+	// page that it sorts... once they have grown to a page's worth, sorting does no allocation
+	static thread_local vector <char> scratch;
+	static thread_local vector <RecordSlot> slots;
+	static thread_local vector <RecordSlot> aux;
+
+	// (the records on a compressed page can take up more than a page as rows, so the frame
+	// grows to hold them)
+	char *bytes = (char *) myPage->getBytes ();
+	size_t bytesUsed = NUM_BYTES_USED;
+	if (scratch.size () < pageSize)
+		scratch.resize (pageSize);
+	bool isPax = (PAGE_TYPE == MyDB_PageType :: PaxPage);
+	bool isCompressed = (PAGE_TYPE == MyDB_PageType :: CompressedPage);
+	if (isPax)
+		MyDB_PaxPage (bytes, pageSize).toRows (scratch.data ());
+	else if (isCompressed)
+		MyDB_CompressedPage (bytes, pageSize).toRows (scratch);
+	else
+		memcpy (scratch.data (), bytes, bytesUsed);
+	char *frame = scratch.data ();
+
+	// find all of the records by walking the size header at the front of each one (or, if
+	// they are fixed-width, by just stepping through them)
+	slots.clear ();
+	MyDB_SchemaPtr recSchema = lhs->getSchema ();
+	unsigned fixedSize = (recSchema != nullptr && recSchema->isFixedWidth ()) ? recSchema->getFixedSize () : 0;
+	for (size_t pos = 2 * sizeof (size_t); pos < bytesUsed; ) {
+		unsigned len = fixedSize ? fixedSize : *((short *) (frame + pos));
+		slots.push_back (RecordSlot {(unsigned) pos, len});
+		pos += len;
 	}
 
-	free (temp);
+	// sort the (offset, length) pairs, using the record contents to compare
+	mergeSortSlots (slots, aux, [&] (const RecordSlot &l, const RecordSlot &r) {
+		lhs->fromBinary (frame + l.offset);
+		rhs->fromBinary (frame + r.offset);
+		return comparator ();
+	});
+
+	// and copy the raw bytes of the records back onto the page, in sorted order... a PAX or
+	// compressed page is just rebuilt from the sorted records (which always fit, since the
+	// records that go on a compressed page do not depend on their order)
+	if (isCompressed) {
+		MyDB_CompressedPageBuilder builder (paxSchema, pageSize);
+		for (RecordSlot &slot : slots)
+			builder.add (frame + slot.offset);
+		builder.write (bytes);
+		myPage->wroteBytes ();	
+		return;
+	}
+	if (isPax) {
+		MyDB_PaxPage page (bytes, pageSize);
+		page.clear (paxSchema);
+		for (RecordSlot &slot : slots)
+			page.appendRow (frame + slot.offset);
+		myPage->wroteBytes ();	
+		return;
+	}
+	char *writeTo = bytes + 2 * sizeof (size_t);
+	for (RecordSlot &slot : slots) {
+		memcpy (writeTo, frame + slot.offset, slot.length);
+		writeTo += slot.length;
+	}
+	myPage->wroteBytes ();	
 }
 
 MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: 
 	sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
+	// the records on a compressed page might not fit on the one page that is returned
+	if (PAGE_TYPE == MyDB_PageType :: CompressedPage) {
+		cout << "This is bad... a compressed page can't be sorted onto a new page; use sortInPlace ().\n";
+		exit (1);
+	}
+
 	// first, read in the positions of all of the records
 	vector <void *> positions;
 	
-	// this basically iterates through all of the records on the page
+	// this basically iterates through all of the records on the page... for a PAX page, we
+	// iterate through a regular copy of it (which has the same NUM_BYTES_USED), made in a
+	// frame that belongs to the thread
+	static thread_local vector <char> scratch;
+	char *fromBytes = (char *) myPage->getBytes ();
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		if (scratch.size () < pageSize)
+			scratch.resize (pageSize);
+		MyDB_PaxPage (fromBytes, pageSize).toRows (scratch.data ());
+		fromBytes = scratch.data ();
+	}
 	int bytesConsumed = sizeof (size_t) * 2;
 	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) myPage->getBytes ();
+		void *pos = bytesConsumed + fromBytes;
 		positions.push_back (pos);
 		void *nextPos = lhs->fromBinary (pos);
 		bytesConsumed += ((char *) nextPos) - ((char *) pos);
@@ -181,4 +337,18 @@ void *MyDB_PageReaderWriter :: getBytes () {
 	return myPage->getBytes ();
 }
 
+void MyDB_PageReaderWriter :: copyFrom (void *image) {
+	memcpy (myPage->getBytes (), image, pageSize);
+	myPage->wroteBytes ();
+}
+
+void MyDB_PageReaderWriter :: copyTo (void *image) {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		MyDB_PaxPage (myPage->getBytes (), pageSize).toRows (image);
+	else if (PAGE_TYPE == MyDB_PageType :: CompressedPage)
+		memcpy (image, myPage->getBytes (), pageSize);
+	else
+		memcpy (image, myPage->getBytes (), pageSize);
+}
+
 #endif
@@ -0,0 +1,248 @@
+
+#ifndef PAX_PAGE_C
+#define PAX_PAGE_C
+
+#include "MyDB_PageType.h"
+#include "MyDB_PaxPage.h"
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+// rounds up to a multiple of eight bytes, so that every minipage starts on an aligned address
+#define ALIGN8(x) ((((size_t) (x)) + 7) & ~((size_t) 7))
+
+MyDB_PaxPage :: MyDB_PaxPage (void *bytesIn, size_t pageSizeIn) {
+	bytes = (char *) bytesIn;
+	pageSize = pageSizeIn;
+}
+
+size_t &MyDB_PaxPage :: numRowBytes () {
+	return *((size_t *) (bytes + sizeof (size_t)));
+}
+
+size_t &MyDB_PaxPage :: numRecs () {
+	return *((size_t *) (bytes + 2 * sizeof (size_t)));
+}
+
+size_t &MyDB_PaxPage :: numAtts () {
+	return *((size_t *) (bytes + 3 * sizeof (size_t)));
+}
+
+MyDB_PaxPage :: MiniPage *MyDB_PaxPage :: miniPages () {
+	return (MiniPage *) (bytes + 4 * sizeof (size_t));
+}
+
+size_t MyDB_PaxPage :: dataStart () {
+	return ALIGN8 (4 * sizeof (size_t) + numAtts () * sizeof (MiniPage));
+}
+
+size_t MyDB_PaxPage :: getNumRecs () {
+	return numRecs ();
+}
+
+char *MyDB_PaxPage :: getColumn (int whichAtt) {
+	return bytes + miniPages ()[whichAtt].start;
+}
+
+unsigned MyDB_PaxPage :: getWidth (int whichAtt) {
+	return miniPages ()[whichAtt].width;
+}
+
+bool MyDB_PaxPage :: isFixedWidth () {
+	for (size_t i = 0; i < numAtts (); i++) {
+		if (miniPages ()[i].width == 0)
+			return false;
+	}
+	return numAtts () > 0;
+}
+
+size_t MyDB_PaxPage :: getFixedSize () {
+	size_t total = 0;
+	for (size_t i = 0; i < numAtts (); i++)
+		total += miniPages ()[i].width;
+	return total;
+}
+
+void MyDB_PaxPage :: clear (MyDB_SchemaPtr mySchema) {
+
+	*((MyDB_PageType *) bytes) = MyDB_PageType :: PaxPage;
+	numRowBytes () = 2 * sizeof (size_t);
+	numRecs () = 0;
+	numAtts () = mySchema->getAtts ().size ();
+
+	// every minipage starts out empty; the first append lays them out
+	MiniPage *mini = miniPages ();
+	int i = 0;
+	for (auto &att : mySchema->getAtts ()) {
+		mini[i].start = dataStart ();
+		mini[i].capacity = 0;
+		mini[i].used = 0;
+		if (att.second->isBool ())
+			mini[i].width = sizeof (char);
+		else if (att.second->promotableToInt ())
+			mini[i].width = sizeof (int);
+		else if (att.second->promotableToDouble ())
+			mini[i].width = sizeof (double);
+		else
+			mini[i].width = 0;
+		i++;
+	}
+}
+
+bool MyDB_PaxPage :: relayout (vector <unsigned> &adds) {
+
+	static thread_local vector <char> scratch;
+	MiniPage *mini = miniPages ();
+	size_t n = numAtts ();
+
+	// see how much space each minipage needs
+	size_t total = pageSize - dataStart ();
+	size_t needed = 0;
+	for (size_t i = 0; i < n; i++)
+		needed += ALIGN8 (mini[i].used + adds[i]);
+	if (needed > total)
+		return false;
+
+	// save the current contents of the minipages
+	size_t saved = 0;
+	for (size_t i = 0; i < n; i++)
+		saved += mini[i].used;
+	if (scratch.size () < saved)
+		scratch.resize (saved);
+	char *pos = scratch.data ();
+	for (size_t i = 0; i < n; i++) {
+		memcpy (pos, bytes + mini[i].start, mini[i].used);
+		pos += mini[i].used;
+	}
+
+	// and put them back, handing out the free space in proportion to what each one needs
+	size_t slack = total - needed;
+	size_t start = dataStart ();
+	pos = scratch.data ();
+	for (size_t i = 0; i < n; i++) {
+		size_t need = ALIGN8 (mini[i].used + adds[i]);
+		size_t share = (needed == 0) ? 0 : (slack * need / needed) & ~((size_t) 7);
+		mini[i].start = start;
+		mini[i].capacity = need + share;
+		memcpy (bytes + start, pos, mini[i].used);
+		pos += mini[i].used;
+		start += mini[i].capacity;
+	}
+	return true;
+}
+
+bool MyDB_PaxPage :: appendRow (void *fromHere) {
+
+	// a PAX page never holds more than a regular page could
+	char *rec = (char *) fromHere;
+	bool fixed = isFixedWidth ();
+	size_t recSize = fixed ? getFixedSize () : *((short *) rec);
+	if (numRowBytes () + recSize > pageSize)
+		return false;
+
+	// figure out how many bytes each minipage grows by
+	static thread_local vector <unsigned> adds;
+	size_t n = numAtts ();
+	MiniPage *mini = miniPages ();
+	adds.resize (n);
+	bool fits = true;
+	char *pos = fixed ? rec : rec + sizeof (short);
+	for (size_t i = 0; i < n; i++) {
+		unsigned len = fixed ? mini[i].width : *((short *) pos);
+		adds[i] = mini[i].width ? mini[i].width : len;
+		if (mini[i].used + adds[i] > mini[i].capacity)
+			fits = false;
+		pos += len;
+	}
+
+	if (!fits && !relayout (adds))
+		return false;
+
+	// and copy in the values... fixed-size values lose their length header, if they have one
+	pos = fixed ? rec : rec + sizeof (short);
+	for (size_t i = 0; i < n; i++) {
+		unsigned len = fixed ? mini[i].width : *((short *) pos);
+		if (fixed)
+			memcpy (bytes + mini[i].start + mini[i].used, pos, mini[i].width);
+		else if (mini[i].width)
+			memcpy (bytes + mini[i].start + mini[i].used, pos + sizeof (short), mini[i].width);
+		else
+			memcpy (bytes + mini[i].start + mini[i].used, pos, len);
+		mini[i].used += adds[i];
+		pos += len;
+	}
+
+	numRecs ()++;
+	numRowBytes () += recSize;
+	return true;
+}
+
+size_t MyDB_PaxPage :: getRowBytes () {
+	return numRowBytes ();
+}
+
+void MyDB_PaxPage :: firstRow (Cursor &cur) {
+	size_t n = numAtts ();
+	MiniPage *mini = miniPages ();
+	cur.at.resize (n);
+	cur.widths.resize (n);
+	for (size_t i = 0; i < n; i++) {
+		cur.at[i] = mini[i].start;
+		cur.widths[i] = mini[i].width;
+	}
+	cur.fixedWidth = isFixedWidth ();
+	cur.numRecs = numRecs ();
+	cur.whichRec = 0;
+}
+
+size_t MyDB_PaxPage :: getRow (Cursor &cur, char *intoHere) {
+
+	// fixed-width records are just their values
+	size_t n = cur.at.size ();
+	char *pos = intoHere;
+	if (cur.fixedWidth) {
+		for (size_t i = 0; i < n; i++) {
+			memcpy (pos, bytes + cur.at[i], cur.widths[i]);
+			pos += cur.widths[i];
+		}
+		return pos - intoHere;
+	}
+
+	// otherwise, stitch the record back together from its values in the minipages
+	pos += sizeof (short);
+	for (size_t i = 0; i < n; i++) {
+		if (cur.widths[i]) {
+			*((short *) pos) = (short) (sizeof (short) + cur.widths[i]);
+			memcpy (pos + sizeof (short), bytes + cur.at[i], cur.widths[i]);
+			pos += sizeof (short) + cur.widths[i];
+		} else {
+			short len = *((short *) (bytes + cur.at[i]));
+			memcpy (pos, bytes + cur.at[i], len);
+			pos += len;
+		}
+	}
+	*((short *) intoHere) = (short) (pos - intoHere);
+	return pos - intoHere;
+}
+
+void MyDB_PaxPage :: skipRow (Cursor &cur) {
+	size_t n = cur.at.size ();
+	for (size_t i = 0; i < n; i++)
+		cur.at[i] += cur.widths[i] ? cur.widths[i] : *((short *) (bytes + cur.at[i]));
+	cur.whichRec++;
+}
+
+void MyDB_PaxPage :: toRows (void *intoHere) {
+
+	static thread_local Cursor cur;
+	char *out = (char *) intoHere;
+	*((MyDB_PageType *) out) = MyDB_PageType :: RegularPage;
+	*((size_t *) (out + sizeof (size_t))) = numRowBytes ();
+	char *pos = out + 2 * sizeof (size_t);
+
+	for (firstRow (cur); cur.whichRec < cur.numRecs; skipRow (cur))
+		pos += getRow (cur, pos);
+}
+
+#endif
@@ -0,0 +1,82 @@
+
+#ifndef PAX_PAGE_BATCH_ITER_C
+#define PAX_PAGE_BATCH_ITER_C
+
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageBatchIterator.h"
+#include "MyDB_RecordBatch.h"
+#include <string.h>
+
+bool MyDB_PaxPageBatchIterator :: getNextBatch (MyDB_RecordBatch &fillMe) {
+
+	fillMe.clear ();
+	MyDB_PaxPage page (myPage->getBytes (), pageSize);
+	size_t numRecs = page.getNumRecs ();
+	if (recsConsumed == numRecs)
+		return false;
+
+	size_t howMany = numRecs - recsConsumed;
+	if (howMany > MAX_BATCH_SIZE)
+		howMany = MAX_BATCH_SIZE;
+
+	if (stringRec.size () < fillMe.columns.size ()) {
+		stringRec.resize (fillMe.columns.size (), 0);
+		stringPos.resize (fillMe.columns.size (), 0);
+	}
+
+	// copy over each of the columns that the batch wants
+	for (size_t i = 0; i < fillMe.columns.size (); i++) {
+		MyDB_RecordBatch :: Column &col = fillMe.columns[i];
+		if (!col.decoded)
+			continue;
+
+		char *values = page.getColumn (i);
+		size_t width = page.getWidth (i);
+		switch (col.type) {
+		case IntCol:
+			memcpy (col.ints.data (), values + recsConsumed * width, howMany * width);
+			break;
+		case DoubleCol:
+			memcpy (col.doubles.data (), values + recsConsumed * width, howMany * width);
+			break;
+		case BoolCol:
+			for (size_t j = 0; j < howMany; j++)
+				col.bools[j] = (values[recsConsumed + j] == 1);
+			break;
+		case StringCol:
+
+			// catch up, in case an earlier batch did not decode this attribute
+			while (stringRec[i] < recsConsumed) {
+				stringPos[i] += *((short *) (values + stringPos[i]));
+				stringRec[i]++;
+			}
+			for (size_t j = 0; j < howMany; j++) {
+				char *val = values + stringPos[i];
+				short len = *((short *) val);
+				col.stringStarts[j] = fillMe.stringData.size ();
+				fillMe.stringData.insert (fillMe.stringData.end (), val + sizeof (short), val + len);
+				stringPos[i] += len;
+			}
+			stringRec[i] += howMany;
+			break;
+		}
+	}
+
+	// there is no contiguous version of the records on the page to point to
+	for (size_t j = 0; j < howMany; j++)
+		fillMe.recPointers[j] = nullptr;
+
+	fillMe.numRecs = howMany;
+	recsConsumed += howMany;
+	return true;
+}
+
+MyDB_PaxPageBatchIterator :: MyDB_PaxPageBatchIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn) {
+	recsConsumed = 0;
+	myPage = myPageIn;
+	pageSize = pageSizeIn;
+}
+
+MyDB_PaxPageBatchIterator :: ~MyDB_PaxPageBatchIterator () {}
+
+#endif
@@ -0,0 +1,38 @@
+
+#ifndef PAX_PAGE_REC_ITER_C
+#define PAX_PAGE_REC_ITER_C
+
+#include "MyDB_PaxPageRecIterator.h"
+
+void MyDB_PaxPageRecIterator :: getNext () {
+	MyDB_PaxPage page (myPage->getBytes (), pageSize);
+	char *where = rows.empty () ? row.get () : rows.data () + rowOffset;
+	rowOffset += page.getRow (cur, where);
+	myRec->fromBinary (where);
+	page.skipRow (cur);
+}
+
+void *MyDB_PaxPageRecIterator :: getCurrentPointer () {
+	MyDB_PaxPage page (myPage->getBytes (), pageSize);
+	if (rows.empty ())
+		rows.resize (page.getRowBytes ());
+	page.getRow (cur, rows.data () + rowOffset);
+	return rows.data () + rowOffset;
+}
+
+bool MyDB_PaxPageRecIterator :: hasNext () {
+	return cur.whichRec != cur.numRecs;
+}
+
+MyDB_PaxPageRecIterator :: MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, size_t pageSizeIn,
+	MyDB_RecordPtr myRecIn) : row (new char[pageSizeIn]) {
+	myPage = myPageIn;
+	pageSize = pageSizeIn;
+	myRec = myRecIn;
+	MyDB_PaxPage (myPage->getBytes (), pageSize).firstRow (cur);
+	rowOffset = sizeof (size_t) * 2;
+}
+
+MyDB_PaxPageRecIterator :: ~MyDB_PaxPageRecIterator () {}
+
+#endif
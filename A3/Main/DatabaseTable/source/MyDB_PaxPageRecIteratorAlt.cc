@@ -0,0 +1,45 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_C
+#define PAX_PAGE_REC_ITER_ALT_C
+
+#include "MyDB_PaxPageRecIteratorAlt.h"
+
+void MyDB_PaxPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	char *where = rows.empty () ? row.get () : rows.data () + rowOffset;
+	nextRecSize = MyDB_PaxPage (myPage->getBytes (), pageSize).getRow (cur, where);
+	intoMe->fromBinary (where);
+}
+
+void *MyDB_PaxPageRecIteratorAlt :: getCurrentPointer () {
+	MyDB_PaxPage page (myPage->getBytes (), pageSize);
+	if (rows.empty ())
+		rows.resize (page.getRowBytes ());
+	page.getRow (cur, rows.data () + rowOffset);
+	return rows.data () + rowOffset;
+}
+
+bool MyDB_PaxPageRecIteratorAlt :: advance () {
+	if (nextRecSize == -1) {
+		cout << "You can't call advance without calling getCurrent!!\n";
+		exit (1);
+	}
+	if (nextRecSize != 0) {
+		MyDB_PaxPage (myPage->getBytes (), pageSize).skipRow (cur);
+		rowOffset += nextRecSize;
+	}
+	nextRecSize = -1;
+	return cur.whichRec != cur.numRecs;
+}
+
+MyDB_PaxPageRecIteratorAlt :: MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn, size_t pageSizeIn) :
+	row (new char[pageSizeIn]) {
+	myPage = myPageIn;
+	pageSize = pageSizeIn;
+	MyDB_PaxPage (myPage->getBytes (), pageSize).firstRow (cur);
+	rowOffset = sizeof (size_t) * 2;
+	nextRecSize = 0;
+}
+
+MyDB_PaxPageRecIteratorAlt :: ~MyDB_PaxPageRecIteratorAlt () {}
+
+#endif
@@ -0,0 +1,150 @@
+
+#ifndef RECORD_BATCH_C
+#define RECORD_BATCH_C
+
+#include "MyDB_RecordBatch.h"
+#include <string.h>
+
+using namespace std;
+
+MyDB_RecordBatch :: MyDB_RecordBatch (MyDB_SchemaPtr mySchemaIn) {
+	mySchema = mySchemaIn;
+	vector <int> whichAtts;
+	for (int i = 0; i < (int) mySchema->getAtts ().size (); i++)
+		whichAtts.push_back (i);
+	setUp (whichAtts);
+}
+
+MyDB_RecordBatch :: MyDB_RecordBatch (MyDB_SchemaPtr mySchemaIn, vector <int> whichAtts) {
+	mySchema = mySchemaIn;
+	setUp (whichAtts);
+}
+
+void MyDB_RecordBatch :: setUp (vector <int> &whichAtts) {
+
+	// figure out the type of each column
+	for (auto &att : mySchema->getAtts ()) {
+		Column col;
+		if (att.second->isBool ())
+			col.type = BoolCol;
+		else if (att.second->promotableToInt ())
+			col.type = IntCol;
+		else if (att.second->promotableToDouble ())
+			col.type = DoubleCol;
+		else
+			col.type = StringCol;
+		col.decoded = false;
+		columns.push_back (col);
+	}
+
+	// and allocate space for the ones that we decode; this is the only allocation that the
+	// batch does, other than growing the string buffer
+	for (int i : whichAtts) {
+		Column &col = columns[i];
+		col.decoded = true;
+		col.offsets.resize (MAX_BATCH_SIZE);
+		if (col.type == IntCol)
+			col.ints.resize (MAX_BATCH_SIZE);
+		else if (col.type == DoubleCol)
+			col.doubles.resize (MAX_BATCH_SIZE);
+		else if (col.type == BoolCol)
+			col.bools.resize (MAX_BATCH_SIZE);
+		else
+			col.stringStarts.resize (MAX_BATCH_SIZE);
+	}
+
+	recPointers.resize (MAX_BATCH_SIZE);
+	numRecs = 0;
+}
+
+void MyDB_RecordBatch :: clear () {
+	numRecs = 0;
+	stringData.clear ();
+}
+
+void *MyDB_RecordBatch :: addRecord (void *fromHere) {
+
+	if (mySchema->isFixedWidth ())
+		return addRecords (fromHere, 1);
+
+	char *recStart = (char *) fromHere;
+	recPointers[numRecs] = recStart;
+
+	// walk through the attributes; each one starts with its length (which includes the length itself)
+	char *pos = recStart + sizeof (short);
+	for (Column &col : columns) {
+		short len = *((short *) pos);
+		if (col.decoded) {
+			char *val = pos + sizeof (short);
+			col.offsets[numRecs] = (unsigned short) (val - recStart);
+			switch (col.type) {
+			case IntCol:
+				memcpy (&col.ints[numRecs], val, sizeof (int));
+				break;
+			case DoubleCol:
+				memcpy (&col.doubles[numRecs], val, sizeof (double));
+				break;
+			case BoolCol:
+				col.bools[numRecs] = (*val == 1);
+				break;
+			case StringCol:
+				col.stringStarts[numRecs] = stringData.size ();
+				stringData.insert (stringData.end (), val, val + len - sizeof (short));
+				break;
+			}
+		}
+		pos += len;
+	}
+
+	numRecs++;
+	return recStart + *((short *) recStart);
+}
+
+void *MyDB_RecordBatch :: addRecords (void *fromHere, int n) {
+
+	// every attribute is at the same offset in each record, and the records are a fixed
+	// distance apart, so each column is just a strided copy
+	char *recStart = (char *) fromHere;
+	size_t recSize = mySchema->getFixedSize ();
+	for (int r = 0; r < n; r++)
+		recPointers[numRecs + r] = recStart + r * recSize;
+
+	int whichAtt = 0;
+	for (Column &col : columns) {
+		size_t offset = mySchema->getFixedOffset (whichAtt++);
+		if (!col.decoded)
+			continue;
+		char *val = recStart + offset;
+		for (int r = 0; r < n; r++)
+			col.offsets[numRecs + r] = (unsigned short) offset;
+		switch (col.type) {
+		case IntCol:
+			for (int r = 0; r < n; r++, val += recSize)
+				memcpy (&col.ints[numRecs + r], val, sizeof (int));
+			break;
+		case DoubleCol:
+			for (int r = 0; r < n; r++, val += recSize)
+				memcpy (&col.doubles[numRecs + r], val, sizeof (double));
+			break;
+		case BoolCol:
+			for (int r = 0; r < n; r++, val += recSize)
+				col.bools[numRecs + r] = (*val == 1);
+			break;
+		case StringCol:
+			break;
+		}
+	}
+
+	numRecs += n;
+	return recStart + n * recSize;
+}
+
+void MyDB_RecordBatch :: getRecord (int whichRec, MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (recPointers[whichRec]);
+}
+
+MyDB_SchemaPtr MyDB_RecordBatch :: getSchema () {
+	return mySchema;
+}
+
+#endif
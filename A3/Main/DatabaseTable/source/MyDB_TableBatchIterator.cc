@@ -0,0 +1,40 @@
+
+#ifndef TABLE_BATCH_ITER_C
+#define TABLE_BATCH_ITER_C
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableBatchIterator.h"
+
+bool MyDB_TableBatchIterator :: getNextBatch (MyDB_RecordBatch &fillMe) {
+
+	while (true) {
+		if (myParent[curPage].getType () != MyDB_PageType :: DirectoryPage && myIter->getNextBatch (fillMe))
+			return true;
+
+		if (curPage == myTable->lastPage () || curPage == highPage)
+			return false;
+
+		curPage++;
+		myIter = myParent[curPage].getBatchIterator ();
+	}
+}
+
+MyDB_TableBatchIterator :: MyDB_TableBatchIterator (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	int lowPage, int highPageIn) : myParent (myParent) {
+	myTable = myTableIn;
+	curPage = lowPage;
+	highPage = highPageIn;
+	myIter = myParent[curPage].getBatchIterator ();
+}
+
+MyDB_TableBatchIterator :: MyDB_TableBatchIterator (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn) :
+	myParent (myParent) {
+	myTable = myTableIn;
+	curPage = 0;
+	highPage = 1999999999;
+	myIter = myParent[curPage].getBatchIterator ();
+}
+
+MyDB_TableBatchIterator :: ~MyDB_TableBatchIterator () {}
+
+#endif
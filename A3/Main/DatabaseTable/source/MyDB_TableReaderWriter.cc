@@ -13,10 +13,19 @@
 #ifndef TABLE_RW_C
 #define TABLE_RW_C
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <limits>
 #include <queue>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "MyDB_CompressedPage.h"
+#include "MyDB_PageListFilterIteratorAlt.h"
 #include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableBatchIterator.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
@@ -69,10 +78,10 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: operator [] (size_t i) {
 	return arrayAccessBuffer;
 }
 
-MyDB_RecordPtr MyDB_TableReaderWriter :: getEmptyRecord () {
+MyDB_RecordPtr MyDB_TableReaderWriter :: getEmptyRecord (MyDB_ArenaPtr arena) {
 
 	// use the schema to produce an empty record
-	return make_shared <MyDB_Record> (forMe->getSchema ());
+	return makeInArena <MyDB_Record> (arena, forMe->getSchema (), arena);
 }
 
 MyDB_PageReaderWriter MyDB_TableReaderWriter :: last () {
@@ -89,75 +98,378 @@ void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
 		forMe->setLastPage (forMe->lastPage () + 1);
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
 		lastPage->clear ();
+		emptyZones (forMe->lastPage ());
 		lastPage->append (appendMe);
 	}
+	addToStats (appendMe);
+	addToZones (forMe->lastPage (), appendMe);
 }
 
-pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName) {
-
-	// empty out the database file
+void MyDB_TableReaderWriter :: clear () {
 	forMe->setLastPage (0);
 	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
 	lastPage->clear ();
+	clearStats ();
+	for (auto &a : forMe->getZoneMaps ())
+		a.clear ();
+	emptyZones (0);
+}
 
-	// try to open the file
-	string line;
-	ifstream myfile (fName);
+void MyDB_TableReaderWriter :: emptyZones (int whichPage) {
+	for (auto &a : forMe->getZoneMaps ())
+		a.setEmpty (whichPage);
+}
+
+void MyDB_TableReaderWriter :: addToZones (int whichPage, MyDB_RecordPtr appendMe) {
+	for (auto &a : forMe->getZoneMaps ())
+		a.add (whichPage, appendMe->getAtt (a.getWhichAtt ()));
+}
+
+void MyDB_TableReaderWriter :: addZoneMap (string att) {
+
+	string fileType = forMe->getFileType ();
+	if (fileType != "heap" && fileType != "pax" && fileType != "compressed") {
+		cout << "This is bad... zone maps can only be kept for heap, PAX, and compressed files.\n";
+		exit (1);
+	}
+	pair <int, MyDB_AttTypePtr> whichAtt = forMe->getSchema ()->getAttByName (att);
+	if (whichAtt.first == -1) {
+		cout << "This is bad... could not find the attribute " << att << " to build a zone map on.\n";
+		exit (1);
+	}
 
+	// go through all of the pages, and get the zone of each one
+	MyDB_ZoneMap zoneMap (att, whichAtt.first, whichAtt.second);
 	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	for (int i = 0; i < getNumPages (); i++) {
+		zoneMap.setEmpty (i);
+		MyDB_RecordIteratorAltPtr myIter = (*this)[i].getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (tempRec);
+			zoneMap.add (i, tempRec->getAtt (whichAtt.first));
+		}
+	}
+
+	// and replace the old one, if there was one
+	MyDB_ZoneMap *oldOne = forMe->getZoneMap (att);
+	if (oldOne != nullptr)
+		*oldOne = zoneMap;
+	else
+		forMe->getZoneMaps ().push_back (zoneMap);
+}
 
-	// this data structure is used for apporoximate counting of the number of distinct
-	// values of each attribute
-	vector <pair <set <size_t>, int>> allHashes;
-	for (int i = 0; i < tempRec->getSchema ()->getAtts ().size (); i++) {
-		set <size_t> temp1;
-		allHashes.push_back (make_pair (temp1, 1));
+vector <int> MyDB_TableReaderWriter :: getPagesInRange (string att, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	// the other kinds of files have directory pages mixed in, which are not read
+	MyDB_ZoneMap *zoneMap = forMe->getZoneMap (att);
+	string fileType = forMe->getFileType ();
+	bool checkType = fileType != "heap" && fileType != "pax" && fileType != "compressed";
+	vector <int> returnVal;
+	for (int i = 0; i < getNumPages (); i++) {
+		if (zoneMap != nullptr && !zoneMap->mightHave (i, low, high))
+			continue;
+		if (checkType && (*this)[i].getType () == MyDB_PageType :: DirectoryPage)
+			continue;
+		returnVal.push_back (i);
 	}
+	return returnVal;
+}
 
-	// if we opened it, read the contents
-	size_t counter = 0;
-	if (myfile.is_open()) {
-
-		// loop through all of the lines
-		while (getline (myfile,line)) {
-			tempRec->fromString (line);		
-			counter++;
-			// hash all of the attributes... this is used for counting
-			int i = 0;
-			for (auto &a : allHashes) {
-
-				// insert the hash
-				size_t hash = tempRec->getAtt (i)->hash ();
-				i++;
-				if (hash % a.second != 0)
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getRangeScanIteratorAlt (string att, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+
+	pair <int, MyDB_AttTypePtr> whichAtt = forMe->getSchema ()->getAttByName (att);
+	if (whichAtt.first == -1) {
+		cout << "This is bad... could not find the attribute " << att << " to scan for a range of.\n";
+		exit (1);
+	}
+
+	vector <MyDB_PageReaderWriter> list;
+	for (int i : getPagesInRange (att, low, high))
+		list.push_back ((*this)[i]);
+
+	// the records on the pages still have to be checked, since a page's zone can overlap
+	// the range without all of its records being in it
+	MyDB_ZoneMap checker (att, whichAtt.first, whichAtt.second);
+	MyDB_RecordPtr myRec = getEmptyRecord ();
+	MyDB_AttValPtr val = myRec->getAtt (whichAtt.first);
+	return make_shared <MyDB_PageListFilterIteratorAlt> (list, myRec,
+		[checker, val, low, high] () mutable {return checker.inRange (val, low, high);});
+}
+
+void MyDB_TableReaderWriter :: clearStats () {
+	vector <MyDB_HyperLogLog> sketches (forMe->getSchema ()->getAtts ().size ());
+	forMe->setSketches (sketches);
+	forMe->setTupleCount (0);
+	vector <MyDB_AttStats> noStats;
+	forMe->setAttStats (noStats);
+}
+
+void MyDB_TableReaderWriter :: addToStats (MyDB_RecordPtr appendMe) {
+	vector <MyDB_HyperLogLog> &sketches = forMe->getSketches ();
+	if (sketches.empty ())
+		return;
+	for (size_t i = 0; i < sketches.size (); i++)
+		sketches[i].add (appendMe->getAtt (i)->hash ());
+	forMe->setTupleCount (forMe->getTupleCount () + 1);
+}
+
+void MyDB_TableReaderWriter :: analyze (size_t sampleSize, int numBuckets) {
+
+	// visit the pages in a random order (the same one each time)
+	vector <int> pages (getNumPages ());
+	for (size_t i = 0; i < pages.size (); i++)
+		pages[i] = i;
+	shuffle (pages.begin (), pages.end (), default_random_engine (530));
+
+	vector <pair <string, MyDB_AttTypePtr>> &atts = forMe->getSchema ()->getAtts ();
+	vector <vector <MyDB_AttValPtr>> samples (atts.size ());
+	vector <size_t> numNulls (atts.size (), 0);
+	size_t numSampled = 0;
+	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	for (int whichPage : pages) {
+		if (numSampled >= sampleSize)
+			break;
+		MyDB_PageReaderWriter page = (*this)[whichPage];
+		if (page.getType () == MyDB_PageType :: DirectoryPage)
+			continue;
+
+		MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (tempRec);
+			numSampled++;
+			for (size_t i = 0; i < atts.size (); i++) {
+				MyDB_AttValPtr att = tempRec->getAtt (i);
+				bool isString = !atts[i].second->promotableToDouble () && !atts[i].second->isBool ();
+				if (isString && att->toString ().empty ())
+					numNulls[i]++;
+				else
+					samples[i].push_back (att->getCopy ());
+			}
+		}
+	}
+
+	vector <MyDB_AttStats> allStats;
+	for (size_t i = 0; i < atts.size (); i++) {
+		MyDB_AttStats stats (atts[i].second);
+		stats.build (samples[i], numNulls[i], numBuckets);
+		allStats.push_back (stats);
+	}
+	forMe->setAttStats (allStats);
+}
+
+void MyDB_TableReaderWriter :: appendImage (void *image) {
+
+	// a PAX page is laid out differently from a regular page, so go record by record... a
+	// compressed table takes compressed images as they are, but anything else is appended
+	// record by record, onto PAX pages
+	MyDB_PageType imageType = *((MyDB_PageType *) image);
+	bool compressed = (forMe->getFileType () == "compressed");
+	if (forMe->getFileType () == "pax" || (compressed && imageType != MyDB_PageType :: CompressedPage)) {
+		appendImageRecords (image);
+		return;
+	}
+	if (!compressed && imageType == MyDB_PageType :: CompressedPage) {
+		cout << "This is bad... a compressed page image can only go into a compressed table.\n";
+		exit (1);
+	}
+
+	// the image goes onto the last page if nothing has been written there; otherwise, onto
+	// a new last page
+	if (lastPage->getType () == MyDB_PageType :: CompressedPage || lastPage->getIteratorAlt ()->advance ()) {
+		forMe->setLastPage (forMe->lastPage () + 1);
+		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
+	}
+	lastPage->copyFrom (image);
+
+	// and the zone maps need to hear about each of the records
+	emptyZones (forMe->lastPage ());
+	if (!forMe->getZoneMaps ().empty ()) {
+		MyDB_RecordPtr tempRec = getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = lastPage->getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (tempRec);
+			addToZones (forMe->lastPage (), tempRec);
+		}
+	}
+}
+
+void MyDB_TableReaderWriter :: appendImageRecords (void *image) {
+	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	size_t bytesUsed = *((size_t *) (((char *) image) + sizeof (size_t)));
+	for (char *pos = ((char *) image) + 2 * sizeof (size_t); pos < ((char *) image) + bytesUsed; ) {
+		pos = (char *) tempRec->fromBinary (pos);
+		append (tempRec);
+	}
+}
+
+// parses the lines in [start, end) into a list of page images, packed in order... these are
+// regular pages, unless compress is true, in which case they are compressed pages
+static void parseLines (char *start, char *end, MyDB_SchemaPtr mySchema, size_t pageSize, bool compress,
+	vector <vector <char>> &images, vector <MyDB_HyperLogLog> &sketches, size_t &counter) {
+
+	MyDB_RecordPtr tempRec = make_shared <MyDB_Record> (mySchema);
+	MyDB_CompressedPageBuilder builder (mySchema, pageSize);
+	vector <char> rec;
+	images.clear ();
+	size_t bytesUsed = pageSize;
+	while (start < end) {
+		if (*start == '\n') {
+			start++;
+			continue;
+		}
+
+		start = (char *) tempRec->fromText (start, end);
+		counter++;
+		for (size_t i = 0; i < sketches.size (); i++)
+			sketches[i].add (tempRec->getAtt (i)->hash ());
+
+		// start a new page if this one is full
+		size_t recSize = tempRec->getBinarySize ();
+		if (compress) {
+			rec.resize (recSize);
+			tempRec->toBinary (rec.data ());
+			if (builder.add (rec.data ()))
+				continue;
+			if (builder.getNumRecs () == 0) {
+				cout << "This is bad... a record is too large to fit onto a page.\n";
+				exit (1);
+			}
+			images.push_back (vector <char> (pageSize));
+			builder.write (images.back ().data ());
+			builder.add (rec.data ());
+			continue;
+		}
+		if (bytesUsed + recSize > pageSize) {
+			if (2 * sizeof (size_t) + recSize > pageSize) {
+				cout << "This is bad... a record is too large to fit onto a page.\n";
+				exit (1);
+			}
+			images.push_back (vector <char> (pageSize));
+			*((MyDB_PageType *) images.back ().data ()) = MyDB_PageType :: RegularPage;
+			bytesUsed = 2 * sizeof (size_t);
+		}
+		tempRec->toBinary (images.back ().data () + bytesUsed);
+		bytesUsed += recSize;
+		*((size_t *) (images.back ().data () + sizeof (size_t))) = bytesUsed;
+	}
+
+	if (builder.getNumRecs () > 0) {
+		images.push_back (vector <char> (pageSize));
+		builder.write (images.back ().data ());
+	}
+}
+
+// the number of bytes of the text file that each thread parses at a time
+#define CHUNK_SIZE (8 * 1024 * 1024)
+
+pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName, int numThreads, bool buildStats) {
+
+	// empty out the database file
+	clear ();
+
+	if (numThreads <= 0)
+		numThreads = max (1, (int) thread :: hardware_concurrency ());
+
+	// each thread has its own pages, its own sketches of the attributes, and its own count
+	vector <vector <vector <char>>> images (numThreads);
+	int numAtts = forMe->getSchema ()->getAtts ().size ();
+	vector <vector <MyDB_HyperLogLog>> sketches (numThreads, vector <MyDB_HyperLogLog> (numAtts));
+	vector <size_t> counters (numThreads, 0);
+
+	// try to open the file
+	auto startTime = chrono :: steady_clock :: now ();
+	size_t totalBytes = 0;
+	FILE *myFile = fopen (fName.c_str (), "r");
+
+	// if we opened it, read the contents... in each round, the buffer holds whatever was
+	// left over (an incomplete line) from the last round, plus the new bytes
+	if (myFile != nullptr) {
+
+		// no need for a buffer that is bigger than the file
+		fseek (myFile, 0, SEEK_END);
+		size_t fileSize = ftell (myFile);
+		fseek (myFile, 0, SEEK_SET);
+		vector <char> buffer (min (CHUNK_SIZE * (size_t) numThreads, fileSize + 1));
+		size_t bytesInBuffer = 0;
+		bool done = false;
+		while (!done) {
+			if (bytesInBuffer == buffer.size ())
+				buffer.resize (2 * buffer.size ());
+			size_t bytesRead = fread (buffer.data () + bytesInBuffer, 1, buffer.size () - bytesInBuffer, myFile);
+			totalBytes += bytesRead;
+			bytesInBuffer += bytesRead;
+			done = (bytesRead == 0);
+
+			// parse up through the last full line (or everything, at the end of the file)
+			char *start = buffer.data ();
+			char *end = start + bytesInBuffer;
+			if (!done) {
+				while (end > start && end[-1] != '\n')
+					end--;
+				if (end == start)
 					continue;
+			}
 
-				a.first.insert (hash);
-
-				// if we have too many items, compact them
-				#define MAX_SIZE 1000
-				if (a.first.size () > MAX_SIZE) {
-					a.second *= 2;
-					set <size_t> newSet;
-					for (auto &num : a.first) {
-						if (num % a.second == 0)
-							newSet.insert (num);
-					}
-					a.first = newSet;	
-				}
+			// cut the lines up into one piece per thread, at line boundaries
+			vector <char *> cuts {start};
+			for (int i = 1; i < numThreads; i++) {
+				char *cut = max (cuts.back (), start + (end - start) * i / numThreads);
+				while (cut < end && cut != start && cut[-1] != '\n')
+					cut++;
+				cuts.push_back (cut);
 			}
-			append (tempRec);
+			cuts.push_back (end);
+
+			vector <thread> threads;
+			for (int i = 0; i < numThreads; i++) {
+				threads.push_back (thread (parseLines, cuts[i], cuts[i + 1], forMe->getSchema (),
+					myBuffer->getPageSize (), forMe->getFileType () == "compressed", ref (images[i]),
+					ref (sketches[i]), ref (counters[i])));
+			}
+			for (auto &t : threads)
+				t.join ();
+
+			// add the pages onto the table, in the order that they appeared in the file
+			for (auto &forThread : images) {
+				for (auto &image : forThread)
+					appendImage (image.data ());
+			}
+
+			// and keep the partial line for the next round
+			bytesInBuffer = start + bytesInBuffer - end;
+			memmove (start, end, bytesInBuffer);
 		}
-		myfile.close ();
+		fclose (myFile);
+	}
+
+	// the table's statistics are just the ones from all of the threads put together (if the
+	// records went through append (), the table's sketches already have them, but adding a
+	// value to a sketch twice does not change anything)
+	size_t counter = 0;
+	vector <MyDB_HyperLogLog> &tableSketches = forMe->getSketches ();
+	for (int i = 0; i < numThreads; i++) {
+		counter += counters[i];
+		for (int j = 0; j < numAtts; j++)
+			tableSketches[j].merge (sketches[i][j]);
 	}
-	cout << "Loaded " << counter << " records.\n";
+	forMe->setTupleCount (counter);
+
+	// the load rate is just for parsing and writing the pages... building the statistics is
+	// timed on its own, since it reads a sample of the pages back in
+	double secs = chrono :: duration <double> (chrono :: steady_clock :: now () - startTime).count ();
+	cout << "Loaded " << counter << " records (" << (totalBytes / (1024.0 * 1024.0)) / max (secs, 1e-9) << " MB/s";
+	if (buildStats) {
+		auto analyzeStart = chrono :: steady_clock :: now ();
+		analyze ();
+		cout << ", plus " << chrono :: duration <double, milli> (chrono :: steady_clock :: now () - analyzeStart).count ()
+			<< " ms to build the statistics";
+	}
+	cout << ").\n";
 
 	// finally, compute the vector of estimates
 	vector <size_t> returnVal;
-	for (auto &a : allHashes) {
-		size_t est = ((size_t) a.first.size ()) * a.second;
-		returnVal.push_back (est);
-	}
+	for (auto &a : tableSketches)
+		returnVal.push_back (a.estimate ());
 	return make_pair (returnVal, counter);
 }
 
@@ -173,6 +485,30 @@ MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (int lowPage,
 	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, lowPage, highPage);
 }
 
+MyDB_BatchIteratorPtr MyDB_TableReaderWriter :: getBatchIterator () {
+	return make_shared <MyDB_TableBatchIterator> (*this, forMe);
+}
+
+MyDB_BatchIteratorPtr MyDB_TableReaderWriter :: getBatchIterator (int lowPage, int highPage) {
+	return make_shared <MyDB_TableBatchIterator> (*this, forMe, lowPage, highPage);
+}
+
+MyDB_RecordBatchPtr MyDB_TableReaderWriter :: getEmptyBatch (vector <string> whichAtts) {
+	if (whichAtts.empty ())
+		return make_shared <MyDB_RecordBatch> (forMe->getSchema ());
+
+	vector <int> positions;
+	for (string &att : whichAtts) {
+		int pos = forMe->getSchema ()->getAttByName (att).first;
+		if (pos == -1) {
+			cout << "This is bad... could not find the attribute " << att << " to put in a batch.\n";
+			exit (1);
+		}
+		positions.push_back (pos);
+	}
+	return make_shared <MyDB_RecordBatch> (forMe->getSchema (), positions);
+}
+
 void MyDB_TableReaderWriter :: writeIntoTextFile (string fName) {
 	
 	// open up the output file
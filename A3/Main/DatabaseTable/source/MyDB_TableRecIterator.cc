@@ -25,7 +25,7 @@ void *MyDB_TableRecIterator :: getCurrentPointer () {
 }
 
 bool MyDB_TableRecIterator :: hasNext () {
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->hasNext ())
+	if (myParent[curPage].getType () != MyDB_PageType :: DirectoryPage && myIter->hasNext ())
 		return true;
 
 	if (curPage == myTable->lastPage ())
@@ -26,7 +26,7 @@ void *MyDB_TableRecIteratorAlt :: getCurrentPointer () {
 
 bool MyDB_TableRecIteratorAlt :: advance () {
 
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
+	if (myParent[curPage].getType () != MyDB_PageType :: DirectoryPage && myIter->advance ())
 		return true;
 
 	if (curPage == myTable->lastPage () || curPage == highPage)
@@ -3,10 +3,12 @@
 #define SORT_C
 
 #include "Sorting.h"
+#include "MyDB_MergeIteratorAlt.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
+#include "RecordComparator.h"
 
 using namespace std;
 
@@ -14,10 +16,6 @@ using namespace std;
 #include <queue>
 #include <vector>
 
-#include <algorithm>
-#include <queue>
-#include <vector>
-
 // Comparator struct for the priority queue in mergeIntoFile
 struct MergeRecord {
   MyDB_RecordIteratorAltPtr iterator;
@@ -79,7 +77,7 @@ public:
 void mergeIntoFile(MyDB_TableReaderWriter &sortIntoMe,
                    vector<MyDB_RecordIteratorAltPtr> &mergeUs,
                    function<bool()> comparator, MyDB_RecordPtr lhs,
-                   MyDB_RecordPtr rhs) {
+                   MyDB_RecordPtr rhs, size_t limit) {
 
   std::priority_queue<MyDB_RecordIteratorAltPtr,
                       std::vector<MyDB_RecordIteratorAltPtr>,
@@ -92,12 +90,14 @@ void mergeIntoFile(MyDB_TableReaderWriter &sortIntoMe,
     }
   }
 
-  while (!pQueue.empty()) {
+  size_t written = 0;
+  while (!pQueue.empty() && written < limit) {
     MyDB_RecordIteratorAltPtr smallestIter = pQueue.top();
     pQueue.pop();
 
     smallestIter->getCurrent(lhs);
     sortIntoMe.append(lhs);
+    written++;
 
     if (smallestIter->advance()) {
       pQueue.push(smallestIter);
@@ -168,9 +168,50 @@ mergeIntoList(MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
   return resultPages;
 }
 
-void sort(int runSize, MyDB_TableReaderWriter &sortMe,
-          MyDB_TableReaderWriter &sortIntoMe, function<bool()> comparator,
-          MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+// sorts each of the pages in pagesInRun in place, and then merges them into a single
+// sorted list of anonymous pages
+static vector<MyDB_PageReaderWriter>
+sortRun(MyDB_BufferManagerPtr myMgr, vector<MyDB_PageReaderWriter> &pagesInRun,
+        function<bool()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+  vector<vector<MyDB_PageReaderWriter>> subRuns;
+  for (auto &p : pagesInRun) {
+    p.sortInPlace(comparator, lhs, rhs);
+    vector<MyDB_PageReaderWriter> singlePageRun;
+    singlePageRun.push_back(p);
+    subRuns.push_back(singlePageRun);
+  }
+
+  while (subRuns.size() > 1) {
+    vector<vector<MyDB_PageReaderWriter>> nextSubRuns;
+    for (auto it = subRuns.begin(); it != subRuns.end();) {
+      vector<MyDB_PageReaderWriter> &run1 = *it;
+      it++;
+      if (it != subRuns.end()) {
+        vector<MyDB_PageReaderWriter> &run2 = *it;
+        it++;
+
+        MyDB_RecordIteratorAltPtr iter1 = getIteratorAlt(run1);
+        MyDB_RecordIteratorAltPtr iter2 = getIteratorAlt(run2);
+        nextSubRuns.push_back(
+            mergeIntoList(myMgr, iter1, iter2, comparator, lhs, rhs));
+      } else {
+        nextSubRuns.push_back(run1);
+      }
+    }
+    subRuns = nextSubRuns;
+  }
+
+  return subRuns.empty() ? vector<MyDB_PageReaderWriter>() : subRuns[0];
+}
+
+// helper function for sort () and sortTopK ().  Runs the first phase of the TPMMS: every
+// group of runSize pages in sortMe is sorted into a single run of anonymous pages, and an
+// iterator over each of those runs is returned
+static vector<MyDB_RecordIteratorAltPtr>
+buildSortedRuns(int runSize, MyDB_TableReaderWriter &sortMe,
+                function<bool()> comparator, MyDB_RecordPtr lhs,
+                MyDB_RecordPtr rhs) {
 
   MyDB_BufferManagerPtr myMgr = sortMe.getBufferMgr();
   vector<MyDB_RecordIteratorAltPtr> mergePhaseIterators;
@@ -178,45 +219,188 @@ void sort(int runSize, MyDB_TableReaderWriter &sortMe,
 
   for (int i = 0; i < numPages; i += runSize) {
     vector<MyDB_PageReaderWriter> pagesInRun;
-
-    for (int j = 0; j < runSize && (i + j) < numPages; j++) {
+    for (int j = 0; j < runSize && (i + j) < numPages; j++)
       pagesInRun.push_back(sortMe[i + j]);
-      pagesInRun.back().sortInPlace(comparator, lhs, rhs);
+
+    vector<MyDB_PageReaderWriter> run =
+        sortRun(myMgr, pagesInRun, comparator, lhs, rhs);
+    if (!run.empty()) {
+      mergePhaseIterators.push_back(getIteratorAlt(run));
     }
+  }
+
+  return mergePhaseIterators;
+}
+
+void sort(int runSize, MyDB_TableReaderWriter &sortMe,
+          MyDB_TableReaderWriter &sortIntoMe, function<bool()> comparator,
+          MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+  vector<MyDB_RecordIteratorAltPtr> mergePhaseIterators =
+      buildSortedRuns(runSize, sortMe, comparator, lhs, rhs);
+  mergeIntoFile(sortIntoMe, mergePhaseIterators, comparator, lhs, rhs);
+}
 
-    vector<vector<MyDB_PageReaderWriter>> subRuns;
-    for (auto &p : pagesInRun) {
-      vector<MyDB_PageReaderWriter> singlePageRun;
-      singlePageRun.push_back(p);
-      subRuns.push_back(singlePageRun);
+MyDB_RecordIteratorAltPtr
+buildIteratorOverSortedRuns(int runSize, MyDB_TableReaderWriter &sortMe,
+                            function<bool()> comparator, MyDB_RecordPtr lhs,
+                            MyDB_RecordPtr rhs) {
+
+  vector<MyDB_RecordIteratorAltPtr> mergePhaseIterators =
+      buildSortedRuns(runSize, sortMe, comparator, lhs, rhs);
+  return make_shared<MyDB_MergeIteratorAlt>(mergePhaseIterators, comparator,
+                                            lhs, rhs);
+}
+
+MyDB_RecordIteratorAltPtr
+buildIteratorOverSortedRuns(int runSize, MyDB_BufferManagerPtr parent,
+                            vector<MyDB_PageReaderWriter> &sortMe,
+                            function<bool()> comparator, MyDB_RecordPtr lhs,
+                            MyDB_RecordPtr rhs) {
+
+  vector<MyDB_RecordIteratorAltPtr> mergePhaseIterators;
+  for (size_t i = 0; i < sortMe.size(); i += runSize) {
+    vector<MyDB_PageReaderWriter> pagesInRun(
+        sortMe.begin() + i,
+        sortMe.begin() + min(sortMe.size(), i + (size_t)runSize));
+
+    vector<MyDB_PageReaderWriter> run =
+        sortRun(parent, pagesInRun, comparator, lhs, rhs);
+    if (!run.empty()) {
+      mergePhaseIterators.push_back(getIteratorAlt(run));
     }
+  }
+  return make_shared<MyDB_MergeIteratorAlt>(mergePhaseIterators, comparator,
+                                            lhs, rhs);
+}
 
-    while (subRuns.size() > 1) {
-      vector<vector<MyDB_PageReaderWriter>> nextSubRuns;
-      for (auto it = subRuns.begin(); it != subRuns.end();) {
-        vector<MyDB_PageReaderWriter> &run1 = *it;
-        it++;
-        if (it != subRuns.end()) {
-          vector<MyDB_PageReaderWriter> &run2 = *it;
-          it++;
-
-          MyDB_RecordIteratorAltPtr iter1 = getIteratorAlt(run1);
-          MyDB_RecordIteratorAltPtr iter2 = getIteratorAlt(run2);
-          nextSubRuns.push_back(
-              mergeIntoList(myMgr, iter1, iter2, comparator, lhs, rhs));
-        } else {
-          nextSubRuns.push_back(run1);
-        }
+// one of the k candidates held by sortTopK (): the index of the pinned page
+// that holds the record, and the location of the record on that page
+struct TopKEntry {
+  size_t page;
+  void *rec;
+};
+
+// packs all of the live candidates to the front of the pinned pages, so that the
+// space held by records that were evicted from the heap can be reused.  Records
+// are moved in address order, so a record never moves past a record that has not
+// been moved yet, and the heap order is unchanged since only the locations change.
+// Returns the index of the last page that holds a live record
+static size_t compactTopK(vector<MyDB_PageReaderWriter> &heapPages,
+                          vector<TopKEntry> &heap, MyDB_RecordPtr lhs) {
+
+  vector<size_t> order(heap.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (heap[a].page != heap[b].page)
+      return heap[a].page < heap[b].page;
+    return heap[a].rec < heap[b].rec;
+  });
+
+  for (auto &page : heapPages)
+    page.clear();
+
+  size_t curPage = 0;
+  for (size_t i : order) {
+    lhs->fromBinary(heap[i].rec);
+    void *loc;
+    while ((loc = heapPages[curPage].appendAndReturnLocation(lhs)) == nullptr)
+      curPage++;
+    heap[i].page = curPage;
+    heap[i].rec = loc;
+  }
+  return curPage;
+}
+
+void sortTopK(size_t k, int runSize, MyDB_TableReaderWriter &sortMe,
+              MyDB_TableReaderWriter &sortIntoMe, function<bool()> comparator,
+              MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
+
+  if (k == 0)
+    return;
+
+  MyDB_BufferManagerPtr myMgr = sortMe.getBufferMgr();
+  RecordComparator recComp(comparator, lhs, rhs);
+  auto entryComp = [&](const TopKEntry &a, const TopKEntry &b) {
+    return recComp(a.rec, b.rec);
+  };
+
+  // the candidates are a max-heap, so the largest of the k smallest records seen
+  // so far is always at the front, and their bytes live in pinned anonymous pages
+  vector<TopKEntry> heap;
+  vector<MyDB_PageReaderWriter> heapPages;
+  heapPages.push_back(MyDB_PageReaderWriter(true, *myMgr));
+  size_t curPage = 0;
+
+  // rhs caches the current k^th record, so that rejecting a record costs
+  // a single comparison and nothing is copied
+  bool rhsHoldsTop = false;
+  bool fits = true;
+
+  MyDB_RecordIteratorAltPtr myIter = sortMe.getIteratorAlt();
+  while (myIter->advance()) {
+    myIter->getCurrent(lhs);
+
+    if (heap.size() == k) {
+      if (!rhsHoldsTop) {
+        rhs->fromBinary(heap.front().rec);
+        rhsHoldsTop = true;
       }
-      subRuns = nextSubRuns;
+      if (!comparator())
+        continue;
+
+      // the new record beats the k^th one, so the k^th one leaves the heap;
+      // its bytes stay on the page as garbage until the next compaction
+      std::pop_heap(heap.begin(), heap.end(), entryComp);
+      heap.pop_back();
+      myIter->getCurrent(lhs);
+    }
+
+    // find space for the new candidate: first on the current page, then on the next
+    // page (adding one while we are under budget), and finally by compacting
+    void *loc = heapPages[curPage].appendAndReturnLocation(lhs);
+    if (loc == nullptr && curPage + 1 == heapPages.size() &&
+        (int)heapPages.size() < runSize)
+      heapPages.push_back(MyDB_PageReaderWriter(true, *myMgr));
+    if (loc == nullptr && curPage + 1 < heapPages.size())
+      loc = heapPages[++curPage].appendAndReturnLocation(lhs);
+    if (loc == nullptr) {
+      curPage = compactTopK(heapPages, heap, lhs);
+      myIter->getCurrent(lhs);
+      loc = heapPages[curPage].appendAndReturnLocation(lhs);
+      if (loc == nullptr && curPage + 1 < heapPages.size())
+        loc = heapPages[++curPage].appendAndReturnLocation(lhs);
     }
 
-    if (!subRuns.empty()) {
-      mergePhaseIterators.push_back(getIteratorAlt(subRuns[0]));
+    // the k records do not fit into runSize pages
+    if (loc == nullptr) {
+      fits = false;
+      break;
     }
+
+    heap.push_back(TopKEntry{curPage, loc});
+    std::push_heap(heap.begin(), heap.end(), entryComp);
+    rhsHoldsTop = false;
   }
 
-  mergeIntoFile(sortIntoMe, mergePhaseIterators, comparator, lhs, rhs);
+  // if k is too large for RAM, use a TPMMS whose final merge stops early
+  if (!fits) {
+    heap.clear();
+    heapPages.clear();
+    vector<MyDB_RecordIteratorAltPtr> mergePhaseIterators =
+        buildSortedRuns(runSize, sortMe, comparator, lhs, rhs);
+    mergeIntoFile(sortIntoMe, mergePhaseIterators, comparator, lhs, rhs, k);
+    return;
+  }
+
+  // otherwise, the heap holds the answer
+  std::sort_heap(heap.begin(), heap.end(), entryComp);
+  for (auto &entry : heap) {
+    lhs->fromBinary(entry.rec);
+    sortIntoMe.append(lhs);
+  }
 }
 
 #endif
@@ -0,0 +1,104 @@
+
+#ifndef HASH_RW_H
+#define HASH_RW_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_INRecord.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include <map>
+#include <vector>
+
+using namespace std;
+
+class MyDB_HashReaderWriter;
+typedef shared_ptr <MyDB_HashReaderWriter> MyDB_HashReaderWriterPtr;
+
+// A MyDB_HashReaderWriter stores a table as a linear hash file on one of its attributes (for
+// a table whose file type is "hash", this is the table's sort attribute).  Each bucket is a
+// chain of regular pages, and an equality probe only reads the chain for one bucket.
+//
+// Whenever an insert has to start a new overflow page, the file grows by one bucket: the next
+// bucket in order is split, and the records in it whose hash (mod twice the current number of
+// buckets, rounded down to a power of two) lands on the new bucket are moved.  So growing the
+// file never rehashes more than one bucket at a time.
+//
+// Which pages belong to which bucket is written into a log of MyDB_INRecords (key = bucket,
+// pointer = page) on a chain of directory pages starting at the table's root location, so the
+// usual table iterators still do a full scan of the records, and the file can be re-opened by
+// replaying the log.  For example:
+//
+//	MyDB_HashReaderWriter myHash ("suppkey", myTable, myMgr);
+//	myHash.loadFromTextFile ("supplier.tbl");
+//	MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+//	key->set (12);
+//	MyDB_RecordIteratorAltPtr myIter = myHash.getEqualityIteratorAlt (key);
+class MyDB_HashReaderWriter : public MyDB_TableReaderWriter {
+
+public:
+
+	// create a hash file over the table, on the named attribute... if the table does not have
+	// a root yet, an empty file (with one bucket) is set up
+	MyDB_HashReaderWriter (string hashOnAttName, MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
+
+	// like the above, except that the file is hashed on the table's sort attribute
+	MyDB_HashReaderWriter (MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
+
+	// gets an instance of an alternate iterator over all of the records whose hashed
+	// attribute is equal to the given value
+	MyDB_RecordIteratorAltPtr getEqualityIteratorAlt (MyDB_AttValPtr key);
+
+	// insert a record into the file, growing the file by a bucket if needed
+	void append (MyDB_RecordPtr appendMe) override;
+
+	// the records on a page image have to go wherever they belong in the file, so they are
+	// inserted one at a time
+	void appendImage (void *image) override;
+
+	// empties out the file, leaving a single empty bucket
+	void clear () override;
+
+	// the number of buckets, and the number of pages in the given bucket
+	int getNumBuckets ();
+	int getBucketSize (int whichBucket);
+
+private:
+
+	// the bucket that a hash value goes to
+	int getBucket (size_t hashVal);
+
+	// the hash of a value of the attribute that the file is hashed on
+	size_t hash (MyDB_AttValPtr hashMe);
+
+	// adds the record at the end of the bucket; returns true if a new page was needed
+	bool addToBucket (int whichBucket, MyDB_RecordPtr addMe);
+
+	// adds one more bucket, by splitting the next bucket in order
+	void split ();
+
+	// gets an empty page, either one that was freed or a new one at the end of the file
+	int getEmptyPage ();
+
+	// writes (whichBucket, whichPage) into the log... whichBucket is FREE_PAGE if the page has
+	// been freed, and DIRECTORY_PAGE if the log continues on the page
+	void writeLog (int whichBucket, int whichPage);
+
+	// reads the log, starting at the root, to find out which pages are in which bucket
+	void readLog ();
+
+	// the type and position of the attribute the file is hashed on
+	MyDB_AttTypePtr hashAttType;
+	int whichAttIsHashed;
+
+	// the pages in each bucket, in order, and the pages that are not being used
+	vector <vector <int>> buckets;
+	vector <int> freePages;
+
+	// the directory page that the log is being written onto, the number of entries on it,
+	// and how many entries it can hold
+	int logPage;
+	int logEntries;
+	int logCapacity;
+};
+
+#endif
@@ -0,0 +1,275 @@
+
+#ifndef HASH_RW_C
+#define HASH_RW_C
+
+#include <algorithm>
+#include "MyDB_HashReaderWriter.h"
+#include "MyDB_PageListFilterIteratorAlt.h"
+#include <iostream>
+#include <string.h>
+
+// the special buckets used in the log
+#define FREE_PAGE -1
+#define DIRECTORY_PAGE -2
+
+MyDB_HashReaderWriter :: MyDB_HashReaderWriter (string hashOnAttName, MyDB_TablePtr forMeIn,
+	MyDB_BufferManagerPtr myBufferIn) : MyDB_TableReaderWriter (forMeIn, myBufferIn) {
+
+	// find the attribute to hash on
+	auto res = forMe->getSchema ()->getAttByName (hashOnAttName);
+	if (res.first == -1) {
+		cout << "This is bad... could not find the attribute " << hashOnAttName << " to hash on.\n";
+		exit (1);
+	}
+	whichAttIsHashed = res.first;
+	hashAttType = res.second;
+
+	// every log entry is the same size
+	MyDB_INRecord entry (make_shared <MyDB_IntAttVal> ());
+	logCapacity = (myBuffer->getPageSize () - 2 * sizeof (size_t)) / entry.getBinarySize ();
+	if (logCapacity < 2) {
+		cout << "This is bad... the pages are too small for a hash file.\n";
+		exit (1);
+	}
+
+	// and set up an empty file if there is not one already
+	if (forMe->getRootLocation () == -1)
+		clear ();
+	else
+		readLog ();
+}
+
+MyDB_HashReaderWriter :: MyDB_HashReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) :
+	MyDB_HashReaderWriter (forMeIn->getSortAtt (), forMeIn, myBufferIn) {}
+
+void MyDB_HashReaderWriter :: clear () {
+
+	// page 0 is the start of the log, and page 1 is the only bucket
+	forMe->setLastPage (1);
+	MyDB_PageReaderWriter root = (*this)[0];
+	root.clear ();
+	root.setType (MyDB_PageType :: DirectoryPage);
+	lastPage = make_shared <MyDB_PageReaderWriter> (*this, 1);
+	lastPage->clear ();
+	forMe->setRootLocation (0);
+
+	logPage = 0;
+	logEntries = 0;
+	buckets.clear ();
+	buckets.push_back (vector <int> {1});
+	freePages.clear ();
+	writeLog (0, 1);
+	clearStats ();
+}
+
+void MyDB_HashReaderWriter :: readLog () {
+
+	buckets.clear ();
+	freePages.clear ();
+	map <int, int> owner;
+	MyDB_INRecordPtr entry = make_shared <MyDB_INRecord> (make_shared <MyDB_IntAttVal> ());
+
+	for (logPage = forMe->getRootLocation (); true; ) {
+		int nextPage = -1;
+		logEntries = 0;
+		MyDB_RecordIteratorAltPtr myIter = (*this)[logPage].getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (entry);
+			logEntries++;
+			int whichBucket = entry->getKey ()->toInt ();
+			int whichPage = entry->getPtr ();
+
+			// take the page out of wherever it was
+			auto oldOwner = owner.find (whichPage);
+			if (oldOwner != owner.end ()) {
+				vector <int> &pages = buckets[oldOwner->second];
+				pages.erase (find (pages.begin (), pages.end (), whichPage));
+				owner.erase (oldOwner);
+			}
+			freePages.erase (remove (freePages.begin (), freePages.end (), whichPage), freePages.end ());
+
+			// and put it where it goes now
+			if (whichBucket == DIRECTORY_PAGE) {
+				nextPage = whichPage;
+			} else if (whichBucket == FREE_PAGE) {
+				freePages.push_back (whichPage);
+			} else {
+				if (whichBucket >= (int) buckets.size ())
+					buckets.resize (whichBucket + 1);
+				buckets[whichBucket].push_back (whichPage);
+				owner[whichPage] = whichBucket;
+			}
+		}
+		if (nextPage == -1)
+			break;
+		logPage = nextPage;
+	}
+}
+
+void MyDB_HashReaderWriter :: writeLog (int whichBucket, int whichPage) {
+
+	// if this page of the log is almost full, the last entry on it says where the log continues
+	if (logEntries == logCapacity - 1) {
+		int nextPage = getEmptyPage ();
+		(*this)[nextPage].setType (MyDB_PageType :: DirectoryPage);
+		MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+		key->set (DIRECTORY_PAGE);
+		MyDB_INRecordPtr entry = make_shared <MyDB_INRecord> (key);
+		entry->setPtr (nextPage);
+		(*this)[logPage].append (entry);
+		logPage = nextPage;
+		logEntries = 0;
+	}
+
+	MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+	key->set (whichBucket);
+	MyDB_INRecordPtr entry = make_shared <MyDB_INRecord> (key);
+	entry->setPtr (whichPage);
+	(*this)[logPage].append (entry);
+	logEntries++;
+}
+
+int MyDB_HashReaderWriter :: getEmptyPage () {
+	if (!freePages.empty ()) {
+		int whichPage = freePages.back ();
+		freePages.pop_back ();
+		return whichPage;
+	}
+
+	// going off of the end of the file gives us an empty page
+	int whichPage = forMe->lastPage () + 1;
+	(*this)[whichPage];
+	return whichPage;
+}
+
+size_t MyDB_HashReaderWriter :: hash (MyDB_AttValPtr hashMe) {
+
+	// std::hash is the identity on ints, and the buckets are chosen using the low-order
+	// bits, so mix the bits up first
+	size_t hashVal = hashMe->hash ();
+	hashVal ^= hashVal >> 33;
+	hashVal *= 0xff51afd7ed558ccdULL;
+	hashVal ^= hashVal >> 33;
+	return hashVal;
+}
+
+int MyDB_HashReaderWriter :: getBucket (size_t hashVal) {
+
+	// with n buckets, where 2^i <= n < 2^(i + 1), use the hash mod 2^(i + 1); if there is no
+	// such bucket yet (because it has not been split off), use the hash mod 2^i
+	size_t numBuckets = buckets.size ();
+	size_t low = 1;
+	while (low * 2 <= numBuckets)
+		low *= 2;
+	size_t whichBucket = hashVal & (2 * low - 1);
+	if (whichBucket >= numBuckets)
+		whichBucket = hashVal & (low - 1);
+	return (int) whichBucket;
+}
+
+int MyDB_HashReaderWriter :: getNumBuckets () {
+	return buckets.size ();
+}
+
+int MyDB_HashReaderWriter :: getBucketSize (int whichBucket) {
+	return buckets[whichBucket].size ();
+}
+
+MyDB_RecordIteratorAltPtr MyDB_HashReaderWriter :: getEqualityIteratorAlt (MyDB_AttValPtr key) {
+
+	// convert the key to the attribute's type, so that it hashes the same way
+	MyDB_AttValPtr probe = hashAttType->createAtt ();
+	probe->set (key);
+
+	vector <MyDB_PageReaderWriter> list;
+	for (int whichPage : buckets[getBucket (hash (probe))])
+		list.push_back ((*this)[whichPage]);
+
+	MyDB_RecordPtr myRec = getEmptyRecord ();
+	MyDB_AttValPtr att = myRec->getAtt (whichAttIsHashed);
+	function <bool ()> matches;
+	if (hashAttType->isBool ())
+		matches = [att, probe] {return att->toBool () == probe->toBool ();};
+	else if (hashAttType->promotableToInt ())
+		matches = [att, probe] {return att->toInt () == probe->toInt ();};
+	else if (hashAttType->promotableToDouble ())
+		matches = [att, probe] {return att->toDouble () == probe->toDouble ();};
+	else
+		matches = [att, probe] {return att->toString () == probe->toString ();};
+	return make_shared <MyDB_PageListFilterIteratorAlt> (list, myRec, matches);
+}
+
+bool MyDB_HashReaderWriter :: addToBucket (int whichBucket, MyDB_RecordPtr addMe) {
+
+	vector <int> &pages = buckets[whichBucket];
+	if (!pages.empty () && (*this)[pages.back ()].append (addMe))
+		return false;
+
+	int whichPage = getEmptyPage ();
+	if (!(*this)[whichPage].append (addMe)) {
+		cout << "This is bad... a record is too large to fit onto a page.\n";
+		exit (1);
+	}
+	pages.push_back (whichPage);
+	writeLog (whichBucket, whichPage);
+	return true;
+}
+
+void MyDB_HashReaderWriter :: appendImage (void *image) {
+	appendImageRecords (image);
+}
+
+void MyDB_HashReaderWriter :: append (MyDB_RecordPtr appendMe) {
+	addToStats (appendMe);
+	int whichBucket = getBucket (hash (appendMe->getAtt (whichAttIsHashed)));
+
+	// if the bucket needed an overflow page, grow the file
+	if (addToBucket (whichBucket, appendMe) && buckets[whichBucket].size () > 1)
+		split ();
+}
+
+void MyDB_HashReaderWriter :: split () {
+
+	// the bucket to split is the one that the new bucket would have gone to before it existed
+	size_t low = 1;
+	while (low * 2 <= buckets.size ())
+		low *= 2;
+	int fromBucket = buckets.size () - low;
+	int toBucket = buckets.size ();
+	buckets.push_back (vector <int> ());
+
+	// go through the pages in the old bucket, copying each one off to the side and then
+	// re-writing the records that stay from the front of the bucket... since they are a
+	// subset of the records that were there, in the same order, they never get ahead of
+	// the page that is being read
+	vector <int> oldPages = buckets[fromBucket];
+	MyDB_PageReaderWriter copy (true, *myBuffer);
+	MyDB_RecordPtr temp = getEmptyRecord ();
+	MyDB_AttValPtr att = temp->getAtt (whichAttIsHashed);
+	int writeTo = 0;
+	for (int readFrom = 0; readFrom < (int) oldPages.size (); readFrom++) {
+		MyDB_PageReaderWriter page = (*this)[oldPages[readFrom]];
+		memcpy (copy.getBytes (), page.getBytes (), page.getPageSize ());
+		page.clear ();
+
+		MyDB_RecordIteratorAltPtr myIter = copy.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			if (getBucket (hash (att)) == toBucket) {
+				addToBucket (toBucket, temp);
+				continue;
+			}
+			while (!(*this)[oldPages[writeTo]].append (temp))
+				writeTo++;
+		}
+	}
+
+	// and free up any pages at the end of the old bucket that are no longer needed
+	for (int i = writeTo + 1; i < (int) oldPages.size (); i++) {
+		freePages.push_back (oldPages[i]);
+		writeLog (FREE_PAGE, oldPages[i]);
+	}
+	buckets[fromBucket].resize (min (writeTo + 1, (int) oldPages.size ()));
+}
+
+#endif
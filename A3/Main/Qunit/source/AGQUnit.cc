@@ -1,22 +1,87 @@
 
+#include "Aggregate.h"
+#include "HashJoin.h"
+#include "MorselScan.h"
+#include "MyDB_AttStats.h"
 #include "MyDB_AttType.h"
 #include "MyDB_AttVal.h"
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_BatchFilter.h"
 #include "MyDB_BufferManager.h"
 #include "MyDB_Catalog.h"
+#include "MyDB_CompressedPage.h"
+#include "MyDB_HashReaderWriter.h"
+#include "MyDB_HyperLogLog.h"
 #include "MyDB_Record.h"
+#include "MyDB_RecordBatch.h"
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
+#include "MyDB_TextParser.h"
+#include "MyDB_TypedExpr.h"
+#include "MyDB_ZoneMap.h"
 #include "QUnit.h"
+#include "QueryOp.h"
+#include "SortMergeJoin.h"
 #include "Sorting.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <fstream>
 #include <iostream>
 #include <map>
+#include <random>
+#include <set>
 #include <string>
+#include <unistd.h>
 #include <vector>
 
 using namespace std;
 
+// the schema of supplier.tbl, with the given prefix on each attribute name
+static MyDB_SchemaPtr supplierSchema(string prefix) {
+  MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+  mySchema->appendAtt(make_pair(prefix + "suppkey", make_shared<MyDB_IntAttType>()));
+  mySchema->appendAtt(make_pair(prefix + "name", make_shared<MyDB_StringAttType>()));
+  mySchema->appendAtt(make_pair(prefix + "address", make_shared<MyDB_StringAttType>()));
+  mySchema->appendAtt(make_pair(prefix + "nationkey", make_shared<MyDB_IntAttType>()));
+  mySchema->appendAtt(make_pair(prefix + "phone", make_shared<MyDB_StringAttType>()));
+  mySchema->appendAtt(make_pair(prefix + "acctbal", make_shared<MyDB_DoubleAttType>()));
+  mySchema->appendAtt(make_pair(prefix + "comment", make_shared<MyDB_StringAttType>()));
+  return mySchema;
+}
+
+// the fields of each line of supplier.tbl, read without going through the database
+static vector<vector<string>> readSupplierFields() {
+  vector<vector<string>> supps;
+  ifstream in("supplier.tbl");
+  string line;
+  while (getline(in, line)) {
+    vector<string> fields;
+    size_t pos = 0, next;
+    while ((next = line.find('|', pos)) != string::npos) {
+      fields.push_back(line.substr(pos, next - pos));
+      pos = next + 1;
+    }
+    supps.push_back(fields);
+  }
+  return supps;
+}
+
+// the suppkey, nationkey, and acctbal of each supplier
+struct Supp {
+  int suppkey, nationkey;
+  double acctbal;
+};
+
+static vector<Supp> readSupps() {
+  vector<Supp> supps;
+  for (auto &fields : readSupplierFields())
+    supps.push_back({stoi(fields[0]), stoi(fields[3]), stod(fields[5])});
+  return supps;
+}
+
 int main() {
 
   QUnit::UnitTest qunit(std::cerr, QUnit::verbose);
@@ -94,5 +159,1965 @@ int main() {
     QUNIT_IS_TRUE(orderingCorrect);
   }
 
+  // Test 2: Top-k sort, both when the k records fit into the pinned pages and
+  // when they do not (and the final merge has to stop early)
+  {
+    cout << "Running SortTopK test..." << endl;
+
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("val", make_shared<MyDB_IntAttType>()));
+
+    // small pages, so that the heap has to compact and spill over pages
+    MyDB_TablePtr myTable =
+        make_shared<MyDB_Table>("topKInput", "topKInput_storage", mySchema);
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024, 64, "tempFile");
+    MyDB_TableReaderWriterPtr inputTableRW =
+        make_shared<MyDB_TableReaderWriter>(myTable, myMgr);
+
+    vector<int> allVals;
+    MyDB_RecordPtr rec = inputTableRW->getEmptyRecord();
+    for (int i = 0; i < 5000; i++) {
+      int val = rand() % 10000;
+      allVals.push_back(val);
+      rec->getAtt(0)->fromInt(val);
+      rec->recordContentHasChanged();
+      inputTableRW->append(rec);
+    }
+    std::sort(allVals.begin(), allVals.end());
+
+    MyDB_RecordPtr lhs = inputTableRW->getEmptyRecord();
+    MyDB_RecordPtr rhs = inputTableRW->getEmptyRecord();
+    function<bool()> myComparator = buildRecordComparator(lhs, rhs, "[val]");
+
+    // k = 300 fits into 4 pages of 126 records; k = 900 does not
+    vector<pair<size_t, string>> cases = {{10, "topKTen_storage"},
+                                          {300, "topKSmall_storage"},
+                                          {900, "topKLarge_storage"}};
+    for (auto &c : cases) {
+      MyDB_TablePtr outTable = make_shared<MyDB_Table>(c.second, c.second, mySchema);
+      MyDB_TableReaderWriter outputTableRW(outTable, myMgr);
+      sortTopK(c.first, 4, *inputTableRW, outputTableRW, myComparator, lhs, rhs);
+
+      MyDB_RecordPtr checkRec = outputTableRW.getEmptyRecord();
+      MyDB_RecordIteratorPtr iter = outputTableRW.getIterator(checkRec);
+      size_t count = 0;
+      bool matches = true;
+      while (iter->hasNext()) {
+        iter->getNext();
+        if (count >= c.first || checkRec->getAtt(0)->toInt() != allVals[count])
+          matches = false;
+        count++;
+      }
+      QUNIT_IS_EQUAL(count, c.first);
+      QUNIT_IS_TRUE(matches);
+    }
+  }
+
+  // Test 3: Batch iteration over the supplier table matches record iteration
+  {
+    cout << "Running BatchIterator test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_TablePtr myTable =
+        make_shared<MyDB_Table>("batchSupplier", "batchSupplier_storage", mySchema);
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 128, 16, "tempFile");
+    MyDB_TableReaderWriter supplierTable(myTable, myMgr);
+    supplierTable.loadFromTextFile("supplier.tbl");
+
+    // decode everything, and compare against the record iterator
+    MyDB_RecordPtr rec = supplierTable.getEmptyRecord();
+    MyDB_RecordIteratorAltPtr recIter = supplierTable.getIteratorAlt();
+    MyDB_RecordBatchPtr batch = supplierTable.getEmptyBatch();
+    MyDB_BatchIteratorPtr batchIter = supplierTable.getBatchIterator();
+    int count = 0;
+    bool matches = true;
+    while (batchIter->getNextBatch(*batch)) {
+      for (int i = 0; i < batch->size(); i++) {
+        recIter->advance();
+        recIter->getCurrent(rec);
+        if (batch->getIntColumn(0)[i] != rec->getAtt(0)->toInt() ||
+            batch->getString(1, i) != rec->getAtt(1)->toString() ||
+            batch->getDoubleColumn(5)[i] != rec->getAtt(5)->toDouble() ||
+            batch->getString(6, i) != rec->getAtt(6)->toString())
+          matches = false;
+        count++;
+      }
+    }
+    QUNIT_IS_EQUAL(count, 10000);
+    QUNIT_IS_TRUE(matches);
+
+    // and a projection that decodes only two of the columns
+    batch = supplierTable.getEmptyBatch({"nationkey", "acctbal"});
+    batchIter = supplierTable.getBatchIterator();
+    double total = 0;
+    count = 0;
+    while (batchIter->getNextBatch(*batch)) {
+      double *acctbal = batch->getDoubleColumn(5);
+      for (int i = 0; i < batch->size(); i++)
+        total += acctbal[i];
+      count += batch->size();
+    }
+
+    double expected = 0;
+    recIter = supplierTable.getIteratorAlt();
+    while (recIter->advance()) {
+      recIter->getCurrent(rec);
+      expected += rec->getAtt(5)->toDouble();
+    }
+    QUNIT_IS_EQUAL(count, 10000);
+    QUNIT_IS_FALSE(batch->isDecoded(1));
+    QUNIT_IS_EQUAL(total, expected);
+  }
+
+  // Test 4: a PAX table holds the same records as a heap table, in the same order, and
+  // works with the record iterators, the batch iterators, and the sorts
+  {
+    cout << "Running PaxPage test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 16, 16, "tempFile");
+    MyDB_TablePtr heapTable = make_shared<MyDB_Table>(
+        "heapSupplier", "heapSupplier_storage", mySchema);
+    MyDB_TablePtr paxTable = make_shared<MyDB_Table>(
+        "paxSupplier", "paxSupplier_storage", mySchema, "pax", "");
+    MyDB_TableReaderWriter heapRW(heapTable, myMgr);
+    MyDB_TableReaderWriter paxRW(paxTable, myMgr);
+    heapRW.loadFromTextFile("supplier.tbl");
+    paxRW.loadFromTextFile("supplier.tbl");
+
+    // a PAX page never holds more than a regular page would
+    QUNIT_IS_TRUE(paxRW.getNumPages() >= heapRW.getNumPages());
+    QUNIT_IS_TRUE(paxRW[0].getType() == MyDB_PageType::PaxPage);
+
+    MyDB_RecordPtr heapRec = heapRW.getEmptyRecord();
+    MyDB_RecordPtr paxRec = paxRW.getEmptyRecord();
+    MyDB_RecordIteratorPtr heapIter = heapRW.getIterator(heapRec);
+    MyDB_RecordIteratorAltPtr paxIter = paxRW.getIteratorAlt();
+    int count = 0;
+    bool matches = true;
+    while (paxIter->advance()) {
+      paxIter->getCurrent(paxRec);
+      heapIter->hasNext();
+      heapIter->getNext();
+      for (int i = 0; i < 7; i++)
+        if (paxRec->getAtt(i)->toString() != heapRec->getAtt(i)->toString())
+          matches = false;
+      count++;
+    }
+    QUNIT_IS_EQUAL(count, 10000);
+    QUNIT_IS_TRUE(matches);
+
+    // a projection touches only the nationkey and phone minipages
+    MyDB_RecordBatchPtr batch = paxRW.getEmptyBatch({"nationkey", "phone"});
+    MyDB_BatchIteratorPtr batchIter = paxRW.getBatchIterator();
+    heapIter = heapRW.getIterator(heapRec);
+    count = 0;
+    matches = true;
+    while (batchIter->getNextBatch(*batch)) {
+      for (int i = 0; i < batch->size(); i++) {
+        heapIter->hasNext();
+      heapIter->getNext();
+        if (batch->getIntColumn(3)[i] != heapRec->getAtt(3)->toInt() ||
+            batch->getString(4, i) != heapRec->getAtt(4)->toString())
+          matches = false;
+        count++;
+      }
+    }
+    QUNIT_IS_EQUAL(count, 10000);
+    QUNIT_IS_TRUE(matches);
+
+    // sorting a PAX page in place keeps it a PAX page
+    MyDB_RecordPtr lhs = paxRW.getEmptyRecord();
+    MyDB_RecordPtr rhs = paxRW.getEmptyRecord();
+    function<bool()> comp = buildRecordComparator(lhs, rhs, "[name]");
+    paxRW[1].sortInPlace(comp, lhs, rhs);
+    MyDB_RecordIteratorAltPtr pageIter = paxRW[1].getIteratorAlt();
+    bool sorted = true, first = true;
+    int onPage = 0;
+    while (pageIter->advance()) {
+      pageIter->getCurrent(lhs);
+      if (!first && comp())
+        sorted = false;
+      pageIter->getCurrent(rhs);
+      first = false;
+      onPage++;
+    }
+    QUNIT_IS_TRUE(sorted);
+    QUNIT_IS_TRUE(onPage > 0);
+    QUNIT_IS_TRUE(paxRW[1].getType() == MyDB_PageType::PaxPage);
+
+    // the record iterators read a PAX page's minipages directly, and the address of each
+    // record stays good for as long as the iterator is around
+    vector<void *> addresses;
+    vector<string> names;
+    pageIter = paxRW[1].getIteratorAlt();
+    while (pageIter->advance()) {
+      pageIter->getCurrent(lhs);
+      names.push_back(lhs->getAtt(1)->toString());
+      addresses.push_back(pageIter->getCurrentPointer());
+    }
+    MyDB_RecordIteratorPtr otherIter = paxRW[1].getIterator(rhs);
+    matches = (int)names.size() == onPage;
+    for (size_t i = 0; i < addresses.size(); i++) {
+      lhs->fromBinary(addresses[i]);
+      otherIter->getNext();
+      if (lhs->getAtt(1)->toString() != names[i] || rhs->getAtt(1)->toString() != names[i])
+        matches = false;
+    }
+    QUNIT_IS_TRUE(matches && !otherIter->hasNext());
+
+    // and the external sort can read from a PAX table and write into another one
+    MyDB_TablePtr sortedTable = make_shared<MyDB_Table>(
+        "paxSorted", "paxSorted_storage", mySchema, "pax", "");
+    MyDB_TableReaderWriter sortedRW(sortedTable, myMgr);
+    sort(4, paxRW, sortedRW, comp, lhs, rhs);
+    MyDB_RecordIteratorAltPtr sortedIter = sortedRW.getIteratorAlt();
+    sorted = true;
+    first = true;
+    count = 0;
+    while (sortedIter->advance()) {
+      sortedIter->getCurrent(lhs);
+      if (!first && comp())
+        sorted = false;
+      sortedIter->getCurrent(rhs);
+      first = false;
+      count++;
+    }
+    QUNIT_IS_EQUAL(count, 10000);
+    QUNIT_IS_TRUE(sorted);
+  }
+
+  // Test 5: batch filters give the same answer as evaluating the predicate one record at a
+  // time, with every level of kernels that this machine supports
+  {
+    cout << "Running BatchFilter test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_TablePtr myTable = make_shared<MyDB_Table>(
+        "filterSupplier", "filterSupplier_storage", mySchema);
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 128, 16, "tempFile");
+    MyDB_TableReaderWriter supplierTable(myTable, myMgr);
+    supplierTable.loadFromTextFile("supplier.tbl");
+
+    vector<string> preds = {
+        "< ([nationkey], int[10])",
+        "> (double[5000.0], [acctbal])",
+        "!= ([suppkey], [nationkey])",
+        "&& (> ([acctbal], int[0]), ! (== ([nationkey], int[3])))",
+        "|| (< ([acctbal], double[-500.5]), > ([name], string[Supplier#000009000]))",
+        "< (+ ([suppkey], [nationkey]), int[50])"};
+
+    bool matches = true;
+    for (auto level : {ScalarKernels, AVX2Kernels, AVX512Kernels}) {
+      useKernels(level);
+      for (string &pred : preds) {
+        MyDB_BatchFilter filter(mySchema, pred);
+        MyDB_TypedExpr check(mySchema, pred);
+        MyDB_RecordBatchPtr batch =
+            make_shared<MyDB_RecordBatch>(mySchema, filter.getNeededAtts());
+        uint64_t bits[BITMAP_WORDS(MAX_BATCH_SIZE)];
+        MyDB_BatchIteratorPtr myIter = supplierTable.getBatchIterator();
+        while (myIter->getNextBatch(*batch)) {
+          int count = filter.apply(*batch, bits);
+          int expected = 0;
+          for (int i = 0; i < batch->size(); i++) {
+            bool pass = check.evalBool(batch->getRecordPointer(i));
+            expected += pass;
+            if (pass != (bool)((bits[i / 64] >> (i % 64)) & 1))
+              matches = false;
+          }
+          if (count != expected)
+            matches = false;
+        }
+      }
+    }
+    useKernels(AVX512Kernels);
+    QUNIT_IS_TRUE(matches);
+  }
+
+  // Test 6: a B+-Tree with tiny pages (so that there are lots of splits) returns the same
+  // records for range and point lookups as a scan does
+  {
+    cout << "Running BPlusTree test..." << endl;
+
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("value", make_shared<MyDB_DoubleAttType>()));
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(128, 64, "tempFile");
+
+    // the indexvalue table
+    MyDB_TablePtr myTable = make_shared<MyDB_Table>(
+        "indexvalueTree", "indexvalueTree_storage", mySchema, "bplustree", "key");
+    MyDB_BPlusTreeReaderWriter tree(myTable, myMgr);
+    tree.loadFromTextFile("indexvalue.tbl");
+    QUNIT_IS_TRUE(tree.getNumPages() > 2);
+
+    MyDB_IntAttValPtr low = make_shared<MyDB_IntAttVal>();
+    MyDB_IntAttValPtr high = make_shared<MyDB_IntAttVal>();
+    MyDB_RecordPtr rec = tree.getEmptyRecord();
+    low->set(4);
+    high->set(9);
+    MyDB_RecordIteratorAltPtr myIter = tree.getSortedRangeIteratorAlt(low, high);
+    vector<int> keys;
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      keys.push_back(rec->getAtt(0)->toInt());
+    }
+    QUNIT_IS_TRUE(keys == vector<int>({4, 5, 6, 7, 8, 9}));
+
+    // lots of random inserts, with duplicates
+    default_random_engine generator(530);
+    uniform_int_distribution<int> keyDist(0, 999);
+    map<int, int> counts;
+    for (int i = 0; i < 5000; i++) {
+      int key = keyDist(generator);
+      counts[key]++;
+      rec->getAtt(0)->fromInt(key);
+      rec->recordContentHasChanged();
+      tree.append(rec);
+    }
+    for (int key = 1; key <= 13; key++)
+      counts[key]++;
+
+    // a full scan still sees everything
+    int total = 0;
+    myIter = tree.getIteratorAlt();
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      total++;
+    }
+    QUNIT_IS_EQUAL(total, 5013);
+
+    bool matches = true;
+    for (auto range : vector<pair<int, int>>{
+             {-10, 2000}, {500, 500}, {0, 0}, {999, 999}, {250, 300}, {40, 39}}) {
+      low->set(range.first);
+      high->set(range.second);
+      int expected = 0;
+      for (auto &c : counts)
+        if (c.first >= range.first && c.first <= range.second)
+          expected += c.second;
+
+      // the sorted iterator gives the keys in order
+      int count = 0, last = range.first;
+      myIter = tree.getSortedRangeIteratorAlt(low, high);
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        int key = rec->getAtt(0)->toInt();
+        if (key < last || key > range.second)
+          matches = false;
+        last = key;
+        count++;
+      }
+      if (count != expected)
+        matches = false;
+
+      count = 0;
+      myIter = tree.getRangeIteratorAlt(low, high);
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        count++;
+      }
+      if (count != expected)
+        matches = false;
+    }
+    QUNIT_IS_TRUE(matches);
+
+    // reloading starts the tree over
+    tree.loadFromTextFile("indexvalue.tbl");
+    low->set(-10);
+    high->set(2000);
+    total = 0;
+    myIter = tree.getRangeIteratorAlt(low, high);
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      total++;
+    }
+    QUNIT_IS_EQUAL(total, 13);
+  }
+
+  // Test 7: bulk loading a B+-Tree from a sorted table, with different fill factors, gives
+  // the same lookups as a scan, and the tree can still take inserts afterward
+  {
+    cout << "Running BPlusTree bulk load test..." << endl;
+
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("value", make_shared<MyDB_DoubleAttType>()));
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(256, 64, "tempFile");
+
+    // a heap of random keys, sorted on the key
+    MyDB_TablePtr heapTable =
+        make_shared<MyDB_Table>("bulkHeap", "bulkHeap_storage", mySchema);
+    MyDB_TableReaderWriter heap(heapTable, myMgr);
+    heap.loadFromTextFile("indexvalue.tbl");
+    default_random_engine generator(530);
+    uniform_int_distribution<int> keyDist(0, 999);
+    MyDB_RecordPtr rec = heap.getEmptyRecord();
+    map<int, int> counts;
+    for (int key = 1; key <= 13; key++)
+      counts[key]++;
+    for (int i = 0; i < 3000; i++) {
+      int key = keyDist(generator);
+      counts[key]++;
+      rec->getAtt(0)->fromInt(key);
+      rec->recordContentHasChanged();
+      heap.append(rec);
+    }
+    MyDB_TablePtr sortedTable =
+        make_shared<MyDB_Table>("bulkSorted", "bulkSorted_storage", mySchema);
+    MyDB_TableReaderWriter sorted(sortedTable, myMgr);
+    MyDB_RecordPtr lhs = heap.getEmptyRecord();
+    MyDB_RecordPtr rhs = heap.getEmptyRecord();
+    sort(8, heap, sorted, buildRecordComparator(lhs, rhs, "[key]"), lhs, rhs);
+
+    MyDB_IntAttValPtr low = make_shared<MyDB_IntAttVal>();
+    MyDB_IntAttValPtr high = make_shared<MyDB_IntAttVal>();
+    vector<int> numPages;
+    bool matches = true;
+    for (double fillFactor : {1.0, 0.5}) {
+      MyDB_TablePtr treeTable = make_shared<MyDB_Table>(
+          "bulkTree", "bulkTree_storage", mySchema, "bplustree", "key");
+      MyDB_BPlusTreeReaderWriter tree(treeTable, myMgr);
+      tree.bulkLoad(sorted, fillFactor);
+      numPages.push_back(tree.getNumPages());
+
+      // then some more inserts, which have to split the packed pages
+      for (int i = 0; i < 500; i++) {
+        int key = keyDist(generator);
+        counts[key]++;
+        rec->getAtt(0)->fromInt(key);
+        rec->recordContentHasChanged();
+        tree.append(rec);
+      }
+
+      for (auto range : vector<pair<int, int>>{
+               {-10, 2000}, {500, 500}, {0, 0}, {999, 999}, {250, 300}}) {
+        low->set(range.first);
+        high->set(range.second);
+        int expected = 0;
+        for (auto &c : counts)
+          if (c.first >= range.first && c.first <= range.second)
+            expected += c.second;
+
+        int count = 0, last = range.first;
+        MyDB_RecordIteratorAltPtr myIter =
+            tree.getSortedRangeIteratorAlt(low, high);
+        while (myIter->advance()) {
+          myIter->getCurrent(rec);
+          int key = rec->getAtt(0)->toInt();
+          if (key < last || key > range.second)
+            matches = false;
+          last = key;
+          count++;
+        }
+        if (count != expected)
+          matches = false;
+      }
+
+      // take the inserts back out of the counts for the next round
+      counts.clear();
+      MyDB_RecordIteratorAltPtr myIter = heap.getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        counts[rec->getAtt(0)->toInt()]++;
+      }
+    }
+    QUNIT_IS_TRUE(matches);
+    QUNIT_IS_TRUE(numPages[1] > numPages[0] * 3 / 2);
+  }
+
+  // Test 8: a hash file with tiny pages (so that it has to grow a lot) finds the same records
+  // for equality probes as a scan does, both before and after it is re-opened
+  {
+    cout << "Running Hash test..." << endl;
+
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("value", make_shared<MyDB_DoubleAttType>()));
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(256, 64, "tempFile");
+    MyDB_TablePtr myTable = make_shared<MyDB_Table>(
+        "hashTable", "hashTable_storage", mySchema, "hash", "key");
+
+    map<int, int> counts;
+    {
+      MyDB_HashReaderWriter hashFile(myTable, myMgr);
+      hashFile.loadFromTextFile("indexvalue.tbl");
+      for (int key = 1; key <= 13; key++)
+        counts[key]++;
+
+      default_random_engine generator(530);
+      uniform_int_distribution<int> keyDist(0, 1999);
+      MyDB_RecordPtr rec = hashFile.getEmptyRecord();
+      for (int i = 0; i < 5000; i++) {
+        int key = keyDist(generator);
+        counts[key]++;
+        rec->getAtt(0)->fromInt(key);
+        rec->recordContentHasChanged();
+        hashFile.append(rec);
+      }
+      QUNIT_IS_TRUE(hashFile.getNumBuckets() > 100);
+    }
+
+    // re-open the file, and probe every key (and some that are not there)
+    MyDB_HashReaderWriter hashFile(myTable, myMgr);
+    MyDB_RecordPtr rec = hashFile.getEmptyRecord();
+    MyDB_IntAttValPtr key = make_shared<MyDB_IntAttVal>();
+    bool matches = true;
+    size_t longestBucket = 0;
+    for (int k = -5; k < 2005; k++) {
+      key->set(k);
+      int count = 0;
+      MyDB_RecordIteratorAltPtr myIter = hashFile.getEqualityIteratorAlt(key);
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        if (rec->getAtt(0)->toInt() != k)
+          matches = false;
+        count++;
+      }
+      if (count != (counts.count(k) ? counts[k] : 0))
+        matches = false;
+    }
+    for (int i = 0; i < hashFile.getNumBuckets(); i++)
+      longestBucket = max(longestBucket, (size_t)hashFile.getBucketSize(i));
+    QUNIT_IS_TRUE(matches);
+    QUNIT_IS_TRUE(longestBucket <= 4);
+
+    // and a scan sees everything
+    int total = 0;
+    MyDB_RecordIteratorAltPtr myIter = hashFile.getIteratorAlt();
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      total++;
+    }
+    QUNIT_IS_EQUAL(total, 5013);
+  }
+
+  // Test 9: loading a text file with several threads gives the same records, in the same
+  // order, with the same counts, as loading it with one thread, for heap, PAX, and B+-Tree
+  // tables; and a table that is loaded into still takes appends
+  {
+    cout << "Running parallel load test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 16, 64, "tempFile");
+
+    // everything in a table, as text, in scan order
+    auto scan = [](MyDB_TableReaderWriter &fromMe) {
+      vector<string> all;
+      MyDB_RecordPtr rec = fromMe.getEmptyRecord();
+      MyDB_RecordIteratorAltPtr myIter = fromMe.getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        all.push_back(rec->getAtt(0)->toString() + "|" + rec->getAtt(1)->toString() +
+                      "|" + rec->getAtt(6)->toString());
+      }
+      return all;
+    };
+
+    MyDB_TablePtr oneTable = make_shared<MyDB_Table>(
+        "oneThread", "oneThread_storage", mySchema);
+    MyDB_TableReaderWriter oneRW(oneTable, myMgr);
+    pair<vector<size_t>, size_t> oneRes = oneRW.loadFromTextFile("supplier.tbl", 1);
+    vector<string> expected = scan(oneRW);
+    QUNIT_IS_EQUAL(oneRes.second, 10000);
+    QUNIT_IS_EQUAL(expected.size(), 10000);
+
+    bool matches = true;
+    for (int numThreads : {2, 3, 8}) {
+      MyDB_TablePtr heapTable = make_shared<MyDB_Table>(
+          "manyThreads", "manyThreads_storage", mySchema);
+      MyDB_TableReaderWriter heapRW(heapTable, myMgr);
+      pair<vector<size_t>, size_t> res =
+          heapRW.loadFromTextFile("supplier.tbl", numThreads);
+      if (res.second != 10000 || scan(heapRW) != expected)
+        matches = false;
+
+      // the distinct value estimates are close to the ones from one thread
+      for (size_t i = 0; i < res.first.size(); i++) {
+        if (res.first[i] * 2 < oneRes.first[i] || res.first[i] > oneRes.first[i] * 2)
+          matches = false;
+      }
+
+      // appends go after the loaded records
+      MyDB_RecordPtr rec = heapRW.getEmptyRecord();
+      rec->fromString("10001|Supplier#000010001|address|1|11-111-111-1111|1.00|comment|");
+      heapRW.append(rec);
+      vector<string> after = scan(heapRW);
+      if (after.size() != 10001 || after.back() != "10001|Supplier#000010001|comment")
+        matches = false;
+    }
+    QUNIT_IS_TRUE(matches);
+
+    MyDB_TablePtr paxTable = make_shared<MyDB_Table>(
+        "paxThreads", "paxThreads_storage", mySchema, "pax", "");
+    MyDB_TableReaderWriter paxRW(paxTable, myMgr);
+    paxRW.loadFromTextFile("supplier.tbl", 4);
+    QUNIT_IS_TRUE(scan(paxRW) == expected);
+
+    MyDB_TablePtr treeTable = make_shared<MyDB_Table>(
+        "treeThreads", "treeThreads_storage", mySchema, "bplustree", "suppkey");
+    MyDB_BPlusTreeReaderWriter treeRW(treeTable, myMgr);
+    treeRW.loadFromTextFile("supplier.tbl", 4);
+    MyDB_IntAttValPtr low = make_shared<MyDB_IntAttVal>();
+    MyDB_IntAttValPtr high = make_shared<MyDB_IntAttVal>();
+    low->set(1);
+    high->set(10000);
+    int count = 0;
+    MyDB_RecordPtr rec = treeRW.getEmptyRecord();
+    MyDB_RecordIteratorAltPtr myIter = treeRW.getSortedRangeIteratorAlt(low, high);
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      if (rec->getAtt(0)->toInt() != ++count)
+        matches = false;
+    }
+    QUNIT_IS_EQUAL(count, 10000);
+    QUNIT_IS_TRUE(matches);
+  }
+
+  // Test 10: the text parser agrees with the C library on ints and doubles, and the delimiter
+  // search finds every delimiter
+  {
+    cout << "Running text parser test..." << endl;
+
+    default_random_engine generator(530);
+    bool matches = true;
+
+    uniform_int_distribution<int> intDist(INT_MIN, INT_MAX);
+    vector<string> ints = {"0", "-0", "+17", "  42", "12abc", "2147483647", "-2147483648"};
+    for (int i = 0; i < 10000; i++)
+      ints.push_back(to_string(intDist(generator) >> (i % 31)));
+    for (string &text : ints) {
+      int val;
+      if (!parseInt(text.data(), text.data() + text.size(), val) || val != stoi(text))
+        matches = false;
+    }
+    int untouched = 7;
+    if (parseInt("", nullptr, untouched) || parseInt("x1", (const char *)"x1" + 2, untouched) ||
+        untouched != 7)
+      matches = false;
+
+    // as with stoi, an int that does not fit is an error
+    for (string text : {"2147483648", "-2147483649", "4294967296", "99999999999999999999"})
+      if (parseInt(text.data(), text.data() + text.size(), untouched) || untouched != 7)
+        matches = false;
+    QUNIT_IS_TRUE(matches);
+
+    uniform_real_distribution<double> doubleDist(-1e6, 1e6);
+    vector<string> doubles = {"0", "-0.0", "5755.94", "  .5", "3.", "1e10", "1.5E-7",
+                              "123456789012345678901234", "0.000000000000000000000000001",
+                              "2.2250738585072014e-308", "1.7976931348623157e308", "inf", "-nan", "0x1p3",
+                              "2.5|", "7.25e", "12.5abc"};
+    for (int i = 0; i < 10000; i++) {
+      char buf[64];
+      snprintf(buf, sizeof(buf), "%.*f", i % 8, doubleDist(generator));
+      doubles.push_back(buf);
+      snprintf(buf, sizeof(buf), "%.17g", doubleDist(generator) * pow(10.0, i % 40 - 20));
+      doubles.push_back(buf);
+    }
+    for (string &text : doubles) {
+      double val;
+      double expected = stod(text);
+      if (!parseDouble(text.data(), text.data() + text.size(), val) ||
+          (val != expected && !(std::isnan(val) && std::isnan(expected))) ||
+          signbit(val) != signbit(expected))
+        matches = false;
+    }
+    QUNIT_IS_TRUE(matches);
+
+    uniform_int_distribution<int> charDist(0, 9);
+    for (int i = 0; i < 2000; i++) {
+      string text;
+      for (int j = 0; j < i % 100; j++) {
+        int c = charDist(generator);
+        text.push_back(c == 0 ? '|' : c == 1 ? '\n' : 'a' + c);
+      }
+      const char *start = text.data(), *end = text.data() + text.size();
+      for (const char *pos = start; pos < end; pos++) {
+        const char *found = findDelimiter(pos, end);
+        const char *expected = pos;
+        while (expected < end && *expected != '|' && *expected != '\n')
+          expected++;
+        if (found != expected)
+          matches = false;
+        pos = found;
+      }
+    }
+    QUNIT_IS_TRUE(matches);
+
+    // a record parsed from a buffer of lines matches one parsed with fromString, and the
+    // pointer that comes back is the start of the next line
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("name", make_shared<MyDB_StringAttType>()));
+    mySchema->appendAtt(make_pair("value", make_shared<MyDB_DoubleAttType>()));
+    mySchema->appendAtt(make_pair("flag", make_shared<MyDB_BoolAttType>()));
+    MyDB_Record lhs(mySchema), rhs(mySchema);
+    string lines = "12|a string with spaces|-3.25|true|\n\n7||1e3|false\n-4|x|0.1|true|";
+    const char *pos = lines.data(), *end = lines.data() + lines.size();
+    pos = lhs.fromText(pos, end);
+    QUNIT_IS_EQUAL(lhs.getAtt(0)->toInt(), 12);
+    QUNIT_IS_EQUAL(lhs.getAtt(1)->toString(), "a string with spaces");
+    QUNIT_IS_EQUAL(lhs.getAtt(2)->toDouble(), -3.25);
+    QUNIT_IS_TRUE(lhs.getAtt(3)->toBool());
+    QUNIT_IS_TRUE(*pos == '\n');
+    pos = lhs.fromText(pos + 1, end);
+    QUNIT_IS_EQUAL(lhs.getAtt(0)->toInt(), 7);
+    QUNIT_IS_EQUAL(lhs.getAtt(1)->toString(), "");
+    QUNIT_IS_EQUAL(lhs.getAtt(2)->toDouble(), 1000.0);
+    QUNIT_IS_TRUE(!lhs.getAtt(3)->toBool());
+    pos = lhs.fromText(pos, end);
+    QUNIT_IS_TRUE(pos == end);
+    rhs.fromString("-4|x|0.1|true|");
+    QUNIT_IS_EQUAL(lhs.getAtt(0)->toInt(), rhs.getAtt(0)->toInt());
+    QUNIT_IS_EQUAL(lhs.getAtt(2)->toDouble(), 0.1);
+  }
+
+  // Test 11: the HyperLogLog sketches built when a table is loaded give distinct value
+  // counts that are close to the real ones, they are kept up to date on append, and they
+  // go into the catalog and come back out
+  {
+    cout << "Running HyperLogLog test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 16, 64, "tempFile");
+    MyDB_TablePtr myTable = make_shared<MyDB_Table>(
+        "hllSupplier", "hllSupplier_storage", mySchema);
+    MyDB_TableReaderWriter myRW(myTable, myMgr);
+    pair<vector<size_t>, size_t> res = myRW.loadFromTextFile("supplier.tbl", 4);
+    QUNIT_IS_EQUAL(myTable->getTupleCount(), 10000);
+
+    // the real counts (of distinct hashes, since that is what the sketches see)
+    vector<set<size_t>> exact(7);
+    MyDB_RecordPtr rec = myRW.getEmptyRecord();
+    MyDB_RecordIteratorAltPtr myIter = myRW.getIteratorAlt();
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      for (int i = 0; i < 7; i++)
+        exact[i].insert(rec->getAtt(i)->hash());
+    }
+    bool close = true;
+    for (int i = 0; i < 7; i++) {
+      double err = fabs((double)res.first[i] - exact[i].size()) / exact[i].size();
+      if (err > 0.05 || res.first[i] != myTable->getDistinctValues(i))
+        close = false;
+    }
+    QUNIT_IS_TRUE(close);
+    QUNIT_IS_EQUAL(myTable->getDistinctValues("nationkey"), 25);
+
+    // appends with new keys raise the count; appends with old keys do not
+    for (int i = 0; i < 1000; i++) {
+      rec->getAtt(0)->fromInt(20000 + i);
+      rec->recordContentHasChanged();
+      myRW.append(rec);
+    }
+    QUNIT_IS_EQUAL(myTable->getTupleCount(), 11000);
+    QUNIT_IS_TRUE(fabs(myTable->getDistinctValues(0) - 11000.0) / 11000.0 < 0.05);
+    QUNIT_IS_EQUAL(myTable->getDistinctValues("nationkey"), 25);
+
+    // through the catalog and back
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("hllCatFile");
+      myTable->putInCatalog(myCatalog);
+    }
+    MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("hllCatFile");
+    MyDB_TablePtr fromCatalog = make_shared<MyDB_Table>();
+    QUNIT_IS_TRUE(fromCatalog->fromCatalog("hllSupplier", myCatalog));
+    bool same = fromCatalog->getSketches().size() == 7;
+    for (int i = 0; i < 7; i++) {
+      if (fromCatalog->getDistinctValues(i) != myTable->getDistinctValues(i))
+        same = false;
+    }
+    QUNIT_IS_TRUE(same);
+
+    // merging the sketches of two halves is the same as sketching the whole thing
+    MyDB_HyperLogLog whole, lowHalf, highHalf;
+    for (size_t i = 0; i < 100000; i++) {
+      whole.add(i);
+      (i % 2 ? lowHalf : highHalf).add(i);
+    }
+    lowHalf.merge(highHalf);
+    QUNIT_IS_TRUE(lowHalf.toString() == whole.toString());
+    QUNIT_IS_TRUE(fabs(whole.estimate() - 100000.0) / 100000.0 < 0.05);
+    MyDB_HyperLogLog small;
+    for (size_t i = 0; i < 13; i++)
+      small.add(i);
+    QUNIT_IS_EQUAL(small.estimate(), 13);
+  }
+
+  // Test 12: the histograms and other statistics built when a table is loaded (or
+  // analyzed) give estimates that are close to the real counts, and go through the catalog
+  {
+    cout << "Running table statistics test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 16, 64, "tempFile");
+    MyDB_TablePtr myTable = make_shared<MyDB_Table>(
+        "statsSupplier", "statsSupplier_storage", mySchema);
+    MyDB_TableReaderWriter myRW(myTable, myMgr);
+    myRW.loadFromTextFile("supplier.tbl");
+    QUNIT_IS_EQUAL(myTable->getAttStats().size(), 7);
+    QUNIT_IS_EQUAL(myTable->getAttStats()[0].getMin()->toInt(), 1);
+    QUNIT_IS_EQUAL(myTable->getAttStats()[0].getMax()->toInt(), 10000);
+    QUNIT_IS_EQUAL(myTable->getAttStats()[0].getNumBuckets(), 64);
+    QUNIT_IS_EQUAL(myTable->getAttStats()[1].getNullFraction(), 0.0);
+
+    // the real counts
+    map<int, int> perNation;
+    int negative = 0, lowKeys = 0;
+    MyDB_RecordPtr rec = myRW.getEmptyRecord();
+    MyDB_RecordIteratorAltPtr myIter = myRW.getIteratorAlt();
+    while (myIter->advance()) {
+      myIter->getCurrent(rec);
+      perNation[rec->getAtt(3)->toInt()]++;
+      if (rec->getAtt(5)->toDouble() < 0)
+        negative++;
+      if (rec->getAtt(0)->toInt() <= 2500)
+        lowKeys++;
+    }
+
+    // every estimate is within slack of the real count
+    auto checkEstimates = [&](MyDB_TablePtr forMe, double slack) {
+      bool close = true;
+      MyDB_IntAttValPtr intVal = make_shared<MyDB_IntAttVal>();
+      for (auto &nation : perNation) {
+        intVal->set(nation.first);
+        if (fabs(forMe->estimateEqualCount("nationkey", intVal) - nation.second) > slack)
+          close = false;
+      }
+      intVal->set(2500);
+      if (fabs(forMe->estimateRangeCount("suppkey", nullptr, intVal) - lowKeys) > slack)
+        close = false;
+      intVal->set(20000);
+      if (forMe->estimateEqualCount("suppkey", intVal) != 0.0)
+        close = false;
+      MyDB_DoubleAttValPtr doubleVal = make_shared<MyDB_DoubleAttVal>();
+      doubleVal->set(-0.000001);
+      if (fabs(forMe->estimateRangeCount("acctbal", nullptr, doubleVal) - negative) > slack)
+        close = false;
+      return close;
+    };
+    QUNIT_IS_TRUE(checkEstimates(myTable, 200));
+
+    // a smaller sample (from fewer pages) still does pretty well
+    myRW.analyze(2000, 16);
+    QUNIT_IS_EQUAL(myTable->getAttStats()[0].getNumBuckets(), 16);
+    QUNIT_IS_TRUE(checkEstimates(myTable, 500));
+
+    // through the catalog and back
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("statsCatFile");
+      myTable->putInCatalog(myCatalog);
+    }
+    MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("statsCatFile");
+    MyDB_TablePtr fromCatalog = make_shared<MyDB_Table>();
+    QUNIT_IS_TRUE(fromCatalog->fromCatalog("statsSupplier", myCatalog));
+    QUNIT_IS_EQUAL(fromCatalog->getAttStats().size(), 7);
+    QUNIT_IS_TRUE(fromCatalog->getAttStats()[2].toString() == myTable->getAttStats()[2].toString());
+    QUNIT_IS_TRUE(checkEstimates(fromCatalog, 500));
+
+    // empty strings count as nulls, and odd characters make it through the catalog
+    MyDB_AttStats stringStats(make_shared<MyDB_StringAttType>());
+    vector<MyDB_AttValPtr> sample;
+    for (string text : {"a#b", "c|d", "e;f", "100%"}) {
+      MyDB_StringAttValPtr val = make_shared<MyDB_StringAttVal>();
+      val->set(text);
+      sample.push_back(val);
+    }
+    stringStats.build(sample, 4);
+    QUNIT_IS_EQUAL(stringStats.getNullFraction(), 0.5);
+    MyDB_AttStats readBack(make_shared<MyDB_StringAttType>());
+    QUNIT_IS_TRUE(readBack.fromString(stringStats.toString()));
+    QUNIT_IS_EQUAL(readBack.getMin()->toString(), "100%");
+    QUNIT_IS_EQUAL(readBack.getMax()->toString(), "e;f");
+    QUNIT_IS_EQUAL(readBack.getNumBuckets(), 3);
+  }
+
+  // Test 13: zone maps let a range scan skip pages, give the same answer as a full scan,
+  // are kept up to date through loads, appends, and sorts, and go through the catalog
+  {
+    cout << "Running zone map test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 16, 64, "tempFile");
+    MyDB_TablePtr myTable = make_shared<MyDB_Table>(
+        "zoneSupplier", "zoneSupplier_storage", mySchema);
+    MyDB_TableReaderWriter myRW(myTable, myMgr);
+    myRW.addZoneMap("suppkey");
+    myRW.addZoneMap("acctbal");
+    myRW.loadFromTextFile("supplier.tbl");
+
+    // the number of records in the range, with a full scan and with a range scan
+    MyDB_RecordPtr rec = myRW.getEmptyRecord();
+    auto fullCount = [&](MyDB_TableReaderWriter &rw, int whichAtt, double low, double high) {
+      size_t count = 0;
+      MyDB_RecordIteratorAltPtr myIter = rw.getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        double val = rec->getAtt(whichAtt)->toDouble();
+        if (val >= low && val <= high)
+          count++;
+      }
+      return count;
+    };
+    auto rangeCount = [&](MyDB_TableReaderWriter &rw, string att, MyDB_AttValPtr low, MyDB_AttValPtr high) {
+      size_t count = 0;
+      MyDB_RecordIteratorAltPtr myIter = rw.getRangeScanIteratorAlt(att, low, high);
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        count++;
+      }
+      return count;
+    };
+
+    // the file is in suppkey order, so only a few pages are read
+    MyDB_IntAttValPtr lowKey = make_shared<MyDB_IntAttVal>();
+    MyDB_IntAttValPtr highKey = make_shared<MyDB_IntAttVal>();
+    lowKey->set(5000);
+    highKey->set(5100);
+    QUNIT_IS_EQUAL(rangeCount(myRW, "suppkey", lowKey, highKey), 101);
+    QUNIT_IS_TRUE(myRW.getPagesInRange("suppkey", lowKey, highKey).size() <= 3);
+    QUNIT_IS_EQUAL(rangeCount(myRW, "suppkey", nullptr, highKey), 5100);
+    QUNIT_IS_EQUAL(myRW.getPagesInRange("suppkey", nullptr, nullptr).size(), myRW.getNumPages());
+    lowKey->set(20000);
+    QUNIT_IS_EQUAL(rangeCount(myRW, "suppkey", lowKey, nullptr), 0);
+    QUNIT_IS_EQUAL(myRW.getPagesInRange("suppkey", lowKey, nullptr).size(), 0);
+
+    // but acctbal is all over the place, so every page is read... and an attribute with no
+    // zone map still works
+    MyDB_DoubleAttValPtr lowBal = make_shared<MyDB_DoubleAttVal>();
+    MyDB_DoubleAttValPtr highBal = make_shared<MyDB_DoubleAttVal>();
+    lowBal->set(100.0);
+    highBal->set(200.0);
+    QUNIT_IS_EQUAL(rangeCount(myRW, "acctbal", lowBal, highBal), fullCount(myRW, 5, 100.0, 200.0));
+    lowKey->set(3);
+    highKey->set(4);
+    QUNIT_IS_EQUAL(rangeCount(myRW, "nationkey", lowKey, highKey), fullCount(myRW, 3, 3, 4));
+
+    // appends widen the zones
+    rec->getAtt(0)->fromInt(20000);
+    rec->recordContentHasChanged();
+    myRW.append(rec);
+    lowKey->set(20000);
+    QUNIT_IS_EQUAL(rangeCount(myRW, "suppkey", lowKey, nullptr), 1);
+    QUNIT_IS_EQUAL(myRW.getPagesInRange("suppkey", lowKey, nullptr).size(), 1);
+
+    // sorting on acctbal into a table with a zone map on it makes acctbal ranges cheap
+    MyDB_TablePtr sortedTable = make_shared<MyDB_Table>(
+        "zoneSorted", "zoneSorted_storage", mySchema);
+    MyDB_TableReaderWriter sortedRW(sortedTable, myMgr);
+    sortedRW.addZoneMap("acctbal");
+    MyDB_RecordPtr lhs = myRW.getEmptyRecord();
+    MyDB_RecordPtr rhs = myRW.getEmptyRecord();
+    sort(16, myRW, sortedRW, buildRecordComparator(lhs, rhs, "[acctbal]"), lhs, rhs);
+    QUNIT_IS_EQUAL(rangeCount(sortedRW, "acctbal", lowBal, highBal), fullCount(myRW, 5, 100.0, 200.0));
+    QUNIT_IS_TRUE(sortedRW.getPagesInRange("acctbal", lowBal, highBal).size() <= 3);
+
+    // through the catalog and back
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("zoneCatFile");
+      sortedTable->putInCatalog(myCatalog);
+    }
+    MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("zoneCatFile");
+    MyDB_TablePtr fromCatalog = make_shared<MyDB_Table>();
+    QUNIT_IS_TRUE(fromCatalog->fromCatalog("zoneSorted", myCatalog));
+    QUNIT_IS_EQUAL(fromCatalog->getZoneMaps().size(), 1);
+    QUNIT_IS_TRUE(fromCatalog->getZoneMap("acctbal")->toString() ==
+                  sortedTable->getZoneMap("acctbal")->toString());
+    QUNIT_IS_TRUE(fromCatalog->getZoneMap("suppkey") == nullptr);
+
+    // odd strings make it through, and a page that nothing is known about is never skipped
+    MyDB_ZoneMap stringZones("name", 1, make_shared<MyDB_StringAttType>());
+    MyDB_StringAttValPtr val = make_shared<MyDB_StringAttVal>();
+    stringZones.setEmpty(1);
+    for (string text : {"a#b", "c|d;", "100%"}) {
+      val->set(text);
+      stringZones.add(0, val);
+      stringZones.add(1, val);
+    }
+    MyDB_ZoneMap readBack("", 1, make_shared<MyDB_StringAttType>());
+    QUNIT_IS_TRUE(readBack.fromString(stringZones.toString()));
+    QUNIT_IS_EQUAL(readBack.getAttName(), "name");
+    QUNIT_IS_TRUE(readBack.getMin(0) == nullptr);
+    QUNIT_IS_EQUAL(readBack.getMin(1)->toString(), "100%");
+    QUNIT_IS_EQUAL(readBack.getMax(1)->toString(), "c|d;");
+    val->set("zzz");
+    QUNIT_IS_TRUE(readBack.mightHave(0, val, nullptr));
+    QUNIT_IS_TRUE(!readBack.mightHave(1, val, nullptr));
+    QUNIT_IS_TRUE(readBack.mightHave(2, val, nullptr));
+  }
+
+  // Test 14: the catalog file is a log of records that only gets the changed groups appended
+  // on a save, is compacted once it gets big, and can still read the old text format
+  {
+    cout << "Running binary catalog test..." << endl;
+
+    auto fileSize = [](string fName) {
+      ifstream in(fName, ifstream::binary | ifstream::ate);
+      return (size_t)in.tellg();
+    };
+
+    unlink("binCatFile");
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      for (int i = 0; i < 100; i++) {
+        myCatalog->putInt("table" + to_string(i) + ".numTuples", i);
+        myCatalog->putString("table" + to_string(i) + ".fileName", "file|" + to_string(i) + "\n");
+        myCatalog->putStringList("table" + to_string(i) + ".attList", {"a", "", "c"});
+      }
+      myCatalog->putStringList("tables", {"table0", "table1"});
+    }
+    size_t firstSize = fileSize("binCatFile");
+    {
+      ifstream in("binCatFile", ifstream::binary);
+      char magic[8];
+      in.read(magic, 8);
+      QUNIT_IS_TRUE(string(magic, 8) == "MyDBCat1");
+    }
+
+    // changing one table only adds its record onto the end
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      int value = -1;
+      QUNIT_IS_TRUE(myCatalog->getInt("table7.numTuples", value));
+      QUNIT_IS_EQUAL(value, 7);
+      myCatalog->putInt("table7.numTuples", 700);
+    }
+    size_t secondSize = fileSize("binCatFile");
+    QUNIT_IS_TRUE(secondSize > firstSize && secondSize - firstSize < firstSize / 50);
+
+    // and nothing is written if nothing changed
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      string value;
+      QUNIT_IS_TRUE(myCatalog->getString("table7.fileName", value));
+      QUNIT_IS_EQUAL(value, "file|7\n");
+      vector<string> atts;
+      QUNIT_IS_TRUE(myCatalog->getStringList("table7.attList", atts));
+      QUNIT_IS_EQUAL(atts.size(), 3);
+      QUNIT_IS_EQUAL(atts[1], "");
+      QUNIT_IS_TRUE(!myCatalog->getString("table7.missing", value));
+      QUNIT_IS_TRUE(!myCatalog->getString("table1000.fileName", value));
+    }
+    QUNIT_IS_EQUAL(fileSize("binCatFile"), secondSize);
+
+    // lots of updates do not let the file grow without bound
+    for (int i = 0; i < 500; i++) {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      myCatalog->putInt("table" + to_string(i % 100) + ".numTuples", 1000 + i);
+    }
+    QUNIT_IS_TRUE(fileSize("binCatFile") <= 2 * firstSize);
+
+    // a record that was not completely written is ignored
+    {
+      ofstream out("binCatFile", ofstream::binary | ofstream::app);
+      out.write("\xff\x00\x00\x00\x05", 5);
+    }
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      int value = -1;
+      QUNIT_IS_TRUE(myCatalog->getInt("table7.numTuples", value));
+      QUNIT_IS_EQUAL(value, 1407);
+      QUNIT_IS_TRUE(myCatalog->getInt("table99.numTuples", value));
+      QUNIT_IS_EQUAL(value, 1499);
+    }
+
+    // a catalog in the old text format is read, and then saved in the new one
+    {
+      ofstream out("binCatFile", ofstream::trunc);
+      out << "|tables|oldTable#|\n|oldTable.numTuples|42|\n|oldTable.attList|x#y#|\n";
+    }
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      int value = -1;
+      QUNIT_IS_TRUE(myCatalog->getInt("oldTable.numTuples", value));
+      QUNIT_IS_EQUAL(value, 42);
+      vector<string> tables;
+      QUNIT_IS_TRUE(myCatalog->getStringList("tables", tables));
+      QUNIT_IS_EQUAL(tables.size(), 1);
+    }
+    {
+      MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("binCatFile");
+      vector<string> atts;
+      QUNIT_IS_TRUE(myCatalog->getStringList("oldTable.attList", atts));
+      QUNIT_IS_EQUAL(atts.size(), 2);
+      QUNIT_IS_EQUAL(atts[1], "y");
+      ifstream in("binCatFile", ifstream::binary);
+      char magic[8];
+      in.read(magic, 8);
+      QUNIT_IS_TRUE(string(magic, 8) == "MyDBCat1");
+    }
+  }
+
+
+  // Test 15: the sort-merge join gives the same pairs as a nested-loop join, with
+  // selection predicates on both sides, a final predicate, and lots of duplicate keys
+  {
+    cout << "Running sort-merge join test..." << endl;
+
+    MyDB_BufferManagerPtr myMgr =
+        make_shared<MyDB_BufferManager>(1024 * 16, 64, "tempFile");
+    MyDB_TableReaderWriterPtr leftRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("joinLeft", "joinLeft_storage", supplierSchema("l_")), myMgr);
+    MyDB_TableReaderWriterPtr rightRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("joinRight", "joinRight_storage", supplierSchema("r_")), myMgr);
+    leftRW->loadFromTextFile("supplier.tbl");
+    rightRW->loadFromTextFile("supplier.tbl");
+
+    MyDB_SchemaPtr outSchema = make_shared<MyDB_Schema>();
+    outSchema->appendAtt(make_pair("l_suppkey", make_shared<MyDB_IntAttType>()));
+    outSchema->appendAtt(make_pair("r_suppkey", make_shared<MyDB_IntAttType>()));
+    outSchema->appendAtt(make_pair("sum", make_shared<MyDB_DoubleAttType>()));
+    MyDB_TableReaderWriterPtr outRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("joinOut", "joinOut_storage", outSchema), myMgr);
+
+    // the answer, with nested loops over the records in RAM
+    vector<Supp> supps = readSupps();
+    multiset<pair<int, int>> expected;
+    for (auto &l : supps) {
+      if (!(l.acctbal > 5000.0))
+        continue;
+      for (auto &r : supps)
+        if (r.suppkey < 2000 && l.nationkey == r.nationkey && l.suppkey < r.suppkey)
+          expected.insert(make_pair(l.suppkey, r.suppkey));
+    }
+
+    SortMergeJoin myOp(leftRW, rightRW, outRW, "< ([l_suppkey], [r_suppkey])",
+                       {"[l_suppkey]", "[r_suppkey]", "+ ([l_acctbal], [r_acctbal])"},
+                       make_pair(string("[l_nationkey]"), string("[r_nationkey]")),
+                       "> ([l_acctbal], double[5000.0])", "< ([r_suppkey], int[2000])");
+    myOp.run();
+
+    multiset<pair<int, int>> found;
+    map<int, double> balances;
+    for (auto &s : supps)
+      balances[s.suppkey] = s.acctbal;
+    bool sumsMatch = true;
+    MyDB_RecordPtr outRec = outRW->getEmptyRecord();
+    MyDB_RecordIteratorAltPtr myIter = outRW->getIteratorAlt();
+    while (myIter->advance()) {
+      myIter->getCurrent(outRec);
+      int l = outRec->getAtt(0)->toInt(), r = outRec->getAtt(1)->toInt();
+      found.insert(make_pair(l, r));
+      if (fabs(outRec->getAtt(2)->toDouble() - balances[l] - balances[r]) > 0.01)
+        sumsMatch = false;
+    }
+    QUNIT_IS_TRUE(expected.size() > 1000);
+    QUNIT_IS_EQUAL(found.size(), expected.size());
+    QUNIT_IS_TRUE(found == expected);
+    QUNIT_IS_TRUE(sumsMatch);
+
+    // with no predicates at all, every pair with the same key comes out
+    outRW->clear();
+    SortMergeJoin allOp(leftRW, rightRW, outRW, "", {"[l_suppkey]", "[r_suppkey]", "[r_acctbal]"},
+                        make_pair(string("[l_nationkey]"), string("[r_nationkey]")), "", "");
+    allOp.run();
+    map<int, size_t> perNation;
+    for (auto &s : supps)
+      perNation[s.nationkey]++;
+    size_t allExpected = 0;
+    for (auto &n : perNation)
+      allExpected += n.second * n.second;
+    QUNIT_IS_EQUAL(outRW->getTable()->getTupleCount(), allExpected);
+  }
+
+  // Test 16: the hash join gives the same pairs as a nested-loop join when everything fits,
+  // when the inputs have to be split into partitions, and when one key has more records
+  // than fit in the buffer (so a partition is joined with nested loops)
+  {
+    cout << "Running hash join test..." << endl;
+
+    MyDB_SchemaPtr outSchema = make_shared<MyDB_Schema>();
+    outSchema->appendAtt(make_pair("l_suppkey", make_shared<MyDB_IntAttType>()));
+    outSchema->appendAtt(make_pair("r_suppkey", make_shared<MyDB_IntAttType>()));
+
+    vector<Supp> supps = readSupps();
+
+    // runs the join with a buffer of the given size, and returns the pairs that come out
+    auto runJoin = [&](size_t pageSize, size_t numPages, vector<pair<string, string>> checks,
+                       string finalPred, string leftPred, string rightPred) {
+      MyDB_BufferManagerPtr myMgr =
+          make_shared<MyDB_BufferManager>(pageSize, numPages, "tempFile");
+      MyDB_TableReaderWriterPtr leftRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("hashLeft", "hashLeft_storage", supplierSchema("l_")), myMgr);
+      MyDB_TableReaderWriterPtr rightRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("hashRight", "hashRight_storage", supplierSchema("r_")), myMgr);
+      MyDB_TableReaderWriterPtr outRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("hashOut", "hashOut_storage", outSchema), myMgr);
+      leftRW->loadFromTextFile("supplier.tbl");
+      rightRW->loadFromTextFile("supplier.tbl");
+      outRW->clear();
+
+      HashJoin myOp(leftRW, rightRW, outRW, finalPred, {"[l_suppkey]", "[r_suppkey]"}, checks,
+                    leftPred, rightPred);
+      myOp.run();
+
+      multiset<pair<int, int>> found;
+      MyDB_RecordPtr outRec = outRW->getEmptyRecord();
+      MyDB_RecordIteratorAltPtr myIter = outRW->getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(outRec);
+        found.insert(make_pair((int)outRec->getAtt(0)->toInt(), (int)outRec->getAtt(1)->toInt()));
+      }
+      return found;
+    };
+
+    // the query from the sort-merge join test, with everything fitting, and then with the
+    // inputs split into partitions
+    multiset<pair<int, int>> expected;
+    for (auto &l : supps) {
+      if (!(l.acctbal > 5000.0))
+        continue;
+      for (auto &r : supps)
+        if (r.suppkey < 2000 && l.nationkey == r.nationkey && l.suppkey < r.suppkey)
+          expected.insert(make_pair(l.suppkey, r.suppkey));
+    }
+    vector<pair<string, string>> onNation = {make_pair(string("[l_nationkey]"), string("[r_nationkey]"))};
+    QUNIT_IS_TRUE(expected.size() > 1000);
+    QUNIT_IS_TRUE(runJoin(1024 * 16, 256, onNation, "< ([l_suppkey], [r_suppkey])",
+                          "> ([l_acctbal], double[5000.0])", "< ([r_suppkey], int[2000])") == expected);
+    QUNIT_IS_TRUE(runJoin(1024 * 16, 16, onNation, "< ([l_suppkey], [r_suppkey])",
+                          "> ([l_acctbal], double[5000.0])", "< ([r_suppkey], int[2000])") == expected);
+
+    // two equality checks, so each record that gets through both predicates joins with itself
+    expected.clear();
+    for (auto &s : supps)
+      if (s.acctbal > 5000.0 && s.suppkey < 2000)
+        expected.insert(make_pair(s.suppkey, s.suppkey));
+    QUNIT_IS_TRUE(runJoin(1024 * 16, 16,
+                          {make_pair(string("[l_nationkey]"), string("[r_nationkey]")),
+                           make_pair(string("[l_suppkey]"), string("[r_suppkey]"))},
+                          "", "> ([l_acctbal], double[5000.0])", "< ([r_suppkey], int[2000])") == expected);
+
+    // every left record with a nation key takes up more than the whole buffer
+    expected.clear();
+    for (auto &l : supps)
+      for (auto &r : supps)
+        if (r.suppkey < 200 && l.nationkey == r.nationkey)
+          expected.insert(make_pair(l.suppkey, r.suppkey));
+    QUNIT_IS_TRUE(runJoin(1024 * 4, 8, onNation, "", "", "< ([r_suppkey], int[200])") == expected);
+  }
+
+  // Test 17: the hash aggregation agrees with aggregates computed in RAM, when all of the
+  // groups fit, when they have to be spilled to partitions, with no group key and with two,
+  // and when partial aggregates over parts of the table are merged
+  {
+    cout << "Running hash aggregation test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    // the count, sum, and average balance for each key
+    struct Agg {
+      int count = 0;
+      double sum = 0;
+    };
+    typedef map<string, Agg> Answer;
+
+    // runs the aggregation with a buffer of the given size, and gets the answer; the output has
+    // the group keys, and then the count, sum, and average
+    auto runAgg = [&](size_t pageSize, size_t numPages, vector<string> groupings,
+                      vector<MyDB_AttTypePtr> groupTypes, string pred, bool inParts) {
+      MyDB_BufferManagerPtr myMgr =
+          make_shared<MyDB_BufferManager>(pageSize, numPages, "tempFile");
+      MyDB_TableReaderWriterPtr inRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("aggIn", "aggIn_storage", mySchema), myMgr);
+      inRW->loadFromTextFile("supplier.tbl");
+
+      MyDB_SchemaPtr outSchema = make_shared<MyDB_Schema>();
+      for (size_t i = 0; i < groupTypes.size(); i++)
+        outSchema->appendAtt(make_pair("key" + to_string(i), groupTypes[i]));
+      outSchema->appendAtt(make_pair("cnt", make_shared<MyDB_IntAttType>()));
+      outSchema->appendAtt(make_pair("sum", make_shared<MyDB_DoubleAttType>()));
+      outSchema->appendAtt(make_pair("avg", make_shared<MyDB_DoubleAttType>()));
+      MyDB_TableReaderWriterPtr outRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("aggOut", "aggOut_storage", outSchema), myMgr);
+      outRW->clear();
+
+      Aggregate myOp(inRW, outRW,
+                     {make_pair(cntAgg, string("")), make_pair(sumAgg, string("[acctbal]")),
+                      make_pair(avgAgg, string("[acctbal]"))},
+                     groupings, pred);
+      if (!inParts) {
+        myOp.run();
+      } else {
+        // aggregate the first and second halves of the table separately, and then merge
+        vector<MyDB_TableReaderWriterPtr> partials;
+        int half = inRW->getNumPages() / 2;
+        for (int i = 0; i < 2; i++) {
+          partials.push_back(make_shared<MyDB_TableReaderWriter>(
+              make_shared<MyDB_Table>("aggPart" + to_string(i), "aggPart" + to_string(i) + "_storage",
+                                      myOp.getPartialSchema()),
+              myMgr));
+          partials.back()->clear();
+        }
+        myOp.runPartial(0, half - 1, partials[0]);
+        myOp.runPartial(half, inRW->getNumPages() - 1, partials[1]);
+        myOp.mergePartials(partials);
+      }
+
+      Answer found;
+      bool avgsMatch = true;
+      size_t numRecs = 0;
+      MyDB_RecordPtr outRec = outRW->getEmptyRecord();
+      MyDB_RecordIteratorAltPtr myIter = outRW->getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(outRec);
+        numRecs++;
+        string key;
+        for (size_t i = 0; i < groupTypes.size(); i++)
+          key += outRec->getAtt(i)->toString() + "|";
+        Agg &agg = found[key];
+        agg.count = outRec->getAtt(groupTypes.size())->toInt();
+        agg.sum = outRec->getAtt(groupTypes.size() + 1)->toDouble();
+        if (fabs(outRec->getAtt(groupTypes.size() + 2)->toDouble() - agg.sum / agg.count) > 0.001)
+          avgsMatch = false;
+      }
+      QUNIT_IS_TRUE(avgsMatch);
+      QUNIT_IS_EQUAL(numRecs, found.size());
+      return found;
+    };
+
+    // the answers, computed in RAM
+    vector<vector<string>> supps = readSupplierFields();
+    auto expected = [&](function<string(vector<string> &)> key, function<bool(vector<string> &)> pred) {
+      Answer answer;
+      for (auto &s : supps) {
+        if (!pred(s))
+          continue;
+        Agg &agg = answer[key(s)];
+        agg.count++;
+        agg.sum += stod(s[5]);
+      }
+      return answer;
+    };
+    auto sameAnswer = [](Answer lhs, Answer rhs) {
+      if (lhs.size() != rhs.size())
+        return false;
+      for (auto &a : lhs) {
+        if (rhs.count(a.first) == 0 || rhs[a.first].count != a.second.count ||
+            fabs(rhs[a.first].sum - a.second.sum) > 0.01)
+          return false;
+      }
+      return true;
+    };
+
+    MyDB_AttTypePtr intType = make_shared<MyDB_IntAttType>();
+    MyDB_AttTypePtr boolType = make_shared<MyDB_BoolAttType>();
+    auto positive = [](vector<string> &s) { return stod(s[5]) > 0.0; };
+    auto all = [](vector<string> &) { return true; };
+
+    // by nation, with everything fitting
+    Answer byNation = expected([](vector<string> &s) { return s[3] + "|"; }, positive);
+    QUNIT_IS_EQUAL(byNation.size(), 25);
+    QUNIT_IS_TRUE(sameAnswer(runAgg(1024 * 16, 64, {"[nationkey]"}, {intType}, "> ([acctbal], double[0.0])", false), byNation));
+
+    // by supplier, with a tiny buffer, so that the groups are spilled, and then again in two parts
+    Answer bySupp = expected([](vector<string> &s) { return s[0] + "|"; }, all);
+    QUNIT_IS_EQUAL(bySupp.size(), 10000);
+    QUNIT_IS_TRUE(sameAnswer(runAgg(1024 * 4, 8, {"[suppkey]"}, {intType}, "", false), bySupp));
+    QUNIT_IS_TRUE(sameAnswer(runAgg(1024 * 4, 8, {"[suppkey]"}, {intType}, "", true), bySupp));
+
+    // with no group key, and with two
+    Answer overall = expected([](vector<string> &) { return string(""); }, positive);
+    QUNIT_IS_TRUE(sameAnswer(runAgg(1024 * 16, 64, {}, {}, "> ([acctbal], double[0.0])", false), overall));
+    Answer byTwo = expected([](vector<string> &s) { return s[3] + "|" + (stod(s[5]) > 5000.0 ? "true" : "false") + "|"; }, all);
+    QUNIT_IS_TRUE(sameAnswer(runAgg(1024 * 16, 64, {"[nationkey]", "> ([acctbal], double[5000.0])"}, {intType, boolType}, "", true), byTwo));
+  }
+  // Test 18: plans made of pipelined operators give the same answers as ones computed in RAM,
+  // with the join's left records fitting in the buffer and not, and with either side of the
+  // join (or the input to an aggregation) empty, and each operator counts the records that it
+  // produces
+  {
+    cout << "Running pipelined executor test..." << endl;
+
+    vector<Supp> supps = readSupps();
+
+    // the suppliers with a balance over 9000, sorted by balance
+    {
+      MyDB_BufferManagerPtr myMgr = make_shared<MyDB_BufferManager>(1024 * 4, 16, "tempFile");
+      MyDB_TableReaderWriterPtr suppRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("execSupp", "execSupp_storage", supplierSchema("")), myMgr);
+      suppRW->loadFromTextFile("supplier.tbl");
+
+      MyDB_SchemaPtr projSchema = make_shared<MyDB_Schema>();
+      projSchema->appendAtt(make_pair("suppkey", make_shared<MyDB_IntAttType>()));
+      projSchema->appendAtt(make_pair("acctbal", make_shared<MyDB_DoubleAttType>()));
+      QueryOpPtr scan = make_shared<ScanOp>(suppRW);
+      QueryOpPtr filter = make_shared<FilterOp>(scan, "> ([acctbal], double[9000.0])");
+      QueryOpPtr project =
+          make_shared<ProjectOp>(filter, projSchema, vector<string>{"[suppkey]", "[acctbal]"});
+      QueryOpPtr plan = make_shared<SortOp>(project, "[acctbal]");
+
+      vector<double> expected;
+      for (auto &s : supps)
+        if (s.acctbal > 9000.0)
+          expected.push_back(s.acctbal);
+      sort(expected.begin(), expected.end());
+
+      vector<double> found;
+      plan->open();
+      while (plan->next())
+        found.push_back(plan->getRecord()->getAtt(1)->toDouble());
+      plan->close();
+
+      bool sameBalances = found.size() == expected.size();
+      for (size_t i = 0; sameBalances && i < found.size(); i++)
+        sameBalances = fabs(found[i] - expected[i]) < 0.001;
+      QUNIT_IS_TRUE(sameBalances);
+      QUNIT_IS_EQUAL(scan->getNumRecords(), supps.size());
+      QUNIT_IS_EQUAL(filter->getNumRecords(), expected.size());
+      QUNIT_IS_EQUAL(project->getNumRecords(), expected.size());
+      QUNIT_IS_EQUAL(plan->getNumRecords(), expected.size());
+      QUNIT_IS_TRUE(plan->getProfile().find("  Project: " + to_string(expected.size()) + " records") !=
+                    string::npos);
+
+      // an aggregation over no records has no groups
+      MyDB_SchemaPtr countSchema = make_shared<MyDB_Schema>();
+      countSchema->appendAtt(make_pair("nationkey", make_shared<MyDB_IntAttType>()));
+      countSchema->appendAtt(make_pair("cnt", make_shared<MyDB_IntAttType>()));
+      QueryOpPtr emptyAgg = make_shared<AggregateOp>(
+          make_shared<FilterOp>(make_shared<ScanOp>(suppRW), "< ([suppkey], int[0])"), countSchema,
+          vector<pair<MyDB_AggType, string>>{make_pair(cntAgg, string(""))}, vector<string>{"[nationkey]"});
+      emptyAgg->open();
+      QUNIT_IS_FALSE(emptyAgg->next());
+      emptyAgg->close();
+      QUNIT_IS_EQUAL(emptyAgg->getNumRecords(), (size_t)0);
+    }
+
+    // for each supplier with a suppkey under leftMax, the number of suppliers in the same nation
+    // with a suppkey under rightMax... with a big buffer, the join's left records all fit; with
+    // a small one, they do not
+    auto runJoinAgg = [&](size_t pageSize, size_t numPages, int leftMax, int rightMax) {
+      MyDB_BufferManagerPtr myMgr =
+          make_shared<MyDB_BufferManager>(pageSize, numPages, "tempFile");
+      MyDB_TableReaderWriterPtr leftRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("execLeft", "execLeft_storage", supplierSchema("l_")), myMgr);
+      MyDB_TableReaderWriterPtr rightRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("execRight", "execRight_storage", supplierSchema("r_")), myMgr);
+      leftRW->loadFromTextFile("supplier.tbl");
+      rightRW->loadFromTextFile("supplier.tbl");
+
+      MyDB_SchemaPtr outSchema = make_shared<MyDB_Schema>();
+      outSchema->appendAtt(make_pair("suppkey", make_shared<MyDB_IntAttType>()));
+      outSchema->appendAtt(make_pair("cnt", make_shared<MyDB_IntAttType>()));
+      MyDB_TableReaderWriterPtr outRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("execOut", "execOut_storage", outSchema), myMgr);
+      outRW->clear();
+
+      QueryOpPtr join = make_shared<HashJoinOp>(
+          make_shared<FilterOp>(make_shared<ScanOp>(leftRW), "< ([l_suppkey], int[" + to_string(leftMax) + "])"),
+          make_shared<FilterOp>(make_shared<ScanOp>(rightRW), "< ([r_suppkey], int[" + to_string(rightMax) + "])"),
+          vector<pair<string, string>>{make_pair("[l_nationkey]", "[r_nationkey]")});
+      QueryOpPtr plan = make_shared<AggregateOp>(join, outSchema,
+                                                 vector<pair<MyDB_AggType, string>>{make_pair(cntAgg, string(""))},
+                                                 vector<string>{"[l_suppkey]"});
+      plan->appendAllTo(outRW);
+
+      map<int, int> rightPerNation;
+      for (auto &s : supps)
+        if (s.suppkey < rightMax)
+          rightPerNation[s.nationkey]++;
+      size_t numJoined = 0;
+      map<int, int> expected;
+      for (auto &s : supps) {
+        if (s.suppkey < leftMax && rightPerNation[s.nationkey] > 0) {
+          expected[s.suppkey] = rightPerNation[s.nationkey];
+          numJoined += rightPerNation[s.nationkey];
+        }
+      }
+      QUNIT_IS_EQUAL(join->getNumRecords(), numJoined);
+      QUNIT_IS_EQUAL(plan->getNumRecords(), expected.size());
+
+      map<int, int> found;
+      MyDB_RecordPtr outRec = outRW->getEmptyRecord();
+      MyDB_RecordIteratorAltPtr myIter = outRW->getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(outRec);
+        found[(int)outRec->getAtt(0)->toInt()] = (int)outRec->getAtt(1)->toInt();
+      }
+      return found == expected;
+    };
+    QUNIT_IS_TRUE(runJoinAgg(1024 * 16, 64, 300, INT_MAX));
+    QUNIT_IS_TRUE(runJoinAgg(1024 * 4, 8, 300, INT_MAX));
+
+    // nothing comes out when either side of the join is empty, whether or not the left
+    // records fit
+    QUNIT_IS_TRUE(runJoinAgg(1024 * 16, 64, 0, INT_MAX));
+    QUNIT_IS_TRUE(runJoinAgg(1024 * 16, 64, 300, 0));
+    QUNIT_IS_TRUE(runJoinAgg(1024 * 4, 8, 0, INT_MAX));
+    QUNIT_IS_TRUE(runJoinAgg(1024 * 4, 8, 300, 0));
+  }
+  // Test 19: a morsel-driven parallel scan sees every record once, no matter how many workers
+  // there are or how big the morsels are, and its parallel aggregation agrees with aggregates
+  // computed in RAM, even when the workers have to write their groups out to pages
+  {
+    cout << "Running morsel scan test..." << endl;
+
+    MyDB_SchemaPtr mySchema = supplierSchema("");
+
+    // the count and sum of the positive balances in each nation, and the sum of the suppkeys
+    map<int, pair<int, double>> expected;
+    long long suppkeySum = 0;
+    size_t numPositive = 0;
+    for (auto &s : readSupps()) {
+      suppkeySum += s.suppkey;
+      if (s.acctbal > 0.0) {
+        expected[s.nationkey].first++;
+        expected[s.nationkey].second += s.acctbal;
+        numPositive++;
+      }
+    }
+
+    MyDB_BufferManagerPtr myMgr = make_shared<MyDB_BufferManager>(1024 * 4, 16, "tempFile");
+    MyDB_TableReaderWriterPtr suppRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("morselSupp", "morselSupp_storage", mySchema), myMgr);
+    suppRW->loadFromTextFile("supplier.tbl");
+    MyDB_SchemaPtr outSchema = make_shared<MyDB_Schema>();
+    outSchema->appendAtt(make_pair("nationkey", make_shared<MyDB_IntAttType>()));
+    outSchema->appendAtt(make_pair("cnt", make_shared<MyDB_IntAttType>()));
+    outSchema->appendAtt(make_pair("sum", make_shared<MyDB_DoubleAttType>()));
+    MyDB_TableReaderWriterPtr outRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("morselOut", "morselOut_storage", outSchema), myMgr);
+
+    // the last one is over a PAX copy of the table, whose pages are turned into rows as the
+    // workers copy them
+    MyDB_TableReaderWriterPtr paxRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("morselPax", "morselPax_storage", mySchema, "pax", ""), myMgr);
+    paxRW->loadFromTextFile("supplier.tbl");
+
+    int numMorsels = 0;
+    for (auto &config : vector<pair<int, int>>{{1, 4}, {3, 1}, {4, 7}, {3, 2}}) {
+      if (config.second == 2)
+        suppRW = paxRW;
+      MorselScan myScan(suppRW, config.first, config.second);
+      numMorsels = (suppRW->getNumPages() + config.second - 1) / config.second;
+
+      // each worker adds up the suppkeys it sees
+      vector<long long> sums(config.first, 0);
+      vector<func> suppkeys;
+      for (int i = 0; i < config.first; i++)
+        suppkeys.push_back(myScan.getRecord(i)->compileComputation("[suppkey]"));
+      myScan.run("", [&](int whichWorker, MyDB_RecordPtr) { sums[whichWorker] += suppkeys[whichWorker]()->toInt(); });
+      long long total = 0;
+      for (long long sum : sums)
+        total += sum;
+      QUNIT_IS_EQUAL(total, suppkeySum);
+      size_t morselsRun = 0;
+      for (size_t count : myScan.getMorselsRun())
+        morselsRun += count;
+      QUNIT_IS_EQUAL(morselsRun, (size_t)numMorsels);
+
+      outRW->clear();
+      myScan.aggregate(outRW, {make_pair(cntAgg, string("")), make_pair(sumAgg, string("[acctbal]"))},
+                       {"[nationkey]"}, "> ([acctbal], double[0.0])");
+      map<int, pair<int, double>> found;
+      MyDB_RecordPtr outRec = outRW->getEmptyRecord();
+      MyDB_RecordIteratorAltPtr myIter = outRW->getIteratorAlt();
+      while (myIter->advance()) {
+        myIter->getCurrent(outRec);
+        found[outRec->getAtt(0)->toInt()] = make_pair(outRec->getAtt(1)->toInt(), outRec->getAtt(2)->toDouble());
+      }
+      bool allMatch = found.size() == expected.size();
+      for (auto &group : expected) {
+        if (found[group.first].first != group.second.first ||
+            fabs(found[group.first].second - group.second.second) > 0.01)
+          allMatch = false;
+      }
+      QUNIT_IS_TRUE(allMatch);
+    }
+
+    // with a group for each supplier, the workers run out of RAM many times over
+    {
+      MorselScan myScan(suppRW, 3, 2);
+      MyDB_SchemaPtr keySchema = make_shared<MyDB_Schema>();
+      keySchema->appendAtt(make_pair("suppkey", make_shared<MyDB_IntAttType>()));
+      keySchema->appendAtt(make_pair("cnt", make_shared<MyDB_IntAttType>()));
+      MyDB_TableReaderWriterPtr keyRW = make_shared<MyDB_TableReaderWriter>(
+          make_shared<MyDB_Table>("morselKeys", "morselKeys_storage", keySchema), myMgr);
+      keyRW->clear();
+      myScan.aggregate(keyRW, {make_pair(cntAgg, string(""))}, {"[suppkey]"}, "> ([acctbal], double[0.0])");
+      QUNIT_IS_TRUE(myScan.getNumSpilled() > 10);
+      long long foundSum = 0;
+      size_t numGroups = 0;
+      bool allOnes = true;
+      MyDB_RecordPtr keyRec = keyRW->getEmptyRecord();
+      MyDB_RecordIteratorAltPtr keyIter = keyRW->getIteratorAlt();
+      while (keyIter->advance()) {
+        keyIter->getCurrent(keyRec);
+        foundSum += keyRec->getAtt(0)->toInt();
+        numGroups++;
+        if (keyRec->getAtt(1)->toInt() != 1)
+          allOnes = false;
+      }
+      long long positiveSum = 0;
+      for (auto &s : readSupps())
+        if (s.acctbal > 0.0)
+          positiveSum += s.suppkey;
+      QUNIT_IS_EQUAL(numGroups, numPositive);
+      QUNIT_IS_EQUAL(foundSum, positiveSum);
+      QUNIT_IS_TRUE(allOnes);
+    }
+
+    // with no group key, there is one group, which has all of the records
+    MorselScan myScan(suppRW, 2, 2);
+    MyDB_SchemaPtr countSchema = make_shared<MyDB_Schema>();
+    countSchema->appendAtt(make_pair("cnt", make_shared<MyDB_IntAttType>()));
+    MyDB_TableReaderWriterPtr countRW = make_shared<MyDB_TableReaderWriter>(
+        make_shared<MyDB_Table>("morselCount", "morselCount_storage", countSchema), myMgr);
+    countRW->clear();
+    myScan.aggregate(countRW, {make_pair(cntAgg, string(""))}, {}, "> ([acctbal], double[0.0])");
+    MyDB_RecordPtr countRec = countRW->getEmptyRecord();
+    MyDB_RecordIteratorAltPtr countIter = countRW->getIteratorAlt();
+    QUNIT_IS_TRUE(countIter->advance());
+    countIter->getCurrent(countRec);
+    QUNIT_IS_EQUAL((size_t)countRec->getAtt(0)->toInt(), numPositive);
+  }
+  // Test 20: a compressed table holds the same records as a heap table, in the same order,
+  // on far fewer pages; each column gets the encoding that suits it, and the batches decoded
+  // straight from the compressed pages match, with every level of kernels
+  {
+    cout << "Running compressed page test..." << endl;
+
+    // a sorted key, a small range of ints, runs of bools, a few cities and prices, long runs
+    // of regions, and a note that is different for every record
+    vector<string> cities = {"Houston", "Austin", "Dallas", "El Paso", "Waco", "Tyler"};
+    mt19937 gen(530);
+    {
+      ofstream out("compressTest.tbl");
+      for (int i = 0; i < 20000; i++)
+        out << i << "|" << 1000000 + (i * 7919) % 50 << "|" << ((i / 500) % 2 == 0 ? "true" : "false")
+            << "|" << cities[gen() % cities.size()] << "|" << (i % 7) * 1.5 << "|region"
+            << i / 3000 << "|note" << i << "-" << gen() % 100000 << "|\n";
+    }
+
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("grp", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("flag", make_shared<MyDB_BoolAttType>()));
+    mySchema->appendAtt(make_pair("city", make_shared<MyDB_StringAttType>()));
+    mySchema->appendAtt(make_pair("price", make_shared<MyDB_DoubleAttType>()));
+    mySchema->appendAtt(make_pair("region", make_shared<MyDB_StringAttType>()));
+    mySchema->appendAtt(make_pair("note", make_shared<MyDB_StringAttType>()));
+
+    size_t pageSize = 1024 * 16;
+    MyDB_BufferManagerPtr myMgr = make_shared<MyDB_BufferManager>(pageSize, 16, "tempFile");
+    MyDB_TableReaderWriter heapRW(make_shared<MyDB_Table>("heapCompress", "heapCompress_storage", mySchema),
+                                  myMgr);
+    MyDB_TableReaderWriter compRW(
+        make_shared<MyDB_Table>("compress", "compress_storage", mySchema, "compressed", ""), myMgr);
+    heapRW.loadFromTextFile("compressTest.tbl");
+    compRW.loadFromTextFile("compressTest.tbl", 2);
+    QUNIT_IS_TRUE(compRW[0].getType() == MyDB_PageType::CompressedPage);
+    QUNIT_IS_TRUE(compRW.getNumPages() * 2 < heapRW.getNumPages());
+
+    MyDB_PageReaderWriter pinned = compRW.getPinned(0);
+    MyDB_CompressedPage firstPage(pinned.getBytes(), pageSize);
+    QUNIT_IS_TRUE(firstPage.getEncoding(0) == DeltaEncoding);
+    QUNIT_IS_TRUE(firstPage.getEncoding(1) == FrameOfReference);
+    QUNIT_IS_TRUE(firstPage.getEncoding(2) == RunLength);
+    QUNIT_IS_TRUE(firstPage.getEncoding(3) == Dictionary);
+    QUNIT_IS_TRUE(firstPage.getEncoding(4) == Dictionary);
+    QUNIT_IS_TRUE(firstPage.getEncoding(5) == RunLength);
+    QUNIT_IS_TRUE(firstPage.getEncoding(6) == PlainEncoding);
+    QUNIT_IS_TRUE(firstPage.getBytesUsed() <= pageSize);
+    QUNIT_IS_TRUE(firstPage.getRowBytes() > pageSize);
+
+    // the records come out of both kinds of record iterators just as they went in
+    MyDB_RecordPtr heapRec = heapRW.getEmptyRecord();
+    MyDB_RecordPtr compRec = compRW.getEmptyRecord();
+    MyDB_RecordIteratorAltPtr heapIter = heapRW.getIteratorAlt();
+    MyDB_RecordIteratorPtr compIter = compRW.getIterator(compRec);
+    int count = 0;
+    bool matches = true;
+    while (heapIter->advance()) {
+      heapIter->getCurrent(heapRec);
+      if (!compIter->hasNext())
+        matches = false;
+      compIter->getNext();
+      for (int i = 0; i < 7; i++)
+        if (compRec->getAtt(i)->toString() != heapRec->getAtt(i)->toString())
+          matches = false;
+      count++;
+    }
+    QUNIT_IS_EQUAL(count, 20000);
+    QUNIT_IS_TRUE(matches && !compIter->hasNext());
+
+    // the batches match for every column, and for a projection
+    for (auto level : {ScalarKernels, AVX2Kernels, AVX512Kernels}) {
+      useKernels(level);
+      for (vector<string> atts : vector<vector<string>>{{}, {"region", "key"}}) {
+        MyDB_RecordBatchPtr batch = compRW.getEmptyBatch(atts);
+        MyDB_BatchIteratorPtr batchIter = compRW.getBatchIterator();
+        heapIter = heapRW.getIteratorAlt();
+        count = 0;
+        matches = true;
+        while (batchIter->getNextBatch(*batch)) {
+          for (int i = 0; i < batch->size(); i++) {
+            heapIter->advance();
+            heapIter->getCurrent(heapRec);
+            if (batch->getIntColumn(0)[i] != heapRec->getAtt(0)->toInt() ||
+                batch->getString(5, i) != heapRec->getAtt(5)->toString())
+              matches = false;
+            if (atts.empty() &&
+                (batch->getIntColumn(1)[i] != heapRec->getAtt(1)->toInt() ||
+                 (bool)batch->getBoolColumn(2)[i] != heapRec->getAtt(2)->toBool() ||
+                 batch->getString(3, i) != heapRec->getAtt(3)->toString() ||
+                 batch->getDoubleColumn(4)[i] != heapRec->getAtt(4)->toDouble() ||
+                 batch->getString(6, i) != heapRec->getAtt(6)->toString()))
+              matches = false;
+            count++;
+          }
+        }
+        QUNIT_IS_EQUAL(count, 20000);
+        QUNIT_IS_TRUE(matches);
+      }
+    }
+    useKernels(AVX512Kernels);
+
+    // a column can also be decoded starting part of the way through a page
+    vector<int> keys(firstPage.getNumRecs());
+    vector<char *> regions(firstPage.getNumRecs());
+    MyDB_CompressedPage::Cursor keyCur, regionCur;
+    firstPage.getInts(0, 0, keys.size(), keys.data(), keyCur);
+    firstPage.getStrings(5, 0, regions.size(), regions.data(), regionCur);
+    int someKeys[100];
+    char *someRegions[100];
+    MyDB_CompressedPage::Cursor fresh, freshToo;
+    firstPage.getInts(0, 333, 100, someKeys, fresh);
+    firstPage.getStrings(5, 333, 100, someRegions, freshToo);
+    matches = true;
+    for (int i = 0; i < 100; i++)
+      if (someKeys[i] != 333 + i || someKeys[i] != keys[333 + i] || someRegions[i] != regions[333 + i])
+        matches = false;
+    QUNIT_IS_TRUE(matches);
+
+    // sorting a compressed page in place keeps it a compressed page, with all of its records
+    MyDB_RecordPtr lhs = compRW.getEmptyRecord();
+    MyDB_RecordPtr rhs = compRW.getEmptyRecord();
+    function<bool()> comp = buildRecordComparator(lhs, rhs, "[note]");
+    size_t onPage = MyDB_CompressedPage(compRW.getPinned(1).getBytes(), pageSize).getNumRecs();
+    compRW[1].sortInPlace(comp, lhs, rhs);
+    QUNIT_IS_TRUE(compRW[1].getType() == MyDB_PageType::CompressedPage);
+    MyDB_RecordIteratorAltPtr pageIter = compRW[1].getIteratorAlt();
+    bool sorted = true, first = true;
+    size_t seen = 0;
+    while (pageIter->advance()) {
+      pageIter->getCurrent(lhs);
+      if (!first && comp())
+        sorted = false;
+      pageIter->getCurrent(rhs);
+      first = false;
+      seen++;
+    }
+    QUNIT_IS_TRUE(sorted);
+    QUNIT_IS_EQUAL(seen, onPage);
+
+    // records appended after the load go onto a PAX page, and zone maps and the parallel
+    // scan work over the compressed pages
+    int numPages = compRW.getNumPages();
+    compRW.append(heapRec);
+    QUNIT_IS_EQUAL(compRW.getNumPages(), numPages + 1);
+    QUNIT_IS_TRUE(compRW[numPages].getType() == MyDB_PageType::PaxPage);
+    compRW.addZoneMap("key");
+    MyDB_IntAttValPtr low = make_shared<MyDB_IntAttVal>();
+    low->set(100);
+    MyDB_IntAttValPtr high = make_shared<MyDB_IntAttVal>();
+    high->set(200);
+    QUNIT_IS_EQUAL((int)compRW.getPagesInRange("key", low, high).size(), 1);
+
+    MyDB_TableReaderWriterPtr scanMe = make_shared<MyDB_TableReaderWriter>(compRW.getTable(), myMgr);
+    MorselScan myScan(scanMe, 3, 1);
+    vector<int> counts(3, 0);
+    myScan.run("", [&](int whichWorker, MyDB_RecordPtr) { counts[whichWorker]++; });
+    QUNIT_IS_EQUAL(counts[0] + counts[1] + counts[2], 20001);
+  }
+
+  // Test 21: a schema with no strings gives fixed-width records with no headers, so more of
+  // them fit on a page; heap, PAX, and compressed tables, batches, typed expressions, and
+  // in-place sorting all agree on what the records hold
+  {
+    cout << "Running fixed-width record test..." << endl;
+
+    {
+      ofstream out("fixedTest.tbl");
+      for (int i = 0; i < 5000; i++)
+        out << i << "|" << (i * 37 % 1000) / 4.0 << "|" << (i % 3 == 0 ? "true" : "false") << "|" << i % 17
+            << "|\n";
+    }
+
+    MyDB_SchemaPtr mySchema = make_shared<MyDB_Schema>();
+    mySchema->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    mySchema->appendAtt(make_pair("val", make_shared<MyDB_DoubleAttType>()));
+    mySchema->appendAtt(make_pair("flag", make_shared<MyDB_BoolAttType>()));
+    mySchema->appendAtt(make_pair("grp", make_shared<MyDB_IntAttType>()));
+    QUNIT_IS_TRUE(mySchema->isFixedWidth());
+    QUNIT_IS_EQUAL(mySchema->getFixedSize(), 17);
+    QUNIT_IS_EQUAL(mySchema->getFixedOffset(2), 12);
+    QUNIT_IS_EQUAL(mySchema->getFixedOffset(3), 13);
+
+    MyDB_SchemaPtr withString = make_shared<MyDB_Schema>();
+    withString->appendAtt(make_pair("key", make_shared<MyDB_IntAttType>()));
+    QUNIT_IS_TRUE(withString->isFixedWidth());
+    withString->appendAtt(make_pair("name", make_shared<MyDB_StringAttType>()));
+    QUNIT_IS_FALSE(withString->isFixedWidth());
+    QUNIT_IS_FALSE(make_shared<MyDB_Schema>()->isFixedWidth());
+
+    size_t pageSize = 4096;
+    MyDB_BufferManagerPtr myMgr = make_shared<MyDB_BufferManager>(pageSize, 16, "tempFile");
+    MyDB_TableReaderWriter heapRW(make_shared<MyDB_Table>("fixedHeap", "fixedHeap_storage", mySchema), myMgr);
+    MyDB_TableReaderWriter paxRW(make_shared<MyDB_Table>("fixedPax", "fixedPax_storage", mySchema, "pax", ""),
+                                 myMgr);
+    MyDB_TableReaderWriter compRW(
+        make_shared<MyDB_Table>("fixedComp", "fixedComp_storage", mySchema, "compressed", ""), myMgr);
+    heapRW.loadFromTextFile("fixedTest.tbl");
+    paxRW.loadFromTextFile("fixedTest.tbl");
+    compRW.loadFromTextFile("fixedTest.tbl");
+
+    // every page but the last is packed with 17 byte records
+    int perPage = (pageSize - 2 * sizeof(size_t)) / 17;
+    QUNIT_IS_EQUAL(heapRW.getNumPages(), (5000 + perPage - 1) / perPage);
+    MyDB_RecordPtr rec = heapRW.getEmptyRecord();
+    rec->fromString("7|1.5|true|3|");
+    QUNIT_IS_EQUAL(rec->getBinarySize(), 17);
+    vector<char> bytes(17);
+    rec->toBinary(bytes.data());
+    MyDB_RecordPtr other = heapRW.getEmptyRecord();
+    QUNIT_IS_TRUE(other->fromBinary(bytes.data()) == bytes.data() + 17);
+    QUNIT_IS_EQUAL(other->getAtt(0)->toInt(), 7);
+    QUNIT_IS_EQUAL(other->getAtt(1)->toDouble(), 1.5);
+    QUNIT_IS_TRUE(other->getAtt(2)->toBool());
+    QUNIT_IS_EQUAL(other->getAtt(3)->toInt(), 3);
+
+    // the records come back out of every kind of table just as they went in, and the typed
+    // expressions read them at the right offsets
+    MyDB_TypedExpr bigVal(mySchema, "&& (> ([val], double[100.0]), ! ([flag]))");
+    MyDB_TypedExpr grp(mySchema, "[grp]");
+    bool matches = true;
+    int numBig = 0;
+    for (MyDB_TableReaderWriter *rw : {&heapRW, &paxRW, &compRW}) {
+      MyDB_RecordIteratorAltPtr myIter = rw->getIteratorAlt();
+      int count = 0;
+      while (myIter->advance()) {
+        myIter->getCurrent(rec);
+        if (rec->getAtt(0)->toInt() != count || rec->getAtt(1)->toDouble() != (count * 37 % 1000) / 4.0 ||
+            rec->getAtt(2)->toBool() != (count % 3 == 0) || rec->getAtt(3)->toInt() != count % 17)
+          matches = false;
+        if (rw == &heapRW) {
+          char *current = (char *)myIter->getCurrentPointer();
+          if (grp.evalInt(current) != count % 17)
+            matches = false;
+          if (bigVal.evalBool(current))
+            numBig++;
+        }
+        count++;
+      }
+      if (count != 5000)
+        matches = false;
+    }
+    QUNIT_IS_TRUE(matches);
+    int expectedBig = 0;
+    for (int i = 0; i < 5000; i++)
+      if ((i * 37 % 1000) / 4.0 > 100.0 && i % 3 != 0)
+        expectedBig++;
+    QUNIT_IS_EQUAL(numBig, expectedBig);
+
+    // the batches are decoded a column at a time, straight from the page
+    MyDB_RecordBatchPtr batch = heapRW.getEmptyBatch();
+    MyDB_BatchIteratorPtr batchIter = heapRW.getBatchIterator();
+    int count = 0;
+    matches = true;
+    while (batchIter->getNextBatch(*batch)) {
+      for (int i = 0; i < batch->size(); i++, count++) {
+        if (batch->getIntColumn(0)[i] != count || batch->getDoubleColumn(1)[i] != (count * 37 % 1000) / 4.0 ||
+            batch->getBoolColumn(2)[i] != (count % 3 == 0) || batch->getIntColumn(3)[i] != count % 17 ||
+            batch->getOffsets(3)[i] != 13)
+          matches = false;
+      }
+      batch->getRecord(batch->size() - 1, rec);
+      if (rec->getAtt(0)->toInt() != count - 1)
+        matches = false;
+    }
+    QUNIT_IS_EQUAL(count, 5000);
+    QUNIT_IS_TRUE(matches);
+
+    // and a page is sorted in place by stepping through its records
+    MyDB_RecordPtr lhs = heapRW.getEmptyRecord();
+    MyDB_RecordPtr rhs = heapRW.getEmptyRecord();
+    function<bool()> comp = buildRecordComparator(lhs, rhs, "[val]");
+    heapRW[1].sortInPlace(comp, lhs, rhs);
+    MyDB_RecordIteratorAltPtr pageIter = heapRW[1].getIteratorAlt();
+    bool sorted = true;
+    double last = -1;
+    set<int> keys;
+    while (pageIter->advance()) {
+      pageIter->getCurrent(rec);
+      if (rec->getAtt(1)->toDouble() < last || rec->getAtt(1)->toDouble() != (rec->getAtt(0)->toInt() * 37 % 1000) / 4.0)
+        sorted = false;
+      last = rec->getAtt(1)->toDouble();
+      keys.insert(rec->getAtt(0)->toInt());
+    }
+    QUNIT_IS_TRUE(sorted);
+    QUNIT_IS_EQUAL((int)keys.size(), perPage);
+    QUNIT_IS_EQUAL(*keys.begin(), perPage);
+
+    // the layout goes into the catalog with the table; a table that is in the catalog without
+    // one was written before there was a fixed layout, so its records are read as variable
+    {
+      ofstream out("layoutCatFile");
+      out << "|oldFixed.attList|key#val#flag#grp#|\n|oldFixed.fileName|oldFixed_storage|\n"
+          << "|oldFixed.key.type|int|\n|oldFixed.val.type|double|\n|oldFixed.flag.type|bool|\n"
+          << "|oldFixed.grp.type|int|\n|oldFixed.lastPage|-1|\n";
+    }
+    MyDB_CatalogPtr myCatalog = make_shared<MyDB_Catalog>("layoutCatFile");
+    heapRW.getTable()->putInCatalog(myCatalog);
+    MyDB_TablePtr newTable = make_shared<MyDB_Table>();
+    QUNIT_IS_TRUE(newTable->fromCatalog("fixedHeap", myCatalog));
+    QUNIT_IS_TRUE(newTable->getSchema()->isFixedWidth());
+    MyDB_TablePtr oldTable = make_shared<MyDB_Table>();
+    QUNIT_IS_TRUE(oldTable->fromCatalog("oldFixed", myCatalog));
+    QUNIT_IS_FALSE(oldTable->getSchema()->isFixedWidth());
+
+    unlink("oldFixed_storage");
+    MyDB_TableReaderWriter oldRW(oldTable, myMgr);
+    oldRW.loadFromTextFile("fixedTest.tbl");
+    QUNIT_IS_TRUE(oldRW.getNumPages() > heapRW.getNumPages());
+    oldTable->putInCatalog(myCatalog);
+    oldTable = make_shared<MyDB_Table>();
+    oldTable->fromCatalog("oldFixed", myCatalog);
+    QUNIT_IS_FALSE(oldTable->getSchema()->isFixedWidth());
+    MyDB_TableReaderWriter reopenedRW(oldTable, myMgr);
+    MyDB_RecordPtr oldRec = reopenedRW.getEmptyRecord();
+    MyDB_RecordIteratorAltPtr oldIter = reopenedRW.getIteratorAlt();
+    count = 0;
+    matches = true;
+    while (oldIter->advance()) {
+      oldIter->getCurrent(oldRec);
+      if (oldRec->getAtt(0)->toInt() != count || oldRec->getAtt(1)->toDouble() != (count * 37 % 1000) / 4.0 ||
+          oldRec->getAtt(3)->toInt() != count % 17)
+        matches = false;
+      count++;
+    }
+    QUNIT_IS_EQUAL(count, 5000);
+    QUNIT_IS_TRUE(matches);
+  }
+
   return qunit.errors();
 }
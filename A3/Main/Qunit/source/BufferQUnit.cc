@@ -3,11 +3,14 @@
 #define CATALOG_UNIT_H
 
 #include "MyDB_BufferManager.h"
+#include "MyDB_ExtentFile.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
 #include "QUnit.h"
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -271,6 +274,163 @@ int main () {
 	}
 	cout << "COMPLETE" << endl << flush;
 	QUNIT_IS_TRUE(flag9);
+
+	// the contents of page i in tests 10 and 11... every seventh page is random, so it does not
+	// compress, and the rest are runs of letters
+	auto fillPage = [](char *bytes, int i, int round) {
+		unsigned seed = i * 7919 + round;
+		for (int j = 0; j < 4096; j++) {
+			if (i % 7 == 0) {
+				seed = seed * 1103515245 + 12345;
+				bytes[j] = (char)(seed >> 16);
+			} else {
+				bytes[j] = (char)('a' + (j / 16 + i + round) % 26);
+			}
+		}
+	};
+	auto checkPage = [&fillPage](char *bytes, int i, int round) {
+		vector<char> expected(4096);
+		fillPage(expected.data(), i, round);
+		return memcmp(bytes, expected.data(), 4096) == 0;
+	};
+
+	// rolling temp, compressed
+	cout << "TEST 10..." << flush;
+	bool flag10 = true;
+	{
+		cout << "create manager..." << flush;
+		MyDB_BufferManager myMgr(4096, 16, "tempDSFSD", true);
+		cout << "get page..." << flush;
+		vector<MyDB_PageHandle> pages(50);
+		for (int i = 0; i < 50; i++) {
+			pages[i] = myMgr.getPage();
+		}
+		cout << "write bytes..." << flush;
+		for (int i = 0; i < 50; i++) {
+			fillPage((char *)pages[i]->getBytes(), i, 0);
+			pages[i]->wroteBytes();
+		}
+		cout << "read bytes..." << flush;
+		for (int i = 0; i < 50; i++) {
+			if (!checkPage((char *)pages[i]->getBytes(), i, 0)) flag10 = false;
+		}
+
+		// half of the pages are let go, and new ones take their place in the temp file
+		cout << "recycle pages..." << flush;
+		for (int i = 0; i < 50; i += 2) {
+			pages[i] = myMgr.getPage();
+			fillPage((char *)pages[i]->getBytes(), i, 1);
+			pages[i]->wroteBytes();
+		}
+		for (int i = 0; i < 50; i++) {
+			if (!checkPage((char *)pages[i]->getBytes(), i, i % 2 == 0 ? 1 : 0)) flag10 = false;
+		}
+
+		// the compressible pages should take up much less than a page on disk
+		struct stat fileInfo;
+		stat("tempDSFSD", &fileInfo);
+		cout << fileInfo.st_size << " bytes on disk..." << flush;
+		if (fileInfo.st_size >= 25 * 4096) flag10 = false;
+		if (flag10) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+		cout << "shutdown manager..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag10);
+
+	// compressing a table that already has pages, and opening it again
+	cout << "TEST 11..." << flush;
+	bool flag11 = true;
+	{
+		unlink("file3");
+		MyDB_TablePtr table3 = make_shared <MyDB_Table>("table3", "file3");
+		cout << "write pages..." << flush;
+		{
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+			for (int i = 0; i < 40; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table3, i);
+				fillPage((char *)page->getBytes(), i, 0);
+				page->wroteBytes();
+			}
+		}
+		cout << "compress table..." << flush;
+		{
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+
+			// one page is buffered and changed before the table is compressed
+			MyDB_PageHandle page = myMgr.getPinnedPage(table3, 3);
+			fillPage((char *)page->getBytes(), 3, 1);
+			page->wroteBytes();
+			myMgr.compressTable(table3);
+			for (int i = 0; i < 40; i++) {
+				if (!checkPage((char *)myMgr.getPage(table3, i)->getBytes(), i, i == 3 ? 1 : 0)) flag11 = false;
+			}
+
+			// and some more are changed afterwards
+			for (int i = 10; i < 20; i++) {
+				MyDB_PageHandle page = myMgr.getPage(table3, i);
+				fillPage((char *)page->getBytes(), i, 2);
+				page->wroteBytes();
+			}
+		}
+		struct stat fileInfo;
+		stat("file3", &fileInfo);
+		cout << fileInfo.st_size << " bytes on disk..." << flush;
+		if (fileInfo.st_size >= 20 * 4096) flag11 = false;
+		cout << "read pages..." << flush;
+		{
+			MyDB_BufferManager myMgr(4096, 16, "tempDSFSD");
+			for (int i = 0; i < 40; i++) {
+				int round = (i == 3) ? 1 : (i >= 10 && i < 20) ? 2 : 0;
+				if (!checkPage((char *)myMgr.getPage(table3, i)->getBytes(), i, round)) flag11 = false;
+			}
+		}
+		if (flag11) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag11);
+
+	// a compressed file that is not closed properly can still be read, as of the last time its
+	// map was written
+	cout << "TEST 12..." << flush;
+	bool flag12 = true;
+	{
+		vector<char> bytes(4096);
+		int fd = open("file4", O_TRUNC | O_CREAT | O_RDWR, 0666);
+		{
+			// an empty file is marked as compressed right away
+			MyDB_ExtentFile extents(fd, 4096);
+			if (!MyDB_ExtentFile::holdsExtents(fd)) flag12 = false;
+			for (int i = 0; i < 20; i++) {
+				fillPage(bytes.data(), i, 0);
+				extents.writePage(i, bytes.data());
+			}
+			extents.saveMap();
+		}
+		cout << "write without saving..." << flush;
+		{
+			// new pages go after the map, rather than over it
+			MyDB_ExtentFile extents(fd, 4096);
+			for (int i = 20; i < 40; i++) {
+				fillPage(bytes.data(), i, 0);
+				extents.writePage(i, bytes.data());
+			}
+		}
+		cout << "read pages..." << flush;
+		{
+			MyDB_ExtentFile extents(fd, 4096);
+			for (int i = 0; i < 20; i++) {
+				extents.readPage(i, bytes.data());
+				if (!checkPage(bytes.data(), i, 0)) flag12 = false;
+			}
+		}
+		close(fd);
+		if (flag12) cout << "correct..." << flush;
+		else cout << "INCORRECT..." << flush;
+	}
+	cout << "COMPLETE" << endl << flush;
+	QUNIT_IS_TRUE(flag12);
 }
 
 #endif
@@ -0,0 +1,204 @@
+
+#ifndef CATALOG_TEST_PERF_H
+#define CATALOG_TEST_PERF_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_Catalog.h"
+#include "MyDB_Schema.h"
+#include "MyDB_Table.h"
+#include "QUnit.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+#define FALLTHROUGH_INTENDED do {} while (0)
+
+using namespace std;
+
+// the supplier schema
+MyDB_SchemaPtr supplierSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+	mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+	return mySchema;
+}
+
+// writes the same tables into a catalog file in the old text format, one "|key|value|" line
+// for each of the keys that MyDB_Table :: putInCatalog writes
+void writeTextCatalog (string fName, int numTables) {
+	MyDB_SchemaPtr mySchema = supplierSchema ();
+	ofstream out (fName, ofstream::trunc);
+	out << "|tables|";
+	for (int i = 0; i < numTables; i++)
+		out << "table" << i << "#";
+	out << "|\n";
+	for (int i = 0; i < numTables; i++) {
+		string name = "table" + to_string (i);
+		out << "|" << name << ".fileName|" << name << ".bin|\n";
+		out << "|" << name << ".fileType|heap|\n";
+		out << "|" << name << ".rootLocation|-1|\n";
+		out << "|" << name << ".valCounts||\n";
+		out << "|" << name << ".sketches||\n";
+		out << "|" << name << ".attStats||\n";
+		out << "|" << name << ".zoneMaps||\n";
+		out << "|" << name << ".numTuples|" << i << "|\n";
+		out << "|" << name << ".sortAtt|none|\n";
+		out << "|" << name << ".lastPage|-1|\n";
+		out << "|" << name << ".attList|";
+		for (auto &att : mySchema->getAtts ())
+			out << att.first << "#";
+		out << "|\n";
+		for (auto &att : mySchema->getAtts ())
+			out << "|" << name << "." << att.first << ".type|" << att.second->toString () << "|\n";
+	}
+}
+
+// true if the table is the i^th one written above
+bool rightTable (MyDB_TablePtr table, int i) {
+	return table->getName () == "table" + to_string (i) && table->getStorageLoc () == "table" + to_string (i) + ".bin" &&
+		(int) table->getTupleCount () == i && table->getSchema ()->getAtts ().size () == 7 &&
+		table->getSchema ()->getAtts ()[5].second->toString () == "double";
+}
+
+size_t fileSize (string fName) {
+	ifstream in (fName, ifstream::binary | ifstream::ate);
+	return (size_t) in.tellg ();
+}
+
+int main (int argc, char *argv[]) {
+	int start = 1;
+	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
+		start = argv[1][0] - '0';
+	}
+	cout << "start from test " << start << endl << flush;
+
+	QUnit::UnitTest qunit (cerr, QUnit::normal);
+
+	// the catalog with lots of tables, in the old text format and in the new format (which is
+	// what the text one turns into when it is saved)
+	int numTables = 10000;
+	writeTextCatalog ("perfTextCatFile", numTables);
+	unlink ("perfBinCatFile");
+	auto start_time = chrono::high_resolution_clock::now ();
+	{
+		writeTextCatalog ("perfBinCatFile", numTables);
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("perfBinCatFile");
+		int value;
+		myCatalog->getInt ("table0.numTuples", value);
+	}
+	auto end_time = chrono::high_resolution_clock::now ();
+	cout << "wrote a catalog with " << numTables << " tables: " << fileSize ("perfTextCatFile") << " bytes as text, "
+		<< fileSize ("perfBinCatFile") << " bytes in the new format (converted in "
+		<< chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count () << " ms)" << endl;
+
+	switch (start) {
+	case 1:
+	{
+		// Test 1: opening the catalog and getting all of the tables out of it
+		cout << "TEST 1: Catalog Startup Performance (all tables)..." << endl << flush;
+
+		bool allMatch = true;
+		for (string fName : {"perfTextCatFile", "perfBinCatFile"}) {
+
+			// saving the text catalog converts it, so it is written again each time
+			if (fName == "perfTextCatFile")
+				writeTextCatalog (fName, numTables);
+			start_time = chrono::high_resolution_clock::now ();
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> (fName);
+			map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+			end_time = chrono::high_resolution_clock::now ();
+			cout << "    " << fName << ":  " << chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ()
+				<< " ms" << endl;
+
+			if (allTables.size () != (size_t) numTables)
+				allMatch = false;
+			for (int i = 0; i < numTables; i += 997)
+				if (!rightTable (allTables["table" + to_string (i)], i))
+					allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 2:
+	{
+		// Test 2: opening the catalog and getting just one table out of it... in the new
+		// format, the other tables are never decoded
+		cout << "TEST 2: Catalog Startup Performance (one table)..." << endl << flush;
+
+		bool allMatch = true;
+		for (string fName : {"perfTextCatFile", "perfBinCatFile"}) {
+
+			// saving the text catalog converts it, so it is written again each time
+			if (fName == "perfTextCatFile")
+				writeTextCatalog (fName, numTables);
+			start_time = chrono::high_resolution_clock::now ();
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> (fName);
+			MyDB_TablePtr table = make_shared <MyDB_Table> ();
+			if (!table->fromCatalog ("table4321", myCatalog) || !rightTable (table, 4321))
+				allMatch = false;
+			end_time = chrono::high_resolution_clock::now ();
+			cout << "    " << fName << ":  " << chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ()
+				<< " us" << endl;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 3:
+	{
+		// Test 3: changing one table and saving the catalog... this appends a record for the
+		// one table, rather than writing out all of them
+		cout << "TEST 3: Catalog Update Performance..." << endl << flush;
+
+		int numUpdates = 100;
+		size_t sizeBefore = fileSize ("perfBinCatFile");
+		start_time = chrono::high_resolution_clock::now ();
+		for (int i = 0; i < numUpdates; i++) {
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("perfBinCatFile");
+			MyDB_TablePtr table = make_shared <MyDB_Table> ();
+			table->fromCatalog ("table" + to_string (i * 37), myCatalog);
+			table->setTupleCount (i * 37 + 1);
+			table->putInCatalog (myCatalog);
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		size_t sizeAfter = fileSize ("perfBinCatFile");
+		cout << "    open, update one table, and save:  "
+			<< chrono::duration_cast <chrono::microseconds> (end_time - start_time).count () / (double) numUpdates
+			<< " us, " << (sizeAfter - sizeBefore) / (double) numUpdates << " bytes written per save (the file has "
+			<< sizeBefore << " bytes)" << endl;
+
+		bool allMatch = true;
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("perfBinCatFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		if (allTables.size () != (size_t) numTables)
+			allMatch = false;
+		for (int i = 0; i < numUpdates; i++)
+			if ((int) allTables["table" + to_string (i * 37)]->getTupleCount () != i * 37 + 1)
+				allMatch = false;
+		if (!rightTable (allTables["table1"], 1))
+			allMatch = false;
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	default:
+		break;
+	}
+
+	return qunit.errors ();
+}
+
+#endif
@@ -0,0 +1,353 @@
+
+#ifndef INDEX_TEST_PERF_H
+#define INDEX_TEST_PERF_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_HashReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_Schema.h"
+#include "QUnit.h"
+#include "Sorting.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unistd.h>
+
+#define FALLTHROUGH_INTENDED do {} while (0)
+
+using namespace std;
+
+// the indexvalue schema
+MyDB_SchemaPtr indexValueSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("index", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("value", make_shared <MyDB_DoubleAttType> ()));
+	return mySchema;
+}
+
+// counts the records that an iterator returns
+size_t countAll (MyDB_RecordIteratorAltPtr myIter, MyDB_RecordPtr rec) {
+	size_t count = 0;
+	while (myIter->advance ()) {
+		myIter->getCurrent (rec);
+		count++;
+	}
+	return count;
+}
+
+// counts the records in [low, high] with a full scan of the table
+size_t scanCount (MyDB_TableReaderWriter &table, MyDB_RecordPtr rec, int low, int high) {
+	size_t count = 0;
+	MyDB_RecordIteratorAltPtr myIter = table.getIteratorAlt ();
+	while (myIter->advance ()) {
+		myIter->getCurrent (rec);
+		int key = rec->getAtt (0)->toInt ();
+		if (key >= low && key <= high)
+			count++;
+	}
+	return count;
+}
+
+int main (int argc, char *argv[]) {
+	int start = 1;
+	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
+		start = argv[1][0] - '0';
+	}
+	cout << "start from test " << start << endl << flush;
+
+	QUnit::UnitTest qunit (cerr, QUnit::normal);
+
+	unlink ("perfIndexHeap.bin");
+	unlink ("perfIndexTree.bin");
+	unlink ("perfIndexSorted.bin");
+	unlink ("perfIndexBulk.bin");
+	unlink ("perfIndexHash.bin");
+	unlink ("perfIndexZoned.bin");
+
+	// the indexvalue tables only have a handful of rows, so after loading them, we add a lot
+	// more rows just like them (the key is a random int, and the value is a function of it)
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (8192, 256, "perfTempFile");
+	MyDB_TablePtr heapTable = make_shared <MyDB_Table> ("perfIndexHeap", "perfIndexHeap.bin", indexValueSchema ());
+	MyDB_TablePtr treeTable = make_shared <MyDB_Table> ("perfIndexTree", "perfIndexTree.bin", indexValueSchema (),
+		"bplustree", "index");
+	MyDB_TableReaderWriter heap (heapTable, myMgr);
+	MyDB_BPlusTreeReaderWriter tree (treeTable, myMgr);
+	heap.loadFromTextFile ("indexvalueBigSorted.tbl");
+	tree.loadFromTextFile ("indexvalueBigSorted.tbl");
+
+	int numRecs = 100000;
+	int keyRange = 1000000;
+	default_random_engine generator (530);
+	uniform_int_distribution <int> keyDist (0, keyRange - 1);
+	MyDB_RecordPtr rec = heap.getEmptyRecord ();
+
+	auto start_time = chrono::high_resolution_clock::now ();
+	for (int i = 0; i < numRecs; i++) {
+		int key = keyDist (generator);
+		rec->getAtt (0)->fromInt (key);
+		string value = to_string (key * 1.01);
+		rec->getAtt (1)->fromString (value);
+		rec->recordContentHasChanged ();
+		heap.append (rec);
+		tree.append (rec);
+	}
+	auto end_time = chrono::high_resolution_clock::now ();
+	auto insertDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+	cout << "loaded " << numRecs << " more records into the heap and the tree in "
+		<< insertDuration << " ms; the tree has height "
+		<< tree.getHeight () << " and " << tree.getNumPages () << " pages" << endl;
+
+	MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+	MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+
+	switch (start) {
+	case 1:
+	{
+		// Test 1: point lookups... a full scan of the heap for each key, versus a lookup in
+		// the B+-Tree
+		cout << "TEST 1: Point Lookup Performance..." << endl << flush;
+
+		int numScans = 20;
+		int numLookups = 2000;
+		vector <int> keys;
+		for (int i = 0; i < numLookups; i++)
+			keys.push_back (keyDist (generator));
+
+		vector <size_t> scanCounts;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int i = 0; i < numScans; i++)
+			scanCounts.push_back (scanCount (heap, rec, keys[i], keys[i]));
+		end_time = chrono::high_resolution_clock::now ();
+		auto scanDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		vector <size_t> treeCounts;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int i = 0; i < numLookups; i++) {
+			low->set (keys[i]);
+			high->set (keys[i]);
+			treeCounts.push_back (countAll (tree.getRangeIteratorAlt (low, high), rec));
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto treeDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		cout << "    full scan:       " << scanDuration / (double) numScans << " us/lookup" << endl;
+		cout << "    B+-Tree lookup:  " << treeDuration / (double) numLookups << " us/lookup" << endl;
+
+		bool allMatch = true;
+		for (int i = 0; i < numScans; i++)
+			if (scanCounts[i] != treeCounts[i])
+				allMatch = false;
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 2:
+	{
+		// Test 2: range lookups of different sizes, with a full scan, and with the unsorted
+		// and sorted B+-Tree iterators
+		cout << "TEST 2: Range Lookup Performance..." << endl << flush;
+
+		bool allMatch = true;
+		for (double selectivity : {0.0001, 0.01, 0.1}) {
+			int width = (int) (keyRange * selectivity);
+			int lowKey = keyDist (generator) % (keyRange - width);
+			low->set (lowKey);
+			high->set (lowKey + width);
+
+			start_time = chrono::high_resolution_clock::now ();
+			size_t scanResult = scanCount (heap, rec, lowKey, lowKey + width);
+			end_time = chrono::high_resolution_clock::now ();
+			auto scanDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			start_time = chrono::high_resolution_clock::now ();
+			size_t treeResult = countAll (tree.getRangeIteratorAlt (low, high), rec);
+			end_time = chrono::high_resolution_clock::now ();
+			auto treeDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			// the sorted iterator also has to check the order
+			start_time = chrono::high_resolution_clock::now ();
+			size_t sortedResult = 0;
+			int lastKey = lowKey;
+			MyDB_RecordIteratorAltPtr myIter = tree.getSortedRangeIteratorAlt (low, high);
+			while (myIter->advance ()) {
+				myIter->getCurrent (rec);
+				if (rec->getAtt (0)->toInt () < lastKey)
+					allMatch = false;
+				lastKey = rec->getAtt (0)->toInt ();
+				sortedResult++;
+			}
+			end_time = chrono::high_resolution_clock::now ();
+			auto sortedDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			cout << "range of " << selectivity * 100 << "% of the keys (" << scanResult << " records)" << endl;
+			cout << "    full scan:              " << scanDuration << " us" << endl;
+			cout << "    B+-Tree range:          " << treeDuration << " us" << endl;
+			cout << "    B+-Tree sorted range:   " << sortedDuration << " us" << endl;
+			if (scanResult != treeResult || scanResult != sortedResult)
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 3:
+	{
+		// Test 3: building the tree... inserting the records one at a time (which was done
+		// above), versus sorting them and then bulk loading the tree bottom-up
+		cout << "TEST 3: B+-Tree Build Performance..." << endl << flush;
+
+		start_time = chrono::high_resolution_clock::now ();
+		MyDB_TablePtr sortedTable = make_shared <MyDB_Table> ("perfIndexSorted", "perfIndexSorted.bin", indexValueSchema ());
+		MyDB_TableReaderWriter sorted (sortedTable, myMgr);
+		MyDB_RecordPtr lhs = heap.getEmptyRecord ();
+		MyDB_RecordPtr rhs = heap.getEmptyRecord ();
+		sort (64, heap, sorted, buildRecordComparator (lhs, rhs, "[index]"), lhs, rhs);
+		end_time = chrono::high_resolution_clock::now ();
+		auto sortDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		cout << "    one insert at a time:  " << insertDuration << " ms, " << tree.getNumPages () << " pages" << endl;
+		cout << "    sort:                  " << sortDuration << " ms" << endl;
+
+		bool allMatch = true;
+		low->set (0);
+		high->set (keyRange);
+		for (double fillFactor : {1.0, 0.7}) {
+			unlink ("perfIndexBulk.bin");
+			MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("perfIndexBulk", "perfIndexBulk.bin", indexValueSchema (),
+				"bplustree", "index");
+			MyDB_BPlusTreeReaderWriter bulk (bulkTable, myMgr);
+			start_time = chrono::high_resolution_clock::now ();
+			bulk.bulkLoad (sorted, fillFactor);
+			end_time = chrono::high_resolution_clock::now ();
+			auto bulkDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+			cout << "    bulk load (fill " << fillFactor << "):  " << bulkDuration << " ms, " << bulk.getNumPages ()
+				<< " pages, height " << bulk.getHeight () << endl;
+
+			if (countAll (bulk.getRangeIteratorAlt (low, high), rec) != countAll (tree.getRangeIteratorAlt (low, high), rec))
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 4:
+	{
+		// Test 4: equality probes into a linear hash file, versus point lookups in the B+-Tree
+		cout << "TEST 4: Hash Probe Performance..." << endl << flush;
+
+		MyDB_TablePtr hashTable = make_shared <MyDB_Table> ("perfIndexHash", "perfIndexHash.bin", indexValueSchema (),
+			"hash", "index");
+		MyDB_HashReaderWriter hashFile (hashTable, myMgr);
+		start_time = chrono::high_resolution_clock::now ();
+		MyDB_RecordIteratorAltPtr myIter = heap.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec);
+			hashFile.append (rec);
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		cout << "    build:           " << chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ()
+			<< " ms, " << hashFile.getNumBuckets () << " buckets, " << hashFile.getNumPages () << " pages" << endl;
+
+		int numLookups = 2000;
+		vector <int> keys;
+		for (int i = 0; i < numLookups; i++)
+			keys.push_back (keyDist (generator));
+
+		vector <size_t> hashCounts;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int i = 0; i < numLookups; i++) {
+			low->set (keys[i]);
+			hashCounts.push_back (countAll (hashFile.getEqualityIteratorAlt (low), rec));
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto hashDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		vector <size_t> treeCounts;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int i = 0; i < numLookups; i++) {
+			low->set (keys[i]);
+			high->set (keys[i]);
+			treeCounts.push_back (countAll (tree.getRangeIteratorAlt (low, high), rec));
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto treeDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		cout << "    B+-Tree lookup:  " << treeDuration / (double) numLookups << " us/lookup" << endl;
+		cout << "    hash probe:      " << hashDuration / (double) numLookups << " us/lookup" << endl;
+
+		bool allMatch = (hashCounts == treeCounts);
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 5:
+	{
+		// Test 5: range scans with zone maps... on the heap (where the keys are all over the
+		// place, since most of them were appended in random order), and on a copy of the heap
+		// sorted on the key, where a range only covers a few pages
+		cout << "TEST 5: Zone Map Range Scan Performance..." << endl << flush;
+
+		unlink ("perfIndexZoned.bin");
+		MyDB_TablePtr zonedTable = make_shared <MyDB_Table> ("perfIndexZoned", "perfIndexZoned.bin", indexValueSchema ());
+		MyDB_TableReaderWriter zoned (zonedTable, myMgr);
+		zoned.addZoneMap ("index");
+		MyDB_RecordPtr lhs = heap.getEmptyRecord ();
+		MyDB_RecordPtr rhs = heap.getEmptyRecord ();
+		sort (64, heap, zoned, buildRecordComparator (lhs, rhs, "[index]"), lhs, rhs);
+		heap.addZoneMap ("index");
+
+		bool allMatch = true;
+		for (double selectivity : {0.0001, 0.01, 0.1}) {
+			int width = (int) (keyRange * selectivity);
+			int lowKey = keyDist (generator) % (keyRange - width);
+			low->set (lowKey);
+			high->set (lowKey + width);
+
+			start_time = chrono::high_resolution_clock::now ();
+			size_t scanResult = scanCount (heap, rec, lowKey, lowKey + width);
+			end_time = chrono::high_resolution_clock::now ();
+			auto scanDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			start_time = chrono::high_resolution_clock::now ();
+			size_t heapResult = countAll (heap.getRangeScanIteratorAlt ("index", low, high), rec);
+			end_time = chrono::high_resolution_clock::now ();
+			auto heapDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			start_time = chrono::high_resolution_clock::now ();
+			size_t zonedResult = countAll (zoned.getRangeScanIteratorAlt ("index", low, high), rec);
+			end_time = chrono::high_resolution_clock::now ();
+			auto zonedDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			cout << "range of " << selectivity * 100 << "% of the keys (" << scanResult << " records)" << endl;
+			cout << "    full scan:                " << scanDuration << " us, " << heap.getNumPages () << " pages" << endl;
+			cout << "    zone map scan (heap):     " << heapDuration << " us, "
+				<< heap.getPagesInRange ("index", low, high).size () << " pages" << endl;
+			cout << "    zone map scan (sorted):   " << zonedDuration << " us, "
+				<< zoned.getPagesInRange ("index", low, high).size () << " pages" << endl;
+			if (scanResult != heapResult || scanResult != zonedResult)
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	default:
+		break;
+	}
+
+	return qunit.errors ();
+}
+
+#endif
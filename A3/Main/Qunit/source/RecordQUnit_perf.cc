@@ -0,0 +1,652 @@
+
+#ifndef RECORD_TEST_PERF_H
+#define RECORD_TEST_PERF_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_BatchFilter.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_HyperLogLog.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordBatch.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_TypedExpr.h"
+#include "MyDB_Schema.h"
+#include "QUnit.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FALLTHROUGH_INTENDED do {} while (0)
+
+using namespace std;
+
+// the supplier schema
+MyDB_SchemaPtr supplierSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+	mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+	return mySchema;
+}
+
+int main (int argc, char *argv[]) {
+	int start = 1;
+	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
+		start = argv[1][0] - '0';
+	}
+	cout << "start from test " << start << endl << flush;
+
+	QUnit::UnitTest qunit (cerr, QUnit::normal);
+
+	unlink ("perfSupplier.bin");
+
+	MyDB_TablePtr myTable = make_shared <MyDB_Table> ("perfSupplier", "perfSupplier.bin", supplierSchema ());
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (65536, 64, "perfTempFile");
+	MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+	supplierTable.loadFromTextFile ("supplier.tbl");
+
+	// a batch that does not decode anything; we just use it for the record locations
+	MyDB_RecordBatchPtr batch = make_shared <MyDB_RecordBatch> (myTable->getSchema (), vector <int> ());
+	int numRounds = 20;
+
+	switch (start) {
+	case 1:
+	{
+		// Test 1: predicates... each one is run over the supplier table with compileComputation,
+		// which needs the record to be deserialized and goes through MyDB_AttVal objects, and
+		// with MyDB_TypedExpr, which runs right off of the record bytes
+		cout << "TEST 1: Predicate Evaluation Performance..." << endl << flush;
+
+		vector <string> preds = {
+			"< ([nationkey], int[10])",
+			"> ([acctbal], double[5000.0])",
+			"&& (> ([acctbal], double[5000.0]), == ([nationkey], int[3]))",
+			"== ([phone], string[25-843-787-7479])",
+			"< (+ ([acctbal], * ([suppkey], double[0.5])), double[3000.0])",
+			"|| (! (> ([name], string[Supplier#000005000])), < (- ([suppkey], [nationkey]), int[100]))"
+		};
+
+		bool allMatch = true;
+		for (string &pred : preds) {
+
+			MyDB_RecordPtr rec = supplierTable.getEmptyRecord ();
+			func oldPred = rec->compileComputation (pred);
+			MyDB_TypedExpr newPred (myTable->getSchema (), pred);
+
+			size_t oldCount = 0;
+			auto start_time = chrono::high_resolution_clock::now ();
+			for (int round = 0; round < numRounds; round++) {
+				MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+				while (myIter->advance ()) {
+					myIter->getCurrent (rec);
+					if (oldPred ()->toBool ())
+						oldCount++;
+				}
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			auto oldDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			size_t newCount = 0;
+			start_time = chrono::high_resolution_clock::now ();
+			for (int round = 0; round < numRounds; round++) {
+				MyDB_BatchIteratorPtr myIter = supplierTable.getBatchIterator ();
+				while (myIter->getNextBatch (*batch)) {
+					for (int i = 0; i < batch->size (); i++) {
+						if (newPred.evalBool (batch->getRecordPointer (i)))
+							newCount++;
+					}
+				}
+			}
+			end_time = chrono::high_resolution_clock::now ();
+			auto newDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+			cout << pred << endl;
+			cout << "    compileComputation: " << oldDuration * 1000.0 / (10000 * numRounds) << " ns/rec, "
+				<< oldCount / numRounds << " matches" << endl;
+			cout << "    MyDB_TypedExpr:     " << newDuration * 1000.0 / (10000 * numRounds) << " ns/rec, "
+				<< newCount / numRounds << " matches" << endl;
+			if (oldCount != newCount)
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 2:
+	{
+		// Test 2: arithmetic... the typed expression has to compute the same values
+		cout << "TEST 2: Typed Arithmetic..." << endl << flush;
+
+		string expr = "+ (* ([acctbal], double[2.0]), / ([suppkey], um ([nationkey])))";
+		MyDB_RecordPtr rec = supplierTable.getEmptyRecord ();
+		func oldExpr = rec->compileComputation (expr);
+		MyDB_TypedExpr newExpr (myTable->getSchema (), expr);
+		MyDB_TypedExpr concat (myTable->getSchema (), "+ ([name], [phone])");
+
+		bool allMatch = newExpr.getType () == DoubleExpr && concat.getType () == StringExpr;
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (rec);
+
+			// a nationkey of zero would divide by zero
+			if (rec->getAtt (3)->toInt () == 0)
+				continue;
+			if (oldExpr ()->toDouble () != newExpr.evalDouble (myIter->getCurrentPointer ()))
+				allMatch = false;
+			if (rec->getAtt (1)->toString () + rec->getAtt (4)->toString () != concat.evalString (myIter->getCurrentPointer ()))
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 3:
+	{
+		// Test 3: batch filters... the same predicates, run a record at a time with MyDB_TypedExpr,
+		// and then a batch at a time with the scalar and the SIMD kernels
+		cout << "TEST 3: Batch Filter Performance..." << endl << flush;
+
+		vector <string> preds = {
+			"< ([nationkey], int[10])",
+			"&& (> ([acctbal], double[5000.0]), == ([nationkey], int[3]))",
+			"|| (< ([suppkey], [nationkey]), ! (> ([acctbal], int[0])))"
+		};
+
+		bool allMatch = true;
+		for (string &pred : preds) {
+
+			MyDB_TypedExpr rowPred (myTable->getSchema (), pred);
+			size_t rowCount = 0;
+			auto start_time = chrono::high_resolution_clock::now ();
+			for (int round = 0; round < numRounds; round++) {
+				MyDB_BatchIteratorPtr myIter = supplierTable.getBatchIterator ();
+				while (myIter->getNextBatch (*batch)) {
+					for (int i = 0; i < batch->size (); i++) {
+						if (rowPred.evalBool (batch->getRecordPointer (i)))
+							rowCount++;
+					}
+				}
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			auto rowDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+			cout << pred << endl;
+			cout << "    MyDB_TypedExpr:     " << rowDuration * 1000.0 / (10000 * numRounds) << " ns/rec" << endl;
+
+			// time only the filtering, since the batches have to be decoded either way
+			MyDB_BatchFilter filter (myTable->getSchema (), pred);
+			MyDB_RecordBatchPtr columns = make_shared <MyDB_RecordBatch> (myTable->getSchema (), filter.getNeededAtts ());
+			uint64_t bits[BITMAP_WORDS (MAX_BATCH_SIZE)];
+			for (auto level : {ScalarKernels, AVX2Kernels, AVX512Kernels}) {
+				if (useKernels (level) != level)
+					continue;
+				size_t batchCount = 0;
+				long filterDuration = 0;
+				for (int round = 0; round < numRounds; round++) {
+					MyDB_BatchIteratorPtr myIter = supplierTable.getBatchIterator ();
+					while (myIter->getNextBatch (*columns)) {
+						start_time = chrono::high_resolution_clock::now ();
+						batchCount += filter.apply (*columns, bits);
+						end_time = chrono::high_resolution_clock::now ();
+						filterDuration += chrono::duration_cast <chrono::nanoseconds> (end_time - start_time).count ();
+					}
+				}
+				string name = (level == ScalarKernels) ? "scalar" : (level == AVX2Kernels) ? "AVX2" : "AVX-512";
+				cout << "    MyDB_BatchFilter (" << name << "): " << filterDuration / (10000.0 * numRounds) << " ns/rec" << endl;
+				if (batchCount != rowCount)
+					allMatch = false;
+			}
+			useKernels (AVX512Kernels);
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 4:
+	{
+		// Test 4: bulk loading... a text file made of a bunch of copies of supplier.tbl is
+		// loaded with one, two, four, and eight threads.  The rate is for parsing the text and
+		// writing the pages, so the loads do not build the statistics; that is timed once, at
+		// the end
+		cout << "TEST 4: Load Performance..." << endl << flush;
+
+		int numCopies = 10;
+		{
+			ifstream in ("supplier.tbl");
+			string contents ((istreambuf_iterator <char> (in)), istreambuf_iterator <char> ());
+			ofstream out ("perfLoad.tbl");
+			for (int i = 0; i < numCopies; i++)
+				out << contents;
+		}
+		struct stat fileInfo;
+		stat ("perfLoad.tbl", &fileInfo);
+		double megabytes = fileInfo.st_size / (1024.0 * 1024.0);
+
+		unlink ("perfLoad.bin");
+		MyDB_TablePtr loadTable = make_shared <MyDB_Table> ("perfLoad", "perfLoad.bin", supplierSchema ());
+		MyDB_TableReaderWriter loadRW (loadTable, myMgr);
+		bool allMatch = true;
+		for (int threads : {1, 2, 4, 8}) {
+			auto start_time = chrono::high_resolution_clock::now ();
+			size_t count = loadRW.loadFromTextFile ("perfLoad.tbl", threads, false).second;
+			auto end_time = chrono::high_resolution_clock::now ();
+			auto duration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+			cout << "    " << threads << " thread(s): " << megabytes / (duration / 1000000.0) << " MB/s" << endl;
+			if (count != 10000 * (size_t) numCopies)
+				allMatch = false;
+		}
+		unlink ("perfLoad.tbl");
+		auto start_time = chrono::high_resolution_clock::now ();
+		loadRW.analyze ();
+		auto end_time = chrono::high_resolution_clock::now ();
+		cout << "    statistics: " << chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ()
+			<< " ms" << endl;
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 5:
+	{
+		// Test 5: parsing text... each file is parsed the old way (finding the delimiters with
+		// string::find, making a substr for each attribute, and then calling stoi or stod), and
+		// then in place with MyDB_Record::fromText
+		cout << "TEST 5: Parse Performance..." << endl << flush;
+
+		MyDB_SchemaPtr indexSchema = make_shared <MyDB_Schema> ();
+		indexSchema->appendAtt (make_pair ("key", make_shared <MyDB_IntAttType> ()));
+		indexSchema->appendAtt (make_pair ("value", make_shared <MyDB_DoubleAttType> ()));
+
+		bool allMatch = true;
+		vector <pair <string, MyDB_SchemaPtr>> files = {make_pair ("supplier.tbl", supplierSchema ()),
+			make_pair ("indexvalue.tbl", indexSchema), make_pair ("indexvalueBigSorted.tbl", indexSchema)};
+		for (auto &file : files) {
+			ifstream in (file.first);
+			string contents ((istreambuf_iterator <char> (in)), istreambuf_iterator <char> ());
+			int rounds = max (numRounds, (int) (20000000 / (contents.size () + 1)));
+			double megabytes = rounds * contents.size () / (1024.0 * 1024.0);
+			vector <MyDB_AttTypePtr> types;
+			for (auto &att : file.second->getAtts ())
+				types.push_back (att.second);
+
+			// the old way
+			long oldSum = 0;
+			auto start_time = chrono::high_resolution_clock::now ();
+			for (int round = 0; round < rounds; round++) {
+				istringstream lines (contents);
+				string line, value;
+				while (getline (lines, line)) {
+					int i = 0;
+					for (int pos = 0; pos < (int) line.size (); pos = (int) line.find ("|", pos + 1) + 1) {
+						string temp = line.substr (pos, line.find ("|", pos + 1) - pos);
+						if (types[i]->promotableToInt ()) {
+							int val = stoi (temp);
+							if (i == 0)
+								oldSum += val;
+						} else if (types[i]->promotableToDouble ()) {
+							volatile double val = stod (temp);
+							(void) val;
+						} else {
+							value = temp;
+						}
+						i++;
+					}
+				}
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			auto oldDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+			cout << "    " << file.first << endl;
+			cout << "        find/substr/stoi: " << megabytes / (oldDuration / 1000000.0) << " MB/s" << endl;
+
+			// and the new way
+			MyDB_Record rec (file.second);
+			long newSum = 0;
+			start_time = chrono::high_resolution_clock::now ();
+			for (int round = 0; round < rounds; round++) {
+				const char *pos = contents.data (), *end = contents.data () + contents.size ();
+				while (pos < end) {
+					pos = rec.fromText (pos, end);
+					newSum += rec.getAtt (0)->toInt ();
+				}
+			}
+			end_time = chrono::high_resolution_clock::now ();
+			auto newDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+			cout << "        fromText: " << megabytes / (newDuration / 1000000.0) << " MB/s" << endl;
+			if (newSum != oldSum)
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 6:
+	{
+		// Test 6: distinct value counting... the old way (a sample of at most 1000 hashes in a
+		// set<size_t>, where the sample is thinned out by copying the set whenever it gets too big)
+		// against a MyDB_HyperLogLog, on 2,000,000 values with 500,000 distinct ones
+		cout << "TEST 6: Distinct Count Performance..." << endl << flush;
+
+		size_t numValues = 2000000, numDistinct = 500000;
+		pair <set <size_t>, int> sample (set <size_t> (), 1);
+		auto start_time = chrono::high_resolution_clock::now ();
+		for (size_t i = 0; i < numValues; i++) {
+			size_t hash = std::hash <int> () ((i * 7919) % numDistinct);
+			if (hash % sample.second != 0)
+				continue;
+			sample.first.insert (hash);
+			if (sample.first.size () > 1000) {
+				sample.second *= 2;
+				set <size_t> newSet;
+				for (auto &num : sample.first) {
+					if (num % sample.second == 0)
+						newSet.insert (num);
+				}
+				sample.first = newSet;
+			}
+		}
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto oldDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+		double oldEst = sample.first.size () * (double) sample.second;
+
+		MyDB_HyperLogLog sketch;
+		start_time = chrono::high_resolution_clock::now ();
+		for (size_t i = 0; i < numValues; i++)
+			sketch.add (std::hash <int> () ((i * 7919) % numDistinct));
+		end_time = chrono::high_resolution_clock::now ();
+		auto newDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+		double newEst = sketch.estimate ();
+
+		cout << "    sampled set:  " << oldDuration * 1000.0 / numValues << " ns/value, estimate " << oldEst << endl;
+		cout << "    HyperLogLog:  " << newDuration * 1000.0 / numValues << " ns/value, estimate " << newEst << endl;
+		cout << "    (real count " << numDistinct << ")" << endl;
+
+		bool close = fabs (newEst - numDistinct) / numDistinct < 0.05;
+		if (close) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (close);
+	}
+	FALLTHROUGH_INTENDED;
+	case 7:
+	{
+		// Test 7: compressed pages... 200,000 records with a sorted key, a small range of ints,
+		// a few cities, and a few prices, loaded into a heap table and a compressed table, and
+		// then scanned a batch at a time (with and without the SIMD decode kernels)
+		cout << "TEST 7: Compressed Scan Performance..." << endl << flush;
+
+		vector <string> cities = {"Houston", "Austin", "Dallas", "El Paso", "Waco", "Tyler", "Plano", "Irving"};
+		{
+			ofstream out ("compressPerf.tbl");
+			for (int i = 0; i < 200000; i++)
+				out << i << "|" << 5000 + (i * 7919) % 200 << "|" << cities[(i * 31) % cities.size ()] << "|"
+					<< (i % 13) * 2.5 << "|\n";
+		}
+		MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+		mySchema->appendAtt (make_pair ("key", make_shared <MyDB_IntAttType> ()));
+		mySchema->appendAtt (make_pair ("grp", make_shared <MyDB_IntAttType> ()));
+		mySchema->appendAtt (make_pair ("city", make_shared <MyDB_StringAttType> ()));
+		mySchema->appendAtt (make_pair ("price", make_shared <MyDB_DoubleAttType> ()));
+
+		unlink ("perfHeap.bin");
+		unlink ("perfCompressed.bin");
+		MyDB_TableReaderWriter heapTable (make_shared <MyDB_Table> ("perfHeap", "perfHeap.bin", mySchema), myMgr);
+		MyDB_TableReaderWriter compTable (make_shared <MyDB_Table> ("perfCompressed", "perfCompressed.bin",
+			mySchema, "compressed", ""), myMgr);
+		heapTable.loadFromTextFile ("compressPerf.tbl");
+		compTable.loadFromTextFile ("compressPerf.tbl");
+
+		// adds up the ints and doubles, and counts the records from one city
+		auto scan = [&] (MyDB_TableReaderWriter &scanMe, double &total) {
+			MyDB_RecordBatchPtr myBatch = scanMe.getEmptyBatch ();
+			auto start_time = chrono::high_resolution_clock::now ();
+			total = 0;
+			for (int round = 0; round < numRounds; round++) {
+				MyDB_BatchIteratorPtr myIter = scanMe.getBatchIterator ();
+				while (myIter->getNextBatch (*myBatch)) {
+					int *keys = myBatch->getIntColumn (0);
+					int *grps = myBatch->getIntColumn (1);
+					double *prices = myBatch->getDoubleColumn (3);
+					for (int i = 0; i < myBatch->size (); i++) {
+						total += keys[i] + grps[i] + prices[i];
+						total += (myBatch->getString (2, i)[0] == 'W');
+					}
+				}
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			return chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+		};
+
+		double heapTotal, scalarTotal, simdTotal;
+		auto heapDuration = scan (heapTable, heapTotal);
+		useKernels (ScalarKernels);
+		auto scalarDuration = scan (compTable, scalarTotal);
+		useKernels (AVX512Kernels);
+		auto simdDuration = scan (compTable, simdTotal);
+
+		cout << "    heap:        " << heapTable.getNumPages () << " pages, scanned in " << heapDuration << " ms" << endl;
+		cout << "    compressed:  " << compTable.getNumPages () << " pages, scanned in " << scalarDuration
+			<< " ms (plain loops), " << simdDuration << " ms (SIMD)" << endl;
+
+		bool correct = heapTotal == scalarTotal && heapTotal == simdTotal &&
+			compTable.getNumPages () * 2 < heapTable.getNumPages ();
+		if (correct) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (correct);
+	}
+	FALLTHROUGH_INTENDED;
+	case 8:
+	{
+		// Test 8: fixed-width records... 200,000 records of ints, a double, and a bool, loaded
+		// into a table whose schema has no strings (so its records use the fixed layout), and
+		// into one whose schema has an extra, always-empty string (so its records use the
+		// variable layout), and then scanned a record at a time and a batch at a time
+		cout << "TEST 8: Fixed-Width Record Performance..." << endl << flush;
+
+		{
+			ofstream out ("fixedPerf.tbl");
+			for (int i = 0; i < 200000; i++)
+				out << i << "|" << (i * 7919) % 1000 << "|" << (i % 13) * 2.5 << "|" << (i % 2 ? "true" : "false") << "||\n";
+		}
+		MyDB_SchemaPtr fixedSchema = make_shared <MyDB_Schema> ();
+		fixedSchema->appendAtt (make_pair ("key", make_shared <MyDB_IntAttType> ()));
+		fixedSchema->appendAtt (make_pair ("grp", make_shared <MyDB_IntAttType> ()));
+		fixedSchema->appendAtt (make_pair ("price", make_shared <MyDB_DoubleAttType> ()));
+		fixedSchema->appendAtt (make_pair ("flag", make_shared <MyDB_BoolAttType> ()));
+		MyDB_SchemaPtr varSchema = make_shared <MyDB_Schema> (*fixedSchema);
+		varSchema->appendAtt (make_pair ("pad", make_shared <MyDB_StringAttType> ()));
+
+		unlink ("perfFixed.bin");
+		unlink ("perfVariable.bin");
+		MyDB_TableReaderWriter fixedTable (make_shared <MyDB_Table> ("perfFixed", "perfFixed.bin", fixedSchema), myMgr);
+		MyDB_TableReaderWriter varTable (make_shared <MyDB_Table> ("perfVariable", "perfVariable.bin", varSchema), myMgr);
+		fixedTable.loadFromTextFile ("fixedPerf.tbl");
+		varTable.loadFromTextFile ("fixedPerf.tbl");
+
+		// adds up the ints and the double, and counts the true bools... going a record at a time
+		// is much slower, so it does fewer rounds
+		int recRounds = numRounds / 10;
+		auto recScan = [&] (MyDB_TableReaderWriter &scanMe, double &total) {
+			MyDB_RecordPtr rec = scanMe.getEmptyRecord ();
+			auto start_time = chrono::high_resolution_clock::now ();
+			total = 0;
+			for (int round = 0; round < recRounds; round++) {
+				MyDB_RecordIteratorAltPtr myIter = scanMe.getIteratorAlt ();
+				while (myIter->advance ()) {
+					myIter->getCurrent (rec);
+					total += rec->getAtt (0)->toInt () + rec->getAtt (1)->toInt () + rec->getAtt (2)->toDouble ();
+					total += rec->getAtt (3)->toBool ();
+				}
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			return chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+		};
+		auto batchScan = [&] (MyDB_TableReaderWriter &scanMe, double &total) {
+			MyDB_RecordBatchPtr myBatch = scanMe.getEmptyBatch ({"key", "grp", "price", "flag"});
+			auto start_time = chrono::high_resolution_clock::now ();
+			total = 0;
+			for (int round = 0; round < numRounds; round++) {
+				MyDB_BatchIteratorPtr myIter = scanMe.getBatchIterator ();
+				while (myIter->getNextBatch (*myBatch)) {
+					int *keys = myBatch->getIntColumn (0);
+					int *grps = myBatch->getIntColumn (1);
+					double *prices = myBatch->getDoubleColumn (2);
+					char *flags = myBatch->getBoolColumn (3);
+					for (int i = 0; i < myBatch->size (); i++)
+						total += keys[i] + grps[i] + prices[i] + flags[i];
+				}
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			return chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+		};
+
+		double fixedRecTotal, varRecTotal, fixedBatchTotal, varBatchTotal;
+		auto fixedRecDuration = recScan (fixedTable, fixedRecTotal);
+		auto varRecDuration = recScan (varTable, varRecTotal);
+		auto fixedBatchDuration = batchScan (fixedTable, fixedBatchTotal);
+		auto varBatchDuration = batchScan (varTable, varBatchTotal);
+
+		cout << "    fixed:     " << fixedTable.getNumPages () << " pages, " << fixedRecDuration << " ms by record, "
+			<< fixedBatchDuration << " ms by batch" << endl;
+		cout << "    variable:  " << varTable.getNumPages () << " pages, " << varRecDuration << " ms by record, "
+			<< varBatchDuration << " ms by batch" << endl;
+
+		bool correct = fixedRecTotal == varRecTotal && fixedBatchTotal == varBatchTotal &&
+			fixedRecTotal * (numRounds / recRounds) == fixedBatchTotal &&
+			fixedTable.getNumPages () < varTable.getNumPages ();
+		if (correct) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (correct);
+	}
+	FALLTHROUGH_INTENDED;
+	case 9:
+	{
+		// Test 9: the attribute values themselves... making empty records, computing over a
+		// record that is built from two others (as a join does), and copying computed values
+		// into an output record and writing it out (as a projection does)
+		cout << "TEST 9: Attribute Value Performance..." << endl << flush;
+
+		auto start_time = chrono::high_resolution_clock::now ();
+		size_t numMade = 0;
+		for (int i = 0; i < 10000 * numRounds; i++) {
+			MyDB_RecordPtr rec = supplierTable.getEmptyRecord ();
+			numMade += rec->getSchema ()->getAtts ().size ();
+		}
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto makeDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		// the join: each record is paired up with the first one
+		MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+		for (auto &att : myTable->getSchema ()->getAtts ())
+			combinedSchema->appendAtt (att);
+		for (auto &att : myTable->getSchema ()->getAtts ())
+			combinedSchema->appendAtt (make_pair ("r_" + att.first, att.second));
+		MyDB_RecordPtr leftRec = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rightRec = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (combinedSchema);
+		combinedRec->buildFrom (leftRec, rightRec);
+		func joinPred = combinedRec->compileComputation (
+			"&& (== ([nationkey], [r_nationkey]), > (+ ([acctbal], [r_acctbal]), double[0.0]))");
+		{
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+			myIter->advance ();
+			myIter->getCurrent (rightRec);
+		}
+
+		// and the projection
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+		outSchema->appendAtt (make_pair ("total", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_RecordPtr outRec = make_shared <MyDB_Record> (outSchema);
+		vector <func> projections = {leftRec->compileComputation ("[suppkey]"), leftRec->compileComputation ("[name]"),
+			leftRec->compileComputation ("* ([acctbal], double[2.0])")};
+		vector <char> outBuffer (1024);
+
+		// the records are read from a copy of the table in RAM, so that the time goes to the
+		// values, rather than to the buffer manager
+		vector <char> allRecs;
+		{
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (leftRec);
+				size_t at = allRecs.size ();
+				allRecs.resize (at + leftRec->getBinarySize ());
+				leftRec->toBinary (allRecs.data () + at);
+			}
+		}
+		char *recsEnd = allRecs.data () + allRecs.size ();
+
+		size_t joinCount = 0, expectedJoinCount = 0;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			for (char *pos = allRecs.data (); pos != recsEnd;) {
+				pos = (char *) leftRec->fromBinary (pos);
+				if (joinPred ()->toBool ())
+					joinCount++;
+			}
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto joinDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		double outTotal = 0, expectedOutTotal = 0;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			for (char *pos = allRecs.data (); pos != recsEnd;) {
+				pos = (char *) leftRec->fromBinary (pos);
+				for (size_t i = 0; i < projections.size (); i++)
+					outRec->getAtt (i)->set (projections[i] ());
+				outRec->recordContentHasChanged ();
+				outRec->toBinary (outBuffer.data ());
+				outTotal += outRec->getAtt (2)->toDouble ();
+			}
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto projectDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		// and work out what the answers should have been
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (leftRec);
+			if (leftRec->getAtt (3)->toInt () == rightRec->getAtt (3)->toInt () &&
+				leftRec->getAtt (5)->toDouble () + rightRec->getAtt (5)->toDouble () > 0.0)
+				expectedJoinCount++;
+			expectedOutTotal += leftRec->getAtt (5)->toDouble () * 2.0;
+		}
+
+		cout << "    make record: " << makeDuration * 1000.0 / (10000 * numRounds) << " ns/rec" << endl;
+		cout << "    join check:  " << joinDuration * 1000.0 / (10000 * numRounds) << " ns/rec, "
+			<< joinCount / numRounds << " matches" << endl;
+		cout << "    project:     " << projectDuration * 1000.0 / (10000 * numRounds) << " ns/rec" << endl;
+
+		bool correct = numMade == (size_t) 70000 * numRounds && joinCount == expectedJoinCount * numRounds &&
+			fabs (outTotal - expectedOutTotal * numRounds) < 0.001 * fabs (outTotal);
+		if (correct) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (correct);
+	}
+	FALLTHROUGH_INTENDED;
+	default:
+		break;
+	}
+
+	return qunit.errors ();
+}
+
+#endif
@@ -0,0 +1,606 @@
+
+#ifndef REL_OPS_TEST_PERF_H
+#define REL_OPS_TEST_PERF_H
+
+#include "Aggregate.h"
+#include "HashJoin.h"
+#include "MorselScan.h"
+#include "MyDB_Arena.h"
+#include "MyDB_AttType.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_Record.h"
+#include "MyDB_Schema.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+#include "QUnit.h"
+#include "QueryOp.h"
+#include "SortMergeJoin.h"
+#include "Sorting.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <unistd.h>
+
+#define FALLTHROUGH_INTENDED do {} while (0)
+
+using namespace std;
+
+// every call to new in this program is counted, so that the number made by an operator can
+// be reported
+static atomic <size_t> numNews (0);
+
+void *operator new (size_t size) {
+	numNews++;
+	void *retVal = malloc (size == 0 ? 1 : size);
+	if (retVal == nullptr)
+		throw bad_alloc ();
+	return retVal;
+}
+
+void operator delete (void *freeMe) noexcept {
+	free (freeMe);
+}
+
+// the supplier schema, with a prefix on each attribute name so that two copies can be joined
+MyDB_SchemaPtr supplierSchema (string prefix) {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair (prefix + "suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair (prefix + "name", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair (prefix + "address", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair (prefix + "nationkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair (prefix + "phone", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair (prefix + "acctbal", make_shared <MyDB_DoubleAttType> ()));
+	mySchema->appendAtt (make_pair (prefix + "comment", make_shared <MyDB_StringAttType> ()));
+	return mySchema;
+}
+
+// the output of the joins: the two keys
+MyDB_SchemaPtr pairSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("l_suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("r_suppkey", make_shared <MyDB_IntAttType> ()));
+	return mySchema;
+}
+
+// the baseline: joins left and right by scanning right once for each left record that gets
+// through leftPred, and writing the first attribute of each side for each pair that gets
+// through joinCheck
+void nestedLoopJoin (MyDB_TableReaderWriterPtr leftTable, MyDB_TableReaderWriterPtr rightTable,
+	MyDB_TableReaderWriterPtr output, string leftPred, string joinCheck) {
+
+	MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+	for (auto &att : leftTable->getTable ()->getSchema ()->getAtts ())
+		combinedSchema->appendAtt (att);
+	for (auto &att : rightTable->getTable ()->getSchema ()->getAtts ())
+		combinedSchema->appendAtt (att);
+	MyDB_RecordPtr leftRec = leftTable->getEmptyRecord ();
+	MyDB_RecordPtr rightRec = rightTable->getEmptyRecord ();
+	MyDB_RecordPtr combinedRec = make_shared <MyDB_Record> (combinedSchema);
+	combinedRec->buildFrom (leftRec, rightRec);
+	func leftCheck = leftRec->compileComputation (leftPred);
+	func pairCheck = combinedRec->compileComputation (joinCheck);
+	MyDB_RecordPtr outRec = output->getEmptyRecord ();
+
+	MyDB_RecordIteratorAltPtr leftIter = leftTable->getIteratorAlt ();
+	while (leftIter->advance ()) {
+		leftIter->getCurrent (leftRec);
+		if (!leftCheck ()->toBool ())
+			continue;
+		MyDB_RecordIteratorAltPtr rightIter = rightTable->getIteratorAlt ();
+		while (rightIter->advance ()) {
+			rightIter->getCurrent (rightRec);
+			if (!pairCheck ()->toBool ())
+				continue;
+			outRec->getAtt (0)->set (leftRec->getAtt (0));
+			outRec->getAtt (1)->set (rightRec->getAtt (0));
+			outRec->recordContentHasChanged ();
+			output->append (outRec);
+		}
+	}
+}
+
+int main (int argc, char *argv[]) {
+	int start = 1;
+	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
+		start = argv[1][0] - '0';
+	}
+	cout << "start from test " << start << endl << flush;
+
+	QUnit::UnitTest qunit (cerr, QUnit::normal);
+
+	unlink ("perfLeft.bin");
+	unlink ("perfRight.bin");
+
+	MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (65536, 64, "perfTempFile");
+	MyDB_TableReaderWriterPtr leftTable = make_shared <MyDB_TableReaderWriter> (
+		make_shared <MyDB_Table> ("perfLeft", "perfLeft.bin", supplierSchema ("l_")), myMgr);
+	MyDB_TableReaderWriterPtr rightTable = make_shared <MyDB_TableReaderWriter> (
+		make_shared <MyDB_Table> ("perfRight", "perfRight.bin", supplierSchema ("r_")), myMgr);
+	leftTable->loadFromTextFile ("supplier.tbl");
+	rightTable->loadFromTextFile ("supplier.tbl");
+
+	switch (start) {
+	case 1:
+	{
+		// Test 1: sort-merge join of supplier with itself on nationkey, against a nested-loop
+		// join that scans the right table once for each left record that gets through the
+		// selection predicate
+		cout << "TEST 1: Sort-Merge Join Performance..." << endl << flush;
+
+		string leftPred = "> ([l_acctbal], double[9800.0])";
+		MyDB_TableReaderWriterPtr loopOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfLoopOut", "perfLoopOut.bin", pairSchema ()), myMgr);
+		MyDB_TableReaderWriterPtr mergeOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfMergeOut", "perfMergeOut.bin", pairSchema ()), myMgr);
+		loopOut->clear ();
+		mergeOut->clear ();
+
+		// the nested loops
+		auto start_time = chrono::high_resolution_clock::now ();
+		nestedLoopJoin (leftTable, rightTable, loopOut, leftPred, "== ([l_nationkey], [r_nationkey])");
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto loopDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		// the sort-merge join
+		start_time = chrono::high_resolution_clock::now ();
+		SortMergeJoin myOp (leftTable, rightTable, mergeOut, "", {"[l_suppkey]", "[r_suppkey]"},
+			make_pair (string ("[l_nationkey]"), string ("[r_nationkey]")), leftPred, "");
+		myOp.run ();
+		end_time = chrono::high_resolution_clock::now ();
+		auto mergeDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		cout << "    nested loops:    " << loopDuration << " ms" << endl;
+		cout << "    sort-merge join: " << mergeDuration << " ms" << endl;
+		cout << "    " << mergeOut->getTable ()->getTupleCount () << " records out" << endl;
+
+		bool allMatch = mergeOut->getTable ()->getTupleCount () == loopOut->getTable ()->getTupleCount () &&
+			mergeOut->getTable ()->getTupleCount () > 0;
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 2:
+	{
+		// Test 2: hash join of supplier with itself on nationkey (the same join as in test 1,
+		// but with a buffer of only eight pages), and of the small indexvalue table with
+		// supplier, against nested loops
+		cout << "TEST 2: Hash Join Performance..." << endl << flush;
+
+		MyDB_BufferManagerPtr smallMgr = make_shared <MyDB_BufferManager> (65536, 8, "perfTempFile2");
+		MyDB_TableReaderWriterPtr smallLeft = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfSmallLeft", "perfSmallLeft.bin", supplierSchema ("l_")), smallMgr);
+		MyDB_TableReaderWriterPtr smallRight = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfSmallRight", "perfSmallRight.bin", supplierSchema ("r_")), smallMgr);
+		smallLeft->loadFromTextFile ("supplier.tbl");
+		smallRight->loadFromTextFile ("supplier.tbl");
+
+		MyDB_SchemaPtr indexValueSchema = make_shared <MyDB_Schema> ();
+		indexValueSchema->appendAtt (make_pair ("i_key", make_shared <MyDB_IntAttType> ()));
+		indexValueSchema->appendAtt (make_pair ("i_value", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TableReaderWriterPtr indexValue = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfIndexValue", "perfIndexValue.bin", indexValueSchema), myMgr);
+		indexValue->loadFromTextFile ("indexvalue.tbl");
+
+		struct Query {
+			string name;
+			MyDB_TableReaderWriterPtr left, right;
+			string leftKey, rightKey, leftPred;
+		};
+		vector <Query> queries = {
+			{"supplier x supplier", smallLeft, smallRight, "[l_nationkey]", "[r_nationkey]", "> ([l_acctbal], double[9800.0])"},
+			{"indexvalue x supplier", indexValue, rightTable, "[i_key]", "[r_nationkey]", "bool[true]"}};
+
+		bool allMatch = true;
+		for (Query &q : queries) {
+			MyDB_TableReaderWriterPtr loopOut = make_shared <MyDB_TableReaderWriter> (
+				make_shared <MyDB_Table> ("perfLoopOut", "perfLoopOut.bin", pairSchema ()), myMgr);
+			MyDB_TableReaderWriterPtr hashOut = make_shared <MyDB_TableReaderWriter> (
+				make_shared <MyDB_Table> ("perfHashOut", "perfHashOut.bin", pairSchema ()), myMgr);
+			loopOut->clear ();
+			hashOut->clear ();
+
+			auto start_time = chrono::high_resolution_clock::now ();
+			nestedLoopJoin (q.left, q.right, loopOut, q.leftPred, "== (" + q.leftKey + ", " + q.rightKey + ")");
+			auto end_time = chrono::high_resolution_clock::now ();
+			auto loopDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+			start_time = chrono::high_resolution_clock::now ();
+			string leftFirst = "[" + q.left->getTable ()->getSchema ()->getAtts ()[0].first + "]";
+			HashJoin myOp (q.left, q.right, hashOut, "", {leftFirst, "[r_suppkey]"},
+				{make_pair (q.leftKey, q.rightKey)}, q.leftPred, "");
+			myOp.run ();
+			end_time = chrono::high_resolution_clock::now ();
+			auto hashDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+			cout << "    " << q.name << ":  nested loops " << loopDuration << " ms, hash join " << hashDuration
+				<< " ms, " << hashOut->getTable ()->getTupleCount () << " records out" << endl;
+			if (hashOut->getTable ()->getTupleCount () != loopOut->getTable ()->getTupleCount () ||
+				hashOut->getTable ()->getTupleCount () == 0)
+				allMatch = false;
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 3:
+	{
+		// Test 3: hash aggregation of the count, sum, and average balance by nation, against
+		// sorting supplier on the nation and then scanning the sorted table
+		cout << "TEST 3: Hash Aggregation Performance..." << endl << flush;
+
+		MyDB_TableReaderWriterPtr supplier = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfAggIn", "perfAggIn.bin", supplierSchema ("")), myMgr);
+		supplier->loadFromTextFile ("supplier.tbl");
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("cnt", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("sum", make_shared <MyDB_DoubleAttType> ()));
+		outSchema->appendAtt (make_pair ("avg", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TableReaderWriterPtr sortOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfSortOut", "perfSortOut.bin", outSchema), myMgr);
+		MyDB_TableReaderWriterPtr hashOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfAggOut", "perfAggOut.bin", outSchema), myMgr);
+		sortOut->clear ();
+		hashOut->clear ();
+
+		int numRounds = 10;
+
+		// sort, then scan, starting a new group each time the nation changes
+		auto start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			sortOut->clear ();
+			MyDB_TableReaderWriter sorted (make_shared <MyDB_Table> ("perfSorted", "perfSorted.bin", supplierSchema ("")), myMgr);
+			MyDB_RecordPtr lhs = supplier->getEmptyRecord (), rhs = supplier->getEmptyRecord ();
+			sort (32, *supplier, sorted, buildRecordComparator (lhs, rhs, "[nationkey]"), lhs, rhs);
+
+			MyDB_RecordPtr rec = sorted.getEmptyRecord (), outRec = sortOut->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = sorted.getIteratorAlt ();
+			int nation = -1, count = 0;
+			double sum = 0;
+			auto finishGroup = [&] () {
+				if (count == 0)
+					return;
+				outRec->getAtt (0)->fromInt (nation);
+				outRec->getAtt (1)->fromInt (count);
+				static_pointer_cast <MyDB_DoubleAttVal> (outRec->getAtt (2))->set (sum);
+				static_pointer_cast <MyDB_DoubleAttVal> (outRec->getAtt (3))->set (sum / count);
+				outRec->recordContentHasChanged ();
+				sortOut->append (outRec);
+			};
+			while (myIter->advance ()) {
+				myIter->getCurrent (rec);
+				if (rec->getAtt (3)->toInt () != nation) {
+					finishGroup ();
+					nation = rec->getAtt (3)->toInt ();
+					count = 0;
+					sum = 0;
+				}
+				count++;
+				sum += rec->getAtt (5)->toDouble ();
+			}
+			finishGroup ();
+		}
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto sortDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			hashOut->clear ();
+			Aggregate myOp (supplier, hashOut, {make_pair (cntAgg, string ("")), make_pair (sumAgg, string ("[acctbal]")),
+				make_pair (avgAgg, string ("[acctbal]"))}, {"[nationkey]"}, "");
+			myOp.run ();
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto hashDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		cout << "    sort and scan:    " << sortDuration / (double) numRounds << " ms" << endl;
+		cout << "    hash aggregation: " << hashDuration / (double) numRounds << " ms" << endl;
+
+		// the two should have the same groups
+		map <int, pair <int, double>> sortGroups, hashGroups;
+		for (auto &answer : {make_pair (sortOut, &sortGroups), make_pair (hashOut, &hashGroups)}) {
+			MyDB_RecordPtr outRec = answer.first->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = answer.first->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (outRec);
+				(*answer.second)[outRec->getAtt (0)->toInt ()] = make_pair (outRec->getAtt (1)->toInt (),
+					outRec->getAtt (2)->toDouble ());
+			}
+		}
+		bool allMatch = sortGroups.size () == 25 && hashGroups.size () == 25;
+		for (auto &group : sortGroups) {
+			if (hashGroups[group.first].first != group.second.first ||
+				fabs (hashGroups[group.first].second - group.second.second) > 0.01)
+				allMatch = false;
+		}
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 4:
+	{
+		// Test 4: a filter, a join, and an aggregation, run as one pipelined plan, against running
+		// the same operators one at a time, with the join written out to a table
+		cout << "TEST 4: Pipelined Executor Performance..." << endl << flush;
+
+		MyDB_SchemaPtr joinSchema = make_shared <MyDB_Schema> ();
+		joinSchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+		joinSchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("cnt", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("sum", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TableReaderWriterPtr joined = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfJoined", "perfJoined.bin", joinSchema), myMgr);
+		MyDB_TableReaderWriterPtr stagedOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfStagedOut", "perfStagedOut.bin", outSchema), myMgr);
+		MyDB_TableReaderWriterPtr pipelinedOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfPipelinedOut", "perfPipelinedOut.bin", outSchema), myMgr);
+		stagedOut->clear ();
+		pipelinedOut->clear ();
+
+		int numRounds = 5;
+
+		// the join goes to a table, which is then aggregated
+		auto start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			joined->clear ();
+			stagedOut->clear ();
+			HashJoin joinOp (leftTable, rightTable, joined, "", {"[l_nationkey]", "[r_acctbal]"},
+				{make_pair ("[l_nationkey]", "[r_nationkey]")}, "< ([l_suppkey], int[1000])", "");
+			joinOp.run ();
+			Aggregate aggOp (joined, stagedOut, {make_pair (cntAgg, string ("")), make_pair (sumAgg, string ("[acctbal]"))},
+				{"[nationkey]"}, "");
+			aggOp.run ();
+		}
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto stagedDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		// the joined records go straight from the join to the aggregation
+		QueryOpPtr plan;
+		start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			pipelinedOut->clear ();
+			plan = make_shared <AggregateOp> (
+				make_shared <ProjectOp> (
+					make_shared <HashJoinOp> (
+						make_shared <FilterOp> (make_shared <ScanOp> (leftTable), "< ([l_suppkey], int[1000])"),
+						make_shared <ScanOp> (rightTable), vector <pair <string, string>> {make_pair ("[l_nationkey]", "[r_nationkey]")}),
+					joinSchema, vector <string> {"[l_nationkey]", "[r_acctbal]"}),
+				outSchema, vector <pair <MyDB_AggType, string>> {make_pair (cntAgg, string ("")), make_pair (sumAgg, string ("[acctbal]"))},
+				vector <string> {"[nationkey]"});
+			plan->appendAllTo (pipelinedOut);
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto pipelinedDuration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+
+		cout << "    one operator at a time: " << stagedDuration / (double) numRounds << " ms" << endl;
+		cout << "    pipelined:              " << pipelinedDuration / (double) numRounds << " ms" << endl;
+		cout << plan->getProfile ();
+
+		// the two should have the same groups
+		map <int, pair <int, double>> stagedGroups, pipelinedGroups;
+		for (auto &answer : {make_pair (stagedOut, &stagedGroups), make_pair (pipelinedOut, &pipelinedGroups)}) {
+			MyDB_RecordPtr outRec = answer.first->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = answer.first->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (outRec);
+				(*answer.second)[outRec->getAtt (0)->toInt ()] = make_pair (outRec->getAtt (1)->toInt (),
+					outRec->getAtt (2)->toDouble ());
+			}
+		}
+		bool allMatch = stagedGroups.size () == 25 && pipelinedGroups.size () == 25;
+		for (auto &group : stagedGroups) {
+			if (pipelinedGroups[group.first].first != group.second.first ||
+				fabs (pipelinedGroups[group.first].second - group.second.second) > 0.01)
+				allMatch = false;
+		}
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 5:
+	{
+		// Test 5: a scan, a filter, and an aggregation over a table made of many copies of
+		// supplier, run with a morsel-driven scan on more and more threads, against Aggregate
+		// on one thread... numCopies can be turned up to scale this to a multi-GB table (at
+		// about 1.7MB per copy, 2000 copies is over 3GB)
+		cout << "TEST 5: Morsel-Driven Parallel Scan Performance..." << endl << flush;
+		cout << "    (the workers copy pages out of the buffer one morsel at a time, under a lock, so" << endl;
+		cout << "    the time holding the lock is a floor on each run: page I/O is not parallel)" << endl;
+
+		int numCopies = 20;
+		{
+			ifstream in ("supplier.tbl");
+			string contents ((istreambuf_iterator <char> (in)), istreambuf_iterator <char> ());
+			ofstream out ("perfMorsel.tbl");
+			for (int i = 0; i < numCopies; i++)
+				out << contents;
+		}
+		MyDB_TableReaderWriterPtr supplier = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfMorselIn", "perfMorselIn.bin", supplierSchema ("")), myMgr);
+		supplier->loadFromTextFile ("perfMorsel.tbl");
+		unlink ("perfMorsel.tbl");
+		double megabytes = supplier->getNumPages () * (double) myMgr->getPageSize () / (1024.0 * 1024.0);
+
+		MyDB_SchemaPtr outSchema = make_shared <MyDB_Schema> ();
+		outSchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("cnt", make_shared <MyDB_IntAttType> ()));
+		outSchema->appendAtt (make_pair ("avg", make_shared <MyDB_DoubleAttType> ()));
+		vector <pair <MyDB_AggType, string>> aggs {make_pair (cntAgg, string ("")), make_pair (avgAgg, string ("[acctbal]"))};
+		vector <string> groupings {"[nationkey]"};
+		string pred = "> ([acctbal], double[0.0])";
+
+		// reads a table of results into a map
+		auto getGroups = [] (MyDB_TableReaderWriterPtr fromMe) {
+			map <int, pair <int, double>> groups;
+			MyDB_RecordPtr outRec = fromMe->getEmptyRecord ();
+			MyDB_RecordIteratorAltPtr myIter = fromMe->getIteratorAlt ();
+			while (myIter->advance ()) {
+				myIter->getCurrent (outRec);
+				groups[outRec->getAtt (0)->toInt ()] = make_pair (outRec->getAtt (1)->toInt (),
+					outRec->getAtt (2)->toDouble ());
+			}
+			return groups;
+		};
+
+		MyDB_TableReaderWriterPtr serialOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfSerialOut", "perfSerialOut.bin", outSchema), myMgr);
+		serialOut->clear ();
+		auto start_time = chrono::high_resolution_clock::now ();
+		Aggregate serialOp (supplier, serialOut, aggs, groupings, pred);
+		serialOp.run ();
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto duration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+		cout << "    " << megabytes << " MB table" << endl;
+		cout << "    Aggregate:           " << duration << " ms" << endl;
+		map <int, pair <int, double>> expected = getGroups (serialOut);
+
+		bool allMatch = expected.size () == 25;
+		int hardware = max (1, (int) thread :: hardware_concurrency ());
+		for (int numThreads : {1, 2, 4, 8}) {
+			if (numThreads > 1 && numThreads > 2 * hardware)
+				break;
+			MyDB_TableReaderWriterPtr morselOut = make_shared <MyDB_TableReaderWriter> (
+				make_shared <MyDB_Table> ("perfMorselOut", "perfMorselOut.bin", outSchema), myMgr);
+			morselOut->clear ();
+			start_time = chrono::high_resolution_clock::now ();
+			MorselScan myScan (supplier, numThreads);
+			myScan.aggregate (morselOut, aggs, groupings, pred);
+			end_time = chrono::high_resolution_clock::now ();
+			duration = chrono::duration_cast <chrono::milliseconds> (end_time - start_time).count ();
+			cout << "    morsels, " << numThreads << " thread(s): " << duration << " ms ("
+				<< megabytes / (duration / 1000.0) << " MB/s, " << myScan.getNumStolen () << " morsels stolen, "
+				<< (int) myScan.getLockedMillis () << " ms holding the buffer lock)" << endl;
+
+			map <int, pair <int, double>> found = getGroups (morselOut);
+			for (auto &group : expected) {
+				if (found[group.first].first != group.second.first ||
+					fabs (found[group.first].second - group.second.second) > 0.01)
+					allMatch = false;
+			}
+		}
+
+		if (allMatch) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allMatch);
+	}
+	FALLTHROUGH_INTENDED;
+	case 6:
+	{
+		// Test 6: the number of calls to new made in setting up an operator (its records, and the
+		// computations compiled over them), with and without an arena, and in running each of
+		// the operators (which set themselves up in arenas)
+		cout << "TEST 6: Operator Allocation Counts..." << endl << flush;
+
+		MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+		for (auto &att : leftTable->getTable ()->getSchema ()->getAtts ())
+			combinedSchema->appendAtt (att);
+		for (auto &att : rightTable->getTable ()->getSchema ()->getAtts ())
+			combinedSchema->appendAtt (att);
+		vector <string> computations = {"> ([l_acctbal], double[9800.0])", "== ([l_nationkey], [r_nationkey])",
+			"[l_suppkey]", "[r_suppkey]", "+ ([l_acctbal], * ([r_acctbal], double[0.5]))",
+			"&& (< ([l_suppkey], [r_suppkey]), == ([l_phone], string[25-843-787-7479]))"};
+
+		// sets up the records and computations, and runs them over each pair of the first 100
+		// records on each side... returns the number of calls to new, and the sum of the results
+		auto setUp = [&] (MyDB_ArenaPtr arena, double &sum) {
+			size_t before = numNews;
+			MyDB_RecordPtr leftRec = leftTable->getEmptyRecord (arena);
+			MyDB_RecordPtr rightRec = rightTable->getEmptyRecord (arena);
+			MyDB_RecordPtr combinedRec = makeInArena <MyDB_Record> (arena, combinedSchema, arena);
+			combinedRec->buildFrom (leftRec, rightRec);
+			vector <func> funcs;
+			for (string &computation : computations)
+				funcs.push_back (combinedRec->compileComputation (computation));
+			size_t numAllocs = numNews - before;
+
+			sum = 0;
+			MyDB_RecordIteratorAltPtr leftIter = leftTable->getIteratorAlt ();
+			for (int i = 0; i < 100 && leftIter->advance (); i++) {
+				leftIter->getCurrent (leftRec);
+				MyDB_RecordIteratorAltPtr rightIter = rightTable->getIteratorAlt ();
+				for (int j = 0; j < 100 && rightIter->advance (); j++) {
+					rightIter->getCurrent (rightRec);
+					sum += funcs[0] ()->toBool () + funcs[1] ()->toBool () + funcs[2] ()->toInt () +
+						funcs[3] ()->toInt () + funcs[4] ()->toDouble () + funcs[5] ()->toBool ();
+				}
+			}
+			return numAllocs;
+		};
+		double heapSum, arenaSum;
+		size_t heapAllocs = setUp (nullptr, heapSum);
+		MyDB_ArenaPtr arena = make_shared <MyDB_Arena> ();
+		size_t arenaAllocs = setUp (arena, arenaSum);
+		cout << "    set up without an arena: " << heapAllocs << " calls to new" << endl;
+		cout << "    set up with an arena:    " << arenaAllocs << " calls to new (" << arena->getNumAllocations ()
+			<< " allocations from " << arena->getNumChunks () << " chunks)" << endl;
+
+		// and the operators themselves
+		MyDB_TableReaderWriterPtr joinOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfAllocOut", "perfAllocOut.bin", pairSchema ()), myMgr);
+		MyDB_SchemaPtr aggSchema = make_shared <MyDB_Schema> ();
+		aggSchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+		aggSchema->appendAtt (make_pair ("cnt", make_shared <MyDB_IntAttType> ()));
+		aggSchema->appendAtt (make_pair ("sum", make_shared <MyDB_DoubleAttType> ()));
+		MyDB_TableReaderWriterPtr aggOut = make_shared <MyDB_TableReaderWriter> (
+			make_shared <MyDB_Table> ("perfAllocAgg", "perfAllocAgg.bin", aggSchema), myMgr);
+		string leftPred = "> ([l_acctbal], double[9800.0])";
+		pair <string, string> keys = make_pair (string ("[l_nationkey]"), string ("[r_nationkey]"));
+
+		joinOut->clear ();
+		size_t before = numNews;
+		{
+			HashJoin myOp (leftTable, rightTable, joinOut, "", {"[l_suppkey]", "[r_suppkey]"}, {keys}, leftPred, "");
+			myOp.run ();
+		}
+		size_t hashJoinAllocs = numNews - before;
+		size_t hashJoinCount = joinOut->getTable ()->getTupleCount ();
+
+		joinOut->clear ();
+		before = numNews;
+		{
+			SortMergeJoin myOp (leftTable, rightTable, joinOut, "", {"[l_suppkey]", "[r_suppkey]"}, keys, leftPred, "");
+			myOp.run ();
+		}
+		size_t mergeJoinAllocs = numNews - before;
+		size_t mergeJoinCount = joinOut->getTable ()->getTupleCount ();
+
+		aggOut->clear ();
+		before = numNews;
+		{
+			Aggregate myOp (leftTable, aggOut, {make_pair (cntAgg, string ("")), make_pair (sumAgg, string ("[l_acctbal]"))},
+				{"[l_nationkey]"}, "");
+			myOp.run ();
+		}
+		size_t aggAllocs = numNews - before;
+
+		cout << "    hash join:       " << hashJoinAllocs << " calls to new" << endl;
+		cout << "    sort-merge join: " << mergeJoinAllocs << " calls to new" << endl;
+		cout << "    aggregation:     " << aggAllocs << " calls to new" << endl;
+
+		bool correct = heapSum == arenaSum && arenaAllocs < heapAllocs && arena->getNumChunks () > 0 &&
+			hashJoinCount == mergeJoinCount && hashJoinCount > 0 && aggOut->getTable ()->getTupleCount () == 25;
+		if (correct) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (correct);
+	}
+	FALLTHROUGH_INTENDED;
+	default:
+		break;
+	}
+
+	return qunit.errors ();
+}
+
+#endif
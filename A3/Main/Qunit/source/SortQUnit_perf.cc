@@ -0,0 +1,187 @@
+
+#ifndef SORT_TEST_PERF_H
+#define SORT_TEST_PERF_H
+
+#include "MyDB_AttType.h"
+#include "MyDB_BufferManager.h"
+#include "MyDB_Catalog.h"
+#include "MyDB_Page.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_Table.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_Schema.h"
+#include "QUnit.h"
+#include "Sorting.h"
+#include <chrono>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FALLTHROUGH_INTENDED do {} while (0)
+
+using namespace std;
+
+// the supplier schema
+MyDB_SchemaPtr supplierSchema () {
+	MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema> ();
+	mySchema->appendAtt (make_pair ("suppkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("name", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("address", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("nationkey", make_shared <MyDB_IntAttType> ()));
+	mySchema->appendAtt (make_pair ("phone", make_shared <MyDB_StringAttType> ()));
+	mySchema->appendAtt (make_pair ("acctbal", make_shared <MyDB_DoubleAttType> ()));
+	mySchema->appendAtt (make_pair ("comment", make_shared <MyDB_StringAttType> ()));
+	return mySchema;
+}
+
+int main (int argc, char *argv[]) {
+	int start = 1;
+	if (argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9') {
+		start = argv[1][0] - '0';
+	}
+	cout << "start from test " << start << endl << flush;
+
+	QUnit::UnitTest qunit (cerr, QUnit::normal);
+
+	unlink ("perfSupplier.bin");
+	unlink ("perfSupplierSorted.bin");
+
+	switch (start) {
+	case 1:
+	{
+		// Test 1: per-page sort... every page of the supplier table is sorted over and over,
+		// alternating the sort key so that no page is ever already sorted
+		cout << "TEST 1: Per-Page Sort Performance..." << endl << flush;
+
+		MyDB_TablePtr myTable = make_shared <MyDB_Table> ("perfSupplier", "perfSupplier.bin", supplierSchema ());
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (65536, 64, "perfTempFile");
+		MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+		supplierTable.loadFromTextFile ("supplier.tbl");
+
+		MyDB_RecordPtr lhs = supplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rhs = supplierTable.getEmptyRecord ();
+		vector <function <bool ()>> comps;
+		comps.push_back (buildRecordComparator (lhs, rhs, "[acctbal]"));
+		comps.push_back (buildRecordComparator (lhs, rhs, "[name]"));
+		comps.push_back (buildRecordComparator (lhs, rhs, "[nationkey]"));
+
+		int numRounds = 30;
+		int numPages = supplierTable.getNumPages ();
+
+		// the copying sort, which re-serializes each record onto a new anonymous page
+		auto start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			for (int i = 0; i < numPages; i++) {
+				MyDB_PageReaderWriterPtr sorted = supplierTable[i].sort (comps[round % comps.size ()], lhs, rhs);
+			}
+		}
+		auto end_time = chrono::high_resolution_clock::now ();
+		auto copyDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		// the in-place sort
+		start_time = chrono::high_resolution_clock::now ();
+		for (int round = 0; round < numRounds; round++) {
+			for (int i = 0; i < numPages; i++) {
+				supplierTable[i].sortInPlace (comps[round % comps.size ()], lhs, rhs);
+			}
+		}
+		end_time = chrono::high_resolution_clock::now ();
+		auto inPlaceDuration = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count ();
+
+		cout << "Sorted " << numPages * numRounds << " pages of " << supplierTable.getBufferMgr ()->getPageSize () << " bytes" << endl;
+		cout << "sort ():        " << copyDuration / (double) (numPages * numRounds) << " us/page" << endl;
+		cout << "sortInPlace (): " << inPlaceDuration / (double) (numPages * numRounds) << " us/page" << endl;
+
+		// the last round sorted on comps[(numRounds - 1) % 3]; check that every page is sorted and
+		// that no records were lost
+		function <bool ()> lastComp = comps[(numRounds - 1) % comps.size ()];
+		int totRecs = 0;
+		bool allSorted = true;
+		for (int i = 0; i < numPages; i++) {
+			MyDB_RecordIteratorAltPtr myIter = supplierTable[i].getIteratorAlt ();
+			bool first = true;
+			while (myIter->advance ()) {
+				myIter->getCurrent (lhs);
+				if (!first && lastComp ())
+					allSorted = false;
+				myIter->getCurrent (rhs);
+				first = false;
+				totRecs++;
+			}
+		}
+
+		if (allSorted && totRecs == 10000) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allSorted);
+		QUNIT_IS_EQUAL (totRecs, 10000);
+	}
+	FALLTHROUGH_INTENDED;
+	case 2:
+	{
+		// Test 2: spill-heavy sort... the supplier table is sorted with a buffer that is much
+		// smaller than the table, so every run is written out to the temp file and read back
+		// during the merge; this is done with the temp file stored as it is, and compressed
+		cout << "TEST 2: Spilling Sort Performance..." << endl << flush;
+
+		long long durations[2];
+		long long tempBytes[2];
+		bool allSorted = true;
+		int totRecs = 0;
+		for (int compressed = 0; compressed < 2; compressed++) {
+
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (8192, 48, "perfTempFile", compressed == 1);
+			MyDB_TablePtr myTable = make_shared <MyDB_Table> ("perfSupplier", "perfSupplier.bin", supplierSchema ());
+			MyDB_TablePtr sortedTable = make_shared <MyDB_Table> ("perfSupplierSorted", "perfSupplierSorted.bin", supplierSchema ());
+			MyDB_TableReaderWriter supplierTable (myTable, myMgr);
+			MyDB_TableReaderWriter sortedSupplier (sortedTable, myMgr);
+			supplierTable.loadFromTextFile ("supplier.tbl");
+
+			MyDB_RecordPtr lhs = supplierTable.getEmptyRecord ();
+			MyDB_RecordPtr rhs = supplierTable.getEmptyRecord ();
+			function <bool ()> comp = buildRecordComparator (lhs, rhs, "[name]");
+
+			int numRounds = 5;
+			auto start_time = chrono::high_resolution_clock::now ();
+			for (int round = 0; round < numRounds; round++) {
+				sortedSupplier.loadFromTextFile ("empty.tbl");
+				sort (16, supplierTable, sortedSupplier, comp, lhs, rhs);
+			}
+			auto end_time = chrono::high_resolution_clock::now ();
+			durations[compressed] = chrono::duration_cast <chrono::microseconds> (end_time - start_time).count () / numRounds;
+
+			// the temp file never shrinks, so its size is the most that was spilled at once
+			struct stat fileInfo;
+			stat ("perfTempFile", &fileInfo);
+			tempBytes[compressed] = fileInfo.st_size;
+
+			MyDB_RecordIteratorAltPtr myIter = sortedSupplier.getIteratorAlt ();
+			bool first = true;
+			while (myIter->advance ()) {
+				myIter->getCurrent (lhs);
+				if (!first && comp ())
+					allSorted = false;
+				myIter->getCurrent (rhs);
+				first = false;
+				totRecs++;
+			}
+		}
+
+		cout << "plain temp file:      " << durations[0] / 1000.0 << " ms/sort, " << tempBytes[0] << " bytes spilled" << endl;
+		cout << "compressed temp file: " << durations[1] / 1000.0 << " ms/sort, " << tempBytes[1] << " bytes spilled" << endl;
+
+		if (allSorted && totRecs == 20000) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE (allSorted);
+		QUNIT_IS_EQUAL (totRecs, 20000);
+		QUNIT_IS_TRUE (tempBytes[1] < tempBytes[0]);
+	}
+	FALLTHROUGH_INTENDED;
+	default:
+		break;
+	}
+
+	return qunit.errors ();
+}
+
+#endif
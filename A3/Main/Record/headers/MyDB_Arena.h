@@ -0,0 +1,123 @@
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <memory>
+#include <stddef.h>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for arenas
+class MyDB_Arena;
+typedef shared_ptr <MyDB_Arena> MyDB_ArenaPtr;
+
+// An arena is a place to get lots of small pieces of memory that all go away at the same time.
+// Memory is obtained from the system a chunk at a time, and handed out by bumping a pointer
+// through the current chunk; nothing is ever freed on its own, but all of the chunks are freed
+// when the arena is destroyed.
+//
+// This is used for the things that an operator (a join, an aggregation) sets up when it starts
+// and throws away when it is done: its records and their buffers, and the temporary values and
+// types that compileComputation makes for each node of each computation.  Giving the operator
+// one arena turns all of those allocations into a few chunk allocations, and lets them all go
+// at once.  Anything allocated out of an arena (with a MyDB_ArenaAllocator) holds a pointer to
+// the arena, so the arena lives until the last of those things is gone.
+//
+// An arena is not thread-safe; each thread needs its own.
+class MyDB_Arena {
+
+public:
+
+	// an arena that gets memory from the system chunkSize bytes at a time
+	MyDB_Arena (size_t chunkSize = 16 * 1024);
+
+	// frees all of the memory that has been handed out
+	~MyDB_Arena ();
+
+	// returns numBytes bytes of memory, aligned for any type; it is good until the arena
+	// is destroyed
+	inline void *allocate (size_t numBytes) {
+		numBytes = (numBytes + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+		numAllocations++;
+		if (numBytes > bytesLeft)
+			return allocateFromNewChunk (numBytes);
+		void *retVal = nextByte;
+		nextByte += numBytes;
+		bytesLeft -= numBytes;
+		return retVal;
+	}
+
+	// the number of calls to allocate, and the number of chunks that were needed for them
+	size_t getNumAllocations ();
+	size_t getNumChunks ();
+
+	// the number of bytes that have been obtained from the system
+	size_t getBytesReserved ();
+
+private:
+
+	static const size_t ARENA_ALIGN = 16;
+
+	// gets a new chunk and allocates from it... a request that is a big part of a chunk gets
+	// its own chunk, so that the rest of the current chunk is not wasted
+	void *allocateFromNewChunk (size_t numBytes);
+
+	size_t chunkSize;
+	vector <char *> chunks;
+	char *nextByte;
+	size_t bytesLeft;
+	size_t numAllocations;
+	size_t bytesReserved;
+};
+
+// An allocator (for the standard containers, and for allocate_shared) that gets its memory from
+// an arena; deallocate does nothing, since the arena frees everything at once.  An allocator
+// made with a null arena just uses new and delete, so code can take an arena that may not be
+// there without checking.
+template <class T>
+class MyDB_ArenaAllocator {
+
+public:
+
+	typedef T value_type;
+
+	MyDB_ArenaAllocator (MyDB_ArenaPtr arenaIn) : arena (arenaIn) {}
+
+	template <class U>
+	MyDB_ArenaAllocator (const MyDB_ArenaAllocator <U> &fromMe) : arena (fromMe.arena) {}
+
+	T *allocate (size_t n) {
+		if (arena == nullptr)
+			return (T *) :: operator new (n * sizeof (T));
+		return (T *) arena->allocate (n * sizeof (T));
+	}
+
+	void deallocate (T *p, size_t) {
+		if (arena == nullptr)
+			:: operator delete (p);
+	}
+
+	MyDB_ArenaPtr arena;
+};
+
+template <class T, class U>
+inline bool operator == (const MyDB_ArenaAllocator <T> &lhs, const MyDB_ArenaAllocator <U> &rhs) {
+	return lhs.arena == rhs.arena;
+}
+
+template <class T, class U>
+inline bool operator != (const MyDB_ArenaAllocator <T> &lhs, const MyDB_ArenaAllocator <U> &rhs) {
+	return lhs.arena != rhs.arena;
+}
+
+// like make_shared, except that the object (along with its reference count) is put into the
+// arena, if there is one
+template <class T, class... Args>
+inline shared_ptr <T> makeInArena (MyDB_ArenaPtr arena, Args &&... args) {
+	if (arena == nullptr)
+		return make_shared <T> (std :: forward <Args> (args)...);
+	return allocate_shared <T> (MyDB_ArenaAllocator <T> (arena), std :: forward <Args> (args)...);
+}
+
+#endif
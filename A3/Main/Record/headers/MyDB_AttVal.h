@@ -2,6 +2,7 @@
 #ifndef ATT_VAL_H
 #define ATT_VAL_H
 
+#include "MyDB_Arena.h"
 #include <memory>
 #include <string>
 #include <string.h>
@@ -11,41 +12,111 @@ using namespace std;
 class MyDB_AttVal;
 typedef shared_ptr <MyDB_AttVal> MyDB_AttValPtr;
 
+// the kinds of values that there are
+enum MyDB_AttValType {IntVal, DoubleVal, StringVal, BoolVal};
+
+// An attribute value.  This is a tagged union rather than a class hierarchy: every value is a
+// MyDB_AttVal, whose type says which of the fields below holds it, and none of the methods
+// are virtual.  That way, a record can keep all of its values together in one block (rather
+// than allocating each one on its own), a value can be copied or assigned like any other
+// object, and the calls made for each record---toInt, toDouble, set, and so on---are just a
+// switch on the type, which the compiler can inline.
+//
+// MyDB_IntAttVal and friends are still around, so that a value of a particular type can be
+// made (and set) as before; they add nothing to MyDB_AttVal but a constructor and a set.
 class MyDB_AttVal {
 
-private:
+public:
 
-	// this is a pointer into a buffer
-	void *myData;
+	// makes a value of the given type that is zero (or false, or the empty string)
+	MyDB_AttVal (MyDB_AttValType type);
 
-	// this tells us whether we are using the buffer
-	bool usingBuffer;
+	// the type of the value
+	inline MyDB_AttValType getType () {
+		return type;
+	}
 
-public:
+	inline int toInt () {
+		if (type == IntVal)
+			return (myData == nullptr) ? intVal : readAs <int> ();
+		if (type == DoubleVal)
+			return (int) toDouble ();
+		cannotConvert ("int");
+		return 0;
+	}
+
+	inline double toDouble () {
+		if (type == DoubleVal)
+			return (myData == nullptr) ? doubleVal : readAs <double> ();
+		if (type == IntVal)
+			return (double) toInt ();
+		cannotConvert ("double");
+		return 0;
+	}
+
+	inline bool toBool () {
+		if (type == BoolVal)
+			return (myData == nullptr) ? boolVal : (*((char *) myData) == 1);
+		cannotConvert ("bool");
+		return false;
+	}
+
+	// an int becomes a double, a string, or a bool (true if it is 1) as needed
+	inline void fromInt (int fromMe) {
+		switch (type) {
+			case IntVal: intVal = fromMe; break;
+			case DoubleVal: doubleVal = (double) fromMe; break;
+			case BoolVal: boolVal = (fromMe == 1); break;
+			case StringVal: stringVal = to_string (fromMe); break;
+		}
+		setNotBuffered ();
+	}
+
+	// sets this value to the other one, converted to this value's type
+	inline void set (MyDB_AttVal *toMe) {
+		switch (type) {
+			case IntVal: intVal = toMe->toInt (); break;
+			case DoubleVal: doubleVal = toMe->toDouble (); break;
+			case BoolVal: boolVal = toMe->toBool (); break;
+			case StringVal: setString (toMe); break;
+		}
+		setNotBuffered ();
+	}
 
-	virtual int toInt () = 0;
-	virtual void fromInt (int fromMe) = 0;
-	virtual double toDouble () = 0;
-	virtual string toString () = 0;
-	virtual bool toBool () = 0;
-	virtual void set (MyDB_AttValPtr toMe) = 0;
-	virtual size_t hash () = 0;
-	virtual MyDB_AttValPtr getCopy () = 0;
-	virtual void fromString (string &fromMe) = 0;
-	virtual void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) = 0;
-	virtual ~MyDB_AttVal ();
+	inline void set (const MyDB_AttValPtr &toMe) {
+		set (toMe.get ());
+	}
+
+	string toString ();
+	size_t hash ();
+	void fromString (string &fromMe);
+
+	// like fromString, except that the text is in [start, end), which need not be
+	// null-terminated... this does not allocate any memory (except for a string that
+	// is longer than any this value has held before)
+	void fromText (const char *start, const char *end);
+
+	// returns a new value (of the same type) that is set to this one... unlike a plain copy
+	// of a value that is in a record's buffer, the new value does not point into the buffer
+	MyDB_AttValPtr getCopy ();
+
+	// appends the value to the totSize bytes in buffer, making the buffer bigger if need be...
+	// if there is an arena, the bigger buffer comes from it (and the old one is left alone)
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize, MyDB_Arena *arena = nullptr);
 
 	// this gets a pointer to our data... useful because we can avoid deserializing the record
 	inline void *getDataPointer () {
 		return myData;
 	}
 
-	inline void extendBuffer (char *&buffer, size_t &allocatedSize, size_t &totSize, int extraSpaceNeeded) {
+	inline void extendBuffer (char *&buffer, size_t &allocatedSize, size_t &totSize, int extraSpaceNeeded,
+		MyDB_Arena *arena = nullptr) {
 		if (totSize + extraSpaceNeeded > allocatedSize) {
 			size_t newSize = (totSize + extraSpaceNeeded) * 2;
-			char *newBuff = new char[newSize];
+			char *newBuff = (arena == nullptr) ? new char[newSize] : (char *) arena->allocate (newSize);
 			memcpy (newBuff, buffer, allocatedSize);
-			delete [] buffer;
+			if (arena == nullptr)
+				delete [] buffer;
 			buffer = newBuff;
 			allocatedSize = newSize;
 		}
@@ -53,16 +124,10 @@ public:
 
 	inline void setBuffered (char *where) {
 		myData = where;
-		usingBuffer = true;
 	}
 
 	inline void setNotBuffered () {
 		myData = nullptr;
-		usingBuffer = false;
-	}
-
-	MyDB_AttVal () {
-		setNotBuffered ();	
 	}
 
 	inline char *fromBinary (char *fromHere) {
@@ -74,9 +139,39 @@ public:
 		setBuffered (fromHere + sizeof (short));
 
 		// and return a pointer to the next guy
-		return fromHere + myLen; 
+		return fromHere + myLen;
 	}
 
+protected:
+
+	// the value, when it is not in a buffer... only the field for our type is used
+	union {
+		int intVal;
+		double doubleVal;
+		bool boolVal;
+	};
+	string stringVal;
+
+private:
+
+	// reads the value out of the buffer; the values in a record are not aligned
+	template <class T>
+	inline T readAs () {
+		T val;
+		memcpy (&val, myData, sizeof (T));
+		return val;
+	}
+
+	// sets a string value to the other one
+	void setString (MyDB_AttVal *toMe);
+
+	// complains that this value cannot be converted to the given type, and exits
+	void cannotConvert (const char *toType);
+
+	MyDB_AttValType type;
+
+	// this is a pointer into a buffer, or nullptr if we are not using the buffer
+	void *myData;
 };
 
 class MyDB_IntAttVal;
@@ -86,23 +181,14 @@ class MyDB_IntAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	void fromInt (int fromMe) override;
-	bool toBool () override;
-	void fromString (string &fromMe) override;
-	void set (MyDB_AttValPtr toMe) override;
-	size_t hash () override;
-	MyDB_AttValPtr getCopy () override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void set (int val);
-	MyDB_IntAttVal ();
-	~MyDB_IntAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (int val) {
+		intVal = val;
+		setNotBuffered ();
+	}
 
-	int value;
+	MyDB_IntAttVal () : MyDB_AttVal (IntVal) {}
 };
 
 class MyDB_DoubleAttVal;
@@ -112,23 +198,14 @@ class MyDB_DoubleAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	bool toBool () override;
-	void fromInt (int fromMe) override;
-	MyDB_AttValPtr getCopy () override;
-	size_t hash () override;
-	void set (MyDB_AttValPtr toMe) override;
-	void fromString (string &fromMe) override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void set (double val);
-	MyDB_DoubleAttVal ();
-	~MyDB_DoubleAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (double val) {
+		doubleVal = val;
+		setNotBuffered ();
+	}
 
-	double value;
+	MyDB_DoubleAttVal () : MyDB_AttVal (DoubleVal) {}
 };
 
 class MyDB_StringAttVal;
@@ -138,23 +215,14 @@ class MyDB_StringAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	bool toBool () override;
-	void fromString (string &fromMe) override;
-	MyDB_AttValPtr getCopy () override;
-	size_t hash () override;
-	void set (MyDB_AttValPtr toMe) override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void fromInt (int fromMe) override;
-	void set (string val);
-	MyDB_StringAttVal ();
-	~MyDB_StringAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (string val) {
+		stringVal = val;
+		setNotBuffered ();
+	}
 
-	string value;
+	MyDB_StringAttVal () : MyDB_AttVal (StringVal) {}
 };
 
 class MyDB_BoolAttVal;
@@ -164,25 +232,14 @@ class MyDB_BoolAttVal : public MyDB_AttVal {
 
 public:
 
-	int toInt () override;
-	double toDouble () override;
-	string toString () override;
-	bool toBool () override;
-	void fromString (string &fromMe) override;
-	void set (MyDB_AttValPtr toMe) override;
-	MyDB_AttValPtr getCopy () override;
-	size_t hash () override;
-	void fromInt (int fromMe) override;
-	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
-	void set (bool val);
-	MyDB_BoolAttVal ();
-	~MyDB_BoolAttVal ();
+	using MyDB_AttVal :: set;
 
-private:
+	inline void set (bool val) {
+		boolVal = val;
+		setNotBuffered ();
+	}
 
-	bool value;
+	MyDB_BoolAttVal () : MyDB_AttVal (BoolVal) {}
 };
 
-
-
 #endif
@@ -3,6 +3,7 @@
 #define RECORD_H
 
 #include <functional>
+#include "MyDB_Arena.h"
 #include "MyDB_AttVal.h"
 #include "MyDB_Schema.h"
 #include <memory>
@@ -15,18 +16,23 @@ using namespace std;
 class MyDB_Record;
 typedef shared_ptr <MyDB_Record> MyDB_RecordPtr;
 
-// a lambda function over the record... computes an attribute value
-typedef function <MyDB_AttValPtr ()> func;
+// a lambda function over the record... computes an attribute value.  The value that is
+// returned belongs to the function (or to the record), and is overwritten the next time
+// that the function is called
+typedef function <MyDB_AttVal * ()> func;
 
 class MyDB_Record {
 
 public:
 
-	// constructs a record that can hold data for the given schema
-	MyDB_Record (MyDB_SchemaPtr mySchema);
+	// constructs a record that can hold data for the given schema... if there is an arena, the
+	// record's buffer and values, and everything that compileComputation makes, come from it
+	MyDB_Record (MyDB_SchemaPtr mySchema, MyDB_ArenaPtr arena = nullptr);
 
-	// read the record from the text string
-	void fromText (string fromMe);
+	// parse the contents of this record from the line of text that starts at start... the
+	// attributes are separated by '|', and the line ends at a '\n' or at end.  This parses
+	// in place, without any temporary strings; it returns a pointer just past the line
+	const char *fromText (const char *start, const char *end);
 
 	// get the number of bytes required to store the record as a binary string
 	size_t getBinarySize ();
@@ -150,6 +156,15 @@ private:
 	// write the current attribute values into the buffer
 	void writeAttsToBuffer ();
 
+	// replaces the buffer with one of the given size (the contents are not kept)
+	void newBuffer (size_t size);
+
+	// true if the record uses its schema's fixed layout (see MyDB_Schema.h); a record with no
+	// schema, or whose attributes do not match its schema, uses the variable layout
+	inline bool isFixedWidth () {
+		return mySchema != nullptr && values.size () == mySchema->getAtts ().size () && mySchema->isFixedWidth ();
+	}
+
 	// true when the set of attributes don't match the attribute buffer
 	bool bufferOld;
 
@@ -157,8 +172,17 @@ private:
 	friend class MyDB_INRecord;
 
 	MyDB_SchemaPtr mySchema;
-	vector <MyDB_AttValPtr> values;	
-	vector <MyDB_AttValPtr> scratch;
+
+	// where the record's memory comes from, or nullptr if it comes from new
+	MyDB_ArenaPtr arena;
+
+	// the values of the attributes... these point into attBlock, which holds all of the
+	// values that belong to this record, or (after buildFrom) into other records' blocks
+	typedef vector <MyDB_AttValPtr, MyDB_ArenaAllocator <MyDB_AttValPtr>> AttValList;
+	typedef vector <MyDB_AttVal, MyDB_ArenaAllocator <MyDB_AttVal>> AttValBlock;
+	AttValList values;
+	shared_ptr <AttValBlock> attBlock;
+	AttValList scratch;
 
 };
 
@@ -0,0 +1,23 @@
+
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+using namespace std;
+
+// These are the routines used to parse the text (.tbl) files that tables are loaded from.
+// Nothing here allocates memory or needs the text to be null-terminated: they all work
+// on a range [start, end) of characters, say a line sitting in a big read buffer.
+
+// finds the first '|' or '\n' in [start, end)... returns end if there is not one
+const char *findDelimiter (const char *start, const char *end);
+
+// parses an int or a double out of [start, end)... like stoi and stod, leading white space
+// is skipped, and parsing stops at the first character that cannot be part of the number.
+// Returns false (and leaves result alone) if there is no number there at all, or if an int
+// is too big to fit in an int.  A double with
+// no more than 15 significant digits and a small exponent (like every double in the .tbl
+// files) is parsed exactly without calling the C library; anything else falls back to strtod
+bool parseInt (const char *start, const char *end, int &result);
+bool parseDouble (const char *start, const char *end, double &result);
+
+#endif
@@ -0,0 +1,127 @@
+
+#ifndef TYPED_EXPR_H
+#define TYPED_EXPR_H
+
+#include <functional>
+#include <memory>
+#include "MyDB_Schema.h"
+#include <string>
+
+using namespace std;
+
+class MyDB_TypedExpr;
+typedef shared_ptr <MyDB_TypedExpr> MyDB_TypedExprPtr;
+
+// the type of the value produced by a typed expression
+enum MyDB_ExprType {IntExpr, DoubleExpr, BoolExpr, StringExpr};
+
+// the compiled pieces of a typed expression... each one takes the address of a record in its
+// binary form (that is, a pointer to the start of the record, as on a page, or as obtained
+// from getCurrentPointer () on an iterator)
+typedef function <int (const char *)> MyDB_IntFunc;
+typedef function <double (const char *)> MyDB_DoubleFunc;
+typedef function <bool (const char *)> MyDB_BoolFunc;
+typedef function <const char * (const char *)> MyDB_StringFunc;
+
+// This compiles the same expressions as MyDB_Record.compileComputation (), such as
+//
+//	&& (> ([acctbal], double[5000.0]), == ([nationkey], int[3]))
+//
+// but rather than building a tree of closures that pass MyDB_AttVal objects around (with a
+// virtual call to toInt ()/toDouble ()/toBool () at every node), the type of every subtree
+// is worked out from the schema when the expression is compiled, and each node is built to
+// produce a plain int, double, bool, or char *.  The expression is evaluated directly over
+// the bytes of a record, so there is no need to deserialize the record first.  Attributes
+// that come after only fixed-size (int, double, bool) attributes are at a constant offset
+// in the record, and comparisons between such an attribute and a constant, or between two
+// such attributes, are fused into one closure with no further calls.
+//
+// For example, to count the records on a page with nationkey < 10:
+//
+//	MyDB_TypedExpr pred (mySchema, "< ([nationkey], int[10])");
+//	MyDB_RecordIteratorAltPtr myIter = myPage.getIteratorAlt ();
+//	while (myIter->advance ()) {
+//		if (pred.evalBool ((char *) myIter->getCurrentPointer ()))
+//			count++;
+//	}
+//
+// Unlike compileComputation, strings can only be compared with and added to other strings.
+class MyDB_TypedExpr {
+
+public:
+
+	// compile the given expression over records with the given schema
+	MyDB_TypedExpr (MyDB_SchemaPtr mySchema, string expression);
+
+	// the type of the result of the expression
+	MyDB_ExprType getType ();
+
+	// evaluate the expression over the record whose binary form is at rec... evalBool ()
+	// may only be called if the expression is a bool, evalString () if it is a string, and
+	// evalInt () if it is an int; evalDouble () works for both ints and doubles.  The result
+	// of evalString () is valid until the next time the expression is evaluated
+	inline bool evalBool (const void *rec) {
+		return boolFunc ((const char *) rec);
+	}
+
+	inline int evalInt (const void *rec) {
+		return intFunc ((const char *) rec);
+	}
+
+	inline double evalDouble (const void *rec) {
+		return doubleFunc ((const char *) rec);
+	}
+
+	inline const char *evalString (const void *rec) {
+		return stringFunc ((const char *) rec);
+	}
+
+private:
+
+	// one node in the expression as it is being compiled
+	struct Node {
+
+		MyDB_ExprType type;
+
+		// the closure that computes the node's value (only the one matching the type is set;
+		// for an int, doubleFunc is also set)
+		MyDB_IntFunc intFunc;
+		MyDB_DoubleFunc doubleFunc;
+		MyDB_BoolFunc boolFunc;
+		MyDB_StringFunc stringFunc;
+
+		// if the node is a numeric constant, its value
+		bool isConst;
+		double constVal;
+
+		// if the node is an attribute at a fixed offset in the record, the offset of its value
+		int fixedOffset;
+	};
+
+	// parse and compile the expression starting at vals
+	Node compile (char * &vals);
+
+	// the various types of nodes
+	Node attribute (string attName);
+	Node intConst (int val);
+	Node doubleConst (double val);
+	Node boolConst (bool val);
+	Node stringConst (string val);
+	Node arith (char op, Node &lhs, Node &rhs);
+	Node compare (string op, Node &lhs, Node &rhs);
+	Node logical (char op, Node &lhs, Node &rhs);
+	Node unaryMinus (Node &lhs);
+	Node nott (Node &lhs);
+
+	// a node that computes a double from an int node
+	void promote (Node &intNode);
+
+	MyDB_SchemaPtr mySchema;
+	MyDB_ExprType myType;
+	MyDB_IntFunc intFunc;
+	MyDB_DoubleFunc doubleFunc;
+	MyDB_BoolFunc boolFunc;
+	MyDB_StringFunc stringFunc;
+};
+
+#endif
@@ -0,0 +1,51 @@
+
+#ifndef ARENA_C
+#define ARENA_C
+
+#include "MyDB_Arena.h"
+
+MyDB_Arena :: MyDB_Arena (size_t chunkSizeIn) {
+	chunkSize = chunkSizeIn;
+	nextByte = nullptr;
+	bytesLeft = 0;
+	numAllocations = 0;
+	bytesReserved = 0;
+}
+
+MyDB_Arena :: ~MyDB_Arena () {
+	for (char *chunk : chunks)
+		delete [] chunk;
+}
+
+void *MyDB_Arena :: allocateFromNewChunk (size_t numBytes) {
+
+	// a big request gets a chunk all to itself; the current chunk is kept for the next one
+	if (numBytes > chunkSize / 4) {
+		char *chunk = new char[numBytes];
+		chunks.push_back (chunk);
+		bytesReserved += numBytes;
+		return chunk;
+	}
+
+	// otherwise, whatever is left in the current chunk is abandoned
+	char *chunk = new char[chunkSize];
+	chunks.push_back (chunk);
+	bytesReserved += chunkSize;
+	nextByte = chunk + numBytes;
+	bytesLeft = chunkSize - numBytes;
+	return chunk;
+}
+
+size_t MyDB_Arena :: getNumAllocations () {
+	return numAllocations;
+}
+
+size_t MyDB_Arena :: getNumChunks () {
+	return chunks.size ();
+}
+
+size_t MyDB_Arena :: getBytesReserved () {
+	return bytesReserved;
+}
+
+#endif
@@ -4,6 +4,7 @@
 
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
+#include "MyDB_TextParser.h"
 #include <iostream>
 #include <string.h>
 
@@ -319,12 +320,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol (']', vals);
 
 			// remember this value
-			MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+			MyDB_IntAttValPtr temp = makeInArena <MyDB_IntAttVal> (arena);
 			scratch.push_back (temp);
 			temp->set (val);
 
 			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_IntAttType> ());
+			return make_pair ([temp] {return temp.get ();}, makeInArena <MyDB_IntAttType> (arena));
 
 		} else if (strncmp (vals, "double", 6) == 0) {
 
@@ -333,12 +334,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol (']', vals);
 
 			// remember this value
-			MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+			MyDB_DoubleAttValPtr temp = makeInArena <MyDB_DoubleAttVal> (arena);
 			scratch.push_back (temp);
 			temp->set (val);
 
 			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_DoubleAttType> ());
+			return make_pair ([temp] {return temp.get ();}, makeInArena <MyDB_DoubleAttType> (arena));
 
 		} else if (strncmp (vals, "bool", 4) == 0) {
 
@@ -350,12 +351,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol (']', vals);
 
 			// remember this value
-			MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+			MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 			scratch.push_back (temp);
 			temp->set (val);
 
 			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_BoolAttType> ());
+			return make_pair ([temp] {return temp.get ();}, makeInArena <MyDB_BoolAttType> (arena));
 
 		} else if (strncmp (vals, "string", 6) == 0) {
 
@@ -376,12 +377,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol (']', vals);
 	
 			// remember this value
-			MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
+			MyDB_StringAttValPtr temp = makeInArena <MyDB_StringAttVal> (arena);
 			scratch.push_back (temp);
 			temp->set (name);
 
 			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_StringAttType> ());
+			return make_pair ([temp] {return temp.get ();}, makeInArena <MyDB_StringAttType> (arena));
 			
 		} else {
 			vals++;
@@ -393,37 +394,37 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName) {
 
 	// just return a particular attribute
 	auto whichAtt = mySchema->getAttByName (attName);
-	return make_pair ([this, whichAtt] {return values[whichAtt.first];}, whichAtt.second);		
+	return make_pair ([this, whichAtt] {return values[whichAtt.first].get ();}, whichAtt.second);		
 }
 
 pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr temp = makeInArena <MyDB_IntAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () + rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () + rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_IntAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr temp = makeInArena <MyDB_DoubleAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () + rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () + rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_DoubleAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
+		MyDB_StringAttValPtr temp = makeInArena <MyDB_StringAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () + rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_StringAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () + rhs.first ()->toString ()); return temp.get ();},
+			makeInArena <MyDB_StringAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the plus.\n";
@@ -435,21 +436,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: minus (pair <func, MyDB_AttTypePtr>
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr temp = makeInArena <MyDB_IntAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () - rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () - rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_IntAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr temp = makeInArena <MyDB_DoubleAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () - rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () - rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_DoubleAttType> (arena));
 	
 	} else {
 		cout << "This is bad... cannot do anything with the minus.\n";
@@ -461,21 +462,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <func, MyDB_AttType
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr temp = makeInArena <MyDB_IntAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
+		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_IntAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr temp = makeInArena <MyDB_DoubleAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
+		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_DoubleAttType> (arena));
 	
 	} else {
 		cout << "This is bad... cannot do anything with the unary minus.\n";
@@ -487,21 +488,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: times (pair <func, MyDB_AttTypePtr>
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr temp = makeInArena <MyDB_IntAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () * rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () * rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_IntAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr temp = makeInArena <MyDB_DoubleAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () * rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () * rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_DoubleAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the times.\n";
@@ -513,21 +514,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: divide (pair <func, MyDB_AttTypePtr>
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr temp = makeInArena <MyDB_IntAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () / rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_IntAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () / rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_IntAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr temp = makeInArena <MyDB_DoubleAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () / rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_DoubleAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () / rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_DoubleAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the divide.\n";
@@ -539,30 +540,30 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () > rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () > rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () > rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () > rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () > rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () > rhs.first ()->toString ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the >.\n";
@@ -574,30 +575,30 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () < rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () < rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () < rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () < rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () < rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () < rhs.first ()->toString ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the >.\n";
@@ -609,38 +610,38 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () == rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () == rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () == rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () == rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () == rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () == rhs.first ()->toBool ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () == rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () == rhs.first ()->toString ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the >.\n";
@@ -652,38 +653,38 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lh
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () != rhs.first ()->toInt ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () != rhs.first ()->toInt ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () != rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () != rhs.first ()->toBool ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () != rhs.first ()->toDouble ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () != rhs.first ()->toDouble ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () != rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () != rhs.first ()->toString ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do anything with the >.\n";
@@ -695,12 +696,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: orr (pair <func, MyDB_AttTypePtr> lh
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () || rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () || rhs.first ()->toBool ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do or on non booleans.\n";
@@ -712,12 +713,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: andd (pair <func, MyDB_AttTypePtr> l
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () && rhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () && rhs.first ()->toBool ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do or on non booleans.\n";
@@ -729,12 +730,12 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: nott (pair <func, MyDB_AttTypePtr> l
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
+		MyDB_BoolAttValPtr temp = makeInArena <MyDB_BoolAttVal> (arena);
 		scratch.push_back (temp);
 
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (!lhs.first ()->toBool ()); return temp;},
-			make_shared <MyDB_BoolAttType> ());
+		return make_pair ([temp, lhs] {temp->set (!lhs.first ()->toBool ()); return temp.get ();},
+			makeInArena <MyDB_BoolAttType> (arena));
 
 	} else {
 		cout << "This is bad... cannot do not on non boolean.\n";
@@ -755,9 +756,30 @@ void MyDB_Record :: recordContentHasChanged () {
 }
 
 void MyDB_Record :: writeAttsToBuffer () {
+
+	// a fixed-width record is just its values, each at its offset
+	if (isFixedWidth ()) {
+		recSize = mySchema->getFixedSize ();
+		for (size_t i = 0; i < values.size (); i++) {
+			char *toHere = buffer + mySchema->getFixedOffset (i);
+			MyDB_AttTypePtr &type = mySchema->getAtts ()[i].second;
+			if (type->isBool ()) {
+				*toHere = values[i]->toBool () ? 1 : 0;
+			} else if (type->promotableToInt ()) {
+				int val = values[i]->toInt ();
+				memcpy (toHere, &val, sizeof (int));
+			} else {
+				double val = values[i]->toDouble ();
+				memcpy (toHere, &val, sizeof (double));
+			}
+		}
+		bufferOld = false;
+		return;
+	}
+
 	recSize = sizeof (short);
-	for (MyDB_AttValPtr temp : values) {
-		temp->serialize (buffer, allocatedSize, recSize);
+	for (MyDB_AttValPtr &temp : values) {
+		temp->serialize (buffer, allocatedSize, recSize, arena.get ());
 	}		
 	*((short *) buffer) = (short) recSize;
 	bufferOld = false;
@@ -775,22 +797,28 @@ void *MyDB_Record :: toBinary (void *toHere) {
 
 void *MyDB_Record :: fromBinary (void *fromHere) {
 
+	// a fixed-width record does not need to be walked; each attribute is at its offset
+	if (isFixedWidth ()) {
+		recSize = mySchema->getFixedSize ();
+		memcpy (buffer, fromHere, recSize);
+		for (size_t i = 0; i < values.size (); i++)
+			values[i]->setBuffered (buffer + mySchema->getFixedOffset (i));
+		bufferOld = false;
+		return ((char *) fromHere) + recSize;
+	}
+
 	recSize = *((short *) fromHere);
 
 	// if our buffer is not large enough, reallocate
-	if (recSize > allocatedSize) {
-		if (buffer != nullptr)
-			delete [] buffer;
-		buffer = new char[recSize * 2];
-		allocatedSize = recSize * 2;
-	}
+	if (recSize > allocatedSize)
+		newBuffer (recSize * 2);
 
 	// copy over
 	memcpy (buffer, fromHere, recSize);
 
 	// and set up the attributes
 	char *recLoc = buffer + sizeof (short);
-	for (MyDB_AttValPtr temp : values) {
+	for (MyDB_AttValPtr &temp : values) {
 		recLoc = temp->fromBinary (recLoc);
 	}		
 
@@ -801,16 +829,24 @@ void *MyDB_Record :: fromBinary (void *fromHere) {
 }
 
 void MyDB_Record :: fromString (string res) {	
-	int i = 0;
-        for (int pos = 0; pos < (int) res.size (); pos = (int) res.find ("|", pos + 1) + 1) {
-                string temp = res.substr (pos, res.find ("|", pos + 1) - pos);
-		values[i++]->fromString (temp);
-        }
+	fromText (res.data (), res.data () + res.size ());
+}
+
+const char *MyDB_Record :: fromText (const char *start, const char *end) {
+	for (size_t i = 0; start < end && *start != '\n'; i++) {
+		const char *delimiter = findDelimiter (start, end);
+		if (i < values.size ())
+			values[i]->fromText (start, delimiter);
+		start = delimiter;
+		if (start < end && *start == '|')
+			start++;
+	}
 	bufferOld = true;
+	return (start < end) ? start + 1 : end;
 }
 
 std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
-	for (MyDB_AttValPtr temp : printMe.values) {
+	for (auto &temp : printMe.values) {
 		os << temp->toString () << "|";
 	}
 	return os;
@@ -819,7 +855,7 @@ std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
 std::ostream& operator<<(std::ostream& os, const MyDB_RecordPtr printMe) {
 	if (printMe == nullptr)
 		return os;
-	for (MyDB_AttValPtr temp : printMe->values) {
+	for (MyDB_AttValPtr &temp : printMe->values) {
 		os << temp->toString () << "|";
 	}
 	return os;
@@ -841,20 +877,45 @@ function <bool ()> buildRecordComparator (MyDB_RecordPtr lhs,  MyDB_RecordPtr rh
 	
 }
 
-MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
+MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn, MyDB_ArenaPtr arenaIn) :
+	values (MyDB_ArenaAllocator <MyDB_AttValPtr> (arenaIn)), scratch (MyDB_ArenaAllocator <MyDB_AttValPtr> (arenaIn)) {
+
 	mySchema = mySchemaIn;
+	arena = arenaIn;
 
-	buffer = new char[256];
-	allocatedSize = 256;
+	buffer = nullptr;
+	allocatedSize = 0;
+	newBuffer (256);
 	recSize = 0;
 	bufferOld = true;
 
 	if (mySchemaIn == nullptr)
 		return;
 
+	// all of the values go in one block, so that making a record does not allocate each one
+	attBlock = makeInArena <AttValBlock> (arena, MyDB_ArenaAllocator <MyDB_AttVal> (arena));
+	attBlock->reserve (mySchema->getAtts ().size ());
 	for (auto &val : mySchema->getAtts ()) {
-		values.push_back (val.second->createAtt ());	
+		attBlock->push_back (val.second->makeAtt ());
+	}
+	values.reserve (attBlock->size ());
+	for (MyDB_AttVal &val : *attBlock) {
+		values.push_back (MyDB_AttValPtr (attBlock, &val));
+	}
+
+	// make sure that the buffer can hold a fixed-width record
+	if (isFixedWidth () && mySchema->getFixedSize () > allocatedSize)
+		newBuffer (mySchema->getFixedSize ());
+}
+
+void MyDB_Record :: newBuffer (size_t size) {
+	if (arena != nullptr) {
+		buffer = (char *) arena->allocate (size);
+	} else {
+		delete [] buffer;
+		buffer = new char[size];
 	}
+	allocatedSize = size;
 }
 
 MyDB_SchemaPtr &MyDB_Record :: getSchema () {
@@ -866,18 +927,19 @@ MyDB_AttValPtr &MyDB_Record :: getAtt (int whichAtt) {
 }
 
 void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
-        vector <MyDB_AttValPtr> newValues;
+        values.clear ();
+        values.reserve (left->values.size () + right->values.size ());
         for (auto &v : left->values) {
-                newValues.push_back (v);
+                values.push_back (v);
         }
         for (auto &v : right->values) {
-                newValues.push_back (v);
+                values.push_back (v);
         }
-        values = newValues;
 }
 
 MyDB_Record :: ~MyDB_Record () {
-	delete [] buffer;
+	if (arena == nullptr)
+		delete [] buffer;
 }
 
 #endif
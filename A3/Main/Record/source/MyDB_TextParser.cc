@@ -0,0 +1,162 @@
+
+#ifndef TEXT_PARSER_C
+#define TEXT_PARSER_C
+
+#include <climits>
+#include "MyDB_TextParser.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+
+const char *findDelimiter (const char *start, const char *end) {
+	for (; start < end; start++) {
+		if (*start == '|' || *start == '\n')
+			return start;
+	}
+	return end;
+}
+
+static inline bool isSpace (char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static inline bool isDigit (char c) {
+	return c >= '0' && c <= '9';
+}
+
+bool parseInt (const char *start, const char *end, int &result) {
+
+	while (start < end && isSpace (*start))
+		start++;
+
+	bool negative = false;
+	if (start < end && (*start == '-' || *start == '+')) {
+		negative = (*start == '-');
+		start++;
+	}
+
+	if (start == end || !isDigit (*start))
+		return false;
+
+	// accumulate as an unsigned value, so that INT_MIN works... like stoi, a value that does
+	// not fit in an int is an error
+	uint64_t limit = negative ? (uint64_t) INT_MAX + 1 : (uint64_t) INT_MAX;
+	uint64_t val = 0;
+	for (; start < end && isDigit (*start); start++) {
+		val = val * 10 + (*start - '0');
+		if (val > limit)
+			return false;
+	}
+	result = negative ? (int) (0u - (uint32_t) val) : (int) val;
+	return true;
+}
+
+// the powers of ten that are exactly representable as a double
+static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// strtod needs a null-terminated string, so copy the text over first
+static bool slowParseDouble (const char *start, const char *end, double &result) {
+	char local[64];
+	string big;
+	const char *text;
+	if (end - start < (long) sizeof (local)) {
+		memcpy (local, start, end - start);
+		local[end - start] = 0;
+		text = local;
+	} else {
+		big = string (start, end);
+		text = big.c_str ();
+	}
+
+	char *parsedTo;
+	double val = strtod (text, &parsedTo);
+	if (parsedTo == text)
+		return false;
+	result = val;
+	return true;
+}
+
+bool parseDouble (const char *start, const char *end, double &result) {
+
+	const char *begin = start;
+	while (start < end && isSpace (*start))
+		start++;
+
+	bool negative = false;
+	if (start < end && (*start == '-' || *start == '+')) {
+		negative = (*start == '-');
+		start++;
+	}
+
+	// hex is left to the C library
+	if (end - start > 1 && start[0] == '0' && (start[1] == 'x' || start[1] == 'X'))
+		return slowParseDouble (begin, end, result);
+
+	// collect up to 19 significant digits, and the power of ten they are scaled by
+	uint64_t mantissa = 0;
+	int numDigits = 0, exponent = 0;
+	bool sawDigit = false;
+	for (; start < end && isDigit (*start); start++) {
+		sawDigit = true;
+		if (mantissa == 0 && *start == '0')
+			continue;
+		if (numDigits < 19) {
+			mantissa = mantissa * 10 + (*start - '0');
+			numDigits++;
+		} else {
+			exponent++;
+		}
+	}
+	if (start < end && *start == '.') {
+		for (start++; start < end && isDigit (*start); start++) {
+			sawDigit = true;
+			if (mantissa == 0 && *start == '0') {
+				exponent--;
+				continue;
+			}
+			if (numDigits < 19) {
+				mantissa = mantissa * 10 + (*start - '0');
+				numDigits++;
+				exponent--;
+			}
+		}
+	}
+
+	// and so are things like "inf" and "nan"
+	if (!sawDigit)
+		return slowParseDouble (begin, end, result);
+
+	if (start < end && (*start == 'e' || *start == 'E')) {
+		const char *expStart = start + 1;
+		bool negativeExp = false;
+		if (expStart < end && (*expStart == '-' || *expStart == '+')) {
+			negativeExp = (*expStart == '-');
+			expStart++;
+		}
+		if (expStart < end && isDigit (*expStart)) {
+			int exp = 0;
+			for (; expStart < end && isDigit (*expStart); expStart++) {
+				if (exp < 100000)
+					exp = exp * 10 + (*expStart - '0');
+			}
+			exponent += negativeExp ? -exp : exp;
+		}
+	}
+
+	// with at most 15 digits, the mantissa is exact as a double, and so is 10^exponent for a
+	// small enough exponent... and then one multiply or divide rounds correctly
+	if (numDigits > 15 || exponent < -22 || exponent > 22)
+		return slowParseDouble (begin, end, result);
+
+	double val = (double) mantissa;
+	if (exponent < 0)
+		val /= powersOfTen[-exponent];
+	else
+		val *= powersOfTen[exponent];
+	result = negative ? -val : val;
+	return true;
+}
+
+#endif
@@ -0,0 +1,449 @@
+
+#ifndef TYPED_EXPR_C
+#define TYPED_EXPR_C
+
+#include "MyDB_TypedExpr.h"
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+
+// reads a value out of a record; the values in a record are not aligned
+template <class T>
+static inline T readAt (const char *fromHere) {
+	T val;
+	memcpy (&val, fromHere, sizeof (T));
+	return val;
+}
+
+// builds a comparison between two numeric nodes of type T... if one side is an attribute at a
+// fixed offset and the other is a constant (or both are attributes at fixed offsets), the whole
+// comparison is done in one closure, straight off of the record bytes
+template <class T, class Cmp>
+static MyDB_BoolFunc buildCompare (function <T (const char *)> lhs, int lhsOffset, bool lhsConst, T lhsVal,
+	function <T (const char *)> rhs, int rhsOffset, bool rhsConst, T rhsVal) {
+
+	Cmp cmp;
+	if (lhsOffset >= 0 && rhsConst)
+		return [=] (const char *rec) {return cmp (readAt <T> (rec + lhsOffset), rhsVal);};
+	if (lhsConst && rhsOffset >= 0)
+		return [=] (const char *rec) {return cmp (lhsVal, readAt <T> (rec + rhsOffset));};
+	if (lhsOffset >= 0 && rhsOffset >= 0)
+		return [=] (const char *rec) {return cmp (readAt <T> (rec + lhsOffset), readAt <T> (rec + rhsOffset));};
+	return [=] (const char *rec) {return cmp (lhs (rec), rhs (rec));};
+}
+
+template <class T>
+static MyDB_BoolFunc buildCompare (string op, function <T (const char *)> lhs, int lhsOffset, bool lhsConst,
+	T lhsVal, function <T (const char *)> rhs, int rhsOffset, bool rhsConst, T rhsVal) {
+
+	if (op == "<")
+		return buildCompare <T, less <T>> (lhs, lhsOffset, lhsConst, lhsVal, rhs, rhsOffset, rhsConst, rhsVal);
+	else if (op == ">")
+		return buildCompare <T, greater <T>> (lhs, lhsOffset, lhsConst, lhsVal, rhs, rhsOffset, rhsConst, rhsVal);
+	else if (op == "==")
+		return buildCompare <T, equal_to <T>> (lhs, lhsOffset, lhsConst, lhsVal, rhs, rhsOffset, rhsConst, rhsVal);
+	else
+		return buildCompare <T, not_equal_to <T>> (lhs, lhsOffset, lhsConst, lhsVal, rhs, rhsOffset, rhsConst, rhsVal);
+}
+
+// strings are compared with strcmp, which orders them the same way as string's operator <
+template <class Cmp>
+static MyDB_BoolFunc buildStringCompare (MyDB_StringFunc lhs, MyDB_StringFunc rhs) {
+	Cmp cmp;
+	return [=] (const char *rec) {return cmp (strcmp (lhs (rec), rhs (rec)), 0);};
+}
+
+static char *findsymbol (char val, char *input) {
+	while (*input != val) {
+		input++;
+	}
+	return input + 1;
+}
+
+MyDB_TypedExpr :: MyDB_TypedExpr (MyDB_SchemaPtr mySchemaIn, string expression) {
+	mySchema = mySchemaIn;
+	char *str = (char *) expression.c_str ();
+	Node result = compile (str);
+	myType = result.type;
+	intFunc = result.intFunc;
+	doubleFunc = result.doubleFunc;
+	boolFunc = result.boolFunc;
+	stringFunc = result.stringFunc;
+}
+
+MyDB_ExprType MyDB_TypedExpr :: getType () {
+	return myType;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: compile (char * &vals) {
+
+	// reads the parenthesized pair of arguments to a binary operation
+	auto twoArgs = [&] (Node &lhs, Node &rhs) {
+		vals = findsymbol ('(', vals);
+		lhs = compile (vals);
+		vals = findsymbol (',', vals);
+		rhs = compile (vals);
+		vals = findsymbol (')', vals);
+	};
+
+	// and the argument to a unary one
+	auto oneArg = [&] (Node &arg) {
+		vals = findsymbol ('(', vals);
+		arg = compile (vals);
+		vals = findsymbol (')', vals);
+	};
+
+	Node lhs, rhs;
+	while (true) {
+
+		if (vals[0] == 0) {
+			cout << "Reached end of string while parsing.\n";
+			exit (1);
+		}
+
+		if (vals[0] == '!' && vals[1] == '=') {
+			twoArgs (lhs, rhs);
+			return compare ("!=", lhs, rhs);
+
+		} else if (vals[0] == '!') {
+			oneArg (lhs);
+			return nott (lhs);
+
+		} else if (vals[0] == '|' && vals[1] == '|') {
+			twoArgs (lhs, rhs);
+			return logical ('|', lhs, rhs);
+
+		} else if (vals[0] == '&' && vals[1] == '&') {
+			twoArgs (lhs, rhs);
+			return logical ('&', lhs, rhs);
+
+		} else if (vals[0] == '=' && vals[1] == '=') {
+			twoArgs (lhs, rhs);
+			return compare ("==", lhs, rhs);
+
+		} else if (vals[0] == '>') {
+			twoArgs (lhs, rhs);
+			return compare (">", lhs, rhs);
+
+		} else if (vals[0] == '<') {
+			twoArgs (lhs, rhs);
+			return compare ("<", lhs, rhs);
+
+		} else if (vals[0] == '+' || vals[0] == '-' || vals[0] == '*' || vals[0] == '/') {
+			char op = vals[0];
+			twoArgs (lhs, rhs);
+			return arith (op, lhs, rhs);
+
+		} else if (vals[0] == 'u' && vals[1] == 'm') {
+			oneArg (lhs);
+			return unaryMinus (lhs);
+
+		} else if (vals[0] == '[') {
+			vals++;
+			int cnt = 0;
+			for (; vals[cnt] != ']'; cnt++);
+			string name (vals, cnt);
+			vals = findsymbol (']', vals);
+			return attribute (name);
+
+		} else if (strncmp (vals, "int", 3) == 0) {
+			vals = findsymbol ('[', vals);
+			int val = stoi (vals);
+			vals = findsymbol (']', vals);
+			return intConst (val);
+
+		} else if (strncmp (vals, "double", 6) == 0) {
+			vals = findsymbol ('[', vals);
+			double val = stod (vals);
+			vals = findsymbol (']', vals);
+			return doubleConst (val);
+
+		} else if (strncmp (vals, "bool", 4) == 0) {
+			vals = findsymbol ('[', vals);
+			bool val = (strncmp (vals, "true", 4) == 0);
+			vals = findsymbol (']', vals);
+			return boolConst (val);
+
+		} else if (strncmp (vals, "string", 6) == 0) {
+			vals = findsymbol ('[', vals);
+			int cnt = 0;
+			for (; vals[cnt] != ']'; cnt++);
+			string val (vals, cnt);
+			vals = findsymbol (']', vals);
+			return stringConst (val);
+
+		} else {
+			vals++;
+		}
+	}
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: attribute (string attName) {
+
+	auto whichAtt = mySchema->getAttByName (attName);
+	if (whichAtt.first < 0) {
+		cout << "Could not find attribute " << attName << ".\n";
+		exit (1);
+	}
+
+	// walk the attributes that come before this one... as long as they are all of fixed size,
+	// we know exactly where this attribute is.  Otherwise, we know where the first string is,
+	// and we need to skip over the attributes from there at run time
+	auto &atts = mySchema->getAtts ();
+	int base = sizeof (short);
+	int toSkip = 0;
+	for (int i = 0; i < whichAtt.first; i++) {
+		MyDB_AttTypePtr type = atts[i].second;
+		if (toSkip > 0 || !(type->isBool () || type->promotableToDouble ())) {
+			toSkip++;
+			continue;
+		}
+		base += sizeof (short) + (type->isBool () ? sizeof (char) : type->promotableToInt () ? sizeof (int) : sizeof (double));
+	}
+
+	Node result;
+	result.isConst = false;
+	result.fixedOffset = (toSkip == 0) ? base + (int) sizeof (short) : -1;
+
+	// (a record with the fixed layout has no headers at all)
+	if (mySchema->isFixedWidth ())
+		result.fixedOffset = (int) mySchema->getFixedOffset (whichAtt.first);
+
+	// this finds the start of the value at run time
+	function <const char * (const char *)> locate = [base, toSkip] (const char *rec) {
+		const char *pos = rec + base;
+		for (int i = 0; i < toSkip; i++)
+			pos += *((short *) pos);
+		return pos + sizeof (short);
+	};
+
+	int offset = result.fixedOffset;
+	MyDB_AttTypePtr type = whichAtt.second;
+	if (type->isBool ()) {
+		result.type = BoolExpr;
+		if (offset >= 0)
+			result.boolFunc = [offset] (const char *rec) {return rec[offset] != 0;};
+		else
+			result.boolFunc = [locate] (const char *rec) {return *locate (rec) != 0;};
+
+	} else if (type->promotableToInt ()) {
+		result.type = IntExpr;
+		if (offset >= 0)
+			result.intFunc = [offset] (const char *rec) {return readAt <int> (rec + offset);};
+		else
+			result.intFunc = [locate] (const char *rec) {return readAt <int> (locate (rec));};
+		promote (result);
+
+	} else if (type->promotableToDouble ()) {
+		result.type = DoubleExpr;
+		if (offset >= 0)
+			result.doubleFunc = [offset] (const char *rec) {return readAt <double> (rec + offset);};
+		else
+			result.doubleFunc = [locate] (const char *rec) {return readAt <double> (locate (rec));};
+
+	} else {
+		result.type = StringExpr;
+		if (offset >= 0)
+			result.stringFunc = [offset] (const char *rec) {return rec + offset;};
+		else
+			result.stringFunc = locate;
+	}
+	return result;
+}
+
+void MyDB_TypedExpr :: promote (Node &intNode) {
+	MyDB_IntFunc asInt = intNode.intFunc;
+	intNode.doubleFunc = [asInt] (const char *rec) {return (double) asInt (rec);};
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: intConst (int val) {
+	Node result;
+	result.type = IntExpr;
+	result.isConst = true;
+	result.constVal = val;
+	result.fixedOffset = -1;
+	result.intFunc = [val] (const char *) {return val;};
+	result.doubleFunc = [val] (const char *) {return (double) val;};
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: doubleConst (double val) {
+	Node result;
+	result.type = DoubleExpr;
+	result.isConst = true;
+	result.constVal = val;
+	result.fixedOffset = -1;
+	result.doubleFunc = [val] (const char *) {return val;};
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: boolConst (bool val) {
+	Node result;
+	result.type = BoolExpr;
+	result.isConst = false;
+	result.fixedOffset = -1;
+	result.boolFunc = [val] (const char *) {return val;};
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: stringConst (string val) {
+	Node result;
+	result.type = StringExpr;
+	result.isConst = false;
+	result.fixedOffset = -1;
+	result.stringFunc = [val] (const char *) {return val.c_str ();};
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: arith (char op, Node &lhs, Node &rhs) {
+
+	Node result;
+	result.isConst = false;
+	result.fixedOffset = -1;
+
+	// if both sides are ints, then the result is an int
+	if (lhs.type == IntExpr && rhs.type == IntExpr) {
+		MyDB_IntFunc l = lhs.intFunc, r = rhs.intFunc;
+		result.type = IntExpr;
+		if (op == '+')
+			result.intFunc = [l, r] (const char *rec) {return l (rec) + r (rec);};
+		else if (op == '-')
+			result.intFunc = [l, r] (const char *rec) {return l (rec) - r (rec);};
+		else if (op == '*')
+			result.intFunc = [l, r] (const char *rec) {return l (rec) * r (rec);};
+		else
+			result.intFunc = [l, r] (const char *rec) {return l (rec) / r (rec);};
+		promote (result);
+
+	// otherwise, if both are numbers, it is a double
+	} else if ((lhs.type == IntExpr || lhs.type == DoubleExpr) && (rhs.type == IntExpr || rhs.type == DoubleExpr)) {
+		MyDB_DoubleFunc l = lhs.doubleFunc, r = rhs.doubleFunc;
+		result.type = DoubleExpr;
+		if (op == '+')
+			result.doubleFunc = [l, r] (const char *rec) {return l (rec) + r (rec);};
+		else if (op == '-')
+			result.doubleFunc = [l, r] (const char *rec) {return l (rec) - r (rec);};
+		else if (op == '*')
+			result.doubleFunc = [l, r] (const char *rec) {return l (rec) * r (rec);};
+		else
+			result.doubleFunc = [l, r] (const char *rec) {return l (rec) / r (rec);};
+
+	// strings can be added together; the result goes into a buffer owned by the node
+	} else if (op == '+' && lhs.type == StringExpr && rhs.type == StringExpr) {
+		MyDB_StringFunc l = lhs.stringFunc, r = rhs.stringFunc;
+		shared_ptr <string> buffer = make_shared <string> ();
+		result.type = StringExpr;
+		result.stringFunc = [l, r, buffer] (const char *rec) {
+			buffer->assign (l (rec));
+			buffer->append (r (rec));
+			return buffer->c_str ();
+		};
+
+	} else {
+		cout << "This is bad... cannot do anything with the " << op << ".\n";
+		exit (1);
+	}
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: compare (string op, Node &lhs, Node &rhs) {
+
+	Node result;
+	result.type = BoolExpr;
+	result.isConst = false;
+	result.fixedOffset = -1;
+
+	if (lhs.type == IntExpr && rhs.type == IntExpr) {
+		result.boolFunc = buildCompare <int> (op, lhs.intFunc, lhs.fixedOffset, lhs.isConst, (int) lhs.constVal,
+			rhs.intFunc, rhs.fixedOffset, rhs.isConst, (int) rhs.constVal);
+
+	} else if ((lhs.type == IntExpr || lhs.type == DoubleExpr) && (rhs.type == IntExpr || rhs.type == DoubleExpr)) {
+
+		// an int attribute cannot be read as a double, so only fuse on double attributes
+		int lhsOffset = (lhs.type == DoubleExpr) ? lhs.fixedOffset : -1;
+		int rhsOffset = (rhs.type == DoubleExpr) ? rhs.fixedOffset : -1;
+		result.boolFunc = buildCompare <double> (op, lhs.doubleFunc, lhsOffset, lhs.isConst, lhs.constVal,
+			rhs.doubleFunc, rhsOffset, rhs.isConst, rhs.constVal);
+
+	} else if (lhs.type == BoolExpr && rhs.type == BoolExpr && (op == "==" || op == "!=")) {
+		MyDB_BoolFunc l = lhs.boolFunc, r = rhs.boolFunc;
+		if (op == "==")
+			result.boolFunc = [l, r] (const char *rec) {return l (rec) == r (rec);};
+		else
+			result.boolFunc = [l, r] (const char *rec) {return l (rec) != r (rec);};
+
+	} else if (lhs.type == StringExpr && rhs.type == StringExpr) {
+		if (op == "<")
+			result.boolFunc = buildStringCompare <less <int>> (lhs.stringFunc, rhs.stringFunc);
+		else if (op == ">")
+			result.boolFunc = buildStringCompare <greater <int>> (lhs.stringFunc, rhs.stringFunc);
+		else if (op == "==")
+			result.boolFunc = buildStringCompare <equal_to <int>> (lhs.stringFunc, rhs.stringFunc);
+		else
+			result.boolFunc = buildStringCompare <not_equal_to <int>> (lhs.stringFunc, rhs.stringFunc);
+
+	} else {
+		cout << "This is bad... cannot do anything with the " << op << ".\n";
+		exit (1);
+	}
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: logical (char op, Node &lhs, Node &rhs) {
+
+	if (lhs.type != BoolExpr || rhs.type != BoolExpr) {
+		cout << "This is bad... cannot do and/or on non booleans.\n";
+		exit (1);
+	}
+
+	Node result;
+	result.type = BoolExpr;
+	result.isConst = false;
+	result.fixedOffset = -1;
+	MyDB_BoolFunc l = lhs.boolFunc, r = rhs.boolFunc;
+	if (op == '&')
+		result.boolFunc = [l, r] (const char *rec) {return l (rec) && r (rec);};
+	else
+		result.boolFunc = [l, r] (const char *rec) {return l (rec) || r (rec);};
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: unaryMinus (Node &lhs) {
+
+	Node result;
+	result.isConst = false;
+	result.fixedOffset = -1;
+	if (lhs.type == IntExpr) {
+		MyDB_IntFunc l = lhs.intFunc;
+		result.type = IntExpr;
+		result.intFunc = [l] (const char *rec) {return -l (rec);};
+		promote (result);
+	} else if (lhs.type == DoubleExpr) {
+		MyDB_DoubleFunc l = lhs.doubleFunc;
+		result.type = DoubleExpr;
+		result.doubleFunc = [l] (const char *rec) {return -l (rec);};
+	} else {
+		cout << "This is bad... cannot do anything with the unary minus.\n";
+		exit (1);
+	}
+	return result;
+}
+
+MyDB_TypedExpr :: Node MyDB_TypedExpr :: nott (Node &lhs) {
+
+	if (lhs.type != BoolExpr) {
+		cout << "This is bad... cannot do not on non boolean.\n";
+		exit (1);
+	}
+
+	Node result;
+	result.type = BoolExpr;
+	result.isConst = false;
+	result.fixedOffset = -1;
+	MyDB_BoolFunc l = lhs.boolFunc;
+	result.boolFunc = [l] (const char *rec) {return !l (rec);};
+	return result;
+}
+
+#endif
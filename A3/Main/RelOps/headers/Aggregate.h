@@ -0,0 +1,176 @@
+
+#ifndef AGG_H
+#define AGG_H
+
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// the aggregates that can be computed
+enum MyDB_AggType {sumAgg, avgAgg, cntAgg};
+
+// This class encapsulates a hash aggregation (a GROUP BY).  Each group's partial aggregate
+// (the group's key, and a running sum and count for each aggregate) is kept as a record on a
+// pinned anonymous page, and an open-addressed hash table of (hash, page, offset) slots finds
+// the group for each input record; the sums and counts are fixed-size, so a partial aggregate
+// is updated in place on its page.
+//
+// The partial aggregates can use up to half of the buffer.  If there are more groups than that,
+// all of the partial aggregates are written out to partitions (by the hash of the group key) on
+// unpinned anonymous pages, and the aggregation starts over with an empty table; at the end,
+// each partition is aggregated again, by merging the partial aggregates in it.
+//
+// Since partial aggregates can be merged, the aggregation can also be split up: runPartial ()
+// aggregates part of the input into partial aggregates, and mergePartials () merges the results
+// of any number of those into the final answer.  Note that one Aggregate object should not be
+// used by more than one thread at a time.
+//
+// For example, to get the number of suppliers and their average balance in each nation:
+//
+//	Aggregate myOp (supplierTable, outputTable, {make_pair (cntAgg, ""), make_pair (avgAgg,
+//		"[acctbal]")}, {"[nationkey]"}, "> ([acctbal], double[0.0])");
+//	myOp.run ();
+class Aggregate {
+
+public:
+
+	// This creates an aggregation over the table managed by input.  The computations and the
+	// predicate are written just like the ones sent to compileComputation:
+	//
+	// 1) groupings has the computations over the input records that make up the group key.
+	//    If it is empty, there is one group (as long as there is at least one input record).
+	// 2) aggsToCompute has the aggregates to compute for each group; each is a computation
+	//    over the input records, and what to do with it (for cntAgg, the computation is not used)
+	// 3) selectionPredicate is over the input records; a record that does not satisfy it is
+	//    not aggregated.  An empty string means that there is no predicate.
+	//
+	// For each group, one record is appended to output: the attributes of output are the group
+	// key, followed by the aggregates, so output has to have groupings.size () +
+	// aggsToCompute.size () attributes (an average always comes out as a double)
+	Aggregate (MyDB_TableReaderWriterPtr input, MyDB_TableReaderWriterPtr output,
+		vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings, string selectionPredicate);
+
+	// execute the aggregation
+	void run ();
+
+	// like the above, except that the aggregation is over any records: inputSchema is the
+	// schema of the records that are aggregated, and outputSchema that of the records that
+	// come out.  Only run (inputIter, emit) can be used with this one
+	Aggregate (MyDB_BufferManagerPtr myMgr, MyDB_SchemaPtr inputSchema, MyDB_SchemaPtr outputSchema,
+		vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings, string selectionPredicate);
+
+	// aggregates the records from inputIter, and calls emit on each output record (the record
+	// is reused, so emit has to copy it if it wants to keep it)
+	void run (MyDB_RecordIteratorAltPtr inputIter, function <void (MyDB_RecordPtr)> emit);
+
+	// the partial aggregates can use up to half of the buffer; this lowers that to the given
+	// number of pages, for when other operators are holding pages at the same time
+	void setBudget (size_t numPages);
+
+	// the schema of the partial aggregates: the group key, and then a running sum and a count
+	// for each aggregate
+	MyDB_SchemaPtr getPartialSchema ();
+
+	// aggregates the input records on pages lowPage through highPage (inclusive) into partial
+	// aggregates, which are appended to partialOutput... partialOutput must have the schema from
+	// getPartialSchema (), and it may have more than one partial aggregate for a group
+	void runPartial (int lowPage, int highPage, MyDB_TableReaderWriterPtr partialOutput);
+
+	// merges the partial aggregates in all of the given tables, writing the final answer to output
+	void mergePartials (vector <MyDB_TableReaderWriterPtr> partials);
+
+	// like the above, except that the partial aggregates come from the given iterators
+	void mergePartials (vector <MyDB_RecordIteratorAltPtr> partials);
+
+private:
+
+	// one slot in the hash table... whichPage is -1 if the slot is empty
+	struct Slot {
+		size_t hash;
+		int whichPage;
+		int offset;
+	};
+
+	// the partial aggregates that are in RAM
+	struct GroupTable {
+		vector <Slot> slots;
+		size_t numGroups;
+		vector <MyDB_PageReaderWriter> pages;
+	};
+
+	// compiles all of the computations... this is done before any aggregation
+	void setUp ();
+
+	// aggregates all of the records from the iterators... if fromPartials is true, these are
+	// partial aggregates; otherwise, they are input records (that have not been checked against
+	// the selection predicate).  If partialOut is not nullptr, the results are written to it as
+	// partial aggregates; otherwise, they are final.  depth is the number of times that the
+	// records have been split into partitions
+	void aggregate (vector <MyDB_RecordIteratorAltPtr> iters, bool fromPartials,
+		MyDB_TableReaderWriterPtr partialOut, int depth);
+
+	// finds the group that the current record (in inRec or otherRec) belongs to, updating it
+	// if it is there; returns false if there is no such group yet
+	bool update (GroupTable &table, size_t hash, bool fromPartial);
+
+	// adds a new group for the current record... returns false if there is no room
+	bool insert (GroupTable &table, size_t hash, bool fromPartial);
+
+	// empties out the table
+	void clear (GroupTable &table);
+
+	// the hash of the group key of the current input record, partial aggregate, or group
+	size_t inputHash ();
+	size_t partialHash (MyDB_RecordPtr fromMe);
+
+	// the tables (which are nullptr if this is not over tables), the schemas, and where the
+	// output records go
+	MyDB_TableReaderWriterPtr input;
+	MyDB_TableReaderWriterPtr output;
+	MyDB_SchemaPtr inputSchema;
+	MyDB_SchemaPtr outputSchema;
+	function <void (MyDB_RecordPtr)> emit;
+	MyDB_BufferManagerPtr myMgr;
+	vector <pair <MyDB_AggType, string>> aggsToCompute;
+	vector <string> groupings;
+	string selectionPredicate;
+
+	// the budget from setBudget (), or zero if there is none
+	size_t maxPages;
+
+	// these are all set up by setUp ()... the records, and the funcs compiled over them, are
+	// made in the arena, which is freed (all at once) when the aggregation is destroyed
+	bool isSetUp;
+	MyDB_ArenaPtr arena;
+	size_t budget;
+	MyDB_SchemaPtr partialSchema;
+
+	// the input record, the group being updated, another partial aggregate (that is being merged
+	// into the group), and records that are made up of the first and the second, and the third
+	// and the second, which the computations that update a group are compiled over
+	MyDB_RecordPtr inRec;
+	MyDB_RecordPtr groupRec;
+	MyDB_RecordPtr otherRec;
+	MyDB_RecordPtr inputAndGroup;
+	MyDB_RecordPtr otherAndGroup;
+
+	// used to go through the groups when they are written out
+	MyDB_RecordPtr spillRec;
+	MyDB_RecordPtr outRec;
+
+	func inputPred;
+	vector <func> groupFuncs;
+	func inputMatches;
+	func otherMatches;
+	vector <func> inputUpdates;
+	vector <func> otherUpdates;
+};
+
+#endif
@@ -0,0 +1,103 @@
+
+#ifndef HASH_JOIN_H
+#define HASH_JOIN_H
+
+#include "JoinHashTable.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This class encapsulates a Grace hash join, for inputs that are not sorted on the join key.
+//
+// The left input is the build side.  Its records are put into a JoinHashTable, which copies
+// them into pinned anonymous pages, up to a budget of half of the buffer.  If the whole left input fits, the right input is
+// then scanned once, and each right record is looked up in the hash table.
+//
+// If the left input does not fit, both inputs are split into partitions (using the hash of the
+// key) that are written to unpinned anonymous pages, and each pair of partitions is then joined
+// in the same way, splitting it again if needed.  A partition that is still too big after a few
+// rounds of this (say, because one key has more records than fit in the budget) is joined as a
+// block nested-loop join: one budget's worth of its left records at a time is put into a hash
+// table, and the right partition is scanned for each.
+//
+// For example, to join supplier with itself on nationkey, where the output has the two keys:
+//
+//	HashJoin myOp (leftTable, rightTable, outputTable, "< ([l_suppkey], [r_suppkey])",
+//		{"[l_suppkey]", "[r_suppkey]"}, {make_pair ("[l_nationkey]", "[r_nationkey]")},
+//		"> ([l_acctbal], double[0.0])", "");
+//	myOp.run ();
+class HashJoin {
+
+public:
+
+	// This creates a hash join of the tables managed by leftInput and rightInput.  The arguments
+	// are just like the ones to SortMergeJoin, except that there can be any number of equality
+	// checks: a left and a right record are joined if, for each pair in equalityChecks, the
+	// first computation over the left record is equal to the second one over the right record
+	HashJoin (MyDB_TableReaderWriterPtr leftInput, MyDB_TableReaderWriterPtr rightInput,
+		MyDB_TableReaderWriterPtr output, string finalSelectionPredicate,
+		vector <string> projections, vector <pair <string, string>> equalityChecks,
+		string leftSelectionPredicate, string rightSelectionPredicate);
+
+	// execute the join
+	void run ();
+
+private:
+
+	// gets a new iterator over one of the inputs (or one partition of one)
+	typedef function <MyDB_RecordIteratorAltPtr ()> IterSource;
+
+	// joins all of the left records from leftSource with all of the right ones from
+	// rightSource... checkPreds is true at the top level, where the selection predicates
+	// have not been applied yet, and depth is the number of times the inputs have been split
+	void join (IterSource leftSource, IterSource rightSource, bool checkPreds, int depth);
+
+	// empties the hash table, and puts left records from leftIter into it, until the budget is
+	// used up.  Returns true if there are more left records (in which case the first of them
+	// is the current record of leftIter, and pending is set, so that the next call starts
+	// with it)
+	bool loadBuildSide (MyDB_RecordIteratorAltPtr leftIter, bool checkPreds, bool &pending);
+
+	// scans the right records from rightIter, joining each with the records in the hash table
+	void probe (MyDB_RecordIteratorAltPtr rightIter, bool checkPreds);
+
+	// appends the record to the list of anonymous pages
+	void appendToList (vector <MyDB_PageReaderWriter> &list, MyDB_RecordPtr appendMe);
+
+	MyDB_TableReaderWriterPtr leftTable;
+	MyDB_TableReaderWriterPtr rightTable;
+	MyDB_TableReaderWriterPtr output;
+	string finalSelectionPredicate;
+	vector <string> projections;
+	vector <pair <string, string>> equalityChecks;
+	string leftSelectionPredicate;
+	string rightSelectionPredicate;
+
+	// these are all set up by run ()... the records are what the join works over, and the
+	// funcs are compiled over them; both are made in the arena, which is freed (all at once)
+	// when the join is run again or destroyed
+	MyDB_BufferManagerPtr myMgr;
+	size_t budget;
+	MyDB_ArenaPtr arena;
+	MyDB_RecordPtr leftRec;
+	MyDB_RecordPtr rightRec;
+	MyDB_RecordPtr combinedRec;
+	MyDB_RecordPtr outRec;
+	func leftPred;
+	func rightPred;
+	func keysMatch;
+	func finalPred;
+	vector <func> leftKeys;
+	vector <func> rightKeys;
+	vector <func> finalComputations;
+
+	// the hash table over the left records
+	JoinHashTable table;
+};
+
+#endif
@@ -0,0 +1,102 @@
+
+#ifndef JOIN_HASH_TABLE_H
+#define JOIN_HASH_TABLE_H
+
+#include "MyDB_BufferManager.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This is the hash table over the build side of a hash join, along with the other parts that
+// HashJoin and HashJoinOp have in common (hashing the keys, and the predicate that checks that
+// two records' keys really are equal).  The records are copied into pinned anonymous pages, up
+// to a budget of pages, and the table holds only the hash of each record's key and the
+// record's location (a page and an offset on that page), so building it allocates no records.
+// For example:
+//
+//	bool pending = false;
+//	table.load (myMgr, budget, [&] () {...load the next build record into buildRec...},
+//		buildRec, buildKeys, pending);
+//	table.startProbe (JoinHashTable :: hashKeys (probeKeys));
+//	while (table.nextMatch (buildRec))
+//		... buildRec is a build record with the same hash ...
+class JoinHashTable {
+
+public:
+
+	// empties the table, and lets go of its pages; records will be copied into pages from
+	// myMgr, using no more than budget of them
+	void reset (MyDB_BufferManagerPtr myMgr, size_t budget);
+
+	// copies the record into the pinned pages, and puts it into the table under the given
+	// hash... returns false (and does not add the record) if the budget is used up
+	bool add (MyDB_RecordPtr addMe, size_t hash);
+
+	// puts the records added so far into buckets; this must be called before probing
+	void finish ();
+
+	// empties the table (just like reset ()), and then adds records to it until it is full,
+	// and calls finish ().  nextRecord loads the next record into addMe, returning false if
+	// there are no more, and the hash of each is found by hashKeys (keys)... if pending is
+	// true, then the record in addMe did not fit last time, and it goes in first.  Returns
+	// true (and sets pending) if the table filled up before nextRecord ran out, in which case
+	// the record in addMe is the one that did not fit
+	bool load (MyDB_BufferManagerPtr myMgr, size_t budget, function <bool ()> nextRecord,
+		MyDB_RecordPtr addMe, vector <func> &keys, bool &pending);
+
+	// starts looking for the records with the given hash
+	void startProbe (size_t hash);
+
+	// loads the next record with the hash given to startProbe into intoMe, returning false
+	// if there are no more (different keys can have the same hash, so the caller still has
+	// to check that the keys are equal)
+	bool nextMatch (MyDB_RecordPtr intoMe);
+
+	// the number of records in the table, and the pages that they are on
+	size_t size ();
+	vector <MyDB_PageReaderWriter> &getPages ();
+
+	// the hash of a record's key, from the computations that make up the key
+	static size_t hashKeys (vector <func> &keys);
+
+	// the computation that checks whether, for each pair in equalityChecks, the first
+	// computation is equal to the second one (this is compiled over a record that has both
+	// the build and the probe attributes, since records with the same hash may not match)
+	static string matchPredicate (vector <pair <string, string>> &equalityChecks);
+
+	// scrambles a hash... the buckets are picked with the seed bucketSeed, so anyone splitting
+	// records up (say, into partitions) with mix should use smaller seeds, so that the
+	// records in a partition are not all put in the same few buckets
+	static size_t mix (size_t hash, size_t seed);
+	static const size_t bucketSeed = 64;
+
+private:
+
+	// where a record in the table is, and the hash of its key... next is the position of the
+	// next entry in the same bucket, or -1
+	struct Entry {
+		size_t hash;
+		int whichPage;
+		int offset;
+		int next;
+	};
+
+	MyDB_BufferManagerPtr myMgr;
+	size_t budget = 0;
+	vector <MyDB_PageReaderWriter> pages;
+	vector <char *> pageBytes;
+	vector <int> buckets;
+	vector <Entry> entries;
+
+	// where we are in the probe: the hash we are looking for, and the next entry in its
+	// bucket to check (or -1)
+	size_t probeHash = 0;
+	int nextEntry = -1;
+};
+
+#endif
@@ -0,0 +1,117 @@
+
+#ifndef MORSEL_SCAN_H
+#define MORSEL_SCAN_H
+
+#include "Aggregate.h"
+#include "MyDB_Record.h"
+#include "MyDB_TableReaderWriter.h"
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This class scans a table with several threads.  The table is cut up into morsels (small
+// ranges of pages), and each worker thread has its own queue of morsels, which starts out with
+// one contiguous part of the table, so that each worker mostly reads pages that are next to
+// one another.  A worker takes morsels from the front of its own queue; once that is empty, it
+// steals morsels from the back of the queue of the worker with the most left, so that all of
+// the workers keep busy until the whole table is done, even if some morsels take longer.
+//
+// The buffer manager is not thread-safe, so the workers take turns getting pages out of it:
+// a worker copies all of the pages in its morsel into memory of its own (just like the threads
+// in loadFromTextFile () work on page images outside of the buffer), and then runs its part
+// of the pipeline over those records without holding anything.  Note that this means that
+// all of the page I/O is done one morsel at a time, by whichever worker holds the lock, so a
+// scan can only go as fast as one thread can get pages out of the buffer; getLockedMillis ()
+// says how much of the time went to that.
+//
+// For example, to count the suppliers with a balance over 9000, on four threads:
+//
+//	MorselScan myScan (supplierTable, 4);
+//	vector <size_t> counts (4);
+//	myScan.run ("> ([acctbal], double[9000.0])", [&] (int whichWorker, MyDB_RecordPtr) {
+//		counts[whichWorker]++;
+//	});
+class MorselScan {
+
+public:
+
+	// sets up a scan of the table managed by input, with numWorkers threads (by default, one
+	// per core), where each morsel has morselSize pages
+	MorselScan (MyDB_TableReaderWriterPtr input, int numWorkers = 0, int morselSize = 4);
+
+	// the number of workers, and the record that the given worker loads each input record
+	// into... computations that a worker uses in processMe should be compiled over its record
+	// ahead of time, since compiling is not thread-safe
+	int getNumWorkers ();
+	MyDB_RecordPtr getRecord (int whichWorker);
+
+	// runs processMe on every record in the table that satisfies the selection predicate
+	// (which is written just like the ones sent to compileComputation; an empty string means
+	// that there is no predicate).  processMe is called on the worker threads, with the
+	// worker's number and its record; calls with different worker numbers can happen at the
+	// same time, so processMe should only touch things that belong to that worker
+	void run (string selectionPredicate, function <void (int, MyDB_RecordPtr)> processMe);
+
+	// a parallel version of Aggregate (see Aggregate.h, which explains the arguments): each
+	// worker aggregates the records that it scans into partial aggregates in RAM.  The workers
+	// share half of the buffer's worth of RAM for these; when a worker runs out of its share,
+	// it writes its partial aggregates out to anonymous pages (holding the buffer lock), and
+	// starts over.  All of the partial aggregates from all of the workers are then merged on
+	// this thread by an Aggregate, which spills them to partitions if it needs to, and written
+	// to output
+	void aggregate (MyDB_TableReaderWriterPtr output, vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings, string selectionPredicate);
+
+	// for the last run: the number of morsels that each worker ran, and how many of those
+	// were stolen from another worker's queue
+	vector <size_t> getMorselsRun ();
+	size_t getNumStolen ();
+
+	// for the last run: the total time that the workers spent holding the buffer lock (copying
+	// pages, or writing out partial aggregates), in milliseconds... since only one worker can
+	// hold the lock at a time, the run took at least this long
+	double getLockedMillis ();
+
+	// for the last aggregate: the number of times that a worker ran out of RAM, and wrote its
+	// partial aggregates out to pages
+	size_t getNumSpilled ();
+
+private:
+
+	// one worker's queue of morsels (each is the number of its first page)
+	struct MorselQueue {
+		mutex lock;
+		deque <int> morsels;
+	};
+
+	// gets the next morsel for the given worker, from its own queue or another one... returns
+	// false if there are none left anywhere
+	bool nextMorsel (int whichWorker, int &firstPage);
+
+	// what each worker thread does
+	void work (int whichWorker, func pred, function <void (int, MyDB_RecordPtr)> processMe);
+
+	MyDB_TableReaderWriterPtr input;
+	int numWorkers;
+	int morselSize;
+	size_t pageSize;
+	vector <MyDB_RecordPtr> records;
+
+	// the queues, and the lock that a worker holds while it is getting pages out of the buffer
+	vector <MorselQueue> queues;
+	mutex bufferLock;
+
+	// the statistics for the last run... each worker only touches its own spot
+	vector <size_t> morselsRun;
+	vector <size_t> stolen;
+	vector <chrono::steady_clock::duration> lockedFor;
+	vector <size_t> spilled;
+};
+
+#endif
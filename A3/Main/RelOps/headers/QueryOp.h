@@ -0,0 +1,304 @@
+
+#ifndef QUERY_OP_H
+#define QUERY_OP_H
+
+#include "Aggregate.h"
+#include "JoinHashTable.h"
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_TableReaderWriter.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// These classes are a pull-based (Volcano-style) query executor.  Each operator produces one
+// record at a time, pulling records from its children as it needs them, so records flow from
+// one operator to the next without going through intermediate tables.  For example, to get
+// the sum of the balances of the suppliers in each nation, for the nations with a supplier
+// whose balance is over 9000:
+//
+//	QueryOpPtr plan = make_shared <AggregateOp> (
+//		make_shared <FilterOp> (make_shared <ScanOp> (supplierTable), "> ([acctbal], double[9000.0])"),
+//		outSchema, vector <pair <MyDB_AggType, string>> {make_pair (sumAgg, "[acctbal]")},
+//		vector <string> {"[nationkey]"});
+//	plan->open ();
+//	while (plan->next ())
+//		cout << plan->getRecord () << "\n";
+//	plan->close ();
+//	cout << plan->getProfile ();
+//
+// Each operator's output is in the record returned by getRecord (), which is reused for every
+// record that the operator produces (and that, for some operators, is the same record as the
+// child's).  An operator that cannot produce anything until it has seen all of its input
+// (sort, aggregate, and the build side of a join) does that work in open (), and holds what
+// it has built on anonymous pages; everything else is pipelined.
+//
+// Each operator counts the records it produces and the time spent in it (and its children),
+// and getProfile () gives these for the whole tree.
+class QueryOp;
+typedef shared_ptr <QueryOp> QueryOpPtr;
+
+class QueryOp {
+
+public:
+
+	// gets ready to produce records
+	void open ();
+
+	// moves to the next output record, which is then in getRecord ()... returns false if
+	// there are no more
+	bool next ();
+
+	// lets go of everything that this operator (and its children) are holding onto
+	void close ();
+
+	// the record that holds the current output record, and its schema
+	MyDB_RecordPtr getRecord ();
+	MyDB_SchemaPtr getSchema ();
+
+	// the number of records produced so far, and the time spent in open () and next () in
+	// this operator and its children, in milliseconds
+	size_t getNumRecords ();
+	double getMillis ();
+
+	// a description of the tree of operators rooted at this one, with one line for each
+	// operator that has its name, the number of records it produced, and the time spent in it
+	// (both with and without the time spent in its children)
+	string getProfile ();
+
+	// appends all of the records produced by this operator to the given table (this opens and
+	// closes the operator)
+	void appendAllTo (MyDB_TableReaderWriterPtr appendToMe);
+
+	virtual ~QueryOp ();
+
+protected:
+
+	// these are what the operators actually implement, and are the same as the above
+	virtual void doOpen () = 0;
+	virtual bool doNext () = 0;
+	virtual void doClose ();
+
+	// the name of the operator, for the profile
+	virtual string getName () = 0;
+
+	// adds an input to this operator... the operator uses the same buffer manager as its inputs
+	void addChild (QueryOpPtr child);
+
+	// the number of pages that this operator can use for what it builds... this is half of
+	// the buffer, halved again for each operator below this one that holds pages, so that all
+	// of the operators in a plan fit in the buffer together
+	size_t getBudget ();
+
+	// appends a record to a list of anonymous pages
+	static void appendToList (vector <MyDB_PageReaderWriter> &list, MyDB_BufferManagerPtr myMgr,
+		MyDB_RecordPtr appendMe);
+
+	// the inputs to this operator, the output record, and the buffer manager that this
+	// operator uses (the one of the tables at the leaves)
+	vector <QueryOpPtr> children;
+	MyDB_RecordPtr output;
+	MyDB_BufferManagerPtr myMgr;
+
+	// true for an operator that holds pages between calls to next () (see getBudget ())
+	bool holdsPages = false;
+
+private:
+
+	// the number of operators below this one that hold pages
+	size_t numHoldingBelow ();
+
+	// adds the lines for this operator (and its children) to the profile
+	void addToProfile (string &profile, int indent);
+
+	size_t numRecords = 0;
+	chrono::steady_clock::duration timeSpent = chrono::steady_clock::duration :: zero ();
+};
+
+// gets the records from a table
+class ScanOp : public QueryOp {
+
+public:
+
+	ScanOp (MyDB_TableReaderWriterPtr scanMe);
+
+protected:
+
+	void doOpen () override;
+	bool doNext () override;
+	void doClose () override;
+	string getName () override;
+
+private:
+
+	MyDB_TableReaderWriterPtr table;
+	MyDB_RecordIteratorAltPtr iter;
+};
+
+// passes along the records from the child that satisfy the predicate (which is written just
+// like the ones sent to compileComputation)... the output record is the child's record
+class FilterOp : public QueryOp {
+
+public:
+
+	FilterOp (QueryOpPtr child, string predicate);
+
+protected:
+
+	void doOpen () override;
+	bool doNext () override;
+	string getName () override;
+
+private:
+
+	string predicate;
+	func pred;
+};
+
+// for each record from the child, produces a record with the given schema, whose attributes
+// are the results of the given computations over the child's record
+class ProjectOp : public QueryOp {
+
+public:
+
+	ProjectOp (QueryOpPtr child, MyDB_SchemaPtr outSchema, vector <string> computations);
+
+protected:
+
+	void doOpen () override;
+	bool doNext () override;
+	string getName () override;
+
+private:
+
+	vector <func> computations;
+};
+
+// sorts the records from the child on the result of the given computation, using the TPMMS
+// from Sorting.h... the child's records are copied into anonymous pages and sorted into runs
+// in open (), and the runs are merged as records are asked for
+class SortOp : public QueryOp {
+
+public:
+
+	SortOp (QueryOpPtr child, string sortOn);
+
+protected:
+
+	void doOpen () override;
+	bool doNext () override;
+	void doClose () override;
+	string getName () override;
+
+private:
+
+	string sortOn;
+	MyDB_RecordPtr lhs;
+	MyDB_RecordPtr rhs;
+	vector <MyDB_PageReaderWriter> pages;
+	MyDB_RecordIteratorAltPtr iter;
+};
+
+// joins the records from the two children: a left and a right record are joined if, for
+// each pair in equalityChecks, the first computation over the left record is equal to the
+// second one over the right record.  The output record is made up of the left record's
+// attributes, then the right record's (so the two should not have any names in common).
+//
+// In open (), the left records are put into a JoinHashTable (using up to half of the buffer); the right records are then pipelined
+// through, with each being joined with the matching left records.  If the left records do
+// not all fit, the right records are copied to anonymous pages instead, and joined with one
+// buffer's worth of left records at a time
+class HashJoinOp : public QueryOp {
+
+public:
+
+	HashJoinOp (QueryOpPtr left, QueryOpPtr right, vector <pair <string, string>> equalityChecks);
+
+protected:
+
+	void doOpen () override;
+	bool doNext () override;
+	void doClose () override;
+	string getName () override;
+
+private:
+
+	// empties the hash table, and puts left records into it, until there are no more or it
+	// is full... returns true if there are more left records (the first of which is the left child's
+	// current record)
+	bool loadBuildSide ();
+
+	// moves to the next right record; returns false if there are no more
+	bool nextProbe ();
+
+	vector <pair <string, string>> equalityChecks;
+	vector <func> leftKeys;
+	vector <func> rightKeys;
+	func keysMatch;
+
+	// the left record from the hash table, which is part of the output record
+	MyDB_RecordPtr buildRec;
+
+	// the hash table over the left records
+	JoinHashTable table;
+
+	// true if the left child has a record that has not been put into the hash table yet
+	bool leftPending;
+
+	// if the left records did not all fit, the right records are here
+	bool rightCopied;
+	vector <MyDB_PageReaderWriter> rightPages;
+	MyDB_RecordIteratorAltPtr rightIter;
+
+	// true if the hash table is being probed with the right child's current record
+	bool probing;
+};
+
+// a hash aggregation (see Aggregate.h) of the records from the child... the output records
+// have the given schema, which has the group key, then the aggregates
+class AggregateOp : public QueryOp {
+
+public:
+
+	AggregateOp (QueryOpPtr child, MyDB_SchemaPtr outSchema, vector <pair <MyDB_AggType, string>> aggsToCompute,
+		vector <string> groupings);
+
+protected:
+
+	void doOpen () override;
+	bool doNext () override;
+	void doClose () override;
+	string getName () override;
+
+private:
+
+	vector <pair <MyDB_AggType, string>> aggsToCompute;
+	vector <string> groupings;
+	vector <MyDB_PageReaderWriter> pages;
+	MyDB_RecordIteratorAltPtr iter;
+};
+
+// lets a QueryOp be used anywhere that a MyDB_RecordIteratorAlt can be... each record from the
+// operator is copied into a buffer, and getCurrent () loads it from there
+class QueryOpIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+	QueryOpIteratorAlt (QueryOpPtr iterateOverMe);
+
+	void getCurrent (MyDB_RecordPtr intoMe) override;
+	void *getCurrentPointer () override;
+	bool advance () override;
+
+private:
+
+	QueryOpPtr op;
+	vector <char> buffer;
+};
+
+#endif
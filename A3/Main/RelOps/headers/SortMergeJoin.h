@@ -0,0 +1,66 @@
+
+#ifndef SORTMERGE_H
+#define SORTMERGE_H
+
+#include "MyDB_TableReaderWriter.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// This class encapsulates a sort-merge join.  Each input is sorted on its join key, using the
+// first phase of the TPMMS in Sorting.h (each run is runSize pages, where runSize is half of
+// the buffer), but the sorted runs are never written out: the runs from both inputs are merged
+// on the fly as the join walks through them.  All of the left records that have the same key
+// are copied into pinned anonymous pages, and then each right record with that key is joined
+// with each of them; so the left records that share any one key must fit into the buffer.
+//
+// Note that, just like sort (), this sorts the records on each of the input's pages in place.
+//
+// For example, to join supplier with itself on nationkey, where the output has the two keys:
+//
+//	SortMergeJoin myOp (leftTable, rightTable, outputTable, "< ([l_suppkey], [r_suppkey])",
+//		{"[l_suppkey]", "[r_suppkey]"}, make_pair ("[l_nationkey]", "[r_nationkey]"),
+//		"> ([l_acctbal], double[0.0])", "");
+//	myOp.run ();
+class SortMergeJoin {
+
+public:
+
+	// This creates a sort-merge join of the tables managed by leftInput and rightInput.  The
+	// predicates and computations are all written just like the ones sent to compileComputation:
+	//
+	// 1) equalityCheck is the join key: the first entry is a computation over the left input's
+	//    attributes, and the second is one over the right input's, and a left and a right
+	//    record are joined if the two are equal.
+	// 2) leftSelectionPredicate and rightSelectionPredicate are over the attributes of the
+	//    left and right inputs; a record that does not satisfy its predicate is not joined
+	//    with anything.  An empty string means that there is no predicate.
+	// 3) finalSelectionPredicate is over the attributes of both inputs (which is why the two
+	//    inputs should not have any attribute names in common), and must be satisfied by a
+	//    pair of records for them to be written out.  Again, it can be empty.
+	// 4) projections has one computation over the attributes of both inputs for each of the
+	//    attributes of the output table, in order; for each pair of records that are joined,
+	//    a record with the results of those computations is appended to output
+	SortMergeJoin (MyDB_TableReaderWriterPtr leftInput, MyDB_TableReaderWriterPtr rightInput,
+		MyDB_TableReaderWriterPtr output, string finalSelectionPredicate,
+		vector <string> projections, pair <string, string> equalityCheck,
+		string leftSelectionPredicate, string rightSelectionPredicate);
+
+	// execute the join
+	void run ();
+
+private:
+
+	MyDB_TableReaderWriterPtr leftTable;
+	MyDB_TableReaderWriterPtr rightTable;
+	MyDB_TableReaderWriterPtr output;
+	string finalSelectionPredicate;
+	vector <string> projections;
+	pair <string, string> equalityCheck;
+	string leftSelectionPredicate;
+	string rightSelectionPredicate;
+};
+
+#endif
@@ -0,0 +1,396 @@
+
+#ifndef AGG_CC
+#define AGG_CC
+
+#include <algorithm>
+#include <iostream>
+#include "Aggregate.h"
+#include "JoinHashTable.h"
+
+// the number of times that the records can be split into partitions... this is only reached
+// if lots of different group keys have the same hash.  The partitions at each level and the
+// slots are picked with JoinHashTable :: mix, using the depth (or MAX_DEPTH + 1) as the seed,
+// so that they are not all picked using the same bits
+#define MAX_DEPTH 8
+
+Aggregate :: Aggregate (MyDB_TableReaderWriterPtr inputIn, MyDB_TableReaderWriterPtr outputIn,
+	vector <pair <MyDB_AggType, string>> aggsToComputeIn,
+	vector <string> groupingsIn, string selectionPredicateIn) {
+
+	input = inputIn;
+	output = outputIn;
+	myMgr = input->getBufferMgr ();
+	inputSchema = input->getTable ()->getSchema ();
+	outputSchema = output->getTable ()->getSchema ();
+	aggsToCompute = aggsToComputeIn;
+	groupings = groupingsIn;
+	selectionPredicate = (selectionPredicateIn == "") ? "bool[true]" : selectionPredicateIn;
+	isSetUp = false;
+	maxPages = 0;
+	emit = [outputIn] (MyDB_RecordPtr outRec) {outputIn->append (outRec);};
+}
+
+Aggregate :: Aggregate (MyDB_BufferManagerPtr myMgrIn, MyDB_SchemaPtr inputSchemaIn, MyDB_SchemaPtr outputSchemaIn,
+	vector <pair <MyDB_AggType, string>> aggsToComputeIn,
+	vector <string> groupingsIn, string selectionPredicateIn) {
+
+	input = nullptr;
+	output = nullptr;
+	myMgr = myMgrIn;
+	inputSchema = inputSchemaIn;
+	outputSchema = outputSchemaIn;
+	aggsToCompute = aggsToComputeIn;
+	groupings = groupingsIn;
+	selectionPredicate = (selectionPredicateIn == "") ? "bool[true]" : selectionPredicateIn;
+	isSetUp = false;
+	maxPages = 0;
+}
+
+void Aggregate :: setBudget (size_t numPages) {
+	maxPages = max ((size_t) 1, numPages);
+	if (isSetUp)
+		budget = maxPages;
+}
+
+MyDB_SchemaPtr Aggregate :: getPartialSchema () {
+	setUp ();
+	return partialSchema;
+}
+
+void Aggregate :: run () {
+	setUp ();
+	if (input == nullptr) {
+		cout << "This is bad... this aggregation was not set up over a table.\n";
+		exit (1);
+	}
+	aggregate ({input->getIteratorAlt ()}, false, nullptr, 0);
+}
+
+void Aggregate :: run (MyDB_RecordIteratorAltPtr inputIter, function <void (MyDB_RecordPtr)> emitIn) {
+	setUp ();
+	emit = emitIn;
+	aggregate ({inputIter}, false, nullptr, 0);
+}
+
+void Aggregate :: runPartial (int lowPage, int highPage, MyDB_TableReaderWriterPtr partialOutput) {
+	setUp ();
+	if (input == nullptr) {
+		cout << "This is bad... this aggregation was not set up over a table.\n";
+		exit (1);
+	}
+	aggregate ({input->getIteratorAlt (lowPage, highPage)}, false, partialOutput, 0);
+}
+
+void Aggregate :: mergePartials (vector <MyDB_TableReaderWriterPtr> partials) {
+	setUp ();
+	if (output == nullptr) {
+		cout << "This is bad... this aggregation was not set up over a table.\n";
+		exit (1);
+	}
+	vector <MyDB_RecordIteratorAltPtr> iters;
+	for (auto &partial : partials)
+		iters.push_back (partial->getIteratorAlt ());
+	aggregate (iters, true, nullptr, 0);
+}
+
+void Aggregate :: mergePartials (vector <MyDB_RecordIteratorAltPtr> partials) {
+	setUp ();
+	if (output == nullptr) {
+		cout << "This is bad... this aggregation was not set up over a table.\n";
+		exit (1);
+	}
+	aggregate (partials, true, nullptr, 0);
+}
+
+void Aggregate :: setUp () {
+
+	if (isSetUp)
+		return;
+	isSetUp = true;
+
+	vector <pair <string, MyDB_AttTypePtr>> &outAtts = outputSchema->getAtts ();
+	if (outAtts.size () != groupings.size () + aggsToCompute.size ()) {
+		cout << "This is bad... the output of an aggregation needs one attribute per group key and aggregate.\n";
+		exit (1);
+	}
+
+	budget = (maxPages != 0) ? maxPages : max ((size_t) 1, myMgr->numPages / 2);
+
+	// the partial aggregates have the group key, and a sum and count for each aggregate... the
+	// ones being merged in have the same schema, but with different names, so that the two can
+	// be put together into one record
+	partialSchema = make_shared <MyDB_Schema> ();
+	MyDB_SchemaPtr otherSchema = make_shared <MyDB_Schema> ();
+	for (size_t i = 0; i < groupings.size (); i++) {
+		partialSchema->appendAtt (make_pair ("MyDB_Group" + to_string (i), outAtts[i].second));
+		otherSchema->appendAtt (make_pair ("MyDB_OtherGroup" + to_string (i), outAtts[i].second));
+	}
+	for (size_t i = 0; i < aggsToCompute.size (); i++) {
+		MyDB_AttTypePtr outType = outAtts[groupings.size () + i].second;
+		MyDB_AttTypePtr sumType;
+		if (aggsToCompute[i].first == sumAgg && outType->promotableToInt () && !outType->isBool ())
+			sumType = make_shared <MyDB_IntAttType> ();
+		else
+			sumType = make_shared <MyDB_DoubleAttType> ();
+		partialSchema->appendAtt (make_pair ("MyDB_Sum" + to_string (i), sumType));
+		partialSchema->appendAtt (make_pair ("MyDB_Count" + to_string (i), make_shared <MyDB_IntAttType> ()));
+		otherSchema->appendAtt (make_pair ("MyDB_OtherSum" + to_string (i), sumType));
+		otherSchema->appendAtt (make_pair ("MyDB_OtherCount" + to_string (i), make_shared <MyDB_IntAttType> ()));
+	}
+
+	MyDB_SchemaPtr inputAndGroupSchema = make_shared <MyDB_Schema> ();
+	for (auto &att : inputSchema->getAtts ())
+		inputAndGroupSchema->appendAtt (att);
+	for (auto &att : partialSchema->getAtts ())
+		inputAndGroupSchema->appendAtt (att);
+	MyDB_SchemaPtr otherAndGroupSchema = make_shared <MyDB_Schema> ();
+	for (auto &att : otherSchema->getAtts ())
+		otherAndGroupSchema->appendAtt (att);
+	for (auto &att : partialSchema->getAtts ())
+		otherAndGroupSchema->appendAtt (att);
+
+	arena = make_shared <MyDB_Arena> ();
+	inRec = makeInArena <MyDB_Record> (arena, inputSchema, arena);
+	groupRec = makeInArena <MyDB_Record> (arena, partialSchema, arena);
+	otherRec = makeInArena <MyDB_Record> (arena, otherSchema, arena);
+	inputAndGroup = makeInArena <MyDB_Record> (arena, inputAndGroupSchema, arena);
+	inputAndGroup->buildFrom (inRec, groupRec);
+	otherAndGroup = makeInArena <MyDB_Record> (arena, otherAndGroupSchema, arena);
+	otherAndGroup->buildFrom (otherRec, groupRec);
+	spillRec = makeInArena <MyDB_Record> (arena, partialSchema, arena);
+	outRec = makeInArena <MyDB_Record> (arena, outputSchema, arena);
+
+	// the computations that check whether a record is in a group
+	inputPred = inRec->compileComputation (selectionPredicate);
+	string inputMatch = "bool[true]", otherMatch = "bool[true]";
+	for (size_t i = 0; i < groupings.size (); i++) {
+		groupFuncs.push_back (inRec->compileComputation (groupings[i]));
+		inputMatch = "&& (" + inputMatch + ", == (" + groupings[i] + ", [MyDB_Group" + to_string (i) + "]))";
+		otherMatch = "&& (" + otherMatch + ", == ([MyDB_OtherGroup" + to_string (i) + "], [MyDB_Group" +
+			to_string (i) + "]))";
+	}
+	inputMatches = inputAndGroup->compileComputation (inputMatch);
+	otherMatches = otherAndGroup->compileComputation (otherMatch);
+
+	// and the ones that compute the new sum and count for a group
+	for (size_t i = 0; i < aggsToCompute.size (); i++) {
+		string sum = "[MyDB_Sum" + to_string (i) + "]", count = "[MyDB_Count" + to_string (i) + "]";
+		if (aggsToCompute[i].first == cntAgg)
+			inputUpdates.push_back (inputAndGroup->compileComputation (sum));
+		else
+			inputUpdates.push_back (inputAndGroup->compileComputation ("+ (" + sum + ", " + aggsToCompute[i].second + ")"));
+		inputUpdates.push_back (inputAndGroup->compileComputation ("+ (" + count + ", int[1])"));
+		otherUpdates.push_back (otherAndGroup->compileComputation ("+ (" + sum + ", [MyDB_OtherSum" + to_string (i) + "])"));
+		otherUpdates.push_back (otherAndGroup->compileComputation ("+ (" + count + ", [MyDB_OtherCount" + to_string (i) + "])"));
+	}
+}
+
+void Aggregate :: aggregate (vector <MyDB_RecordIteratorAltPtr> iters, bool fromPartials,
+	MyDB_TableReaderWriterPtr partialOut, int depth) {
+
+	GroupTable table;
+	table.numGroups = 0;
+	size_t numParts = max ((size_t) 2, budget - 1);
+	vector <vector <MyDB_PageReaderWriter>> parts;
+
+	// writes all of the groups in RAM out as partial aggregates... to partialOut if there is
+	// one, and to the partitions if not
+	auto spill = [&] () {
+		if (partialOut == nullptr && parts.empty ())
+			parts.resize (numParts);
+		for (auto &page : table.pages) {
+			MyDB_RecordIteratorAltPtr pageIter = page.getIteratorAlt ();
+			while (pageIter->advance ()) {
+				pageIter->getCurrent (spillRec);
+				if (partialOut != nullptr) {
+					partialOut->append (spillRec);
+					continue;
+				}
+				vector <MyDB_PageReaderWriter> &part = parts[JoinHashTable :: mix (partialHash (spillRec), depth) % numParts];
+				if (part.empty () || !part.back ().append (spillRec)) {
+					part.push_back (MyDB_PageReaderWriter (*myMgr));
+					part.back ().clear ();
+					part.back ().append (spillRec);
+				}
+			}
+		}
+		clear (table);
+	};
+
+	for (auto &iter : iters) {
+		while (iter->advance ()) {
+
+			size_t hash;
+			if (fromPartials) {
+				iter->getCurrent (otherRec);
+				hash = partialHash (otherRec);
+			} else {
+				iter->getCurrent (inRec);
+				if (!inputPred ()->toBool ())
+					continue;
+				hash = inputHash ();
+			}
+
+			if (update (table, hash, fromPartials))
+				continue;
+
+			// a new group... if there is no room for it, make room
+			if (!insert (table, hash, fromPartials)) {
+				if (partialOut == nullptr && depth >= MAX_DEPTH) {
+					cout << "This is bad... too many groups with the same hash in an aggregation.\n";
+					exit (1);
+				}
+				spill ();
+				insert (table, hash, fromPartials);
+			}
+		}
+	}
+
+	// the easy case: everything is in RAM
+	if (partialOut == nullptr && parts.empty ()) {
+		for (auto &page : table.pages) {
+			MyDB_RecordIteratorAltPtr pageIter = page.getIteratorAlt ();
+			while (pageIter->advance ()) {
+				pageIter->getCurrent (groupRec);
+				size_t numGroupAtts = groupings.size ();
+				for (size_t i = 0; i < numGroupAtts; i++)
+					outRec->getAtt (i)->set (groupRec->getAtt (i));
+				for (size_t i = 0; i < aggsToCompute.size (); i++) {
+					MyDB_AttValPtr sum = groupRec->getAtt (numGroupAtts + 2 * i);
+					MyDB_AttValPtr count = groupRec->getAtt (numGroupAtts + 2 * i + 1);
+					if (aggsToCompute[i].first == sumAgg) {
+						outRec->getAtt (numGroupAtts + i)->set (sum);
+					} else if (aggsToCompute[i].first == cntAgg) {
+						outRec->getAtt (numGroupAtts + i)->set (count);
+					} else {
+						MyDB_DoubleAttValPtr avg = make_shared <MyDB_DoubleAttVal> ();
+						avg->set (sum->toDouble () / count->toInt ());
+						outRec->getAtt (numGroupAtts + i)->set (avg);
+					}
+				}
+				outRec->recordContentHasChanged ();
+				emit (outRec);
+			}
+		}
+		clear (table);
+		return;
+	}
+
+	// otherwise, write out what is left, and (if this is not a partial aggregation) finish
+	// each partition by merging the partial aggregates in it
+	spill ();
+	for (auto &part : parts) {
+		if (part.empty ())
+			continue;
+		aggregate ({getIteratorAlt (part)}, true, nullptr, depth + 1);
+		part.clear ();
+	}
+}
+
+bool Aggregate :: update (GroupTable &table, size_t hash, bool fromPartial) {
+
+	if (table.slots.empty ())
+		return false;
+
+	size_t mask = table.slots.size () - 1;
+	for (size_t i = JoinHashTable :: mix (hash, MAX_DEPTH + 1) & mask; table.slots[i].whichPage != -1; i = (i + 1) & mask) {
+		Slot &slot = table.slots[i];
+		if (slot.hash != hash)
+			continue;
+
+		// see if this is the right group
+		void *loc = (char *) table.pages[slot.whichPage].getBytes () + slot.offset;
+		groupRec->fromBinary (loc);
+		if (!(fromPartial ? otherMatches : inputMatches) ()->toBool ())
+			continue;
+
+		// it is, so update the group in place... the sums and counts are all fixed-size, so
+		// the group's record does not change size
+		vector <func> &updates = fromPartial ? otherUpdates : inputUpdates;
+		size_t numGroupAtts = groupings.size ();
+		for (size_t j = 0; j < updates.size (); j++)
+			groupRec->getAtt (numGroupAtts + j)->set (updates[j] ());
+		groupRec->recordContentHasChanged ();
+		groupRec->toBinary (loc);
+		return true;
+	}
+	return false;
+}
+
+bool Aggregate :: insert (GroupTable &table, size_t hash, bool fromPartial) {
+
+	// set up the new group
+	size_t numGroupAtts = groupings.size ();
+	if (fromPartial) {
+		for (size_t i = 0; i < partialSchema->getAtts ().size (); i++)
+			groupRec->getAtt (i)->set (otherRec->getAtt (i));
+	} else {
+		for (size_t i = 0; i < numGroupAtts; i++)
+			groupRec->getAtt (i)->set (groupFuncs[i] ());
+		for (size_t j = 0; j < inputUpdates.size (); j++)
+			groupRec->getAtt (numGroupAtts + j)->fromInt (0);
+		for (size_t j = 0; j < inputUpdates.size (); j++)
+			groupRec->getAtt (numGroupAtts + j)->set (inputUpdates[j] ());
+	}
+	groupRec->recordContentHasChanged ();
+
+	// put it on a page
+	void *loc = table.pages.empty () ? nullptr : table.pages.back ().appendAndReturnLocation (groupRec);
+	if (loc == nullptr) {
+		if (table.pages.size () == budget)
+			return false;
+		table.pages.push_back (MyDB_PageReaderWriter (true, *myMgr));
+		table.pages.back ().clear ();
+		loc = table.pages.back ().appendAndReturnLocation (groupRec);
+	}
+
+	// and into the hash table, which is kept no more than half full
+	if (2 * (table.numGroups + 1) > table.slots.size ()) {
+		vector <Slot> oldSlots;
+		oldSlots.swap (table.slots);
+		Slot empty;
+		empty.whichPage = -1;
+		table.slots.resize (max ((size_t) 1024, oldSlots.size () * 2), empty);
+		size_t mask = table.slots.size () - 1;
+		for (Slot &slot : oldSlots) {
+			if (slot.whichPage == -1)
+				continue;
+			size_t i = JoinHashTable :: mix (slot.hash, MAX_DEPTH + 1) & mask;
+			while (table.slots[i].whichPage != -1)
+				i = (i + 1) & mask;
+			table.slots[i] = slot;
+		}
+	}
+
+	size_t mask = table.slots.size () - 1;
+	size_t i = JoinHashTable :: mix (hash, MAX_DEPTH + 1) & mask;
+	while (table.slots[i].whichPage != -1)
+		i = (i + 1) & mask;
+	table.slots[i].hash = hash;
+	table.slots[i].whichPage = (int) table.pages.size () - 1;
+	table.slots[i].offset = (int) ((char *) loc - (char *) table.pages.back ().getBytes ());
+	table.numGroups++;
+	return true;
+}
+
+void Aggregate :: clear (GroupTable &table) {
+	table.slots.clear ();
+	table.numGroups = 0;
+	table.pages.clear ();
+}
+
+size_t Aggregate :: inputHash () {
+	size_t hash = 0;
+	for (auto &group : groupFuncs)
+		hash = hash * 31 + group ()->hash ();
+	return hash;
+}
+
+size_t Aggregate :: partialHash (MyDB_RecordPtr fromMe) {
+	size_t hash = 0;
+	for (size_t i = 0; i < groupings.size (); i++)
+		hash = hash * 31 + fromMe->getAtt (i)->hash ();
+	return hash;
+}
+
+#endif
@@ -0,0 +1,183 @@
+
+#ifndef HASH_JOIN_CC
+#define HASH_JOIN_CC
+
+#include <algorithm>
+#include <iostream>
+#include "HashJoin.h"
+
+// the number of times that the inputs can be split into partitions, before a partition that
+// is still too big is joined with nested loops (this has to be less than the seed that
+// JoinHashTable picks its buckets with)
+#define MAX_DEPTH 3
+
+HashJoin :: HashJoin (MyDB_TableReaderWriterPtr leftInput, MyDB_TableReaderWriterPtr rightInput,
+	MyDB_TableReaderWriterPtr outputIn, string finalSelectionPredicateIn,
+	vector <string> projectionsIn, vector <pair <string, string>> equalityChecksIn,
+	string leftSelectionPredicateIn, string rightSelectionPredicateIn) {
+
+	leftTable = leftInput;
+	rightTable = rightInput;
+	output = outputIn;
+	finalSelectionPredicate = (finalSelectionPredicateIn == "") ? "bool[true]" : finalSelectionPredicateIn;
+	projections = projectionsIn;
+	equalityChecks = equalityChecksIn;
+	leftSelectionPredicate = (leftSelectionPredicateIn == "") ? "bool[true]" : leftSelectionPredicateIn;
+	rightSelectionPredicate = (rightSelectionPredicateIn == "") ? "bool[true]" : rightSelectionPredicateIn;
+}
+
+void HashJoin :: run () {
+
+	if (equalityChecks.empty ()) {
+		cout << "This is bad... a hash join needs at least one equality check.\n";
+		exit (1);
+	}
+
+	myMgr = leftTable->getBufferMgr ();
+	budget = max ((size_t) 1, myMgr->numPages / 2);
+
+	// the join works over a record made up of the current left and right records... since
+	// the combined record shares its attributes with them, it changes whenever they do
+	MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+	for (auto &att : leftTable->getTable ()->getSchema ()->getAtts ())
+		combinedSchema->appendAtt (att);
+	for (auto &att : rightTable->getTable ()->getSchema ()->getAtts ())
+		combinedSchema->appendAtt (att);
+
+	arena = make_shared <MyDB_Arena> ();
+	leftRec = leftTable->getEmptyRecord (arena);
+	rightRec = rightTable->getEmptyRecord (arena);
+	combinedRec = makeInArena <MyDB_Record> (arena, combinedSchema, arena);
+	combinedRec->buildFrom (leftRec, rightRec);
+	outRec = output->getEmptyRecord (arena);
+
+	leftPred = leftRec->compileComputation (leftSelectionPredicate);
+	rightPred = rightRec->compileComputation (rightSelectionPredicate);
+	finalPred = combinedRec->compileComputation (finalSelectionPredicate);
+	leftKeys.clear ();
+	rightKeys.clear ();
+	finalComputations.clear ();
+	for (auto &check : equalityChecks) {
+		leftKeys.push_back (leftRec->compileComputation (check.first));
+		rightKeys.push_back (rightRec->compileComputation (check.second));
+	}
+	for (string &s : projections)
+		finalComputations.push_back (combinedRec->compileComputation (s));
+
+	// two records with the same hash are only joined if all of the equality checks pass
+	keysMatch = combinedRec->compileComputation (JoinHashTable :: matchPredicate (equalityChecks));
+
+	MyDB_TableReaderWriterPtr leftInput = leftTable, rightInput = rightTable;
+	join ([leftInput] () {return leftInput->getIteratorAlt ();},
+		[rightInput] () {return rightInput->getIteratorAlt ();}, true, 0);
+
+	table.reset (myMgr, budget);
+}
+
+void HashJoin :: join (IterSource leftSource, IterSource rightSource, bool checkPreds, int depth) {
+
+	MyDB_RecordIteratorAltPtr leftIter = leftSource ();
+	bool pending = false;
+	bool more = loadBuildSide (leftIter, checkPreds, pending);
+
+	// the easy case: all of the left records fit
+	if (!more) {
+		probe (rightSource (), checkPreds);
+		return;
+	}
+
+	// they don't fit, and splitting them up has not helped, so do nested loops
+	if (depth >= MAX_DEPTH) {
+		while (true) {
+			probe (rightSource (), checkPreds);
+			if (!more)
+				return;
+			more = loadBuildSide (leftIter, checkPreds, pending);
+		}
+	}
+
+	// otherwise, split both sides into partitions... the left records that have already been
+	// loaded go first, then the one that did not fit, then the rest
+	size_t numParts = max ((size_t) 2, budget - 1);
+	vector <vector <MyDB_PageReaderWriter>> leftParts (numParts), rightParts (numParts);
+	for (auto &page : table.getPages ()) {
+		MyDB_RecordIteratorAltPtr buildIter = page.getIteratorAlt ();
+		while (buildIter->advance ()) {
+			buildIter->getCurrent (leftRec);
+			appendToList (leftParts[JoinHashTable :: mix (JoinHashTable :: hashKeys (leftKeys), depth) % numParts], leftRec);
+		}
+	}
+	table.reset (myMgr, budget);
+
+	leftIter->getCurrent (leftRec);
+	appendToList (leftParts[JoinHashTable :: mix (JoinHashTable :: hashKeys (leftKeys), depth) % numParts], leftRec);
+	while (leftIter->advance ()) {
+		leftIter->getCurrent (leftRec);
+		if (checkPreds && !leftPred ()->toBool ())
+			continue;
+		appendToList (leftParts[JoinHashTable :: mix (JoinHashTable :: hashKeys (leftKeys), depth) % numParts], leftRec);
+	}
+
+	MyDB_RecordIteratorAltPtr rightIter = rightSource ();
+	while (rightIter->advance ()) {
+		rightIter->getCurrent (rightRec);
+		if (checkPreds && !rightPred ()->toBool ())
+			continue;
+		appendToList (rightParts[JoinHashTable :: mix (JoinHashTable :: hashKeys (rightKeys), depth) % numParts], rightRec);
+	}
+
+	// and join each pair of partitions
+	for (size_t i = 0; i < numParts; i++) {
+		if (leftParts[i].empty () || rightParts[i].empty ())
+			continue;
+		vector <MyDB_PageReaderWriter> *leftPart = &leftParts[i], *rightPart = &rightParts[i];
+		join ([leftPart] () {return getIteratorAlt (*leftPart);},
+			[rightPart] () {return getIteratorAlt (*rightPart);}, false, depth + 1);
+		leftParts[i].clear ();
+		rightParts[i].clear ();
+	}
+}
+
+bool HashJoin :: loadBuildSide (MyDB_RecordIteratorAltPtr leftIter, bool checkPreds, bool &pending) {
+
+	// probing loads left records into leftRec, so the one that did not fit last time has to
+	// be loaded again
+	if (pending)
+		leftIter->getCurrent (leftRec);
+	return table.load (myMgr, budget, [&] () {
+		while (leftIter->advance ()) {
+			leftIter->getCurrent (leftRec);
+			if (!checkPreds || leftPred ()->toBool ())
+				return true;
+		}
+		return false;
+	}, leftRec, leftKeys, pending);
+}
+
+void HashJoin :: probe (MyDB_RecordIteratorAltPtr rightIter, bool checkPreds) {
+	while (rightIter->advance ()) {
+		rightIter->getCurrent (rightRec);
+		if (checkPreds && !rightPred ()->toBool ())
+			continue;
+
+		table.startProbe (JoinHashTable :: hashKeys (rightKeys));
+		while (table.nextMatch (leftRec)) {
+			if (!keysMatch ()->toBool () || !finalPred ()->toBool ())
+				continue;
+			for (size_t j = 0; j < finalComputations.size (); j++)
+				outRec->getAtt (j)->set (finalComputations[j] ());
+			outRec->recordContentHasChanged ();
+			output->append (outRec);
+		}
+	}
+}
+
+void HashJoin :: appendToList (vector <MyDB_PageReaderWriter> &list, MyDB_RecordPtr appendMe) {
+	if (list.empty () || !list.back ().append (appendMe)) {
+		list.push_back (MyDB_PageReaderWriter (*myMgr));
+		list.back ().clear ();
+		list.back ().append (appendMe);
+	}
+}
+
+#endif
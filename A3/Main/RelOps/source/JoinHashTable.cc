@@ -0,0 +1,127 @@
+
+#ifndef JOIN_HASH_TABLE_CC
+#define JOIN_HASH_TABLE_CC
+
+#include <cstdint>
+#include "JoinHashTable.h"
+
+void JoinHashTable :: reset (MyDB_BufferManagerPtr myMgrIn, size_t budgetIn) {
+	myMgr = myMgrIn;
+	budget = budgetIn;
+	pages.clear ();
+	pageBytes.clear ();
+	buckets.clear ();
+	entries.clear ();
+	nextEntry = -1;
+}
+
+bool JoinHashTable :: add (MyDB_RecordPtr addMe, size_t hash) {
+
+	void *loc = pages.empty () ? nullptr : pages.back ().appendAndReturnLocation (addMe);
+	if (loc == nullptr) {
+		if (pages.size () >= budget)
+			return false;
+		pages.push_back (MyDB_PageReaderWriter (true, *myMgr));
+		pages.back ().clear ();
+		loc = pages.back ().appendAndReturnLocation (addMe);
+	}
+
+	Entry entry;
+	entry.hash = hash;
+	entry.whichPage = (int) pages.size () - 1;
+	entry.offset = (int) ((char *) loc - (char *) pages.back ().getBytes ());
+	entry.next = -1;
+	entries.push_back (entry);
+	return true;
+}
+
+void JoinHashTable :: finish () {
+
+	// there are at least twice as many buckets as entries, and the number of buckets is a
+	// power of two
+	size_t numBuckets = 16;
+	while (numBuckets < 2 * entries.size ())
+		numBuckets *= 2;
+	buckets.assign (numBuckets, -1);
+	for (size_t i = 0; i < entries.size (); i++) {
+		size_t whichBucket = mix (entries[i].hash, bucketSeed) & (numBuckets - 1);
+		entries[i].next = buckets[whichBucket];
+		buckets[whichBucket] = (int) i;
+	}
+
+	pageBytes.clear ();
+	for (auto &page : pages)
+		pageBytes.push_back ((char *) page.getBytes ());
+	nextEntry = -1;
+}
+
+bool JoinHashTable :: load (MyDB_BufferManagerPtr myMgrIn, size_t budgetIn, function <bool ()> nextRecord,
+	MyDB_RecordPtr addMe, vector <func> &keys, bool &pending) {
+
+	reset (myMgrIn, budgetIn);
+	while (true) {
+
+		// get the next record, unless the current one did not fit last time
+		if (pending)
+			pending = false;
+		else if (!nextRecord ())
+			break;
+
+		// out of room, so this record is left for next time
+		if (!add (addMe, hashKeys (keys))) {
+			pending = true;
+			break;
+		}
+	}
+
+	finish ();
+	return pending;
+}
+
+void JoinHashTable :: startProbe (size_t hash) {
+	probeHash = hash;
+	nextEntry = buckets[mix (hash, bucketSeed) & (buckets.size () - 1)];
+}
+
+bool JoinHashTable :: nextMatch (MyDB_RecordPtr intoMe) {
+	while (nextEntry != -1) {
+		Entry &entry = entries[nextEntry];
+		nextEntry = entry.next;
+		if (entry.hash != probeHash)
+			continue;
+		intoMe->fromBinary (pageBytes[entry.whichPage] + entry.offset);
+		return true;
+	}
+	return false;
+}
+
+size_t JoinHashTable :: size () {
+	return entries.size ();
+}
+
+vector <MyDB_PageReaderWriter> &JoinHashTable :: getPages () {
+	return pages;
+}
+
+size_t JoinHashTable :: hashKeys (vector <func> &keys) {
+	size_t hash = 0;
+	for (auto &key : keys)
+		hash = hash * 31 + key ()->hash ();
+	return hash;
+}
+
+string JoinHashTable :: matchPredicate (vector <pair <string, string>> &equalityChecks) {
+	string allMatch = "== (" + equalityChecks[0].first + ", " + equalityChecks[0].second + ")";
+	for (size_t i = 1; i < equalityChecks.size (); i++)
+		allMatch = "&& (" + allMatch + ", == (" + equalityChecks[i].first + ", " + equalityChecks[i].second + "))";
+	return allMatch;
+}
+
+size_t JoinHashTable :: mix (size_t hash, size_t seed) {
+	uint64_t x = (uint64_t) hash + 0x9E3779B97F4A7C15ULL * (seed + 1);
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return (size_t) (x ^ (x >> 31));
+}
+
+#endif
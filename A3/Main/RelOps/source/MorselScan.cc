@@ -0,0 +1,296 @@
+
+#ifndef MORSEL_SCAN_CC
+#define MORSEL_SCAN_CC
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include "MorselScan.h"
+#include "MyDB_AttVal.h"
+#include "MyDB_CompressedPage.h"
+#include "MyDB_PageReaderWriter.h"
+
+// where the records on a page image start and end
+#define FIRST_RECORD(image) ((image) + 2 * sizeof (size_t))
+#define END_OF_RECORDS(image) ((image) + *((size_t *) ((image) + sizeof (size_t))))
+
+MorselScan :: MorselScan (MyDB_TableReaderWriterPtr inputIn, int numWorkersIn, int morselSizeIn) {
+	input = inputIn;
+	numWorkers = (numWorkersIn <= 0) ? max (1, (int) thread :: hardware_concurrency ()) : numWorkersIn;
+	morselSize = max (1, morselSizeIn);
+	pageSize = input->getBufferMgr ()->getPageSize ();
+	for (int i = 0; i < numWorkers; i++)
+		records.push_back (input->getEmptyRecord ());
+	vector <MorselQueue> newQueues (numWorkers);
+	queues.swap (newQueues);
+	morselsRun.assign (numWorkers, 0);
+	stolen.assign (numWorkers, 0);
+	lockedFor.assign (numWorkers, chrono::steady_clock::duration :: zero ());
+	spilled.assign (numWorkers, 0);
+}
+
+int MorselScan :: getNumWorkers () {
+	return numWorkers;
+}
+
+MyDB_RecordPtr MorselScan :: getRecord (int whichWorker) {
+	return records[whichWorker];
+}
+
+vector <size_t> MorselScan :: getMorselsRun () {
+	return morselsRun;
+}
+
+size_t MorselScan :: getNumStolen () {
+	size_t total = 0;
+	for (size_t count : stolen)
+		total += count;
+	return total;
+}
+
+double MorselScan :: getLockedMillis () {
+	chrono::steady_clock::duration total = chrono::steady_clock::duration :: zero ();
+	for (auto &time : lockedFor)
+		total += time;
+	return chrono::duration <double, milli> (total).count ();
+}
+
+size_t MorselScan :: getNumSpilled () {
+	size_t total = 0;
+	for (size_t count : spilled)
+		total += count;
+	return total;
+}
+
+void MorselScan :: run (string selectionPredicate, function <void (int, MyDB_RecordPtr)> processMe) {
+
+	if (selectionPredicate == "")
+		selectionPredicate = "bool[true]";
+
+	// each worker starts out with the morsels in one contiguous part of the table
+	int numMorsels = (input->getNumPages () + morselSize - 1) / morselSize;
+	for (int i = 0; i < numWorkers; i++) {
+		queues[i].morsels.clear ();
+		for (int j = numMorsels * i / numWorkers; j < numMorsels * (i + 1) / numWorkers; j++)
+			queues[i].morsels.push_back (j * morselSize);
+	}
+	morselsRun.assign (numWorkers, 0);
+	stolen.assign (numWorkers, 0);
+	lockedFor.assign (numWorkers, chrono::steady_clock::duration :: zero ());
+
+	// the predicates are compiled here, since compiling is not thread-safe
+	vector <func> preds;
+	for (int i = 0; i < numWorkers; i++)
+		preds.push_back (records[i]->compileComputation (selectionPredicate));
+
+	vector <thread> threads;
+	for (int i = 0; i < numWorkers; i++)
+		threads.push_back (thread (&MorselScan :: work, this, i, preds[i], processMe));
+	for (auto &t : threads)
+		t.join ();
+}
+
+bool MorselScan :: nextMorsel (int whichWorker, int &firstPage) {
+
+	// first, try this worker's own queue
+	{
+		lock_guard <mutex> guard (queues[whichWorker].lock);
+		if (!queues[whichWorker].morsels.empty ()) {
+			firstPage = queues[whichWorker].morsels.front ();
+			queues[whichWorker].morsels.pop_front ();
+			return true;
+		}
+	}
+
+	// then steal from the back of the longest queue... since morsels are never added, once
+	// every queue has been seen to be empty, there is nothing left
+	while (true) {
+		int victim = -1;
+		size_t mostLeft = 0;
+		for (int i = 0; i < numWorkers; i++) {
+			lock_guard <mutex> guard (queues[i].lock);
+			if (queues[i].morsels.size () > mostLeft) {
+				mostLeft = queues[i].morsels.size ();
+				victim = i;
+			}
+		}
+		if (victim == -1)
+			return false;
+
+		lock_guard <mutex> guard (queues[victim].lock);
+		if (!queues[victim].morsels.empty ()) {
+			firstPage = queues[victim].morsels.back ();
+			queues[victim].morsels.pop_back ();
+			stolen[whichWorker]++;
+			return true;
+		}
+	}
+}
+
+void MorselScan :: work (int whichWorker, func pred, function <void (int, MyDB_RecordPtr)> processMe) {
+
+	MyDB_RecordPtr rec = records[whichWorker];
+	vector <vector <char>> images (morselSize, vector <char> (pageSize));
+	vector <char> rows;
+	int firstPage;
+	while (nextMorsel (whichWorker, firstPage)) {
+
+		// copy the morsel's pages out of the buffer
+		int numPages = 0;
+		{
+			lock_guard <mutex> guard (bufferLock);
+			auto start = chrono::steady_clock::now ();
+			int lastPage = min (firstPage + morselSize, input->getNumPages ());
+			for (int i = firstPage; i < lastPage; i++) {
+				MyDB_PageReaderWriter page = (*input)[i];
+				if (page.getType () == MyDB_PageType :: DirectoryPage)
+					continue;
+				page.copyTo (images[numPages++].data ());
+			}
+			lockedFor[whichWorker] += chrono::steady_clock::now () - start;
+		}
+
+		// and run the pipeline over their records... a compressed page is decoded here, so
+		// that the decoding is done in parallel as well
+		for (int i = 0; i < numPages; i++) {
+			char *image = images[i].data ();
+			if (*((MyDB_PageType *) image) == MyDB_PageType :: CompressedPage) {
+				MyDB_CompressedPage (image, pageSize).toRows (rows);
+				image = rows.data ();
+			}
+			char *pos = FIRST_RECORD (image);
+			char *end = END_OF_RECORDS (image);
+			while (pos != end) {
+				pos = (char *) rec->fromBinary (pos);
+				if (pred ()->toBool ())
+					processMe (whichWorker, rec);
+			}
+		}
+		morselsRun[whichWorker]++;
+	}
+}
+
+void MorselScan :: aggregate (MyDB_TableReaderWriterPtr output, vector <pair <MyDB_AggType, string>> aggsToCompute,
+	vector <string> groupings, string selectionPredicate) {
+
+	// the partial aggregates are merged by a regular aggregation
+	Aggregate finalOp (input, output, aggsToCompute, groupings, "");
+	MyDB_SchemaPtr partialSchema = finalOp.getPartialSchema ();
+	MyDB_SchemaPtr keySchema = make_shared <MyDB_Schema> ();
+	for (size_t i = 0; i < groupings.size (); i++)
+		keySchema->appendAtt (partialSchema->getAtts ()[i]);
+
+	// each worker's groups are found by the binary version of their keys... each group has
+	// a running sum for each aggregate, and a count.  The groups that a worker has written
+	// out are on its own list of anonymous pages
+	struct WorkerGroups {
+		MyDB_RecordPtr keyRec;
+		MyDB_RecordPtr partialRec;
+		MyDB_DoubleAttValPtr sum;
+		vector <func> groupFuncs;
+		vector <func> aggFuncs;
+		vector <char> keyBytes;
+		unordered_map <string, size_t> index;
+		vector <string> keys;
+		vector <double> sums;
+		vector <int> counts;
+		size_t bytesUsed;
+		vector <MyDB_PageReaderWriter> partials;
+	};
+	size_t numAggs = aggsToCompute.size ();
+	vector <WorkerGroups> workers (numWorkers);
+	for (int i = 0; i < numWorkers; i++) {
+		workers[i].keyRec = make_shared <MyDB_Record> (keySchema);
+		workers[i].partialRec = make_shared <MyDB_Record> (partialSchema);
+		workers[i].sum = make_shared <MyDB_DoubleAttVal> ();
+		workers[i].bytesUsed = 0;
+		for (string &grouping : groupings)
+			workers[i].groupFuncs.push_back (records[i]->compileComputation (grouping));
+		for (auto &agg : aggsToCompute)
+			workers[i].aggFuncs.push_back (records[i]->compileComputation (agg.first == cntAgg ? "int[0]" : agg.second));
+	}
+
+	// the workers split half of the buffer's worth of RAM between them, just as Aggregate keeps
+	// its groups in half of the buffer... each group takes up its key and sums, plus (roughly)
+	// a hash table node and the two copies of the key's string
+	MyDB_BufferManagerPtr myMgr = input->getBufferMgr ();
+	size_t maxBytes = max (pageSize, (myMgr->numPages / 2) * pageSize / numWorkers);
+	size_t overhead = 2 * sizeof (string) + 4 * sizeof (void *) + numAggs * sizeof (double) + sizeof (int);
+	spilled.assign (numWorkers, 0);
+
+	// writes all of a worker's groups out as partial aggregates, and empties out its table
+	auto writeOut = [&] (WorkerGroups &groups) {
+		for (size_t whichGroup = 0; whichGroup < groups.keys.size (); whichGroup++) {
+			groups.keyRec->fromBinary (&groups.keys[whichGroup][0]);
+			for (size_t i = 0; i < groupings.size (); i++)
+				groups.partialRec->getAtt (i)->set (groups.keyRec->getAtt (i));
+			for (size_t i = 0; i < numAggs; i++) {
+				groups.sum->set (groups.sums[whichGroup * numAggs + i]);
+				groups.partialRec->getAtt (groupings.size () + 2 * i)->set (groups.sum);
+				groups.partialRec->getAtt (groupings.size () + 2 * i + 1)->fromInt (groups.counts[whichGroup]);
+			}
+			groups.partialRec->recordContentHasChanged ();
+			if (groups.partials.empty () || !groups.partials.back ().append (groups.partialRec)) {
+				groups.partials.push_back (MyDB_PageReaderWriter (*myMgr));
+				groups.partials.back ().clear ();
+				groups.partials.back ().append (groups.partialRec);
+			}
+		}
+		groups.index.clear ();
+		groups.keys.clear ();
+		groups.sums.clear ();
+		groups.counts.clear ();
+		groups.bytesUsed = 0;
+	};
+
+	run (selectionPredicate, [&] (int whichWorker, MyDB_RecordPtr) {
+		WorkerGroups &groups = workers[whichWorker];
+		for (size_t i = 0; i < groups.groupFuncs.size (); i++)
+			groups.keyRec->getAtt (i)->set (groups.groupFuncs[i] ());
+		groups.keyRec->recordContentHasChanged ();
+		groups.keyBytes.resize (groups.keyRec->getBinarySize ());
+		groups.keyRec->toBinary (groups.keyBytes.data ());
+
+		string key (groups.keyBytes.data (), groups.keyBytes.size ());
+		auto found = groups.index.find (key);
+		size_t whichGroup;
+		if (found == groups.index.end ()) {
+
+			// a new group... if there is no room for it, make room
+			if (groups.bytesUsed + 2 * key.size () + overhead > maxBytes && !groups.keys.empty ()) {
+				lock_guard <mutex> guard (bufferLock);
+				auto start = chrono::steady_clock::now ();
+				writeOut (groups);
+				spilled[whichWorker]++;
+				lockedFor[whichWorker] += chrono::steady_clock::now () - start;
+			}
+			whichGroup = groups.keys.size ();
+			groups.index[key] = whichGroup;
+			groups.keys.push_back (key);
+			groups.sums.resize (groups.sums.size () + numAggs, 0);
+			groups.counts.push_back (0);
+			groups.bytesUsed += 2 * key.size () + overhead;
+		} else {
+			whichGroup = found->second;
+		}
+
+		for (size_t i = 0; i < numAggs; i++) {
+			if (aggsToCompute[i].first != cntAgg)
+				groups.sums[whichGroup * numAggs + i] += groups.aggFuncs[i] ()->toDouble ();
+		}
+		groups.counts[whichGroup]++;
+	});
+
+	// write out what is left of the partial aggregates (the workers are done, so the buffer
+	// lock is not needed), and merge them all
+	vector <MyDB_RecordIteratorAltPtr> iters;
+	for (auto &groups : workers) {
+		writeOut (groups);
+		if (!groups.partials.empty ())
+			iters.push_back (getIteratorAlt (groups.partials));
+	}
+	finalOp.mergePartials (iters);
+}
+
+#endif
@@ -0,0 +1,430 @@
+
+#ifndef QUERY_OP_CC
+#define QUERY_OP_CC
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "QueryOp.h"
+#include "Sorting.h"
+
+// the combined schema of two records
+static MyDB_SchemaPtr combineSchemas (MyDB_SchemaPtr left, MyDB_SchemaPtr right) {
+	MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+	for (auto &att : left->getAtts ())
+		combinedSchema->appendAtt (att);
+	for (auto &att : right->getAtts ())
+		combinedSchema->appendAtt (att);
+	return combinedSchema;
+}
+
+/*************************************** QueryOp ***************************************/
+
+void QueryOp :: open () {
+	numRecords = 0;
+	timeSpent = chrono::steady_clock::duration :: zero ();
+	auto start = chrono::steady_clock::now ();
+	doOpen ();
+	timeSpent += chrono::steady_clock::now () - start;
+}
+
+bool QueryOp :: next () {
+	auto start = chrono::steady_clock::now ();
+	bool gotOne = doNext ();
+	timeSpent += chrono::steady_clock::now () - start;
+	if (gotOne)
+		numRecords++;
+	return gotOne;
+}
+
+void QueryOp :: close () {
+	doClose ();
+}
+
+void QueryOp :: doClose () {
+	for (auto &child : children)
+		child->close ();
+}
+
+MyDB_RecordPtr QueryOp :: getRecord () {
+	return output;
+}
+
+MyDB_SchemaPtr QueryOp :: getSchema () {
+	return output->getSchema ();
+}
+
+size_t QueryOp :: getNumRecords () {
+	return numRecords;
+}
+
+double QueryOp :: getMillis () {
+	return chrono::duration <double, milli> (timeSpent).count ();
+}
+
+string QueryOp :: getProfile () {
+	string profile;
+	addToProfile (profile, 0);
+	return profile;
+}
+
+void QueryOp :: addToProfile (string &profile, int indent) {
+
+	// the time spent in this operator alone is what is left over after its children
+	double childMillis = 0;
+	for (auto &child : children)
+		childMillis += child->getMillis ();
+
+	ostringstream line;
+	line << fixed << setprecision (2) << string (indent, ' ') << getName () << ": " << numRecords
+		<< " records, " << getMillis () << " ms (" << max (0.0, getMillis () - childMillis)
+		<< " ms in this operator)\n";
+	profile += line.str ();
+
+	for (auto &child : children)
+		child->addToProfile (profile, indent + 2);
+}
+
+void QueryOp :: appendAllTo (MyDB_TableReaderWriterPtr appendToMe) {
+	open ();
+	while (next ())
+		appendToMe->append (output);
+	close ();
+}
+
+QueryOp :: ~QueryOp () {}
+
+void QueryOp :: addChild (QueryOpPtr child) {
+	children.push_back (child);
+	myMgr = children[0]->myMgr;
+}
+
+size_t QueryOp :: getBudget () {
+	size_t budget = myMgr->numPages / 2;
+	for (size_t i = numHoldingBelow (); i > 0 && budget > 1; i--)
+		budget /= 2;
+	return max ((size_t) 1, budget);
+}
+
+size_t QueryOp :: numHoldingBelow () {
+	size_t count = 0;
+	for (auto &child : children)
+		count += child->numHoldingBelow () + (child->holdsPages ? 1 : 0);
+	return count;
+}
+
+void QueryOp :: appendToList (vector <MyDB_PageReaderWriter> &list, MyDB_BufferManagerPtr myMgr,
+	MyDB_RecordPtr appendMe) {
+	if (list.empty () || !list.back ().append (appendMe)) {
+		list.push_back (MyDB_PageReaderWriter (*myMgr));
+		list.back ().clear ();
+		list.back ().append (appendMe);
+	}
+}
+
+/*************************************** ScanOp ***************************************/
+
+ScanOp :: ScanOp (MyDB_TableReaderWriterPtr scanMe) {
+	table = scanMe;
+	myMgr = table->getBufferMgr ();
+	output = table->getEmptyRecord ();
+}
+
+void ScanOp :: doOpen () {
+	iter = table->getIteratorAlt ();
+}
+
+bool ScanOp :: doNext () {
+	if (!iter->advance ())
+		return false;
+	iter->getCurrent (output);
+	return true;
+}
+
+void ScanOp :: doClose () {
+	iter = nullptr;
+}
+
+string ScanOp :: getName () {
+	return "Scan " + table->getTable ()->getName ();
+}
+
+/*************************************** FilterOp ***************************************/
+
+FilterOp :: FilterOp (QueryOpPtr child, string predicateIn) {
+	addChild (child);
+	predicate = (predicateIn == "") ? "bool[true]" : predicateIn;
+	output = child->getRecord ();
+}
+
+void FilterOp :: doOpen () {
+	pred = output->compileComputation (predicate);
+	children[0]->open ();
+}
+
+bool FilterOp :: doNext () {
+	while (children[0]->next ()) {
+		if (pred ()->toBool ())
+			return true;
+	}
+	return false;
+}
+
+string FilterOp :: getName () {
+	return "Filter " + predicate;
+}
+
+/*************************************** ProjectOp ***************************************/
+
+ProjectOp :: ProjectOp (QueryOpPtr child, MyDB_SchemaPtr outSchema, vector <string> computationsIn) {
+	addChild (child);
+	output = make_shared <MyDB_Record> (outSchema);
+	if (computationsIn.size () != outSchema->getAtts ().size ()) {
+		cout << "This is bad... a projection needs one computation per output attribute.\n";
+		exit (1);
+	}
+	for (string &s : computationsIn)
+		computations.push_back (child->getRecord ()->compileComputation (s));
+}
+
+void ProjectOp :: doOpen () {
+	children[0]->open ();
+}
+
+bool ProjectOp :: doNext () {
+	if (!children[0]->next ())
+		return false;
+	for (size_t i = 0; i < computations.size (); i++)
+		output->getAtt (i)->set (computations[i] ());
+	output->recordContentHasChanged ();
+	return true;
+}
+
+string ProjectOp :: getName () {
+	return "Project";
+}
+
+/*************************************** SortOp ***************************************/
+
+SortOp :: SortOp (QueryOpPtr child, string sortOnIn) {
+	addChild (child);
+	sortOn = sortOnIn;
+	holdsPages = true;
+	output = make_shared <MyDB_Record> (child->getSchema ());
+	lhs = make_shared <MyDB_Record> (child->getSchema ());
+	rhs = make_shared <MyDB_Record> (child->getSchema ());
+}
+
+void SortOp :: doOpen () {
+
+	// copy all of the child's records into anonymous pages, and let the child go
+	pages.clear ();
+	children[0]->open ();
+	while (children[0]->next ())
+		appendToList (pages, myMgr, children[0]->getRecord ());
+	children[0]->close ();
+
+	iter = buildIteratorOverSortedRuns ((int) getBudget (), myMgr, pages,
+		buildRecordComparator (lhs, rhs, sortOn), lhs, rhs);
+}
+
+bool SortOp :: doNext () {
+	if (!iter->advance ())
+		return false;
+	iter->getCurrent (output);
+	return true;
+}
+
+void SortOp :: doClose () {
+	iter = nullptr;
+	pages.clear ();
+}
+
+string SortOp :: getName () {
+	return "Sort on " + sortOn;
+}
+
+/*************************************** HashJoinOp ***************************************/
+
+HashJoinOp :: HashJoinOp (QueryOpPtr left, QueryOpPtr right, vector <pair <string, string>> equalityChecksIn) {
+	addChild (left);
+	addChild (right);
+	equalityChecks = equalityChecksIn;
+	holdsPages = true;
+	if (equalityChecks.empty ()) {
+		cout << "This is bad... a hash join needs at least one equality check.\n";
+		exit (1);
+	}
+
+	// the output is made up of a left record from the hash table and the right child's record...
+	// since it shares its attributes with them, it changes whenever they do
+	buildRec = make_shared <MyDB_Record> (left->getSchema ());
+	output = make_shared <MyDB_Record> (combineSchemas (left->getSchema (), right->getSchema ()));
+	output->buildFrom (buildRec, right->getRecord ());
+
+	for (auto &check : equalityChecks) {
+		leftKeys.push_back (left->getRecord ()->compileComputation (check.first));
+		rightKeys.push_back (right->getRecord ()->compileComputation (check.second));
+	}
+
+	// two records with the same hash are only joined if all of the equality checks pass
+	keysMatch = output->compileComputation (JoinHashTable :: matchPredicate (equalityChecks));
+}
+
+void HashJoinOp :: doOpen () {
+
+	leftPending = false;
+	rightCopied = false;
+	probing = false;
+	children[0]->open ();
+	children[1]->open ();
+
+	// if all of the left records fit, the right records are pipelined through; otherwise,
+	// they have to be kept so that they can be joined with each group of left records
+	if (loadBuildSide ()) {
+		rightCopied = true;
+		rightPages.clear ();
+		while (children[1]->next ())
+			appendToList (rightPages, myMgr, children[1]->getRecord ());
+		children[1]->close ();
+
+		// getIteratorAlt () needs at least one page, and with no right records, nothing
+		// can be joined anyway
+		if (!rightPages.empty ())
+			rightIter = getIteratorAlt (rightPages);
+	}
+}
+
+bool HashJoinOp :: doNext () {
+
+	while (true) {
+
+		// go through the rest of the left records that match the current right record
+		while (probing && table.nextMatch (buildRec)) {
+			if (keysMatch ()->toBool ()) {
+				output->recordContentHasChanged ();
+				return true;
+			}
+		}
+		probing = false;
+
+		// on to the next right record... if there are none left, then we are done, unless
+		// there are more left records to join them with
+		if (!nextProbe ()) {
+			if (!rightCopied || !leftPending || rightPages.empty ())
+				return false;
+			loadBuildSide ();
+			rightIter = getIteratorAlt (rightPages);
+			continue;
+		}
+
+		table.startProbe (JoinHashTable :: hashKeys (rightKeys));
+		probing = true;
+	}
+}
+
+void HashJoinOp :: doClose () {
+	QueryOp :: doClose ();
+	table.reset (myMgr, 0);
+	rightIter = nullptr;
+	rightPages.clear ();
+}
+
+string HashJoinOp :: getName () {
+	string name = "Hash join on";
+	for (auto &check : equalityChecks)
+		name += " " + check.first + " = " + check.second;
+	return name;
+}
+
+bool HashJoinOp :: loadBuildSide () {
+
+	QueryOpPtr left = children[0];
+	table.load (myMgr, getBudget (), [left] () {return left->next ();}, left->getRecord (), leftKeys, leftPending);
+
+	// the left child is not needed once all of its records are in
+	if (!leftPending)
+		left->close ();
+	return leftPending;
+}
+
+bool HashJoinOp :: nextProbe () {
+	if (!rightCopied)
+		return children[1]->next ();
+	if (rightIter == nullptr || !rightIter->advance ())
+		return false;
+	rightIter->getCurrent (children[1]->getRecord ());
+	return true;
+}
+
+/*************************************** AggregateOp ***************************************/
+
+AggregateOp :: AggregateOp (QueryOpPtr child, MyDB_SchemaPtr outSchema,
+	vector <pair <MyDB_AggType, string>> aggsToComputeIn, vector <string> groupingsIn) {
+	addChild (child);
+	aggsToCompute = aggsToComputeIn;
+	groupings = groupingsIn;
+	holdsPages = true;
+	output = make_shared <MyDB_Record> (outSchema);
+}
+
+void AggregateOp :: doOpen () {
+
+	// the groups come out of the aggregation all at once, so they are kept on anonymous pages
+	pages.clear ();
+	Aggregate myOp (myMgr, children[0]->getSchema (), output->getSchema (), aggsToCompute, groupings, "");
+	myOp.setBudget (getBudget ());
+
+	vector <MyDB_PageReaderWriter> *appendTo = &pages;
+	MyDB_BufferManagerPtr mgr = myMgr;
+	children[0]->open ();
+	myOp.run (make_shared <QueryOpIteratorAlt> (children[0]),
+		[appendTo, mgr] (MyDB_RecordPtr outRec) {appendToList (*appendTo, mgr, outRec);});
+	children[0]->close ();
+
+	// there are no groups if the child produced no records (and getIteratorAlt () needs at
+	// least one page)
+	iter = pages.empty () ? nullptr : getIteratorAlt (pages);
+}
+
+bool AggregateOp :: doNext () {
+	if (iter == nullptr || !iter->advance ())
+		return false;
+	iter->getCurrent (output);
+	return true;
+}
+
+void AggregateOp :: doClose () {
+	iter = nullptr;
+	pages.clear ();
+}
+
+string AggregateOp :: getName () {
+	return "Aggregate";
+}
+
+/*************************************** QueryOpIteratorAlt ***************************************/
+
+QueryOpIteratorAlt :: QueryOpIteratorAlt (QueryOpPtr iterateOverMe) {
+	op = iterateOverMe;
+}
+
+void QueryOpIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (buffer.data ());
+}
+
+void *QueryOpIteratorAlt :: getCurrentPointer () {
+	return buffer.data ();
+}
+
+bool QueryOpIteratorAlt :: advance () {
+	if (!op->next ())
+		return false;
+	MyDB_RecordPtr rec = op->getRecord ();
+	buffer.resize (rec->getBinarySize ());
+	rec->toBinary (buffer.data ());
+	return true;
+}
+
+#endif
@@ -0,0 +1,140 @@
+
+#ifndef SORTMERGE_CC
+#define SORTMERGE_CC
+
+#include <algorithm>
+#include "MyDB_PageReaderWriter.h"
+#include "SortMergeJoin.h"
+#include "Sorting.h"
+
+SortMergeJoin :: SortMergeJoin (MyDB_TableReaderWriterPtr leftInput, MyDB_TableReaderWriterPtr rightInput,
+	MyDB_TableReaderWriterPtr outputIn, string finalSelectionPredicateIn,
+	vector <string> projectionsIn, pair <string, string> equalityCheckIn,
+	string leftSelectionPredicateIn, string rightSelectionPredicateIn) {
+
+	leftTable = leftInput;
+	rightTable = rightInput;
+	output = outputIn;
+	finalSelectionPredicate = (finalSelectionPredicateIn == "") ? "bool[true]" : finalSelectionPredicateIn;
+	projections = projectionsIn;
+	equalityCheck = equalityCheckIn;
+	leftSelectionPredicate = (leftSelectionPredicateIn == "") ? "bool[true]" : leftSelectionPredicateIn;
+	rightSelectionPredicate = (rightSelectionPredicateIn == "") ? "bool[true]" : rightSelectionPredicateIn;
+}
+
+void SortMergeJoin :: run () {
+
+	// sort each side on its key... the sorted runs are merged as we ask for records
+	MyDB_BufferManagerPtr myMgr = leftTable->getBufferMgr ();
+	int runSize = max (1, (int) myMgr->numPages / 2);
+
+	// everything that the join sets up comes from this arena, which goes away when the join is done
+	MyDB_ArenaPtr arena = make_shared <MyDB_Arena> ();
+
+	MyDB_RecordPtr leftLhs = leftTable->getEmptyRecord (arena);
+	MyDB_RecordPtr leftRhs = leftTable->getEmptyRecord (arena);
+	MyDB_RecordIteratorAltPtr leftIter = buildIteratorOverSortedRuns (runSize, *leftTable,
+		buildRecordComparator (leftLhs, leftRhs, equalityCheck.first), leftLhs, leftRhs);
+
+	MyDB_RecordPtr rightLhs = rightTable->getEmptyRecord (arena);
+	MyDB_RecordPtr rightRhs = rightTable->getEmptyRecord (arena);
+	MyDB_RecordIteratorAltPtr rightIter = buildIteratorOverSortedRuns (runSize, *rightTable,
+		buildRecordComparator (rightLhs, rightRhs, equalityCheck.second), rightLhs, rightRhs);
+
+	// the join works over a record made up of the current left and right records... since
+	// the combined record shares its attributes with them, it changes whenever they do
+	MyDB_SchemaPtr combinedSchema = make_shared <MyDB_Schema> ();
+	for (auto &att : leftTable->getTable ()->getSchema ()->getAtts ())
+		combinedSchema->appendAtt (att);
+	for (auto &att : rightTable->getTable ()->getSchema ()->getAtts ())
+		combinedSchema->appendAtt (att);
+
+	MyDB_RecordPtr leftRec = leftTable->getEmptyRecord (arena);
+	MyDB_RecordPtr rightRec = rightTable->getEmptyRecord (arena);
+	MyDB_RecordPtr combinedRec = makeInArena <MyDB_Record> (arena, combinedSchema, arena);
+	combinedRec->buildFrom (leftRec, rightRec);
+
+	func leftPred = leftRec->compileComputation (leftSelectionPredicate);
+	func rightPred = rightRec->compileComputation (rightSelectionPredicate);
+	func leftSmaller = combinedRec->compileComputation ("< (" + equalityCheck.first + ", " + equalityCheck.second + ")");
+	func rightSmaller = combinedRec->compileComputation ("> (" + equalityCheck.first + ", " + equalityCheck.second + ")");
+	func finalPred = combinedRec->compileComputation (finalSelectionPredicate);
+	vector <func> finalComputations;
+	for (string &s : projections)
+		finalComputations.push_back (combinedRec->compileComputation (s));
+
+	MyDB_RecordPtr outRec = output->getEmptyRecord (arena);
+
+	// move to the next record on one side that passes the selection predicate on that side
+	auto nextLeft = [&] () {
+		while (leftIter->advance ()) {
+			leftIter->getCurrent (leftRec);
+			if (leftPred ()->toBool ())
+				return true;
+		}
+		return false;
+	};
+	auto nextRight = [&] () {
+		while (rightIter->advance ()) {
+			rightIter->getCurrent (rightRec);
+			if (rightPred ()->toBool ())
+				return true;
+		}
+		return false;
+	};
+
+	bool leftValid = nextLeft ();
+	bool rightValid = nextRight ();
+	while (leftValid && rightValid) {
+
+		// move along whichever side is behind
+		if (leftSmaller ()->toBool ()) {
+			leftValid = nextLeft ();
+			continue;
+		}
+		if (rightSmaller ()->toBool ()) {
+			rightValid = nextRight ();
+			continue;
+		}
+
+		// the keys match, so copy all of the left records with this key into pinned pages
+		vector <MyDB_PageReaderWriter> group;
+		do {
+			if (group.empty () || !group.back ().append (leftRec)) {
+				group.push_back (MyDB_PageReaderWriter (true, *myMgr));
+				group.back ().clear ();
+				group.back ().append (leftRec);
+			}
+			leftValid = nextLeft ();
+		} while (leftValid && !rightSmaller ()->toBool ());
+
+		// and join each right record with this key with all of them
+		MyDB_RecordIteratorAltPtr groupIter;
+		do {
+			groupIter = getIteratorAlt (group);
+			while (groupIter->advance ()) {
+				groupIter->getCurrent (leftRec);
+				if (!finalPred ()->toBool ())
+					continue;
+				for (size_t i = 0; i < finalComputations.size (); i++)
+					outRec->getAtt (i)->set (finalComputations[i] ());
+				outRec->recordContentHasChanged ();
+				output->append (outRec);
+			}
+
+			// see if the next right record has the same key as the group
+			rightValid = nextRight ();
+			if (!rightValid)
+				break;
+			groupIter = group.front ().getIteratorAlt ();
+			groupIter->advance ();
+			groupIter->getCurrent (leftRec);
+		} while (!leftSmaller ()->toBool () && !rightSmaller ()->toBool ());
+
+		// the left record was used for the group, so get the current one back
+		if (leftValid)
+			leftIter->getCurrent (leftRec);
+	}
+}
+
+#endif